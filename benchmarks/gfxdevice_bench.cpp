@@ -0,0 +1,539 @@
+/*=========================================================================
+
+                         >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+// Headless microbenchmark of the GfxDevices, running the TestUnits of
+// gfxdevice_testapp against offscreen canvases without opening a window.
+//
+// Every TestUnit is run against SoftGfxDevice and StreamGfxDevice (streaming
+// into a byte-counting GfxStreamWriter) and, when built with WG_BENCH_EGL
+// defined, against GlGfxDevice in a surfaceless EGL core profile context,
+// rendering into a GlSurface canvas. No display or window system is needed,
+// so it runs on Mesa llvmpipe on a headless machine.
+// Each unit is run in batches of beginRender(), N x run(), endRender() until
+// at least the requested time has passed. Results are written as JSON, one
+// object per device/unit/canvas with:
+//
+//		calls		Number of TestUnit::run() calls timed.
+//		seconds		Total time spent in the timed batches.
+//		callsPerSec	TestUnit::run() calls per second.
+//		mpixPerSec	Megapixels filled per second, only for the units that are known to fill
+//					the whole canvas once per call (StraightFill, BlendFill).
+//		bytesPerCall Bytes streamed per call (StreamGfxDevice only).
+//		nsPerDraw	Nanoseconds per draw call, for the draw call units only.
+//
+// The draw call units (SmallFills, SkinBlits) issue many small fills and blits
+// per run() instead of covering the canvas. They measure the per-draw CPU
+// overhead of a device, which is what dominates GlGfxDevice on a software GL
+// like Mesa llvmpipe when rendering ordinary widgets.
+//
+// StreamGfxDevice only encodes the calls, so its figures measure streaming
+// overhead rather than rasterization.
+//
+// Units that fail init(), typically because ../resources/splash.png could not
+// be loaded or the canvas is too small for the unit, are reported with
+// "skipped" : true. Run it from a directory one level below the repository root
+// (e.g. gfxdevice_testapp) for the units that blit to find their resources.
+//
+// Usage: gfxdevice_bench [--sizes WxH,WxH,...] [--time seconds] [--output file.json]
+//        (default --sizes 256x256,1024x768 --time 0.5, output to stdout)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include <wondergui.h>
+#include <wg_softsurfacefactory.h>
+#include <wg_softgfxdevice.h>
+#include <wg_streamgfxdevice.h>
+#include <wg_gfxstreamwriter.h>
+
+#ifdef WG_BENCH_EGL
+#	include <wg_glgfxdevice.h>
+#	include <wg_glsurface.h>
+#	include <wg_glsurfacefactory.h>
+#	include <EGL/egl.h>
+#	include <EGL/eglext.h>
+#endif
+
+#include "../gfxdevice_testapp/testunit.h"
+
+typedef std::chrono::high_resolution_clock	Clock;
+
+//____ Result __________________________________________________________________
+
+struct Result
+{
+	string		device;
+	string		unit;
+	Size		canvas;
+	bool		bSkipped = false;
+	int64_t		calls = 0;
+	double		seconds = 0.0;
+	int64_t		bytes = -1;					// Bytes streamed during the timed calls, -1 if not a stream device.
+	int			drawsPerCall = 0;			// Draw calls per TestUnit::run(), 0 if not a draw call unit.
+	int64_t		pixelsPerCall = 0;			// Pixels filled per TestUnit::run(), 0 if not known.
+};
+
+//____ DrawCallUnit ____________________________________________________________
+
+class DrawCallUnit : public TestUnit
+{
+public:
+	virtual int		drawsPerRun() const = 0;
+};
+
+//____ SmallFills ______________________________________________________________
+
+class SmallFills : public DrawCallUnit
+{
+public:
+	const string	name() const { return "SmallFills"; }
+	int				drawsPerRun() const { return 1024; }
+
+	bool init( GfxDevice * pDevice, const Rect& canvas )
+	{
+		return canvas.w >= 8 && canvas.h >= 8;				// Draws are not clipped, so they need to fit.
+	}
+
+	bool run( GfxDevice * pDevice, const Rect& canvas )
+	{
+		int spanX = std::max( canvas.w - 8, 1 );
+		int spanY = std::max( canvas.h - 8, 1 );
+
+		for( int i = 0 ; i < 1024 ; i++ )
+		{
+			Coord pos( (i*37) % spanX, (i*23) % spanY );
+			pDevice->fill( Rect( pos, 8, 8 ), Color( i & 0xFF, (i*3) & 0xFF, 128, 200 ) );
+		}
+		return true;
+	}
+};
+
+//____ SkinBlits _______________________________________________________________
+
+// Blits from a handful of small static surfaces, like skins of buttons and frames,
+// interleaved with fills.
+
+class SkinBlits : public DrawCallUnit
+{
+public:
+	const string	name() const { return "SkinBlits"; }
+	int				drawsPerRun() const { return 1024; }
+
+	bool init( GfxDevice * pDevice, const Rect& canvas )
+	{
+		if( canvas.w < 16 || canvas.h < 16 )
+			return false;									// Draws are not clipped, so they need to fit.
+
+		m_skins.clear();
+		for( int i = 0 ; i < 8 ; i++ )
+		{
+			Surface_p pSkin = pDevice->surfaceFactory()->createSurface( Size(16,16), PixelFormat::BGRA_8 );
+			if( !pSkin )
+				return false;
+
+			pSkin->fill( Color( 32*i, 255 - 32*i, 128, 255 ) );
+			m_skins.push_back( pSkin );
+		}
+		return true;
+	}
+
+	bool run( GfxDevice * pDevice, const Rect& canvas )
+	{
+		int spanX = std::max( canvas.w - 16, 1 );
+		int spanY = std::max( canvas.h - 16, 1 );
+
+		for( int i = 0 ; i < 1024 ; i += 4 )
+		{
+			Coord pos( (i*37) % spanX, (i*23) % spanY );
+
+			pDevice->blit( m_skins[(i/4) % 8], Rect(0,0,16,16), pos );
+			pDevice->blit( m_skins[(i/4+3) % 8], Rect(4,4,8,8), pos + Coord(4,4) );
+			pDevice->fill( Rect( pos.x + 2, pos.y + 2, 12, 2 ), Color::White );
+			pDevice->stretchBlit( m_skins[(i/4+5) % 8], RectF(0,0,16,16), Rect( pos, 8, 8 ) );
+		}
+		return true;
+	}
+
+private:
+	std::vector<Surface_p>	m_skins;
+};
+
+//____ Backend _________________________________________________________________
+
+class Backend
+{
+public:
+	virtual ~Backend() {}
+
+	virtual const char *	name() const = 0;
+	virtual GfxDevice *		device() = 0;
+	virtual void			finish() {}					// Waits for all queued rendering to complete.
+	virtual int64_t			bytes() const { return -1; }
+};
+
+//____ SoftBackend _____________________________________________________________
+
+class SoftBackend : public Backend
+{
+public:
+	SoftBackend( Size canvas )
+	{
+		m_pCanvas = SoftSurfaceFactory::create()->createSurface( canvas, PixelFormat::BGRA_8 );
+		m_pDevice = SoftGfxDevice::create( m_pCanvas );
+	}
+
+	const char *	name() const { return "SoftGfxDevice"; }
+	GfxDevice *		device() { return m_pDevice; }
+
+private:
+	Surface_p			m_pCanvas;
+	SoftGfxDevice_p		m_pDevice;
+};
+
+//____ StreamBackend ___________________________________________________________
+
+class StreamBackend : public Backend
+{
+public:
+	StreamBackend( Size canvas )
+	{
+		m_pWriter = GfxStreamWriter::create( [this](int nBytes, const void * pData) { m_bytes += nBytes; } );
+		m_pDevice = StreamGfxDevice::create( canvas, &m_pWriter->stream );
+
+		// TestUnits restore the canvas they found, which needs to be a StreamSurface.
+
+		m_pCanvas = m_pDevice->surfaceFactory()->createSurface( canvas, PixelFormat::BGRA_8 );
+		m_pDevice->setCanvas( m_pCanvas );
+	}
+
+	const char *	name() const { return "StreamGfxDevice"; }
+	GfxDevice *		device() { return m_pDevice; }
+	void			finish() { m_pWriter->stream.flush(); }
+	int64_t			bytes() const { return m_bytes; }
+
+private:
+	int64_t				m_bytes = 0;
+	GfxStreamWriter_p	m_pWriter;
+	StreamGfxDevice_p	m_pDevice;
+	Surface_p			m_pCanvas;
+};
+
+#ifdef WG_BENCH_EGL
+
+//____ GlBackend _______________________________________________________________
+
+class GlBackend : public Backend
+{
+public:
+	GlBackend( Size canvas )
+	{
+		auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC) eglGetProcAddress( "eglGetPlatformDisplayEXT" );
+		if( !getPlatformDisplay )
+			return;
+
+		m_display = getPlatformDisplay( EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL );
+		if( m_display == EGL_NO_DISPLAY || !eglInitialize( m_display, NULL, NULL ) )
+		{
+			m_display = EGL_NO_DISPLAY;
+			return;
+		}
+
+		// No config is needed when we never create an EGLSurface (EGL_KHR_no_config_context).
+
+		const EGLint contextAttribs[] = { EGL_CONTEXT_MAJOR_VERSION, 3, EGL_CONTEXT_MINOR_VERSION, 3,
+										  EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT, EGL_NONE };
+		if( !eglBindAPI( EGL_OPENGL_API ) )
+			return;
+
+		m_context = eglCreateContext( m_display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, contextAttribs );
+		if( m_context == EGL_NO_CONTEXT || !eglMakeCurrent( m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, m_context ) )
+			return;
+
+		// Surfaceless contexts have no default framebuffer, so we render into a texture.
+
+		m_pCanvas = GlSurface::create( canvas, PixelFormat::BGRA_8 );
+		m_pDevice = GlGfxDevice::create( m_pCanvas );
+	}
+
+	~GlBackend()
+	{
+		m_pDevice = nullptr;
+		m_pCanvas = nullptr;
+
+		if( m_display != EGL_NO_DISPLAY )
+		{
+			eglMakeCurrent( m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT );
+			if( m_context != EGL_NO_CONTEXT )
+				eglDestroyContext( m_display, m_context );
+			eglTerminate( m_display );
+		}
+	}
+
+	bool			isValid() const { return m_pDevice != nullptr; }
+	const char *	name() const { return "GlGfxDevice"; }
+	GfxDevice *		device() { return m_pDevice; }
+	void			finish() { glFinish(); }
+
+	const char *	renderer() const { return m_pDevice ? (const char*) glGetString( GL_RENDERER ) : nullptr; }
+
+private:
+	EGLDisplay			m_display = EGL_NO_DISPLAY;
+	EGLContext			m_context = EGL_NO_CONTEXT;
+	GlSurface_p			m_pCanvas;
+	GlGfxDevice_p		m_pDevice;
+};
+
+#endif
+
+//____ createUnits() ___________________________________________________________
+
+static std::vector<TestUnit*> createUnits()
+{
+	return { new test::StraightFill(), new test::BlendFill(), new test::OffscreenBGRACanvas(),
+			 new test::StretchBlitBlends(), new test::DrawToBGR_8(), new test::DrawToBGRA_8(),
+			 new test::DrawToBGRX_8(), new test::DrawToBGRA_4(), new test::DrawToBGR_565(),
+			 new SmallFills(), new SkinBlits() };
+}
+
+//____ pixelsPerRun() __________________________________________________________
+
+// Pixels a TestUnit fills per run(), for the units where that is known. The other
+// units draw a mix of primitives that only cover parts of the canvas.
+
+static int64_t pixelsPerRun( TestUnit * pUnit, Size canvas )
+{
+	if( dynamic_cast<test::StraightFill*>( pUnit ) || dynamic_cast<test::BlendFill*>( pUnit ) )
+		return int64_t(canvas.w) * canvas.h;
+
+	return 0;
+}
+
+//____ runUnit() _______________________________________________________________
+
+static Result runUnit( Backend * pBackend, TestUnit * pUnit, Size canvasSize, double minSeconds )
+{
+	Result	res;
+	res.device = pBackend->name();
+	res.unit = pUnit->name();
+	res.canvas = canvasSize;
+
+	GfxDevice * pDevice = pBackend->device();
+	Rect canvas( 0, 0, canvasSize );
+
+	if( !pUnit->init( pDevice, canvas ) )
+	{
+		res.bSkipped = true;
+		return res;
+	}
+
+	// Warm up caches and lazily created resources before timing.
+
+	pDevice->beginRender();
+	pUnit->run( pDevice, canvas );
+	pDevice->endRender();
+	pBackend->finish();
+
+	int64_t bytesBefore = pBackend->bytes();
+
+	int batch = 1;
+	while( res.seconds < minSeconds )
+	{
+		auto beg = Clock::now();
+
+		pDevice->beginRender();
+		for( int i = 0 ; i < batch ; i++ )
+			pUnit->run( pDevice, canvas );
+		pDevice->endRender();
+		pBackend->finish();
+
+		res.seconds += std::chrono::duration<double>( Clock::now() - beg ).count();
+		res.calls += batch;
+
+		if( batch < 1024 )
+			batch *= 2;
+	}
+
+	if( bytesBefore >= 0 )
+		res.bytes = pBackend->bytes() - bytesBefore;
+
+	auto pDrawCallUnit = dynamic_cast<DrawCallUnit*>( pUnit );
+	if( pDrawCallUnit )
+		res.drawsPerCall = pDrawCallUnit->drawsPerRun();
+
+	res.pixelsPerCall = pixelsPerRun( pUnit, canvasSize );
+	return res;
+}
+
+//____ runBackend() ____________________________________________________________
+
+static void runBackend( Backend * pBackend, Size canvas, double minSeconds, std::vector<Result>& results )
+{
+	auto units = createUnits();
+
+	for( auto pUnit : units )
+	{
+		Result res = runUnit( pBackend, pUnit, canvas, minSeconds );
+
+		if( res.bSkipped )
+			fprintf( stderr, "%-16s %-20s %4dx%-4d  skipped (init failed)\n", res.device.c_str(), res.unit.c_str(), canvas.w, canvas.h );
+		else if( res.drawsPerCall > 0 )
+			fprintf( stderr, "%-16s %-20s %4dx%-4d  %10.1f calls/s  %9.1f ns/draw\n", res.device.c_str(), res.unit.c_str(), canvas.w, canvas.h,
+					 res.calls / res.seconds, res.seconds * 1000000000.0 / (res.calls * res.drawsPerCall) );
+		else if( res.pixelsPerCall > 0 )
+			fprintf( stderr, "%-16s %-20s %4dx%-4d  %10.1f calls/s  %9.1f Mpix/s\n", res.device.c_str(), res.unit.c_str(), canvas.w, canvas.h,
+					 res.calls / res.seconds, res.calls * double(res.pixelsPerCall) / res.seconds / 1000000.0 );
+		else
+			fprintf( stderr, "%-16s %-20s %4dx%-4d  %10.1f calls/s\n", res.device.c_str(), res.unit.c_str(), canvas.w, canvas.h,
+					 res.calls / res.seconds );
+
+		results.push_back( res );
+		delete pUnit;
+	}
+}
+
+//____ parseSizes() ____________________________________________________________
+
+static bool parseSizes( const char * pArg, std::vector<Size>& sizes )
+{
+	sizes.clear();
+
+	while( *pArg )
+	{
+		int w, h, n;
+		if( sscanf( pArg, "%dx%d%n", &w, &h, &n ) != 2 || w <= 0 || h <= 0 )
+			return false;
+
+		sizes.push_back( Size(w,h) );
+		pArg += n;
+		if( *pArg == ',' )
+			pArg++;
+	}
+	return !sizes.empty();
+}
+
+//____ writeJSON() _____________________________________________________________
+
+static void writeJSON( FILE * fp, const std::vector<Result>& results )
+{
+	fprintf( fp, "[\n" );
+	for( size_t i = 0 ; i < results.size() ; i++ )
+	{
+		const Result& r = results[i];
+
+		fprintf( fp, "  { \"device\" : \"%s\", \"unit\" : \"%s\", \"canvas\" : [%d, %d]", r.device.c_str(), r.unit.c_str(), r.canvas.w, r.canvas.h );
+
+		if( r.bSkipped )
+			fprintf( fp, ", \"skipped\" : true" );
+		else
+		{
+			fprintf( fp, ", \"calls\" : %lld, \"seconds\" : %.6f, \"callsPerSec\" : %.2f",
+					 (long long) r.calls, r.seconds, r.calls / r.seconds );
+
+			if( r.pixelsPerCall > 0 )
+				fprintf( fp, ", \"mpixPerSec\" : %.3f", r.calls * double(r.pixelsPerCall) / r.seconds / 1000000.0 );
+
+			if( r.bytes >= 0 )
+				fprintf( fp, ", \"bytesPerCall\" : %.1f", r.bytes / double(r.calls) );
+
+			if( r.drawsPerCall > 0 )
+				fprintf( fp, ", \"nsPerDraw\" : %.1f", r.seconds * 1000000000.0 / (r.calls * r.drawsPerCall) );
+		}
+
+		fprintf( fp, " }%s\n", i+1 < results.size() ? "," : "" );
+	}
+	fprintf( fp, "]\n" );
+}
+
+//____ main() __________________________________________________________________
+
+int main( int argc, char * argv[] )
+{
+	std::vector<Size>	sizes = { Size(256,256), Size(1024,768) };
+	double				minSeconds = 0.5;
+	const char *		pOutput = nullptr;
+
+	for( int i = 1 ; i < argc ; i++ )
+	{
+		if( !strcmp( argv[i], "--sizes" ) && i+1 < argc && parseSizes( argv[i+1], sizes ) )
+			i++;
+		else if( !strcmp( argv[i], "--time" ) && i+1 < argc )
+			minSeconds = atof( argv[++i] );
+		else if( !strcmp( argv[i], "--output" ) && i+1 < argc )
+			pOutput = argv[++i];
+		else
+		{
+			fprintf( stderr, "Usage: %s [--sizes WxH,WxH,...] [--time seconds] [--output file.json]\n", argv[0] );
+			return 1;
+		}
+	}
+
+	Base::init();
+
+	std::vector<Result> results;
+
+	for( auto& size : sizes )
+	{
+		{
+			SoftBackend backend( size );
+			runBackend( &backend, size, minSeconds, results );
+		}
+
+		{
+			StreamBackend backend( size );
+			runBackend( &backend, size, minSeconds, results );
+		}
+
+#ifdef WG_BENCH_EGL
+		{
+			GlBackend backend( size );
+			if( backend.isValid() )
+			{
+				fprintf( stderr, "GlGfxDevice: %s\n", backend.renderer() );
+				runBackend( &backend, size, minSeconds, results );
+			}
+			else
+				fprintf( stderr, "GlGfxDevice: could not create surfaceless EGL context, skipped.\n" );
+		}
+#endif
+	}
+
+	FILE * fp = pOutput ? fopen( pOutput, "w" ) : stdout;
+	if( !fp )
+	{
+		fprintf( stderr, "Could not open '%s' for writing.\n", pOutput );
+		Base::exit();
+		return 1;
+	}
+
+	writeJSON( fp, results );
+
+	if( fp != stdout )
+		fclose( fp );
+
+	Base::exit();
+	return 0;
+}
@@ -0,0 +1,161 @@
+/*=========================================================================
+
+                         >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+// Measures layout cost of bulk changes to large widget trees: inserting many
+// widgets into a PackPanel and a PackList and changing the text of all of them,
+// each followed by a render.
+//
+// Every scenario is run twice. In deferred mode the LayoutQueue is left to be
+// flushed by RootPanel before rendering, as in a normal frame. In immediate
+// mode the queue is flushed after every single change, which reproduces the
+// cost of resize requests being propagated right away.
+//
+// Usage: layout_bench [number of widgets]   (default 10000)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <vector>
+
+#include <wondergui.h>
+#include <wg_softsurfacefactory.h>
+#include <wg_softgfxdevice.h>
+
+using namespace wg;
+
+typedef std::chrono::high_resolution_clock	Clock;
+
+//____ Helpers _________________________________________________________________
+
+static double millisSince( Clock::time_point start )
+{
+	return std::chrono::duration<double,std::milli>(Clock::now() - start).count();
+}
+
+static void afterChange( bool bImmediate )
+{
+	if( bImmediate )
+		Base::layoutQueue()->flush();
+}
+
+static void setLabel( TextDisplay * pLabel, int nb, int round )
+{
+	char	text[32];
+	sprintf( text, "Entry %d, round %d", nb, round );
+	pLabel->text.set( text );
+}
+
+//____ benchPackPanel() ________________________________________________________
+
+static void benchPackPanel( RootPanel * pRoot, int nbWidgets, bool bImmediate )
+{
+	PackPanel_p pPanel = PackPanel::create();
+	pPanel->setOrientation( Orientation::Vertical );
+	pRoot->child = pPanel;
+
+	std::vector<TextDisplay_p>	labels;
+	labels.reserve( nbWidgets );
+
+	auto start = Clock::now();
+	for( int i = 0 ; i < nbWidgets ; i++ )
+	{
+		TextDisplay_p pLabel = TextDisplay::create();
+		setLabel( pLabel, i, 0 );
+		pPanel->children.add( pLabel );
+		labels.push_back( pLabel );
+		afterChange( bImmediate );
+	}
+	pRoot->render();
+	printf( "%-48s %10.2f ms\n", bImmediate ? "PackPanel insert + render (immediate):" : "PackPanel insert + render (deferred):", millisSince(start) );
+
+	start = Clock::now();
+	for( int i = 0 ; i < nbWidgets ; i++ )
+	{
+		setLabel( labels[i], i, 1 );
+		afterChange( bImmediate );
+	}
+	pRoot->render();
+	printf( "%-48s %10.2f ms\n", bImmediate ? "PackPanel relabel + render (immediate):" : "PackPanel relabel + render (deferred):", millisSince(start) );
+
+	pRoot->child = nullptr;
+}
+
+//____ benchPackList() _________________________________________________________
+
+static void benchPackList( RootPanel * pRoot, int nbWidgets, bool bImmediate )
+{
+	PackList_p pList = PackList::create();
+	pRoot->child = pList;
+
+	std::vector<TextDisplay_p>	labels;
+	labels.reserve( nbWidgets );
+
+	auto start = Clock::now();
+	for( int i = 0 ; i < nbWidgets ; i++ )
+	{
+		TextDisplay_p pLabel = TextDisplay::create();
+		setLabel( pLabel, i, 0 );
+		pList->children.add( pLabel );
+		labels.push_back( pLabel );
+		afterChange( bImmediate );
+	}
+	pRoot->render();
+	printf( "%-48s %10.2f ms\n", bImmediate ? "PackList insert + render (immediate):" : "PackList insert + render (deferred):", millisSince(start) );
+
+	start = Clock::now();
+	for( int i = 0 ; i < nbWidgets ; i++ )
+	{
+		setLabel( labels[i], i, 1 );
+		afterChange( bImmediate );
+	}
+	pRoot->render();
+	printf( "%-48s %10.2f ms\n", bImmediate ? "PackList relabel + render (immediate):" : "PackList relabel + render (deferred):", millisSince(start) );
+
+	pRoot->child = nullptr;
+}
+
+//____ main() __________________________________________________________________
+
+int main( int argc, char * argv[] )
+{
+	int nbWidgets = argc > 1 ? atoi( argv[1] ) : 10000;
+
+	Base::init();
+
+	{
+		SoftSurfaceFactory_p pFactory = SoftSurfaceFactory::create();
+		Surface_p pCanvas = pFactory->createSurface( Size(512,512), PixelFormat::BGRA_8 );
+		RootPanel_p pRoot = RootPanel::create( SoftGfxDevice::create( pCanvas ) );
+
+		printf( "Layout benchmark with %d widgets\n\n", nbWidgets );
+
+		for( int i = 0 ; i < 2 ; i++ )
+		{
+			bool bImmediate = (i == 1);
+			benchPackPanel( pRoot, nbWidgets, bImmediate );
+			benchPackList( pRoot, nbWidgets, bImmediate );
+		}
+	}
+
+	Base::exit();
+	return 0;
+}
@@ -0,0 +1,107 @@
+/*=========================================================================
+
+                         >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+// Measures throughput of pixel format conversion in Surface::copyFrom() for
+// every pair of PixelFormats, including I8 to formats with CLUT expansion.
+//
+// Usage: pixelconvert_bench [width] [height]   (default 1024 x 1024)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+
+#include <wondergui.h>
+#include <wg_softsurfacefactory.h>
+
+using namespace wg;
+
+typedef std::chrono::high_resolution_clock	Clock;
+
+static const int	c_rounds = 20;
+
+static const PixelFormat	c_formats[] = { PixelFormat::BGR_8, PixelFormat::BGRX_8, PixelFormat::BGRA_8, PixelFormat::BGRA_4,
+											PixelFormat::BGR_565, PixelFormat::I8, PixelFormat::A8 };
+
+//____ createSurface() _________________________________________________________
+
+static Surface_p createSurface( SurfaceFactory * pFactory, Size size, PixelFormat format, const Color * pClut )
+{
+	if( format == PixelFormat::I8 )
+		return pFactory->createSurface( size, format, SurfaceHint::Static, pClut );
+	else
+		return pFactory->createSurface( size, format );
+}
+
+//____ main() __________________________________________________________________
+
+int main( int argc, char * argv[] )
+{
+	Size size( argc > 1 ? atoi( argv[1] ) : 1024, argc > 2 ? atoi( argv[2] ) : 1024 );
+
+	Base::init();
+
+	{
+		SoftSurfaceFactory_p pFactory = SoftSurfaceFactory::create();
+
+		Color	clut[256];
+		for( int i = 0 ; i < 256 ; i++ )
+			clut[i] = Color( i, 255 - i, i ^ 0x55, 255 );
+
+		printf( "Pixel conversion of %d x %d pixels, MPixels/s\n\n", size.w, size.h );
+		printf( "%-10s", "from\\to" );
+		for( PixelFormat dst : c_formats )
+			printf( "%10s", toString( dst ) );
+		printf( "\n" );
+
+		for( PixelFormat src : c_formats )
+		{
+			Surface_p pSrc = createSurface( pFactory, size, src, clut );
+
+			uint8_t * pPixels = pSrc->lock( AccessMode::WriteOnly );
+			for( int i = 0 ; i < pSrc->pitch() * size.h ; i++ )
+				pPixels[i] = (uint8_t) rand();
+			pSrc->unlock();
+
+			printf( "%-10s", toString( src ) );
+
+			for( PixelFormat dst : c_formats )
+			{
+				Surface_p pDst = createSurface( pFactory, size, dst, clut );
+
+				auto start = Clock::now();
+				bool bOk = true;
+				for( int i = 0 ; i < c_rounds ; i++ )
+					bOk &= pDst->copyFrom( pSrc, Coord() );
+				double seconds = std::chrono::duration<double>( Clock::now() - start ).count();
+
+				if( bOk )
+					printf( "%10.1f", double(size.w) * size.h * c_rounds / seconds / 1000000.0 );
+				else
+					printf( "%10s", "-" );
+			}
+			printf( "\n" );
+		}
+	}
+
+	Base::exit();
+	return 0;
+}
@@ -0,0 +1,193 @@
+/*=========================================================================
+
+                         >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+// Measures the single-threaded cost of reference counting in hot paths such as
+// passing and storing strong and weak pointers.
+//
+// Build and run once with the library compiled normally and once with
+// WG_ATOMIC_REFCOUNT defined (for both library and benchmark) to compare.
+// For reference, the benchmark also compares a plain and an atomic counter
+// directly, which is independent of how the library was built.
+
+#include <stdio.h>
+#include <chrono>
+#include <atomic>
+#include <vector>
+
+#include <wondergui.h>
+
+using namespace wg;
+
+#ifdef _MSC_VER
+#	define NOINLINE __declspec(noinline)
+#else
+#	define NOINLINE __attribute__((noinline))
+#endif
+
+static const int	c_rounds = 10000000;
+
+//____ Counters for reference __________________________________________________
+
+struct PlainCounted
+{
+	volatile int	refCount = 0;
+	inline void inc() { refCount++; }
+	inline bool dec() { return --refCount == 0; }
+};
+
+struct AtomicCounted
+{
+	std::atomic<int>	refCount{0};
+	inline void inc() { refCount++; }
+	inline bool dec() { return --refCount == 0; }
+};
+
+//____ BenchObject _____________________________________________________________
+
+class BenchObject : public Object
+{
+public:
+	static StrongPtr<BenchObject> create() { return StrongPtr<BenchObject>(new BenchObject()); }
+	int		value = 1;
+};
+
+typedef StrongPtr<BenchObject>	BenchObject_p;
+typedef WeakPtr<BenchObject>	BenchObject_wp;
+
+//____ Helpers _________________________________________________________________
+
+static double nanosPerRound( std::chrono::high_resolution_clock::time_point start, int rounds )
+{
+	auto end = std::chrono::high_resolution_clock::now();
+	return std::chrono::duration<double,std::nano>(end - start).count() / rounds;
+}
+
+static NOINLINE int passByValue( BenchObject_p p )
+{
+	return p->value;
+}
+
+template<class T> static double benchCounter()
+{
+	T * pCounted = new T();
+	int destroyed = 0;
+
+	auto start = std::chrono::high_resolution_clock::now();
+	for( int i = 0 ; i < c_rounds ; i++ )
+	{
+		pCounted->inc();
+		if( pCounted->dec() )
+			destroyed++;
+	}
+	double ns = nanosPerRound( start, c_rounds );
+	delete pCounted;
+
+	if( destroyed != c_rounds )
+		printf( "Unexpected result!\n" );
+	return ns;
+}
+
+//____ main() __________________________________________________________________
+
+int main( int argc, char * argv[] )
+{
+	Base::init();
+
+#ifdef WG_ATOMIC_REFCOUNT
+	printf( "Library built with WG_ATOMIC_REFCOUNT\n\n" );
+#else
+	printf( "Library built without WG_ATOMIC_REFCOUNT\n\n" );
+#endif
+
+	printf( "%-40s %8.2f ns\n", "Plain counter inc/dec:", benchCounter<PlainCounted>() );
+	printf( "%-40s %8.2f ns\n", "Atomic counter inc/dec:", benchCounter<AtomicCounted>() );
+
+	{
+		BenchObject_p pObj = BenchObject::create();
+		int sum = 0;
+
+		// Copy and release of strong pointer
+
+		auto start = std::chrono::high_resolution_clock::now();
+		for( int i = 0 ; i < c_rounds ; i++ )
+		{
+			BenchObject_p pCopy = pObj;
+			sum += pCopy->value;
+		}
+		printf( "%-40s %8.2f ns\n", "StrongPtr copy + release:", nanosPerRound( start, c_rounds ) );
+
+		// Passing strong pointer by value
+
+		start = std::chrono::high_resolution_clock::now();
+		for( int i = 0 ; i < c_rounds ; i++ )
+			sum += passByValue( pObj );
+		printf( "%-40s %8.2f ns\n", "StrongPtr pass by value:", nanosPerRound( start, c_rounds ) );
+
+		// Reassigning strong pointers in a vector, as containers do with their children
+
+		std::vector<BenchObject_p> vec( 64 );
+		start = std::chrono::high_resolution_clock::now();
+		for( int i = 0 ; i < c_rounds ; i++ )
+			vec[i & 63] = (i & 64) ? pObj : BenchObject_p();
+		printf( "%-40s %8.2f ns\n", "StrongPtr assignment:", nanosPerRound( start, c_rounds ) );
+		vec.clear();
+
+		// Weak pointer copy and release, hub already exists
+
+		BenchObject_wp pWeak = pObj.rawPtr();
+		start = std::chrono::high_resolution_clock::now();
+		for( int i = 0 ; i < c_rounds ; i++ )
+		{
+			BenchObject_wp pCopy = pWeak;
+			sum += pCopy ? 1 : 0;
+		}
+		printf( "%-40s %8.2f ns\n", "WeakPtr copy + release:", nanosPerRound( start, c_rounds ) );
+		pWeak = nullptr;
+
+		// Weak pointer creation and release, hub allocated and freed each round
+
+		start = std::chrono::high_resolution_clock::now();
+		for( int i = 0 ; i < c_rounds ; i++ )
+		{
+			BenchObject_wp pWeak2 = pObj.rawPtr();
+			sum += pWeak2 ? 1 : 0;
+		}
+		printf( "%-40s %8.2f ns\n", "WeakPtr create + release (hub alloc):", nanosPerRound( start, c_rounds ) );
+
+		// Object creation and destruction
+
+		int rounds = c_rounds / 10;
+		start = std::chrono::high_resolution_clock::now();
+		for( int i = 0 ; i < rounds ; i++ )
+		{
+			BenchObject_p p = BenchObject::create();
+			sum += p->value;
+		}
+		printf( "%-40s %8.2f ns\n", "Object create + destroy:", nanosPerRound( start, rounds ) );
+
+		if( sum == 0 )
+			printf( "Unexpected result!\n" );
+	}
+
+	Base::exit();
+	return 0;
+}
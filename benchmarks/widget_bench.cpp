@@ -0,0 +1,388 @@
+/*=========================================================================
+
+                         >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+// Measures the cost of the widget layer itself, such as patch collection, masking,
+// render recursion, layout and hit-testing, on synthetic scenes:
+//
+//		pack_nest		PackPanels nested 7 levels deep, 3 children each, with skinned Fillers as leaves.
+//		packlist_10k	PackList with 10000 TextDisplay rows.
+//		flex_5k			FlexPanel with 5000 overlapping, semi-transparent Fillers.
+//		text_heavy		PackPanel with 500 line-wrapped TextDisplays of a few hundred characters each.
+//
+// Each scene is run on NullGfxDevice, which isolates the widget layer, and on
+// SoftGfxDevice for comparison. The operations timed are:
+//
+//		full_render		Whole root marked dirty, then rendered.
+//		partial_render	Eight 32x32 dirty patches at pseudo-random positions, then rendered.
+//		resize			Root geometry toggled between two sizes, relayout and render.
+//		hit_test		findWidget() at a pseudo-random position (figures are per call).
+//
+// Each operation is repeated until at least the requested time has passed.
+// Results are written as JSON, one object per scene/device/operation.
+//
+// The TextDisplays use the 8x8 bitmap font from the resources directory as default
+// font, so that text layout and glyph rendering are part of the measurements.
+//
+// Usage: widget_bench [--time seconds] [--output file.json] [--resources dir]
+//		  (default --time 0.5, output to stdout, resources from ../resources)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+#include <wondergui.h>
+#include <wg_nullgfxdevice.h>
+#include <wg_softsurfacefactory.h>
+#include <wg_softgfxdevice.h>
+
+using namespace wg;
+
+typedef std::chrono::high_resolution_clock	Clock;
+
+const static Size	c_canvasSize( 1024, 768 );
+const static Size	c_resizedSize( 960, 720 );
+
+//____ Result __________________________________________________________________
+
+struct Result
+{
+	std::string		scene;
+	std::string		device;
+	std::string		operation;
+	int64_t			count;
+	double			seconds;
+};
+
+//____ nextRandom() ____________________________________________________________
+
+static uint32_t nextRandom( uint32_t& seed )
+{
+	seed = seed * 1103515245 + 12345;
+	return (seed >> 16) & 0x7FFF;
+}
+
+//____ loadDefaultFont() _______________________________________________________
+
+static bool loadDefaultFont( const std::string& resourceDir )
+{
+	// Glyph specification
+
+	std::string specPath = resourceDir + "/anuvverbubbla_8x8.fnt";
+
+	FILE * fp = fopen( specPath.c_str(), "rb" );
+	if( !fp )
+		return false;
+
+	std::vector<char> spec;
+	char	buffer[4096];
+	size_t	nRead;
+	while( (nRead = fread( buffer, 1, sizeof(buffer), fp )) > 0 )
+		spec.insert( spec.end(), buffer, buffer + nRead );
+	fclose( fp );
+	spec.push_back( 0 );
+
+	// Glyph bitmap. SDL_PIXELFORMAT_ARGB8888 has the memory layout of PixelFormat::BGRA_8 on little-endian machines.
+
+	SDL_Surface * pLoaded = IMG_Load( (resourceDir + "/anuvverbubbla_8x8.png").c_str() );
+	if( !pLoaded )
+		return false;
+
+	SDL_Surface * pConverted = SDL_ConvertSurfaceFormat( pLoaded, SDL_PIXELFORMAT_ARGB8888, 0 );
+	SDL_FreeSurface( pLoaded );
+	if( !pConverted )
+		return false;
+
+	Surface_p pGlyphs = SoftSurfaceFactory::create()->createSurface( Size( pConverted->w, pConverted->h ), PixelFormat::BGRA_8 );
+	if( !pGlyphs )
+	{
+		SDL_FreeSurface( pConverted );
+		return false;
+	}
+
+	uint8_t * pDest = pGlyphs->lock( AccessMode::WriteOnly );
+	SDL_LockSurface( pConverted );
+	for( int y = 0 ; y < pConverted->h ; y++ )
+		memcpy( pDest + y * pGlyphs->pitch(), ((uint8_t*) pConverted->pixels) + y * pConverted->pitch, pConverted->w * 4 );
+	SDL_UnlockSurface( pConverted );
+	pGlyphs->unlock();
+
+	SDL_FreeSurface( pConverted );
+
+	TextStyle_p pStyle = TextStyle::create();
+	pStyle->setFont( BitmapFont::create( pGlyphs, spec.data() ) );
+	pStyle->setSize( 8 );
+	Base::setDefaultStyle( pStyle );
+	return true;
+}
+
+//.____ Scenes _________________________________________________________________
+
+//____ createLeaf() ____________________________________________________________
+
+static Filler_p createLeaf( int nb )
+{
+	Filler_p pFiller = Filler::create();
+	if( nb % 2 )
+		pFiller->setSkin( ColorSkin::create( Color( nb*37, nb*11, 128, 255 ) ) );
+	else
+		pFiller->setSkin( BoxSkin::create( Color( 200, nb*13, nb*7, 160 ), Border(2), Color::Black ) );
+	pFiller->setPreferredSize( Size( 10, 10 ) );
+	return pFiller;
+}
+
+//____ createPackNest() ________________________________________________________
+
+static Widget_p createPackNest( int depth )
+{
+	PackPanel_p pPanel = PackPanel::create();
+	pPanel->setOrientation( depth % 2 ? Orientation::Horizontal : Orientation::Vertical );
+	pPanel->setSkin( BoxSkin::create( Color( 255, 255, 255, 32 ), Border(1), Color( 0, 0, 0, 255 ) ) );
+
+	for( int i = 0 ; i < 3 ; i++ )
+	{
+		if( depth > 1 )
+			pPanel->children.add( createPackNest( depth-1 ) );
+		else
+			pPanel->children.add( createLeaf( i ) );
+	}
+	return pPanel;
+}
+
+//____ createPackList() ________________________________________________________
+
+static Widget_p createPackList( int nbRows )
+{
+	PackList_p pList = PackList::create();
+
+	char	text[64];
+	for( int i = 0 ; i < nbRows ; i++ )
+	{
+		TextDisplay_p pLabel = TextDisplay::create();
+		sprintf( text, "Row %d of the list", i );
+		pLabel->text.set( text );
+		pList->children.add( pLabel );
+	}
+	return pList;
+}
+
+//____ createFlex() ____________________________________________________________
+
+static Widget_p createFlex( int nbChildren )
+{
+	FlexPanel_p pPanel = FlexPanel::create();
+	pPanel->setSkin( ColorSkin::create( Color( 240, 240, 230, 255 ) ) );
+
+	uint32_t seed = 1;
+	for( int i = 0 ; i < nbChildren ; i++ )
+	{
+		Rect geo( nextRandom(seed) % (c_canvasSize.w - 40), nextRandom(seed) % (c_canvasSize.h - 40), 8 + nextRandom(seed) % 32, 8 + nextRandom(seed) % 32 );
+		pPanel->children.addMovable( createLeaf( i ), geo );
+	}
+	return pPanel;
+}
+
+//____ createTextHeavy() _______________________________________________________
+
+static Widget_p createTextHeavy( int nbTexts )
+{
+	static const char s_lorem[] = "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labore et dolore "
+								  "magna aliqua. Ut enim ad minim veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea commodo "
+								  "consequat. Duis aute irure dolor in reprehenderit in voluptate velit esse cillum dolore eu fugiat nulla pariatur. ";
+
+	StdTextMapper_p pMapper = StdTextMapper::create();
+	pMapper->setLineWrap( true );
+
+	PackPanel_p pPanel = PackPanel::create();
+	pPanel->setOrientation( Orientation::Vertical );
+
+	for( int i = 0 ; i < nbTexts ; i++ )
+	{
+		TextDisplay_p pText = TextDisplay::create();
+		pText->text.setTextMapper( pMapper );
+		pText->text.set( s_lorem + (i % 64) );
+		pPanel->children.add( pText );
+	}
+	return pPanel;
+}
+
+//.____ Benchmarking ___________________________________________________________
+
+//____ timeOperation() _________________________________________________________
+
+template<typename Func>
+static Result timeOperation( const char * pOperation, double minSeconds, int callsPerRound, Func func )
+{
+	Result res;
+	res.operation = pOperation;
+	res.count = 0;
+	res.seconds = 0.0;
+
+	func();												// Warm up
+
+	while( res.seconds < minSeconds )
+	{
+		auto beg = Clock::now();
+		func();
+		res.seconds += std::chrono::duration<double>( Clock::now() - beg ).count();
+		res.count += callsPerRound;
+	}
+	return res;
+}
+
+//____ benchScene() ____________________________________________________________
+
+static void benchScene( const char * pScene, const char * pDevice, RootPanel * pRoot, Widget * pWidget, double minSeconds, std::vector<Result>& results )
+{
+	std::vector<Result>	sceneResults;
+
+	pRoot->setGeo( Rect( 0, 0, c_canvasSize ) );
+	pRoot->child = pWidget;
+
+	sceneResults.push_back( timeOperation( "full_render", minSeconds, 1, [pRoot]()
+	{
+		pRoot->addDirtyPatch( pRoot->geo() );
+		pRoot->render();
+	} ) );
+
+	uint32_t seed = 1;
+	sceneResults.push_back( timeOperation( "partial_render", minSeconds, 1, [pRoot,&seed]()
+	{
+		for( int i = 0 ; i < 8 ; i++ )
+			pRoot->addDirtyPatch( Rect( nextRandom(seed) % (c_canvasSize.w - 32), nextRandom(seed) % (c_canvasSize.h - 32), 32, 32 ) );
+		pRoot->render();
+	} ) );
+
+	bool bToggle = false;
+	sceneResults.push_back( timeOperation( "resize", minSeconds, 1, [pRoot,&bToggle]()
+	{
+		bToggle = !bToggle;
+		pRoot->setGeo( Rect( 0, 0, bToggle ? c_resizedSize : c_canvasSize ) );
+		pRoot->render();
+	} ) );
+	pRoot->setGeo( Rect( 0, 0, c_canvasSize ) );
+
+	const int c_hitsPerRound = 1000;
+	sceneResults.push_back( timeOperation( "hit_test", minSeconds, c_hitsPerRound, [pRoot,&seed]()
+	{
+		for( int i = 0 ; i < c_hitsPerRound ; i++ )
+			pRoot->findWidget( Coord( nextRandom(seed) % c_canvasSize.w, nextRandom(seed) % c_canvasSize.h ), SearchMode::ActionTarget );
+	} ) );
+
+	pRoot->child = nullptr;
+
+	for( auto& res : sceneResults )
+	{
+		res.scene = pScene;
+		res.device = pDevice;
+		fprintf( stderr, "%-14s %-14s %-16s %12.4f ms\n", pScene, pDevice, res.operation.c_str(), res.seconds * 1000.0 / res.count );
+		results.push_back( res );
+	}
+}
+
+//____ writeJSON() _____________________________________________________________
+
+static void writeJSON( FILE * fp, const std::vector<Result>& results )
+{
+	fprintf( fp, "[\n" );
+	for( size_t i = 0 ; i < results.size() ; i++ )
+	{
+		const Result& r = results[i];
+		fprintf( fp, "  { \"scene\" : \"%s\", \"device\" : \"%s\", \"operation\" : \"%s\", \"count\" : %lld, \"seconds\" : %.6f, \"msPerOp\" : %.6f }%s\n",
+				 r.scene.c_str(), r.device.c_str(), r.operation.c_str(), (long long) r.count, r.seconds, r.seconds * 1000.0 / r.count,
+				 i+1 < results.size() ? "," : "" );
+	}
+	fprintf( fp, "]\n" );
+}
+
+//____ main() __________________________________________________________________
+
+int main( int argc, char * argv[] )
+{
+	double			minSeconds = 0.5;
+	const char *	pOutput = nullptr;
+	std::string		resourceDir = "../resources";
+
+	for( int i = 1 ; i < argc ; i++ )
+	{
+		if( !strcmp( argv[i], "--time" ) && i+1 < argc )
+			minSeconds = atof( argv[++i] );
+		else if( !strcmp( argv[i], "--output" ) && i+1 < argc )
+			pOutput = argv[++i];
+		else if( !strcmp( argv[i], "--resources" ) && i+1 < argc )
+			resourceDir = argv[++i];
+		else
+		{
+			fprintf( stderr, "Usage: %s [--time seconds] [--output file.json] [--resources dir]\n", argv[0] );
+			return 1;
+		}
+	}
+
+	Base::init();
+
+	if( !loadDefaultFont( resourceDir ) )
+	{
+		fprintf( stderr, "Could not load the default font from '%s'.\n", resourceDir.c_str() );
+		Base::exit();
+		return 1;
+	}
+
+	std::vector<Result> results;
+
+	{
+		Surface_p pCanvas = SoftSurfaceFactory::create()->createSurface( c_canvasSize, PixelFormat::BGRA_8 );
+
+		GfxDevice_p		devices[2] = { NullGfxDevice::create( c_canvasSize ), SoftGfxDevice::create( pCanvas ) };
+		const char *	deviceNames[2] = { "NullGfxDevice", "SoftGfxDevice" };
+
+		for( int i = 0 ; i < 2 ; i++ )
+		{
+			RootPanel_p pRoot = RootPanel::create( devices[i] );
+
+			benchScene( "pack_nest", deviceNames[i], pRoot, createPackNest( 7 ), minSeconds, results );
+			benchScene( "packlist_10k", deviceNames[i], pRoot, createPackList( 10000 ), minSeconds, results );
+			benchScene( "flex_5k", deviceNames[i], pRoot, createFlex( 5000 ), minSeconds, results );
+			benchScene( "text_heavy", deviceNames[i], pRoot, createTextHeavy( 500 ), minSeconds, results );
+		}
+	}
+
+	FILE * fp = pOutput ? fopen( pOutput, "w" ) : stdout;
+	if( !fp )
+	{
+		fprintf( stderr, "Could not open '%s' for writing.\n", pOutput );
+		Base::exit();
+		return 1;
+	}
+
+	writeJSON( fp, results );
+
+	if( fp != stdout )
+		fclose( fp );
+
+	Base::exit();
+	return 0;
+}
@@ -0,0 +1,1021 @@
+/*=========================================================================
+
+                         >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+/*
+	gfxregress - Pixel-exact regression test of the GfxDevice backends.
+
+	Usage: gfxregress [--golden <dir>] [--failures <dir>] [--update] [case ...]
+
+	Renders a corpus of primitives and widget scenes through each backend and
+	compares the result against golden images, <golden dir>/<case>.png, within
+	the tolerance of each case:
+
+		SoftGfxDevice		Compared against the golden image.
+		GlGfxDevice			Compared against the golden image. Only when built with
+							WG_REGRESS_OSMESA, rendering offscreen in an OSMesa context.
+		StreamGfxDevice		Recorded, played back by GfxStreamPlayer onto a SoftGfxDevice
+							and compared against rendering directly to SoftGfxDevice.
+		GfxStreamRecorder	Same as StreamGfxDevice, but recorded to a seekable recording of
+							12 frames with a keyframe every third frame. Last frame is played
+							after seeking to it, which starts from the last keyframe.
+
+	--update writes the SoftGfxDevice result of each case as its new golden image
+	instead of comparing. Failing results are written to the failures directory
+	(default "failures") as <case>.<backend>.png. If any cases are named, only
+	those are run.
+
+	Returns 0 if all comparisons passed, 1 otherwise. Images are read and written
+	with SDL_image.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+#include <wondergui.h>
+#include <wg_pixelconverter.h>
+#include <wg_softsurfacefactory.h>
+#include <wg_softgfxdevice.h>
+#include <wg_streamgfxdevice.h>
+#include <wg_gfxstreamwriter.h>
+#include <wg_gfxstreamreader.h>
+#include <wg_gfxstreamplayer.h>
+#include <wg_gfxstreamrecorder.h>
+#include <wg_gfxstreamrecording.h>
+
+#ifdef WG_REGRESS_OSMESA
+#	include <wg_glgfxdevice.h>
+#	include <wg_glsurfacefactory.h>
+#	include <GL/osmesa.h>
+#endif
+
+using namespace wg;
+
+//____ Bitmap ___________________________________________________________________
+
+struct Bitmap
+{
+	Size					size;
+	std::vector<uint32_t>	pixels;			// BGRA_8, tightly packed.
+};
+
+//____ Tolerance _______________________________________________________________
+
+struct Tolerance
+{
+	int		maxChannelDiff;				// Largest difference in any channel for a pixel to count as equal.
+	int		maxBadPixels;				// Number of pixels allowed to exceed maxChannelDiff.
+};
+
+const static Tolerance	c_exact = { 0, 0 };
+const static Tolerance	c_rounding = { 1, 0 };
+const static Tolerance	c_antialiased = { 3, 16 };
+const static Tolerance	c_interpolated = { 4, 64 };
+
+//____ Case ____________________________________________________________________
+
+typedef void (*RenderFunc)( GfxDevice * pDevice, SurfaceFactory * pFactory, Size canvas );
+
+struct Case
+{
+	const char *	name;
+	RenderFunc		pRender;
+	Tolerance		tolerance;
+	PixelFormat		canvasFormat;
+	bool			bScene;				// Render function renders through a RootPanel, which does its own beginRender()/endRender().
+	bool			bStreamable;		// GfxStreamPlayer can play back everything the case renders.
+};
+
+const static Size	c_canvasSize( 128, 128 );
+const static Color	c_background( 0x40, 0x48, 0x50, 0xFF );
+
+//____ Helpers _________________________________________________________________
+
+static uint32_t nextRandom( uint32_t& seed )
+{
+	seed = seed * 1103515245 + 12345;
+	return (seed >> 16) & 0x7FFF;
+}
+
+//____ createSource() __________________________________________________________
+//
+// Creates a surface in the given factory with a gradient, checker and radial alpha
+// pattern that exercises all channels. Pixels are written through lock() since
+// StreamSurface does not implement copyFrom().
+
+static Surface_p createSource( SurfaceFactory * pFactory, Size size, PixelFormat format )
+{
+	std::vector<uint8_t> pattern( size.w * size.h * 4 );
+
+	uint8_t * p = pattern.data();
+	for( int y = 0 ; y < size.h ; y++ )
+	{
+		for( int x = 0 ; x < size.w ; x++ )
+		{
+			int dx = x*2 - size.w, dy = y*2 - size.h;
+			int dist = (dx*dx + dy*dy) * 255 / (size.w*size.w);
+
+			*p++ = (uint8_t) (x * 255 / (size.w-1));
+			*p++ = (uint8_t) (y * 255 / (size.h-1));
+			*p++ = ((x ^ y) & 8) ? 240 : 48;
+			*p++ = (uint8_t) (255 - min( dist, 255 ));
+		}
+	}
+
+	Surface_p pSurface = pFactory->createSurface( size, format );
+
+	uint8_t * pPixels = pSurface->lock( AccessMode::WriteOnly );
+	PixelConverter::convert( PixelFormat::BGRA_8, pattern.data(), size.w * 4, format, pPixels, pSurface->pitch(), size.w, size.h );
+	pSurface->unlock();
+
+	return pSurface;
+}
+
+//.____ Primitives _____________________________________________________________
+
+//____ fillReplace() ___________________________________________________________
+
+static void fillReplace( GfxDevice * pDevice, SurfaceFactory * pFactory, Size canvas )
+{
+	pDevice->setBlendMode( BlendMode::Replace );
+	for( int y = 0 ; y < 8 ; y++ )
+		for( int x = 0 ; x < 8 ; x++ )
+			pDevice->fill( Rect( x*16+1, y*16+1, 14, 14 ), Color( x*37, y*33, (x+y)*16, 55 + x*y*3 ) );
+	pDevice->setBlendMode( BlendMode::Blend );
+}
+
+//____ fillBlend() _____________________________________________________________
+
+static void fillBlend( GfxDevice * pDevice, SurfaceFactory * pFactory, Size canvas )
+{
+	pDevice->fill( Rect( 0, 0, 64, 128 ), Color::White );
+	for( int i = 0 ; i < 6 ; i++ )
+		pDevice->fill( Rect( 8 + i*16, 8 + i*12, 48, 48 ), Color( 255 - i*40, i*50, 128, 32 + i*40 ) );
+}
+
+//____ fillBlendModes() ________________________________________________________
+
+static void fillBlendModes( GfxDevice * pDevice, SurfaceFactory * pFactory, Size canvas )
+{
+	for( int x = 0 ; x < canvas.w ; x++ )
+		pDevice->fill( Rect( x, 0, 1, canvas.h ), Color( x*2, 255 - x*2, 128, 255 ) );
+
+	// BlendMode::Ignore is left out since only SoftGfxDevice accepts it.
+
+	const BlendMode modes[] = { BlendMode::Replace, BlendMode::Blend, BlendMode::Add, BlendMode::Subtract, BlendMode::Multiply, BlendMode::Invert };
+
+	int y = 4;
+	for( auto mode : modes )
+	{
+		pDevice->setBlendMode( mode );
+		pDevice->fill( Rect( 0, y, 64, 16 ), Color( 200, 100, 50, 255 ) );
+		pDevice->fill( Rect( 64, y, 64, 16 ), Color( 200, 100, 50, 128 ) );
+		y += 20;
+	}
+	pDevice->setBlendMode( BlendMode::Blend );
+}
+
+//____ fillTint() ______________________________________________________________
+
+static void fillTint( GfxDevice * pDevice, SurfaceFactory * pFactory, Size canvas )
+{
+	Surface_p pSource = createSource( pFactory, Size(48,48), PixelFormat::BGRA_8 );
+
+	pDevice->setTintColor( Color( 255, 128, 64, 192 ) );
+	pDevice->fill( Rect( 4, 4, 56, 56 ), Color( 100, 200, 255, 255 ) );
+	pDevice->fill( Rect( 32, 32, 56, 56 ), Color( 255, 255, 255, 128 ) );
+	pDevice->blit( pSource, Coord( 70, 10 ) );
+	pDevice->stretchBlit( pSource, Rect( 64, 64, 60, 60 ) );
+	pDevice->setTintColor( Color::White );
+}
+
+//____ fillSubPixel() __________________________________________________________
+
+static void fillSubPixel( GfxDevice * pDevice, SurfaceFactory * pFactory, Size canvas )
+{
+	for( int i = 0 ; i < 8 ; i++ )
+	{
+		float ofs = i * 0.125f;
+		pDevice->fillSubPixel( RectF( 2 + ofs, 2 + i*15 + ofs, 20.5f + ofs, 10.25f ), Color( 255, 255, 255, 255 ) );
+		pDevice->fillSubPixel( RectF( 30 + ofs*3, 2 + i*15, 0.6f + ofs, 12.f ), Color( 255, 200, 0, 255 ) );
+		pDevice->fillSubPixel( RectF( 40.3f, 2.7f + i*15, 80.f - ofs*10, 11.f + ofs ), Color( 0, 128, 255, 160 ) );
+	}
+}
+
+//____ plotPixels() ____________________________________________________________
+
+static void plotPixels( GfxDevice * pDevice, SurfaceFactory * pFactory, Size canvas )
+{
+	const int nPixels = 800;
+
+	Coord	coords[nPixels];
+	Color	colors[nPixels];
+
+	uint32_t seed = 1;
+	for( int i = 0 ; i < nPixels ; i++ )
+	{
+		coords[i] = Coord( nextRandom(seed) % canvas.w, nextRandom(seed) % canvas.h );
+		colors[i] = Color( nextRandom(seed) & 0xFF, nextRandom(seed) & 0xFF, nextRandom(seed) & 0xFF, (i & 1) ? 255 : 96 );
+	}
+
+	pDevice->plotPixels( nPixels/2, coords, colors );
+	pDevice->clipPlotPixels( Rect( 32, 32, 64, 64 ), nPixels/2, coords + nPixels/2, colors + nPixels/2 );
+}
+
+//____ drawLines() _____________________________________________________________
+
+static void drawLines( GfxDevice * pDevice, SurfaceFactory * pFactory, Size canvas )
+{
+	Coord center( canvas.w/2, canvas.h/2 );
+
+	for( int angle = 0 ; angle < 360 ; angle += 15 )
+	{
+		float rad = angle * 3.14159265f / 180.f;
+		Coord end( center.x + (int) (60 * cos(rad)), center.y + (int) (60 * sin(rad)) );
+		float thickness = 1.f + (angle % 60) / 20.f;
+
+		pDevice->drawLine( center, end, Color( 255, angle*255/360, 0, 200 ), thickness );
+	}
+}
+
+//____ clipDrawLines() _________________________________________________________
+
+static void clipDrawLines( GfxDevice * pDevice, SurfaceFactory * pFactory, Size canvas )
+{
+	Rect clip( 20, 30, 70, 60 );
+
+	pDevice->fill( clip, Color( 0, 0, 0, 255 ) );
+	for( int i = 0 ; i < 16 ; i++ )
+	{
+		pDevice->clipDrawLine( clip, Coord( 0, i*8 ), Coord( canvas.w-1, canvas.h-1 - i*8 ), Color( 255, 255, i*16, 255 ), 1.f + i*0.25f );
+		pDevice->clipDrawLine( clip, Coord( i*8, 0 ), Direction::Down, canvas.h, Color( 0, 255, 255, 128 ), 1.f + (i%4)*0.5f );
+	}
+}
+
+//____ drawStraightLines() _____________________________________________________
+
+static void drawStraightLines( GfxDevice * pDevice, SurfaceFactory * pFactory, Size canvas )
+{
+	for( int i = 0 ; i < 10 ; i++ )
+	{
+		float thickness = 0.5f + i * 0.75f;
+		pDevice->drawLine( Coord( 4, 6 + i*12 ), Direction::Right, 56, Color( 255, 255, 255, 255 ), thickness );
+		pDevice->drawLine( Coord( 70 + i*6, 4 ), Direction::Down, 120, Color( 255, 64, 64, 192 ), thickness );
+	}
+}
+
+//____ drawPolyline() __________________________________________________________
+
+static void drawPolyline( GfxDevice * pDevice, SurfaceFactory * pFactory, Size canvas )
+{
+	const int nPoints = 64;
+	CoordF	points[nPoints];
+
+	for( int line = 0 ; line < 3 ; line++ )
+	{
+		for( int i = 0 ; i < nPoints ; i++ )
+			points[i] = CoordF( i * 2.f, 24.f + line*40 + 16.f * sin( i * 0.3f + line ) );
+
+		pDevice->drawPolyline( nPoints, points, Color( 64 + line*90, 255, 128, 255 ), 1.f + line*1.5f );
+	}
+}
+
+//____ drawHorrWave() __________________________________________________________
+
+static void drawHorrWave( GfxDevice * pDevice, SurfaceFactory * pFactory, Size canvas )
+{
+	// Traces read past the end of the wave when smoothing the last points, so give them some slack.
+
+	int		top[160];
+	int		bottom[160];
+
+	for( int i = 0 ; i < 160 ; i++ )
+	{
+		top[i] = (int) ((40 + 20 * sin( i * 0.1f )) * 256);
+		bottom[i] = (int) ((90 + 15 * cos( i * 0.07f )) * 256);
+	}
+
+	WaveLine topLine = { 128, 2.5f, Color( 255, 255, 255, 255 ), top, top[127] };
+	WaveLine bottomLine = { 100, 1.f, Color( 255, 255, 0, 255 ), bottom, bottom[99] };
+
+	pDevice->drawHorrWave( Coord( 0, 0 ), canvas.w, &topLine, &bottomLine, Color( 0, 128, 255, 200 ), Color( 255, 0, 128, 128 ) );
+}
+
+//____ drawSegments() __________________________________________________________
+
+static void drawSegments( GfxDevice * pDevice, SurfaceFactory * pFactory, Size canvas )
+{
+	// Stacked area chart with three series, clipped to cut through the edges.
+
+	const int nEdges = 3;
+	const int width = 120;
+
+	int		edges[(width+1)*nEdges];
+	Color	colors[nEdges+1] = { Color( 0, 0, 0, 0 ), Color( 255, 64, 64, 255 ), Color( 64, 255, 64, 200 ), Color( 64, 64, 255, 128 ) };
+
+	for( int x = 0 ; x <= width ; x++ )
+	{
+		float pos = 0.f;
+		for( int i = 0 ; i < nEdges ; i++ )
+		{
+			pos += 25.f + 12.f * sin( x * 0.08f * (i+1) + i );
+			edges[x*nEdges+i] = (int) (pos * 256);
+		}
+	}
+
+	pDevice->drawSegments( Rect( 4, 4, width, 120 ), nEdges, edges, colors );
+	pDevice->clipDrawSegments( Rect( 30, 60, 60, 40 ), Rect( 8, 30, width, 100 ), nEdges, edges, colors );
+}
+
+//____ blitFormat() ____________________________________________________________
+
+static void blitFormat( GfxDevice * pDevice, SurfaceFactory * pFactory, PixelFormat format )
+{
+	Surface_p pSource = createSource( pFactory, Size(64,64), format );
+
+	pDevice->blit( pSource, Coord( 0, 0 ) );
+	pDevice->blit( pSource, Rect( 16, 16, 40, 40 ), Coord( 70, 4 ) );
+	pDevice->setBlendMode( BlendMode::Replace );
+	pDevice->blit( pSource, Coord( 4, 64 ) );
+	pDevice->setBlendMode( BlendMode::Add );
+	pDevice->blit( pSource, Coord( 64, 64 ) );
+	pDevice->setBlendMode( BlendMode::Blend );
+}
+
+static void blitBGRA_8( GfxDevice * pDevice, SurfaceFactory * pFactory, Size canvas ) { blitFormat( pDevice, pFactory, PixelFormat::BGRA_8 ); }
+static void blitBGR_8( GfxDevice * pDevice, SurfaceFactory * pFactory, Size canvas ) { blitFormat( pDevice, pFactory, PixelFormat::BGR_8 ); }
+static void blitBGRA_4( GfxDevice * pDevice, SurfaceFactory * pFactory, Size canvas ) { blitFormat( pDevice, pFactory, PixelFormat::BGRA_4 ); }
+static void blitBGR_565( GfxDevice * pDevice, SurfaceFactory * pFactory, Size canvas ) { blitFormat( pDevice, pFactory, PixelFormat::BGR_565 ); }
+
+//____ clipBlit() ______________________________________________________________
+
+static void clipBlit( GfxDevice * pDevice, SurfaceFactory * pFactory, Size canvas )
+{
+	Surface_p pSource = createSource( pFactory, Size(64,64), PixelFormat::BGRA_8 );
+
+	Rect clip( 10, 20, 90, 70 );
+	for( int i = 0 ; i < 4 ; i++ )
+		pDevice->clipBlit( clip, pSource, Coord( -20 + i*40, -10 + i*30 ) );
+}
+
+//____ stretchBlit() ___________________________________________________________
+
+static void stretchBlit( GfxDevice * pDevice, SurfaceFactory * pFactory, ScaleMode mode )
+{
+	Surface_p pSource = createSource( pFactory, Size(32,32), PixelFormat::BGRA_8 );
+	pSource->setScaleMode( mode );
+
+	pDevice->stretchBlit( pSource, Rect( 0, 0, 80, 80 ) );
+	pDevice->stretchBlit( pSource, RectF( 4.5f, 4.5f, 20.25f, 12.f ), Rect( 84, 0, 44, 100 ) );
+	pDevice->stretchBlit( pSource, Rect( 8, 88, 24, 24 ) );
+	pDevice->clipStretchBlit( Rect( 40, 84, 30, 30 ), pSource, Rect( 36, 84, 50, 40 ) );
+}
+
+static void stretchBlitNearest( GfxDevice * pDevice, SurfaceFactory * pFactory, Size canvas ) { stretchBlit( pDevice, pFactory, ScaleMode::Nearest ); }
+static void stretchBlitInterpolate( GfxDevice * pDevice, SurfaceFactory * pFactory, Size canvas ) { stretchBlit( pDevice, pFactory, ScaleMode::Interpolate ); }
+
+//____ tileBlit() ______________________________________________________________
+
+static void tileBlit( GfxDevice * pDevice, SurfaceFactory * pFactory, Size canvas )
+{
+	Surface_p pSource = createSource( pFactory, Size(32,32), PixelFormat::BGRA_8 );
+
+	pDevice->tileBlit( pSource, Rect( 3, 3, 70, 90 ) );
+	pDevice->tileBlit( pSource, Rect( 8, 8, 12, 10 ), Rect( 76, 5, 50, 118 ) );
+}
+
+//____ blitBars() ______________________________________________________________
+
+static void blitBars( GfxDevice * pDevice, SurfaceFactory * pFactory, Size canvas )
+{
+	Surface_p pSource = createSource( pFactory, Size(32,32), PixelFormat::BGRA_8 );
+
+	pDevice->blitHorrBar( pSource, Rect( 0, 0, 32, 12 ), Border( 0, 8, 0, 8 ), false, Coord( 2, 4 ), 120 );
+	pDevice->blitHorrBar( pSource, Rect( 0, 12, 32, 12 ), Border( 0, 6, 0, 6 ), true, Coord( 2, 20 ), 101 );
+	pDevice->blitVertBar( pSource, Rect( 0, 0, 12, 32 ), Border( 8, 0, 8, 0 ), false, Coord( 10, 40 ), 86 );
+	pDevice->blitVertBar( pSource, Rect( 16, 0, 12, 32 ), Border( 6, 0, 6, 0 ), true, Coord( 40, 40 ), 77 );
+}
+
+//____ blitPremultiplied() _____________________________________________________
+//
+// Fills a premultiplied surface through WriteOnly locks of one band at a time and
+// then locks it repeatedly in all modes. It should still look exactly like the
+// straight alpha surface it is drawn next to.
+
+static void blitPremultiplied( GfxDevice * pDevice, SurfaceFactory * pFactory, Size canvas )
+{
+	Surface_p pStraight = createSource( pFactory, Size(60,60), PixelFormat::BGRA_8 );
+	Surface_p pPremult = pFactory->createSurface( Size(60,60), PixelFormat::BGRA_8, SurfaceHint::Premultiplied );
+
+	uint8_t * pSrc = pStraight->lock( AccessMode::ReadWrite );
+	for( int y = 20 ; y < 30 ; y++ )
+		for( int x = 20 ; x < 30 ; x++ )
+			* (uint32_t*) (pSrc + y * pStraight->pitch() + x * 4) = 0x80C7C7C7;	// Half transparent gray.
+
+	for( int band = 0 ; band < 4 ; band++ )
+	{
+		uint8_t * pDst = pPremult->lockRegion( AccessMode::WriteOnly, Rect( 0, band*15, 60, 15 ) );
+		for( int y = 0 ; y < 15 ; y++ )
+			memcpy( pDst + y * pPremult->pitch(), pSrc + (band*15 + y) * pStraight->pitch(), 60 * 4 );
+		pPremult->unlock();
+	}
+	pStraight->unlock();
+
+	const AccessMode modes[] = { AccessMode::ReadOnly, AccessMode::ReadWrite, AccessMode::WriteOnly };
+	for( int i = 0 ; i < 9 ; i++ )
+	{
+		pPremult->lock( modes[i % 3] );
+		pPremult->unlock();
+	}
+
+	pDevice->blit( pStraight, Coord( 2, 2 ) );
+	pDevice->blit( pPremult, Coord( 66, 2 ) );
+	pDevice->stretchBlit( pStraight, Rect( 2, 66, 60, 30 ) );
+	pDevice->stretchBlit( pPremult, Rect( 66, 66, 60, 30 ) );
+}
+
+//____ mixedPrimitives() _______________________________________________________
+//
+// Used for the cases that render to canvases of other formats than BGRA_8.
+
+static void mixedPrimitives( GfxDevice * pDevice, SurfaceFactory * pFactory, Size canvas )
+{
+	Surface_p pSource = createSource( pFactory, Size(48,48), PixelFormat::BGRA_8 );
+
+	fillBlend( pDevice, pFactory, canvas );
+	pDevice->blit( pSource, Coord( 70, 10 ) );
+	pDevice->stretchBlit( pSource, Rect( 60, 60, 64, 64 ) );
+	pDevice->drawLine( Coord( 4, 120 ), Coord( 123, 40 ), Color::Yellow, 2.f );
+}
+
+//.____ Scenes _________________________________________________________________
+
+//____ createFiller() __________________________________________________________
+
+static Filler_p createFiller( Skin * pSkin, Size preferred )
+{
+	Filler_p pFiller = Filler::create();
+	pFiller->setSkin( pSkin );
+	pFiller->setPreferredSize( preferred );
+	return pFiller;
+}
+
+//____ scenePack() _____________________________________________________________
+
+static void scenePack( GfxDevice * pDevice, SurfaceFactory * pFactory, Size canvas )
+{
+	Surface_p pSource = createSource( pFactory, Size(32,32), PixelFormat::BGRA_8 );
+
+	RootPanel_p pRoot = RootPanel::create( pDevice );
+
+	PackPanel_p pPanel = PackPanel::create();
+	pPanel->setOrientation( Orientation::Vertical );
+	pPanel->setSkin( ColorSkin::create( Color( 20, 30, 40, 255 ) ) );
+
+	pPanel->children.add( createFiller( ColorSkin::create( Color( 200, 60, 60, 255 ) ), Size( 128, 20 ) ) );
+	pPanel->children.add( createFiller( BoxSkin::create( Color( 60, 200, 60, 128 ), Border(3), Color( 255, 255, 255, 255 ) ), Size( 128, 30 ) ) );
+	pPanel->children.add( createFiller( BlockSkin::createStaticFromSurface( pSource, Border(8) ), Size( 128, 40 ) ) );
+	pPanel->children.add( createFiller( BoxSkin::create( Color( 0, 0, 0, 0 ), Border(1,4,7,10), Color( 255, 128, 0, 160 ) ), Size( 128, 30 ) ) );
+
+	pRoot->child = pPanel;
+	pRoot->render();
+}
+
+//____ sceneFlex() _____________________________________________________________
+
+static void sceneFlex( GfxDevice * pDevice, SurfaceFactory * pFactory, Size canvas )
+{
+	Surface_p pSource = createSource( pFactory, Size(48,48), PixelFormat::BGRA_8 );
+
+	RootPanel_p pRoot = RootPanel::create( pDevice );
+
+	FlexPanel_p pPanel = FlexPanel::create();
+	pPanel->setSkin( ColorSkin::create( Color( 240, 240, 230, 255 ) ) );
+
+	for( int i = 0 ; i < 5 ; i++ )
+		pPanel->children.addMovable( createFiller( BoxSkin::create( Color( i*60, 100, 255 - i*60, 96 ), Border(2), Color( 0, 0, 0, 200 ) ), Size(40,40) ), Rect( 8 + i*14, 8 + i*10, 50, 44 ) );
+
+	Image_p pImage = Image::create();
+	pImage->setImage( pSource );
+	pPanel->children.addMovable( pImage, Rect( 60, 60, 64, 64 ) );
+
+	pRoot->child = pPanel;
+	pRoot->render();
+}
+
+//____ sceneNested() ___________________________________________________________
+
+static void sceneNested( GfxDevice * pDevice, SurfaceFactory * pFactory, Size canvas )
+{
+	Surface_p pSource = createSource( pFactory, Size(32,32), PixelFormat::BGRA_8 );
+
+	RootPanel_p pRoot = RootPanel::create( pDevice );
+
+	PackPanel_p pOuter = PackPanel::create();
+	pOuter->setOrientation( Orientation::Horizontal );
+	pOuter->setSkin( BoxSkin::create( Color( 30, 30, 60, 255 ), Border(4), Color( 200, 200, 220, 255 ) ) );
+
+	for( int i = 0 ; i < 3 ; i++ )
+	{
+		PackPanel_p pInner = PackPanel::create();
+		pInner->setOrientation( Orientation::Vertical );
+		pInner->setSkin( BoxSkin::create( Color( 255, 255, 255, 40 + i*40 ), Border(2), Color( 255, 200, 0, 255 ) ) );
+
+		for( int j = 0 ; j < 3 ; j++ )
+		{
+			if( (i + j) % 2 )
+			{
+				Image_p pImage = Image::create();
+				pImage->setImage( pSource, Rect( j*8, i*8, 16, 16 ) );
+				pInner->children.add( pImage );
+			}
+			else
+				pInner->children.add( createFiller( ColorSkin::create( Color( i*100, j*100, 128, 200 ) ), Size(20, 20 + j*6) ) );
+		}
+		pOuter->children.add( pInner );
+	}
+
+	pRoot->child = pOuter;
+	pRoot->render();
+}
+
+//____ c_cases _________________________________________________________________
+
+const static Case c_cases[] =
+{
+	{ "fill_replace",			fillReplace,			c_exact,		PixelFormat::BGRA_8,	false,	true },
+	{ "fill_blend",				fillBlend,				c_rounding,		PixelFormat::BGRA_8,	false,	true },
+	{ "fill_blendmodes",		fillBlendModes,			c_rounding,		PixelFormat::BGRA_8,	false,	true },
+	{ "fill_tint",				fillTint,				c_rounding,		PixelFormat::BGRA_8,	false,	true },
+	{ "fill_subpixel",			fillSubPixel,			c_antialiased,	PixelFormat::BGRA_8,	false,	true },
+	{ "plot_pixels",			plotPixels,				c_rounding,		PixelFormat::BGRA_8,	false,	false },	// StreamGfxDevice does not stream clipPlotPixels() yet.
+	{ "draw_lines",				drawLines,				c_antialiased,	PixelFormat::BGRA_8,	false,	true },
+	{ "clip_draw_lines",		clipDrawLines,			c_antialiased,	PixelFormat::BGRA_8,	false,	false },	// StreamGfxDevice does not stream straight lines yet.
+	{ "draw_straight_lines",	drawStraightLines,		c_antialiased,	PixelFormat::BGRA_8,	false,	false },
+	{ "draw_polyline",			drawPolyline,			c_antialiased,	PixelFormat::BGRA_8,	false,	true },
+	{ "draw_horr_wave",			drawHorrWave,			c_antialiased,	PixelFormat::BGRA_8,	false,	false },	// GfxStreamPlayer does not play ClipDrawHorrWave yet.
+	{ "draw_segments",			drawSegments,			c_antialiased,	PixelFormat::BGRA_8,	false,	true },
+	{ "blit_bgra8",				blitBGRA_8,				c_rounding,		PixelFormat::BGRA_8,	false,	true },
+	{ "blit_bgr8",				blitBGR_8,				c_rounding,		PixelFormat::BGRA_8,	false,	true },
+	{ "blit_bgra4",				blitBGRA_4,				c_rounding,		PixelFormat::BGRA_8,	false,	true },
+	{ "blit_bgr565",			blitBGR_565,			c_rounding,		PixelFormat::BGRA_8,	false,	true },
+	{ "clip_blit",				clipBlit,				c_rounding,		PixelFormat::BGRA_8,	false,	true },
+	{ "stretch_blit_nearest",	stretchBlitNearest,		c_interpolated,	PixelFormat::BGRA_8,	false,	true },
+	{ "stretch_blit_interpolate", stretchBlitInterpolate, c_interpolated, PixelFormat::BGRA_8,	false,	true },
+	{ "tile_blit",				tileBlit,				c_rounding,		PixelFormat::BGRA_8,	false,	true },
+	{ "blit_bars",				blitBars,				c_rounding,		PixelFormat::BGRA_8,	false,	true },
+	{ "blit_premultiplied",		blitPremultiplied,		c_rounding,		PixelFormat::BGRA_8,	false,	true },
+	{ "canvas_bgr8",			mixedPrimitives,		c_antialiased,	PixelFormat::BGR_8,		false,	true },
+	{ "canvas_bgra4",			mixedPrimitives,		c_antialiased,	PixelFormat::BGRA_4,	false,	true },
+	{ "canvas_bgr565",			mixedPrimitives,		c_antialiased,	PixelFormat::BGR_565,	false,	true },
+	{ "scene_pack",				scenePack,				c_rounding,		PixelFormat::BGRA_8,	true,	true },
+	{ "scene_flex",				sceneFlex,				c_rounding,		PixelFormat::BGRA_8,	true,	true },
+	{ "scene_nested",			sceneNested,			c_rounding,		PixelFormat::BGRA_8,	true,	true },
+};
+
+//.____ Rendering ______________________________________________________________
+
+//____ renderCase() ____________________________________________________________
+
+static void renderCase( const Case& c, GfxDevice * pDevice, SurfaceFactory * pFactory )
+{
+	pDevice->beginRender();
+	pDevice->setBlendMode( BlendMode::Replace );
+	pDevice->fill( Rect( 0, 0, c_canvasSize ), c_background );
+	pDevice->setBlendMode( BlendMode::Blend );
+
+	if( c.bScene )
+	{
+		pDevice->endRender();
+		c.pRender( pDevice, pFactory, c_canvasSize );
+	}
+	else
+	{
+		c.pRender( pDevice, pFactory, c_canvasSize );
+		pDevice->endRender();
+	}
+}
+
+//____ readCanvas() ____________________________________________________________
+
+static Bitmap readCanvas( Surface * pCanvas, bool bFlipY )
+{
+	Surface_p pCopy = SoftSurfaceFactory::create()->createSurface( pCanvas->size(), PixelFormat::BGRA_8 );
+	pCopy->copyFrom( pCanvas, Coord(0,0) );
+
+	Bitmap image;
+	image.size = pCopy->size();
+	image.pixels.resize( image.size.w * image.size.h );
+
+	const uint8_t * pPixels = pCopy->lock( AccessMode::ReadOnly );
+	for( int y = 0 ; y < image.size.h ; y++ )
+	{
+		int srcY = bFlipY ? image.size.h - 1 - y : y;
+		memcpy( &image.pixels[y*image.size.w], pPixels + srcY * pCopy->pitch(), image.size.w * 4 );
+	}
+	pCopy->unlock();
+
+	return image;
+}
+
+//____ renderSoft() ____________________________________________________________
+
+static Bitmap renderSoft( const Case& c )
+{
+	SoftSurfaceFactory_p pFactory = SoftSurfaceFactory::create();
+	Surface_p pCanvas = pFactory->createSurface( c_canvasSize, c.canvasFormat );
+	SoftGfxDevice_p pDevice = SoftGfxDevice::create( pCanvas );
+
+	renderCase( c, pDevice, pFactory );
+	return readCanvas( pCanvas, false );
+}
+
+//____ renderStreamRoundTrip() _________________________________________________
+
+static Bitmap renderStreamRoundTrip( const Case& c )
+{
+	std::vector<char>	recording;
+
+	{
+		GfxStreamWriter_p pWriter = GfxStreamWriter::create( [&recording](int nBytes, const void * pData)
+		{
+			recording.insert( recording.end(), (const char*) pData, ((const char*) pData) + nBytes );
+		} );
+
+		StreamGfxDevice_p pDevice = StreamGfxDevice::create( c_canvasSize, &pWriter->stream );
+		renderCase( c, pDevice, pDevice->surfaceFactory() );
+		pWriter->stream.flush();
+	}
+
+	SoftSurfaceFactory_p pFactory = SoftSurfaceFactory::create();
+	Surface_p pCanvas = pFactory->createSurface( c_canvasSize, c.canvasFormat );
+	SoftGfxDevice_p pDevice = SoftGfxDevice::create( pCanvas );
+
+	size_t readOfs = 0;
+	GfxStreamReader_p pReader = GfxStreamReader::create( [&recording,&readOfs](int nBytes, void * pDest)
+	{
+		int n = (int) min( (size_t) nBytes, recording.size() - readOfs );
+		memcpy( pDest, recording.data() + readOfs, n );
+		readOfs += n;
+		return n;
+	} );
+
+	GfxStreamPlayer_p pPlayer = GfxStreamPlayer::create( pReader->stream, pDevice, pFactory );
+	pPlayer->playAll();
+
+	return readCanvas( pCanvas, false );
+}
+
+//____ renderRecording() _______________________________________________________
+
+const static int	c_recordedFrames = 12;			// Multiple of c_keyframeInterval, so a keyframe is due after the last frame.
+const static int	c_keyframeInterval = 3;
+
+static bool renderRecording( const Case& c, Bitmap& image )
+{
+	std::vector<char>	file;
+	int					nFrames;
+
+	{
+		SoftSurfaceFactory_p pShadowFactory = SoftSurfaceFactory::create();
+		Surface_p pShadowCanvas = pShadowFactory->createSurface( c_canvasSize, c.canvasFormat );
+		SoftGfxDevice_p pShadowDevice = SoftGfxDevice::create( pShadowCanvas );
+
+		GfxStreamRecorder_p pRecorder = GfxStreamRecorder::create( [&file](int nBytes, const void * pData)
+		{
+			file.insert( file.end(), (const char*) pData, ((const char*) pData) + nBytes );
+		}, pShadowDevice, pShadowFactory, c_keyframeInterval );
+
+		StreamGfxDevice_p pDevice = StreamGfxDevice::create( c_canvasSize, &pRecorder->stream );
+		renderCase( c, pDevice, pDevice->surfaceFactory() );
+
+		// Scenes render in several frames, so we pad with empty frames up to a multiple of the interval.
+
+		while( pRecorder->frames() < c_recordedFrames || pRecorder->frames() % c_keyframeInterval != 0 )
+		{
+			pDevice->beginRender();
+			pDevice->endRender();
+		}
+
+		nFrames = pRecorder->frames();
+		pRecorder->stream.close();
+	}
+
+	Blob_p pBlob = Blob::create( (int) file.size() );
+	memcpy( pBlob->data(), file.data(), file.size() );
+
+	GfxStreamRecording_p pRecording = GfxStreamRecording::create( pBlob );
+	if( !pRecording->isValid() || !pRecording->hasIndex() || pRecording->frames() != nFrames )
+		return false;
+
+	SoftSurfaceFactory_p pFactory = SoftSurfaceFactory::create();
+	Surface_p pCanvas = pFactory->createSurface( c_canvasSize, c.canvasFormat );
+	SoftGfxDevice_p pDevice = SoftGfxDevice::create( pCanvas );
+
+	GfxStreamPlayer_p pPlayer = GfxStreamPlayer::create( pRecording->stream, pDevice, pFactory );
+	if( !pPlayer->seek( nFrames - 1 ) || !pPlayer->playFrame() )
+		return false;
+
+	image = readCanvas( pCanvas, false );
+	return true;
+}
+
+#ifdef WG_REGRESS_OSMESA
+
+//____ GlContext _______________________________________________________________
+
+class GlContext
+{
+public:
+	GlContext( Size size ) : m_buffer( size.w*size.h*4 )
+	{
+		const int attribs[] = { OSMESA_FORMAT, OSMESA_RGBA, OSMESA_DEPTH_BITS, 0,
+								OSMESA_PROFILE, OSMESA_CORE_PROFILE,
+								OSMESA_CONTEXT_MAJOR_VERSION, 3, OSMESA_CONTEXT_MINOR_VERSION, 3, 0 };
+
+		m_context = OSMesaCreateContextAttribs( attribs, NULL );
+		if( m_context && !OSMesaMakeCurrent( m_context, m_buffer.data(), GL_UNSIGNED_BYTE, size.w, size.h ) )
+		{
+			OSMesaDestroyContext( m_context );
+			m_context = nullptr;
+		}
+	}
+
+	~GlContext()
+	{
+		if( m_context )
+			OSMesaDestroyContext( m_context );
+	}
+
+	bool	isValid() const { return m_context != nullptr; }
+
+private:
+	OSMesaContext			m_context = nullptr;
+	std::vector<uint8_t>	m_buffer;
+};
+
+//____ renderGl() ______________________________________________________________
+
+static bool renderGl( const Case& c, Bitmap& image )
+{
+	if( c.canvasFormat != PixelFormat::BGRA_8 && c.canvasFormat != PixelFormat::BGR_8 )
+		return false;
+
+	GlSurfaceFactory_p pFactory = GlSurfaceFactory::create();
+	GlSurface_p pCanvas = GlSurface::cast( pFactory->createSurface( c_canvasSize, c.canvasFormat ).rawPtr() );
+	GlGfxDevice_p pDevice = GlGfxDevice::create( pCanvas );
+
+	renderCase( c, pDevice, pFactory );
+	glFinish();
+
+	image = readCanvas( pCanvas, true );			// GL canvases are stored bottom-up.
+	return true;
+}
+
+#endif
+
+//.____ Bitmap files and comparison _____________________________________________
+
+//____ loadPNG() _______________________________________________________________
+
+static bool loadPNG( const std::string& path, Bitmap& image )
+{
+	SDL_Surface * pLoaded = IMG_Load( path.c_str() );
+	if( !pLoaded )
+		return false;
+
+	// SDL_PIXELFORMAT_ARGB8888 has the memory layout of PixelFormat::BGRA_8 on little-endian machines.
+
+	SDL_Surface * pConverted = SDL_ConvertSurfaceFormat( pLoaded, SDL_PIXELFORMAT_ARGB8888, 0 );
+	SDL_FreeSurface( pLoaded );
+	if( !pConverted )
+		return false;
+
+	image.size = Size( pConverted->w, pConverted->h );
+	image.pixels.resize( image.size.w * image.size.h );
+
+	SDL_LockSurface( pConverted );
+	for( int y = 0 ; y < image.size.h ; y++ )
+		memcpy( &image.pixels[y*image.size.w], ((uint8_t*) pConverted->pixels) + y * pConverted->pitch, image.size.w * 4 );
+	SDL_UnlockSurface( pConverted );
+
+	SDL_FreeSurface( pConverted );
+	return true;
+}
+
+//____ savePNG() _______________________________________________________________
+
+static bool savePNG( const std::string& path, const Bitmap& image )
+{
+	SDL_Surface * pSurface = SDL_CreateRGBSurfaceWithFormatFrom( (void*) image.pixels.data(), image.size.w, image.size.h, 32,
+																 image.size.w * 4, SDL_PIXELFORMAT_ARGB8888 );
+	if( !pSurface )
+		return false;
+
+	bool bOk = IMG_SavePNG( pSurface, path.c_str() ) == 0;
+	SDL_FreeSurface( pSurface );
+	return bOk;
+}
+
+//____ compareImages() _________________________________________________________
+//
+// Returns true if images are equal within tolerance. Sets badPixels and maxDiff
+// to the number of pixels out of tolerance and the largest channel difference found.
+
+static bool compareImages( const Bitmap& a, const Bitmap& b, const Tolerance& tolerance, int& badPixels, int& maxDiff )
+{
+	badPixels = 0;
+	maxDiff = 0;
+
+	if( a.size != b.size )
+	{
+		badPixels = max( a.size.w*a.size.h, b.size.w*b.size.h );
+		maxDiff = 255;
+		return false;
+	}
+
+	for( size_t i = 0 ; i < a.pixels.size() ; i++ )
+	{
+		uint32_t pa = a.pixels[i], pb = b.pixels[i];
+		if( pa == pb )
+			continue;
+
+		int diff = 0;
+		for( int shift = 0 ; shift < 32 ; shift += 8 )
+			diff = max( diff, abs( (int) ((pa >> shift) & 0xFF) - (int) ((pb >> shift) & 0xFF) ) );
+
+		maxDiff = max( maxDiff, diff );
+		if( diff > tolerance.maxChannelDiff )
+			badPixels++;
+	}
+
+	return badPixels <= tolerance.maxBadPixels;
+}
+
+//.____ Main ___________________________________________________________________
+
+//____ Options _________________________________________________________________
+
+struct Options
+{
+	std::string					goldenDir = "golden";
+	std::string					failuresDir = "failures";
+	bool						bUpdate = false;
+	std::vector<std::string>	cases;
+};
+
+static int	s_nbFailed = 0;
+static int	s_nbPassed = 0;
+static bool	s_bGlAvailable = false;
+
+//____ check() _________________________________________________________________
+
+static void check( const Options& options, const Case& c, const char * pBackend, const Bitmap& actual, const Bitmap& expected )
+{
+	int badPixels, maxDiff;
+	if( compareImages( actual, expected, c.tolerance, badPixels, maxDiff ) )
+	{
+		printf( "PASS  %-8s %s\n", pBackend, c.name );
+		s_nbPassed++;
+		return;
+	}
+
+	printf( "FAIL  %-8s %s  (%d pixels differ by more than %d, max difference %d)\n", pBackend, c.name, badPixels, c.tolerance.maxChannelDiff, maxDiff );
+	s_nbFailed++;
+
+	savePNG( options.failuresDir + "/" + c.name + "." + pBackend + ".png", actual );
+}
+
+//____ runCase() _______________________________________________________________
+
+static void runCase( const Options& options, const Case& c )
+{
+	std::string goldenPath = options.goldenDir + "/" + c.name + ".png";
+
+	Bitmap soft = renderSoft( c );
+
+	if( options.bUpdate )
+	{
+		if( savePNG( goldenPath, soft ) )
+			printf( "WROTE %s\n", goldenPath.c_str() );
+		else
+		{
+			printf( "ERROR could not write %s\n", goldenPath.c_str() );
+			s_nbFailed++;
+		}
+		return;
+	}
+
+	Bitmap golden;
+	bool bHasGolden = loadPNG( goldenPath, golden );
+
+	if( bHasGolden )
+		check( options, c, "soft", soft, golden );
+	else
+	{
+		printf( "FAIL  %-8s %s  (missing golden image %s)\n", "soft", c.name, goldenPath.c_str() );
+		s_nbFailed++;
+	}
+
+	if( c.bStreamable )
+	{
+		check( options, c, "stream", renderStreamRoundTrip( c ), soft );
+
+		Bitmap recorded;
+		if( renderRecording( c, recorded ) )
+			check( options, c, "record", recorded, soft );
+		else
+		{
+			printf( "FAIL  %-8s %s  (recording lost its index or could not be seeked)\n", "record", c.name );
+			s_nbFailed++;
+		}
+	}
+	else
+	{
+		printf( "SKIP  %-8s %s\n", "stream", c.name );
+		printf( "SKIP  %-8s %s\n", "record", c.name );
+	}
+
+#ifdef WG_REGRESS_OSMESA
+	Bitmap gl;
+	if( s_bGlAvailable && bHasGolden && renderGl( c, gl ) )
+		check( options, c, "gl", gl, golden );
+	else
+		printf( "SKIP  %-8s %s\n", "gl", c.name );
+#endif
+}
+
+//____ main() __________________________________________________________________
+
+int main( int argc, char * argv[] )
+{
+	Options options;
+
+	for( int i = 1 ; i < argc ; i++ )
+	{
+		if( !strcmp( argv[i], "--golden" ) && i+1 < argc )
+			options.goldenDir = argv[++i];
+		else if( !strcmp( argv[i], "--failures" ) && i+1 < argc )
+			options.failuresDir = argv[++i];
+		else if( !strcmp( argv[i], "--update" ) )
+			options.bUpdate = true;
+		else if( argv[i][0] == '-' )
+		{
+			printf( "Usage: gfxregress [--golden <dir>] [--failures <dir>] [--update] [case ...]\n" );
+			return 1;
+		}
+		else
+			options.cases.push_back( argv[i] );
+	}
+
+	IMG_Init( IMG_INIT_PNG );
+	Base::init();
+
+#ifdef WG_REGRESS_OSMESA
+	GlContext glContext( c_canvasSize );
+	s_bGlAvailable = glContext.isValid();
+	if( !s_bGlAvailable )
+		printf( "Could not create OSMesa context, GlGfxDevice will be skipped.\n" );
+#endif
+
+	for( auto& c : c_cases )
+	{
+		if( !options.cases.empty() && std::find( options.cases.begin(), options.cases.end(), c.name ) == options.cases.end() )
+			continue;
+
+		runCase( options, c );
+	}
+
+	printf( "\n%d passed, %d failed.\n", s_nbPassed, s_nbFailed );
+
+	Base::exit();
+	IMG_Quit();
+
+	return s_nbFailed == 0 ? 0 : 1;
+}
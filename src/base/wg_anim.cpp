@@ -20,6 +20,9 @@
 
 =========================================================================*/
 
+#include <cmath>
+#include <algorithm>
+
 #include <wg_anim.h>
 
 namespace wg 
@@ -392,6 +395,68 @@ namespace wg
 				return 0;
 		}
 	}
+
+	//____ timeToNextKeyFrame() ____________________________________________________
+	/**
+	 * @brief Get play-time left until another keyframe is reached.
+	 *
+	 * @param ticks		Current play-time, same as passed to timeToOfs().
+	 *
+	 * Takes play mode and time scaler into account. Useful for scheduling the next
+	 * update of an animation instead of updating it continuously.
+	 *
+	 * @return Unscaled play-time until the keyframe changes or -1 if the animation
+	 *			has ended and will not change anymore.
+	 */
+
+	int Anim::timeToNextKeyFrame( int64_t ticks )
+	{
+		if( m_duration == 0 || m_keyframes.isEmpty() )
+			return -1;
+
+		int64_t scaled = (int64_t)(ticks * ((double)m_scale));
+		bool	bForward;
+
+		switch( m_playMode )
+		{
+			case AnimMode::Forward:
+			case AnimMode::Backward:
+				if( scaled >= m_duration )
+					return -1;
+				bForward = (m_playMode == AnimMode::Forward);
+				break;
+
+			case AnimMode::Looping:
+				bForward = true;
+				break;
+
+			case AnimMode::BackwardLooping:
+				bForward = false;
+				break;
+
+			case AnimMode::PingPong:
+				bForward = ((scaled/m_duration) % 2) == 0;
+				break;
+
+			case AnimMode::BackwardPingPong:
+				bForward = ((scaled/m_duration) % 2) == 1;
+				break;
+
+			default:
+				return -1;
+		}
+
+		int ofs = timeToOfs( ticks );
+		KeyFrame * pFrame = _keyFrame( ofs );
+
+		int left;
+		if( bForward )
+			left = pFrame->m_timestamp + pFrame->m_duration - ofs;
+		else
+			left = ofs - pFrame->m_timestamp + 1;
+
+		return std::max( 1, (int) std::ceil( left / m_scale ) );
+	}
 	
 	
 	
@@ -87,6 +87,7 @@ namespace wg
 		float				timeScaler( void ) { return m_scale; };
 		int					durationScaled( void ) { return (int) (m_duration * m_scale); };
 		int					timeToOfs( int64_t ticks );			/// Convert play-time to offset in animation by scaling with timeScaler and unwinding loops.
+		int					timeToNextKeyFrame( int64_t ticks );	/// Play-time left until another keyframe is reached, -1 if animation has ended.
 	
 	protected:
 		Anim();
@@ -0,0 +1,410 @@
+/*=========================================================================
+
+                         >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+#include <wg_asyncloader.h>
+#include <wg_rootpanel.h>
+
+#include <stdio.h>
+#include <limits.h>
+
+namespace wg 
+{
+	const char AsyncResource::CLASSNAME[] = {"AsyncResource"};
+	const char AsyncLoader::CLASSNAME[] = {"AsyncLoader"};
+
+
+	//____ AsyncResource::Constructor _________________________________________
+
+	AsyncResource::AsyncResource( const std::string& path, bool bSurface, int hint ) : m_path(path), m_bSurface(bSurface), m_hint(hint),
+		m_status(Status::Pending), m_bLoaded(false), m_decodedFormat(PixelFormat::Unknown), m_decodedPitch(0)
+	{
+	}
+
+	//____ AsyncResource::isInstanceOf() ______________________________________
+
+	bool AsyncResource::isInstanceOf( const char * pClassName ) const
+	{ 
+		if( pClassName==CLASSNAME )
+			return true;
+
+		return Object::isInstanceOf(pClassName);
+	}
+
+	//____ AsyncResource::className() _________________________________________
+
+	const char * AsyncResource::className( void ) const
+	{ 
+		return CLASSNAME; 
+	}
+
+	//____ AsyncResource::cast() ______________________________________________
+
+	AsyncResource_p AsyncResource::cast( Object * pObject )
+	{
+		if( pObject && pObject->isInstanceOf(CLASSNAME) )
+			return AsyncResource_p( static_cast<AsyncResource*>(pObject) );
+
+		return 0;
+	}
+
+	//____ AsyncResource::setCallback() _______________________________________
+	/**
+	 * @brief Set function to call when resource has been loaded.
+	 *
+	 * The callback is called from AsyncLoader::update() on the render thread once the resource
+	 * is ready or has failed to load. If the resource already is ready or failed, the callback
+	 * is called immediately.
+	 */
+
+	void AsyncResource::setCallback( const std::function<void(AsyncResource*)>& callback )
+	{
+		m_callback = callback;
+		if( m_status != Status::Pending && m_callback )
+			m_callback(this);
+	}
+
+
+	//____ AsyncLoader::Constructor ___________________________________________
+
+	AsyncLoader::AsyncLoader( SurfaceFactory * pFactory, int nbThreads ) : m_pFactory(pFactory), m_blobLoader(loadFile), m_bExit(false)
+	{
+		if( nbThreads < 1 )
+			nbThreads = 1;
+
+		for( int i = 0 ; i < nbThreads ; i++ )
+			m_threads.push_back( std::thread( &AsyncLoader::_workerLoop, this ) );
+	}
+
+	//____ AsyncLoader::Destructor ____________________________________________
+
+	AsyncLoader::~AsyncLoader()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_bExit = true;
+			m_jobs.clear();
+		}
+		m_jobAdded.notify_all();
+
+		for( auto& thread : m_threads )
+			thread.join();
+
+		// Release what workers loaded but never got delivered.
+
+		for( auto pRes : m_done )
+			std::vector<uint8_t>().swap( pRes->m_loaded );
+	}
+
+	//____ AsyncLoader::isInstanceOf() ________________________________________
+
+	bool AsyncLoader::isInstanceOf( const char * pClassName ) const
+	{ 
+		if( pClassName==CLASSNAME )
+			return true;
+
+		return Object::isInstanceOf(pClassName);
+	}
+
+	//____ AsyncLoader::className() ___________________________________________
+
+	const char * AsyncLoader::className( void ) const
+	{ 
+		return CLASSNAME; 
+	}
+
+	//____ AsyncLoader::cast() ________________________________________________
+
+	AsyncLoader_p AsyncLoader::cast( Object * pObject )
+	{
+		if( pObject && pObject->isInstanceOf(CLASSNAME) )
+			return AsyncLoader_p( static_cast<AsyncLoader*>(pObject) );
+
+		return 0;
+	}
+
+	//____ setSurfaceDecoder() ________________________________________________
+	/**
+	 * @brief Set function used to load and decode images.
+	 *
+	 * The decoder is called on a worker thread with the path of the image and should fill
+	 * in pixels, setting size, format and pitch accordingly. It should return false if the
+	 * image could not be loaded.
+	 *
+	 * The decoder must be thread safe and may not create or touch any WonderGUI objects,
+	 * since reference counting is not thread safe.
+	 */
+
+	void AsyncLoader::setSurfaceDecoder( const SurfaceDecoder& decoder )
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_surfaceDecoder = decoder;
+	}
+
+	//____ setBlobLoader() ____________________________________________________
+	/**
+	 * @brief Set function used to load content for loadBlob().
+	 *
+	 * Replaces the default loader, which reads the file from disk using loadFile().
+	 * Same thread safety rules as for the surface decoder applies.
+	 */
+
+	void AsyncLoader::setBlobLoader( const BlobLoader& loader )
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_blobLoader = loader ? loader : BlobLoader(loadFile);
+	}
+
+	//____ setRootPanel() _____________________________________________________
+	/**
+	 * @brief Set RootPanel to request a full rerender of when resources arrive.
+	 *
+	 * Widgets that are given their resources from the callbacks request their
+	 * own rerender, which is preferable. Setting a RootPanel is a convenient
+	 * fallback for placeholders that are updated in place.
+	 */
+
+	void AsyncLoader::setRootPanel( RootPanel * pRoot )
+	{
+		m_pRootPanel = pRoot;
+	}
+
+	//____ loadSurface() ______________________________________________________
+	/**
+	 * @brief Request a surface to be loaded in the background.
+	 *
+	 * @param path		Path of image to load, passed on to the surface decoder.
+	 * @param hint		Surface hint used when the surface is created.
+	 * @param callback	Optional function called from update() when surface is ready or has failed.
+	 *
+	 * @return Handle to the surface, which remains pending until the surface has been created by update().
+	 *
+	 * Skins that should use the surface need to be created once it is ready, typically from
+	 * the callback. Nothing created before that is updated by the loader.
+	 */
+
+	AsyncResource_p AsyncLoader::loadSurface( const std::string& path, int hint, const std::function<void(AsyncResource*)>& callback )
+	{
+		AsyncResource_p p = new AsyncResource(path, true, hint);
+		p->m_callback = callback;
+		m_inFlight.push_back(p);
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_jobs.push_back(p.rawPtr());
+		}
+		m_jobAdded.notify_one();
+		return p;
+	}
+
+	//____ loadBlob() _________________________________________________________
+	/**
+	 * @brief Request content of a file to be loaded in the background.
+	 *
+	 * Typically used for fonts, which should be created from the callback on the render thread.
+	 *
+	 * @param path		Path of file to load, passed on to the blob loader.
+	 * @param callback	Optional function called from update() when content is ready or has failed.
+	 *
+	 * @return Handle to the content, which remains pending until delivered by update().
+	 */
+
+	AsyncResource_p AsyncLoader::loadBlob( const std::string& path, const std::function<void(AsyncResource*)>& callback )
+	{
+		AsyncResource_p p = new AsyncResource(path, false, 0);
+		p->m_callback = callback;
+		m_inFlight.push_back(p);
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_jobs.push_back(p.rawPtr());
+		}
+		m_jobAdded.notify_one();
+		return p;
+	}
+
+	//____ update() ___________________________________________________________
+	/**
+	 * @brief Deliver resources that have been loaded.
+	 *
+	 * Must be called regularly from the render thread, typically once per frame before rendering.
+	 * Creates surfaces for decoded images, marks the resources as ready or failed and calls
+	 * their callbacks.
+	 *
+	 * @return Number of resources delivered.
+	 */
+
+	int AsyncLoader::update()
+	{
+		std::deque<AsyncResource*>	done;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			done.swap(m_done);
+		}
+
+		if( done.empty() )
+			return 0;
+
+		for( auto pRes : done )
+		{
+			AsyncResource_p pKeep = pRes;				// Keep alive during callback.
+
+			for( auto it = m_inFlight.begin() ; it != m_inFlight.end() ; it++ )
+			{
+				if( it->rawPtr() == pRes )
+				{
+					m_inFlight.erase(it);
+					break;
+				}
+			}
+			_deliver(pRes);
+		}
+
+		RootPanel_p pRoot = m_pRootPanel.rawPtr();
+		if( pRoot )
+			pRoot->addDirtyPatch( pRoot->geo() );
+
+		return (int) done.size();
+	}
+
+	//____ waitUntilDone() ____________________________________________________
+	/**
+	 * @brief Block until all requests have been delivered.
+	 *
+	 * Calls update() until nothing is left in flight. Meant for loading screens
+	 * and shutdown, not for use while rendering.
+	 */
+
+	void AsyncLoader::waitUntilDone()
+	{
+		while( !m_inFlight.empty() )
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_jobDone.wait( lock, [this]{ return !m_done.empty(); } );
+			}
+			update();
+		}
+	}
+
+	//____ loadFile() _________________________________________________________
+	/**
+	 * @brief Read the complete content of a file into a Blob.
+	 *
+	 * Default blob loader. Safe to call from any thread.
+	 *
+	 * @return True if the file was read into content.
+	 */
+
+	bool AsyncLoader::loadFile( const std::string& path, std::vector<uint8_t>& content )
+	{
+		FILE * fp = fopen( path.c_str(), "rb" );
+		if( !fp )
+			return false;
+
+		fseek( fp, 0, SEEK_END );
+		long size = ftell(fp);
+		fseek( fp, 0, SEEK_SET );
+
+		bool bOk = false;
+		if( size >= 0 && size <= INT_MAX )
+		{
+			content.resize( size );
+			bOk = fread( content.data(), 1, size, fp ) == (size_t) size;
+		}
+
+		fclose(fp);
+		return bOk;
+	}
+
+	//____ _workerLoop() ______________________________________________________
+
+	void AsyncLoader::_workerLoop()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		while( true )
+		{
+			m_jobAdded.wait( lock, [this]{ return m_bExit || !m_jobs.empty(); } );
+			if( m_bExit )
+				return;
+
+			AsyncResource * pRes = m_jobs.front();
+			m_jobs.pop_front();
+
+			SurfaceDecoder	decoder = m_surfaceDecoder;
+			BlobLoader		loader = m_blobLoader;
+
+			lock.unlock();
+
+			// pRes is kept alive by m_inFlight and only fields reserved for workers are touched.
+
+			if( pRes->m_bSurface )
+			{
+				if( decoder )
+					pRes->m_bLoaded = decoder( pRes->m_path, pRes->m_loaded, pRes->m_decodedSize, pRes->m_decodedFormat, pRes->m_decodedPitch );
+			}
+			else
+				pRes->m_bLoaded = loader( pRes->m_path, pRes->m_loaded );
+
+			lock.lock();
+			m_done.push_back(pRes);
+			m_jobDone.notify_all();
+		}
+	}
+
+	//____ _deliver() _________________________________________________________
+
+	void AsyncLoader::_deliver( AsyncResource * pRes )
+	{
+		// Hand the workers buffer over to a Blob without copying.
+
+		Blob_p pLoaded;
+		if( pRes->m_bLoaded )
+		{
+			auto pBuffer = new std::vector<uint8_t>();
+			pBuffer->swap( pRes->m_loaded );
+			pLoaded = Blob::create( pBuffer->data(), (int) pBuffer->size(), [pBuffer]() { delete pBuffer; } );
+		}
+
+		if( pLoaded )
+		{
+			if( pRes->m_bSurface )
+			{
+				if( m_pFactory )
+				{
+					pRes->m_pSurface = m_pFactory->createSurface( pRes->m_decodedSize, pRes->m_decodedFormat, pLoaded.rawPtr(), pRes->m_decodedPitch, pRes->m_hint );
+					if( pRes->m_pSurface )
+						pRes->m_pSurface->setCreator( "AsyncLoader" );
+				}
+			}
+			else
+				pRes->m_pBlob = pLoaded;
+		}
+
+		bool bOk = pRes->m_bSurface ? (pRes->m_pSurface != nullptr) : (pRes->m_pBlob != nullptr);
+		pRes->m_status = bOk ? AsyncResource::Status::Ready : AsyncResource::Status::Failed;
+
+		if( pRes->m_callback )
+			pRes->m_callback(pRes);
+	}
+
+} // namespace wg
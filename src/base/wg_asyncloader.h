@@ -0,0 +1,212 @@
+/*=========================================================================
+
+                         >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+#ifndef	WG_ASYNCLOADER_DOT_H
+#define	WG_ASYNCLOADER_DOT_H
+#pragma once
+
+#include <string>
+#include <deque>
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <wg_pointers.h>
+#include <wg_surface.h>
+#include <wg_surfacefactory.h>
+#include <wg_blob.h>
+
+namespace wg 
+{
+	class RootPanel;
+	typedef	WeakPtr<RootPanel>	RootPanel_wp;
+
+	class AsyncResource;
+	typedef	StrongPtr<AsyncResource>	AsyncResource_p;
+	typedef	WeakPtr<AsyncResource>		AsyncResource_wp;
+
+	class AsyncLoader;
+	typedef	StrongPtr<AsyncLoader>		AsyncLoader_p;
+	typedef	WeakPtr<AsyncLoader>		AsyncLoader_wp;
+
+
+	//____ AsyncResource ______________________________________________________
+	/**
+	 * @brief Handle to a surface or blob being loaded by an AsyncLoader.
+	 *
+	 * AsyncResource works as a future for a resource requested from an AsyncLoader.
+	 * It is returned immediately and becomes ready once the resource has been
+	 * loaded and, in the case of surfaces, created by AsyncLoader::update().
+	 */
+
+	class AsyncResource : public Object
+	{
+		friend class AsyncLoader;
+	public:
+
+		enum class Status
+		{
+			Pending,
+			Ready,
+			Failed
+		};
+
+		//.____ Identification __________________________________________
+
+		bool				isInstanceOf( const char * pClassName ) const;
+		const char *		className( void ) const;
+		static const char	CLASSNAME[];
+		static AsyncResource_p	cast( Object * pObject );
+
+		//.____ State __________________________________________________
+
+		inline Status		status() const { return m_status; }
+		inline bool			isReady() const { return m_status == Status::Ready; }
+		inline bool			isPending() const { return m_status == Status::Pending; }
+
+		//.____ Content ________________________________________________
+
+		inline const std::string&	path() const { return m_path; }
+		inline Surface_p	surface() const { return m_pSurface; }		///< @brief Surface once ready, null for blob requests or until ready.
+		inline Blob_p		blob() const { return m_pBlob; }			///< @brief Content of file once ready, null for surface requests or until ready.
+
+		//.____ Misc ___________________________________________________
+
+		void				setCallback( const std::function<void(AsyncResource*)>& callback );
+
+	protected:
+		AsyncResource( const std::string& path, bool bSurface, int hint );
+		virtual ~AsyncResource() {}
+
+		std::string			m_path;
+		bool				m_bSurface;
+		int					m_hint;
+		Status				m_status;
+
+		Surface_p			m_pSurface;
+		Blob_p				m_pBlob;
+		std::function<void(AsyncResource*)>	m_callback;
+
+		// Loaded by worker thread, not accessed by render thread until handed over in update().
+		// Plain memory so that workers never touch reference counted objects.
+
+		std::vector<uint8_t>	m_loaded;
+		bool				m_bLoaded;
+		Size				m_decodedSize;
+		PixelFormat			m_decodedFormat;
+		int					m_decodedPitch;
+	};
+
+
+	//____ AsyncLoader ________________________________________________________
+	/**
+	 * @brief Loads surfaces and file content on background threads.
+	 *
+	 * AsyncLoader keeps a pool of worker threads that load files and decode images
+	 * into plain memory buffers. Since WonderGUI has no image decoders of its own, decoding of images
+	 * is done by a SurfaceDecoder supplied by the application, which is called on the
+	 * worker threads and therefore needs to be thread safe.
+	 *
+	 * Surfaces can only be created on the render thread, so decoded images are turned
+	 * into surfaces through the SurfaceFactory by update(), which should be called
+	 * regularly from the render thread, typically right before rendering. When a
+	 * factory supports wrapping a Blob (like SoftSurfaceFactory) the pixels are not
+	 * copied again.
+	 *
+	 * Reference counts are not thread safe unless WonderGUI is built with WG_ATOMIC_REFCOUNT,
+	 * so workers never create or hold any objects. Decoders and loaders fill in plain byte
+	 * vectors, which update() wraps into Blobs without copying.
+	 *
+	 * Fonts are loaded by requesting the font file as a blob through loadBlob() and
+	 * creating the font (e.g. FreeTypeFont::create()) in the resources callback, since
+	 * font engines generally are not thread safe.
+	 */
+
+	class AsyncLoader : public Object
+	{
+	public:
+
+		typedef std::function<bool(const std::string& path, std::vector<uint8_t>& pixels, Size& size, PixelFormat& format, int& pitch)>	SurfaceDecoder;
+		typedef std::function<bool(const std::string& path, std::vector<uint8_t>& content)>	BlobLoader;
+
+		//.____ Creation __________________________________________
+
+		static AsyncLoader_p	create( SurfaceFactory * pFactory, int nbThreads = 2 ) { return AsyncLoader_p(new AsyncLoader(pFactory, nbThreads)); }
+
+		//.____ Identification __________________________________________
+
+		bool				isInstanceOf( const char * pClassName ) const;
+		const char *		className( void ) const;
+		static const char	CLASSNAME[];
+		static AsyncLoader_p	cast( Object * pObject );
+
+		//.____ Behavior _______________________________________________
+
+		void				setSurfaceDecoder( const SurfaceDecoder& decoder );
+		void				setBlobLoader( const BlobLoader& loader );
+		void				setRootPanel( RootPanel * pRoot );
+
+		//.____ Content ________________________________________________
+
+		AsyncResource_p		loadSurface( const std::string& path, int hint = SurfaceHint::Static, const std::function<void(AsyncResource*)>& callback = nullptr );
+		AsyncResource_p		loadBlob( const std::string& path, const std::function<void(AsyncResource*)>& callback = nullptr );
+
+		//.____ Control ________________________________________________
+
+		int					update();
+		void				waitUntilDone();
+		int					nbPending() const { return (int) m_inFlight.size(); }
+
+		//.____ Misc ___________________________________________________
+
+		static bool			loadFile( const std::string& path, std::vector<uint8_t>& content );
+
+	protected:
+		AsyncLoader( SurfaceFactory * pFactory, int nbThreads );
+		virtual ~AsyncLoader();
+
+		void				_workerLoop();
+		void				_deliver( AsyncResource * pRes );
+
+		SurfaceFactory_p	m_pFactory;
+		SurfaceDecoder		m_surfaceDecoder;
+		BlobLoader			m_blobLoader;
+		RootPanel_wp		m_pRootPanel;
+
+		std::vector<std::thread>		m_threads;
+		std::mutex						m_mutex;
+		std::condition_variable			m_jobAdded;
+		std::condition_variable			m_jobDone;
+		bool							m_bExit;
+		std::deque<AsyncResource*>		m_jobs;			// Waiting for a worker.
+		std::deque<AsyncResource*>		m_done;			// Processed by a worker, waiting for update().
+
+		// Keeps requests alive while in flight. Only touched by the render thread so that
+		// reference counts never are modified by workers.
+
+		std::vector<AsyncResource_p>	m_inFlight;
+	};
+
+} // namespace wg
+#endif //WG_ASYNCLOADER_DOT_H
@@ -22,6 +22,8 @@
 =========================================================================*/
 
 
+#include <new>
+
 #include <wg_base.h>
 #include <wg_msgrouter.h>
 #include <wg_dummyfont.h>
@@ -30,6 +32,8 @@
 #include <wg_mempool.h>
 #include <wg_standardformatter.h>
 #include <wg_inputhandler.h>
+#include <wg_tickscheduler.h>
+#include <wg_layoutqueue.h>
 
 
 namespace wg 
@@ -48,8 +52,13 @@ namespace wg
 
 		s_pData = new Data;
 		
+#ifdef WG_ATOMIC_REFCOUNT
+		s_pData->pPtrPool = new AtomicMemPool( 1024, sizeof( WeakPtrHub ) );
+#else
 		s_pData->pPtrPool = new MemPool( 128, sizeof( WeakPtrHub ) );
+#endif
 		s_pData->pMemStack = new MemStack( 4096 );
+		s_pData->pLayoutQueue = new LayoutQueue();
 
 		s_pData->pDefaultCaret = Caret::create();
 
@@ -61,6 +70,7 @@ namespace wg
 
 		s_pData->pMsgRouter = MsgRouter::create();
 		s_pData->pInputHandler = InputHandler::create();
+		s_pData->pTickScheduler = TickScheduler::create();
 	
 		s_pData->pDefaultStyle = TextStyle::create();
 		s_pData->pDefaultStyle->setFont( DummyFont::create() );
@@ -83,6 +93,7 @@ namespace wg
 		if( !s_pData->pMemStack->isEmpty() )
 			return -3;					// There is data left in memstack.
 	
+		s_pData->pTickScheduler = nullptr;
 		s_pData->pDefaultCaret = nullptr;
 		s_pData->pDefaultTextMapper = nullptr;
 		s_pData->pDefaultStyle = nullptr;
@@ -90,6 +101,7 @@ namespace wg
 	
 		delete s_pData->pPtrPool;
 		delete s_pData->pMemStack;
+		delete s_pData->pLayoutQueue;
 		delete s_pData;
 		s_pData = nullptr;
 		
@@ -111,6 +123,20 @@ namespace wg
 		return s_pData->pInputHandler; 
 	}
 
+	//____ tickScheduler() _____________________________________________________
+
+	TickScheduler_p Base::tickScheduler() 
+	{ 
+		return s_pData->pTickScheduler; 
+	}
+
+	//____ layoutQueue() _______________________________________________________
+
+	LayoutQueue * Base::layoutQueue() 
+	{ 
+		return s_pData ? s_pData->pLayoutQueue : nullptr; 
+	}
+
 	
 	
 	//____ _allocWeakPtrHub() ______________________________________________________
@@ -119,6 +145,8 @@ namespace wg
 	{
 		assert( s_pData != 0 );
 		WeakPtrHub * pHub = (WeakPtrHub*) s_pData->pPtrPool->allocEntry();
+		if( !pHub )
+			throw std::bad_alloc();				// Pool is exhausted, same as running out of heap.
 
 		new (pHub) WeakPtrHub();
 
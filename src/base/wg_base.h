@@ -40,6 +40,7 @@ namespace wg
 {
 	class Font;
 	class MemPool;
+	class AtomicMemPool;
 	class WeakPtrHub;
 	class MemStack;
 	class MsgRouter;
@@ -48,6 +49,8 @@ namespace wg
 	class TextMapper;
 	class Caret;
 	class TextStyle;
+	class TickScheduler;
+	class LayoutQueue;
 	
 	typedef	StrongPtr<MsgRouter>		MsgRouter_p;
 	typedef	StrongPtr<ValueFormatter>	ValueFormatter_p;
@@ -55,6 +58,7 @@ namespace wg
 	typedef	StrongPtr<TextMapper>		TextMapper_p;
 	typedef	StrongPtr<Caret>			Caret_p;
 	typedef	StrongPtr<TextStyle>		TextStyle_p;
+	typedef	StrongPtr<TickScheduler>	TickScheduler_p;
 	
 	
 	/**
@@ -84,6 +88,8 @@ namespace wg
 
 		static MsgRouter_p	msgRouter();
 		static InputHandler_p	inputHandler();
+		static TickScheduler_p	tickScheduler();
+		static LayoutQueue *	layoutQueue();
 
 		static void			setDefaultTextMapper( TextMapper * pTextMapper );
 		static TextMapper_p defaultTextMapper();
@@ -112,6 +118,7 @@ namespace wg
 		{
 			MsgRouter_p		pMsgRouter;
 			InputHandler_p	pInputHandler;
+			TickScheduler_p	pTickScheduler;
 			
 	
 			TextMapper_p		pDefaultTextMapper;
@@ -122,8 +129,13 @@ namespace wg
 
 			//
 	
+#ifdef WG_ATOMIC_REFCOUNT
+			AtomicMemPool *	pPtrPool;
+#else
 			MemPool *		pPtrPool;
+#endif
 			MemStack *		pMemStack;
+			LayoutQueue *	pLayoutQueue;
 	
 	
 		};
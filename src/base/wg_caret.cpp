@@ -136,6 +136,19 @@ namespace wg
 		return _updateNeedToRender( oldTicks, m_ticks );
 	}
 	
+	//____ nextChange() ____________________________________________________________
+	/**
+	 * @brief Returns millisec until the caret next changes appearance.
+	 *
+	 * Used to schedule the next tick instead of ticking the caret continuously.
+	 */
+
+	int Caret::nextChange() const
+	{
+		int halfCycle = m_cycleLength / 2;
+		return halfCycle - (m_ticks % halfCycle);
+	}
+
 	//____ dirtyRect() _____________________________________________________________
 	
 	Rect Caret::dirtyRect( Rect cell ) const
@@ -89,6 +89,7 @@ namespace wg
 		virtual int			eolWidth( const Size& eolCell ) const;
 		virtual Rect		dirtyRect( Rect cell ) const;
 		virtual bool		tick( int millisec );
+		virtual int			nextChange() const;
 		inline bool			needToRender() const { return m_bNeedToRender; }
 		virtual void		render( GfxDevice * pDevice, Rect cell, const Rect& clip );
 
@@ -324,7 +324,12 @@ namespace wg
 			"EndSurfaceUpdate",
 			"FillSurface",
 			"CopySurface",
-			"DeleteSurface" };
+			"DeleteSurface",
+			"ClipDrawPolyline",
+			"BeginKeyframe",
+			"EndKeyframe",
+			"ClipDrawSegments",
+			"KeyframeData" };
 
 		return names[(int)i];
 	}
@@ -78,7 +78,7 @@ namespace wg
 	const static ScaleMode       ScaleMode_max       = ScaleMode::Interpolate;
 	const static PixelFormat     PixelFormat_max     = PixelFormat::A8;
 	const static MaskOp          MaskOp_max          = MaskOp::Mask;
-	const static GfxChunkId      GfxChunkId_max      = GfxChunkId::DeleteSurface;
+	const static GfxChunkId      GfxChunkId_max      = GfxChunkId::KeyframeData;
 
 	const static int             CodePage_size       = (int)CodePage::_874 + 1;
 	const static int             BlendMode_size      = (int)BlendMode::Invert + 1;
@@ -99,7 +99,7 @@ namespace wg
 	const static int             ScaleMode_size      = (int)ScaleMode::Interpolate + 1;
 	const static int             PixelFormat_size    = (int)PixelFormat::A8 + 1;
 	const static int             MaskOp_size         = (int)MaskOp::Mask + 1;
-	const static int             GfxChunkId_size     = (int)GfxChunkId::DeleteSurface + 1;
+	const static int             GfxChunkId_size     = (int)GfxChunkId::KeyframeData + 1;
 
 	const char * toString(CodePage);
 	const char * toString(BlendMode);
@@ -31,6 +31,8 @@ namespace wg
 {
 	
 	const char Font::CLASSNAME[] = {"Font"};
+
+	uint32_t Font::s_serialCounter = 0;
 	
 	//____ isInstanceOf() _________________________________________________________
 	
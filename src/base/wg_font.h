@@ -126,6 +126,7 @@ namespace wg
 		virtual bool			hasGlyph( uint16_t chr ) = 0;	///@brief Check if font provides a glyph for specified character.
 		virtual bool			isMonospace() = 0;				///@brief Check if font is monospaced.
 		virtual bool			isMonochrome();					///@brief Check if font is monochrome or multi-colored.
+		inline uint32_t			serial() const { return m_serial; }	///@brief Unique number identifying this font instance, for use as key in caches.
 
 
 
@@ -133,8 +134,11 @@ namespace wg
 	
 	
 	protected:
-		Font() {}
+		Font() : m_serial(++s_serialCounter) {}
 		virtual ~Font() {}
+
+		uint32_t			m_serial;
+		static uint32_t		s_serialCounter;
 	};
 	
 	
@@ -23,6 +23,7 @@
 #include <wg_gfxdevice.h>
 #include <wg_geo.h>
 #include <algorithm>
+#include <cmath>
 #include <wg_util.h>
 #include <algorithm>
 
@@ -208,6 +209,42 @@ namespace wg
 	}
 
 
+	//____ drawPolyline() _____________________________________________________
+
+	/**
+	 * @brief Draw an anti-aliased line through a series of points.
+	 *
+	 * @param nPoints	Number of points in the line. Nothing is drawn if less than two.
+	 * @param pPoints	Pointer to the points, in canvas pixels.
+	 * @param color		Color of the line.
+	 * @param thickness	Thickness of the line in pixels.
+	 *
+	 * All segments are drawn as one primitive with mitered corners instead of overlapping
+	 * line ends. SoftGfxDevice blends every pixel of the line once. GlGfxDevice draws
+	 * the line as one triangle strip, where pixels on the inside of sharp corners can be
+	 * blended twice, which is visible on translucent lines. Points are given with subpixel
+	 * precision and, as for drawLine(), integer coordinates are in the middle of a pixel.
+	 */
+
+	void GfxDevice::drawPolyline(int nPoints, const CoordF * pPoints, Color color, float thickness)
+	{
+		clipDrawPolyline(m_dummyClip, nPoints, pPoints, color, thickness);
+	}
+
+	//____ clipDrawPolyline() _________________________________________________
+
+	// Default implementation draws the segments one by one, devices are expected to override this.
+
+	void GfxDevice::clipDrawPolyline(const Rect& clip, int nPoints, const CoordF * pPoints, Color color, float thickness)
+	{
+		for (int i = 0; i < nPoints - 1; i++)
+		{
+			Coord beg((int)std::floor(pPoints[i].x + 0.5f), (int)std::floor(pPoints[i].y + 0.5f));
+			Coord end((int)std::floor(pPoints[i+1].x + 0.5f), (int)std::floor(pPoints[i+1].y + 0.5f));
+			clipDrawLine(clip, beg, end, color, thickness);
+		}
+	}
+
 	//____ clipDrawLine() _________________________________________________________
 
 	// Coordinates for start are considered to be + 0.5 in the width dimension, so they start in the middle of a line/column.
@@ -648,6 +685,32 @@ namespace wg
 		clipDrawHorrWave(m_dummyClip, begin, length, pTopBorder, pBottomBorder, frontFill, backFill);
 	}
 
+	//____ drawSegments() _____________________________________________________
+
+	/**
+	 * @brief Fill a rectangle with vertically stacked segments separated by anti-aliased edges.
+	 *
+	 * @param dest				Rectangle to fill, in canvas pixels.
+	 * @param nEdgeStrips		Number of edges separating the segments. There is one more segment than edges.
+	 * @param pEdgeStrips		Edge positions, (dest.w+1)*nEdgeStrips values in 24.8 format.
+	 * @param pSegmentColors	Colors of the nEdgeStrips+1 segments, from top to bottom.
+	 *
+	 * Edge positions are vertical offsets from the top of dest, sampled on the pixel borders
+	 * from the left side of dest to the right side of it. The values for all edges at one
+	 * sample point are stored together, so pEdgeStrips[x*nEdgeStrips + i] is the position of edge
+	 * i at sample point x. Edges are expected to be sorted from top to bottom, an edge crossing
+	 * the one above it is clamped to it. Positions outside dest are clamped to dest.
+	 *
+	 * Segment 0 covers everything above the first edge and the last segment everything below
+	 * the last edge. A stacked area chart with N series is drawn as N+1 segments where the first
+	 * one usually is transparent, in a single pass and without seams between the series.
+	 */
+
+	void GfxDevice::drawSegments(const Rect& dest, int nEdgeStrips, const int * pEdgeStrips, const Color * pSegmentColors)
+	{
+		clipDrawSegments(dest, dest, nEdgeStrips, pEdgeStrips, pSegmentColors);
+	}
+
 	//_____ clipBlitFromCanvas() ______________________________________________
 
 	void GfxDevice::clipBlitFromCanvas(const Rect& clip, Surface* pSrc, const Rect& src, Coord dest)
@@ -105,6 +105,7 @@ namespace wg
 
 		virtual void	drawLine( Coord begin, Coord end, Color color, float thickness = 1.f );
 		virtual void	drawLine( Coord begin, Direction dir, int length, Color col, float thickness = 1.f);
+		virtual void	drawPolyline( int nPoints, const CoordF * pPoints, Color color, float thickness = 1.f );
 
 		virtual void	blit( Surface * pSrc );
 		virtual void	blit( Surface * pSrc, Coord dest );
@@ -121,12 +122,15 @@ namespace wg
 
 		virtual void	drawHorrWave(Coord begin, int length, const WaveLine * pTopBorder, const WaveLine * pBottomBorder, Color frontFill, Color backFill);
 
+		virtual void	drawSegments(const Rect& dest, int nEdgeStrips, const int * pEdgeStrips, const Color * pSegmentColors);
+
 		// Versions with clipping
 
 		virtual void    clipPlotPixels(const Rect& clip, int nCoords, const Coord * pCoords, const Color * pColors) = 0;
 
 		virtual void	clipDrawLine(const Rect& clip, Coord begin, Coord end, Color color, float thickness = 1.f) = 0;
 		virtual void	clipDrawLine(const Rect& clip, Coord begin, Direction dir, int length, Color col, float thickness = 1.f);
+		virtual void	clipDrawPolyline(const Rect& clip, int nPoints, const CoordF * pPoints, Color color, float thickness = 1.f);
 
 		virtual void	clipFill( const Rect& clip, const Rect& rect, const Color& col );
 	
@@ -145,6 +149,8 @@ namespace wg
 
 		virtual void	clipDrawHorrWave(const Rect&clip, Coord begin, int length, const WaveLine * pTopBorder, const WaveLine * pBottomBorder, Color frontFill, Color backFill) = 0;
 
+		virtual void	clipDrawSegments(const Rect& clip, const Rect& dest, int nEdgeStrips, const int * pEdgeStrips, const Color * pSegmentColors) = 0;
+
 		// Special draw methods
 
 		virtual void	clipBlitFromCanvas(const Rect& clip, Surface* pSrc, const Rect& src, Coord dest);	// Blit from surface that has been used as canvas. Will flip Y on OpenGL.
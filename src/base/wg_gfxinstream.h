@@ -61,6 +61,8 @@ namespace wg
 		virtual bool	_isStreamOpen() = 0;
 		virtual void	_closeStream() = 0;
 		virtual bool	_reopenStream() = 0;
+
+		virtual int		_seekKeyframe(int frame) { return -1; }		// Only implemented by streams with random access.
 	};
 
 	//____ GfxInStream ________________________________________________________
@@ -77,6 +79,7 @@ namespace wg
 		inline bool		reopen() { return m_pHolder->_reopenStream(); }
 
 		void			skip(int bytes) { m_pHolder->_skipBytes(bytes); }
+		int				seekKeyframe(int frame) { return m_pHolder->_seekKeyframe(frame); }
 
 		bool				isEmpty();
 		GfxStream::Header	peek();
@@ -237,6 +237,41 @@ namespace wg
 				break;
 			}
 
+			case GfxChunkId::ClipDrawPolyline:
+			{
+				Rect		clip;
+				Color		color;
+				float		thickness;
+
+				*m_pGfxStream >> clip;
+				*m_pGfxStream >> color;
+				*m_pGfxStream >> thickness;
+				m_pGfxStream->skip(header.size - 16);			// Skip begin point and deltas.
+
+				m_charStream << "    clip        = " << clip.x << ", " << clip.y << ", " << clip.w << ", " << clip.h << std::endl;
+				m_charStream << "    color       = " << (int)color.a << ", " << (int)color.r << ", " << (int)color.g << ", " << (int)color.b << std::endl;
+				m_charStream << "    thickness   = " << thickness << std::endl;
+				m_charStream << "    number of points: " << (header.size - 24) / 4 + 1 << std::endl;
+				break;
+			}
+
+			case GfxChunkId::ClipDrawSegments:
+			{
+				Rect		clip;
+				Rect		dest;
+				uint16_t	nEdgeStrips;
+
+				*m_pGfxStream >> clip;
+				*m_pGfxStream >> dest;
+				*m_pGfxStream >> nEdgeStrips;
+				m_pGfxStream->skip(header.size - 18);			// Skip colors and edges.
+
+				m_charStream << "    clip        = " << clip.x << ", " << clip.y << ", " << clip.w << ", " << clip.h << std::endl;
+				m_charStream << "    dest        = " << dest.x << ", " << dest.y << ", " << dest.w << ", " << dest.h << std::endl;
+				m_charStream << "    edge strips = " << nEdgeStrips << std::endl;
+				break;
+			}
+
 
 /*
 			case GfxChunkId::ClipDrawHorrWave:
@@ -259,11 +294,27 @@ namespace wg
 				break;
 			}
 
+			case GfxChunkId::BeginKeyframe:
+			{
+				int32_t		frame;
+				int32_t		bytes;
+
+				*m_pGfxStream >> frame;
+				*m_pGfxStream >> bytes;
+
+				m_charStream << "    frame       = " << frame << std::endl;
+				m_charStream << "    bytes       = " << bytes << std::endl;
+				break;
+			}
+
+			case GfxChunkId::EndKeyframe:
+				break;
+
 			case GfxChunkId::StretchBlit:
 			{
 				uint16_t	surfaceId;
 				RectF		source;
-				Coord		dest;
+				Rect		dest;
 
 				*m_pGfxStream >> surfaceId;
 				*m_pGfxStream >> source;
@@ -271,7 +322,7 @@ namespace wg
 
 				m_charStream << "    surfaceId   = " << surfaceId << std::endl;
 				m_charStream << "    source      = " << source.x << ", " << source.y << ", " << source.w << ", " << source.h << std::endl;
-				m_charStream << "    dest        = " << dest.x << ", " << dest.y << std::endl;
+				m_charStream << "    dest        = " << dest.x << ", " << dest.y << ", " << dest.w << ", " << dest.h << std::endl;
 				break;
 			}
 			
@@ -410,6 +461,7 @@ namespace wg
 			logChunk();
 			if (header.type == GfxChunkId::EndRender)
 				return true;
+			header = peekChunk();
 		}
 		return false;
 	}
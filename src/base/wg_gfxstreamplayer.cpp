@@ -44,6 +44,8 @@ namespace wg
 		m_pStream = in.ptr();
 		m_pDevice = pDevice;
 		m_pSurfaceFactory = pFactory;
+		m_pDefaultCanvas = pDevice->canvas();
+		m_pWritePixels = nullptr;
 	}
 
 	//____ Destructor _________________________________________________________
@@ -242,10 +244,77 @@ namespace wg
 			break;
 		}
 
+		case GfxChunkId::ClipDrawPolyline:
+		{
+			Rect		clip;
+			Color		color;
+			float		thickness;
+			CoordF		begin;
+
+			*m_pStream >> clip;
+			*m_pStream >> color;
+			*m_pStream >> thickness;
+			*m_pStream >> begin.x;
+			*m_pStream >> begin.y;
+
+			int nDeltas = (header.size - 24) / 4;
+
+			int bufferSize = (nDeltas+1)*sizeof(CoordF);
+			char * pBuffer = reinterpret_cast<char*>(Base::memStackAlloc(bufferSize));
+
+			// Load all deltas to end of buffer and unpack them into points.
+
+			*m_pStream >> GfxStream::DataChunk{ nDeltas*4, pBuffer + bufferSize - nDeltas*4 };
+
+			CoordF * pDest = (CoordF*)pBuffer;
+			int16_t * pSrc = (int16_t*)(pBuffer + bufferSize - nDeltas*4);
+
+			pDest[0] = begin;
+
+			int posX = 0, posY = 0;
+			for (int i = 1; i <= nDeltas; i++)
+			{
+				posX += *pSrc++;
+				posY += *pSrc++;
+				pDest[i].x = begin.x + posX / 64.f;
+				pDest[i].y = begin.y + posY / 64.f;
+			}
+
+			m_pDevice->clipDrawPolyline(clip, nDeltas+1, pDest, color, thickness);
+
+			Base::memStackRelease(bufferSize);
+			break;
+		}
+
 		case GfxChunkId::ClipDrawHorrWave:
 			//TODO: Implement!
 			break;
 
+		case GfxChunkId::ClipDrawSegments:
+		{
+			Rect		clip;
+			Rect		dest;
+			uint16_t	nEdgeStrips;
+
+			*m_pStream >> clip;
+			*m_pStream >> dest;
+			*m_pStream >> nEdgeStrips;
+
+			int colorBytes = (nEdgeStrips + 1) * 4;
+			int edgeBytes = header.size - 18 - colorBytes;
+
+			int bufferSize = colorBytes + edgeBytes;
+			char * pBuffer = reinterpret_cast<char*>(Base::memStackAlloc(bufferSize));
+
+			*m_pStream >> GfxStream::DataChunk{ colorBytes, pBuffer };
+			*m_pStream >> GfxStream::DataChunk{ edgeBytes, pBuffer + colorBytes };
+
+			m_pDevice->clipDrawSegments(clip, dest, nEdgeStrips, (int*)(pBuffer + colorBytes), (Color*)pBuffer);
+
+			Base::memStackRelease(bufferSize);
+			break;
+		}
+
 		case GfxChunkId::Blit:
 		{
 			uint16_t	surfaceId;
@@ -308,6 +377,8 @@ namespace wg
 				m_vSurfaces.resize(surfaceId + 1, nullptr);
 
 			m_vSurfaces[surfaceId] = m_pSurfaceFactory->createSurface(size, type, 0, pClut);
+			if (m_vSurfaces[surfaceId])
+				m_vSurfaces[surfaceId]->setCreator("GfxStreamPlayer");
 
 			if (pClut)
 				Base::memStackRelease(4096);
@@ -397,6 +468,26 @@ namespace wg
 			break;
 		}
 
+		case GfxChunkId::BeginKeyframe:
+		{
+			// Keyframes only recreate state we already have when playing
+			// from start, so their KeyframeData chunks are skipped unless we are seeking.
+
+			int32_t		frame;
+			int32_t		bytes;
+
+			*m_pStream >> frame;
+			*m_pStream >> bytes;
+			break;
+		}
+
+		case GfxChunkId::KeyframeData:
+			m_pStream->skip(header.size);
+			break;
+
+		case GfxChunkId::EndKeyframe:
+			break;
+
 		default:
 			// We don't know how to handle this, so let's just skip it
 
@@ -423,5 +514,91 @@ namespace wg
 		return false;
 	}
 
+	//____ reset() _____________________________________________________________
+	/**
+	 * @brief Drops all surfaces and resets device state.
+	 *
+	 * Releases all surfaces created by the stream and restores canvas, tint color
+	 * and blend mode of the device to what they would be at the start of a stream.
+	 * Content already rendered to the canvas is left untouched.
+	 */
+
+	void GfxStreamPlayer::reset()
+	{
+		if (m_pUpdatingSurface)
+		{
+			m_pUpdatingSurface->unlock();
+			m_pUpdatingSurface = nullptr;
+		}
+		m_pWritePixels = nullptr;
+
+		m_vSurfaces.clear();
+
+		m_pDevice->setCanvas(m_pDefaultCanvas);
+		m_pDevice->setTintColor(Color::White);
+		m_pDevice->setBlendMode(BlendMode::Blend);
+	}
+
+	//____ seek() ______________________________________________________________
+	/**
+	 * @brief Moves playback to the beginning of specified frame.
+	 *
+	 * Only supported by streams with random access, like GfxStreamRecording. The player
+	 * is reset, state is restored from the closest keyframe at or before the specified frame
+	 * and the frames between keyframe and destination are replayed, so that a following call
+	 * to playFrame() renders the requested frame exactly as it was rendered when recorded.
+	 *
+	 * @param frame	Index of the frame to play next, counting from zero.
+	 *
+	 * @return False if stream doesn't support seeking or frame is out of range.
+	 */
+
+	bool GfxStreamPlayer::seek(int frame)
+	{
+		int keyframe = m_pStream->seekKeyframe(frame);
+		if (keyframe < 0)
+			return false;
+
+		reset();
+
+		if (peekChunk().type == GfxChunkId::BeginKeyframe)
+			_playKeyframe();
+
+		for (int i = keyframe; i < frame; i++)
+		{
+			if (!playFrame())
+				return false;
+		}
+
+		return true;
+	}
+
+	//____ _playKeyframe() _____________________________________________________
+
+	void GfxStreamPlayer::_playKeyframe()
+	{
+		GfxStream::Header	header;
+		int32_t		frame;
+		int32_t		bytes;
+
+		*m_pStream >> header;
+		*m_pStream >> frame;
+		*m_pStream >> bytes;
+
+		// Each chunk of the keyframe is wrapped in a KeyframeData chunk. We
+		// consume the wrapper header and play the chunk within.
+
+		GfxChunkId type = peekChunk().type;
+		while (type == GfxChunkId::KeyframeData)
+		{
+			*m_pStream >> header;
+			playChunk();
+			type = peekChunk().type;
+		}
+
+		if (type == GfxChunkId::EndKeyframe)
+			playChunk();
+	}
+
 
 } //namespace wg
\ No newline at end of file
@@ -39,6 +39,7 @@ namespace wg
 
 	class GfxStreamPlayer : public Object
 	{
+		friend class GfxStreamRecorder;
 	public:
 
 		//.____ Creation __________________________________________
@@ -61,13 +62,19 @@ namespace wg
 		bool		playChunk();
 		bool		playFrame();
 
+		void		reset();
+		bool		seek(int frame);
+
 	protected:
+		void		_playKeyframe();
+
 		GfxStreamPlayer(GfxInStream& in, GfxDevice * pDevice, SurfaceFactory * pFactory);
 		~GfxStreamPlayer();
 
 		GfxInStream_p		m_pStream;
 		GfxDevice_p			m_pDevice;
 		SurfaceFactory_p	m_pSurfaceFactory;
+		Surface_p			m_pDefaultCanvas;
 
 		std::vector<Surface_p>	m_vSurfaces;
 
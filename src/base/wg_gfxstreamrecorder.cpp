@@ -0,0 +1,491 @@
+/*=========================================================================
+
+                         >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+#include <cstring>
+
+#include <wg_gfxstreamrecorder.h>
+#include <wg_gfxstreamrecording.h>
+#include <wg_gfxstreamwriter.h>
+#include <wg_surface.h>
+#include <wg_util.h>
+#include <assert.h>
+
+namespace wg
+{
+
+	const char GfxStreamRecorder::CLASSNAME[] = {"GfxStreamRecorder"};
+
+	//____ create() ___________________________________________________________
+	/**
+	 * @brief Creates a recorder that writes a seekable recording of a GfxStream.
+	 *
+	 * Everything written to the recorders stream is passed on to the dispatcher in the
+	 * recording file format, which can be read back by GfxStreamRecording. The file
+	 * is made up of:
+	 *
+	 * - A 20 byte header: magic "WGSR", version, canvas width, canvas height and keyframe interval.
+	 * - The stream chunks, unmodified, with a keyframe inserted before the first BeginRender of the first and every keyframeInterval:th frame.
+	 * - An index of frame and keyframe offsets, followed by a 12 byte trailer pointing to the index.
+	 *
+	 * The trailer and index are written when the stream is closed. File offsets are 64-bit, other
+	 * integers 32-bit, all stored in the native byte order, just like in the stream itself.
+	 *
+	 * A keyframe starts with a BeginKeyframe chunk holding its frame number and the number of bytes
+	 * that follow up to and including its EndKeyframe chunk. Each chunk of its content is wrapped in
+	 * a KeyframeData chunk, so that code parsing the stream skips the content by chunk size.
+	 *
+	 * To be able to take keyframes the recorder plays the stream onto a shadow device, typically
+	 * a SoftGfxDevice with a canvas of the same size as the one being recorded. A keyframe consists
+	 * of stream chunks recreating all live surfaces, the content of the shadow devices canvas and
+	 * the device state (canvas, tint color and blend mode) as they were at the start of the frame.
+	 * Keyframes are skipped during normal playback.
+	 *
+	 * @param dispatcher		Function receiving the recording, typically writing it to a file.
+	 * @param pShadowDevice		Device the stream is played onto for taking keyframes.
+	 * @param pShadowFactory	SurfaceFactory for creating the surfaces of the shadow device.
+	 * @param keyframeInterval	Number of frames between keyframes. 0 disables keyframes.
+	 */
+
+	GfxStreamRecorder_p GfxStreamRecorder::create( std::function<void(int nBytes, const void * pData)> dispatcher, GfxDevice * pShadowDevice, 
+													SurfaceFactory * pShadowFactory, int keyframeInterval )
+	{
+		return new GfxStreamRecorder(dispatcher, pShadowDevice, pShadowFactory, keyframeInterval);
+	}
+
+	//____ Constructor _____________________________________________________________
+
+	GfxStreamRecorder::GfxStreamRecorder(std::function<void(int nBytes, const void * pData)> dispatcher, GfxDevice * pShadowDevice, SurfaceFactory * pShadowFactory, int keyframeInterval) : stream(this)
+	{
+		m_dispatcher = dispatcher;
+		m_pShadowDevice = pShadowDevice;
+		m_keyframeInterval = keyframeInterval;
+		m_bOpen = true;
+		m_bKeyframePending = keyframeInterval > 0;
+		m_writeOfs = 0;
+
+		m_pShadowPlug = GfxStreamPlug::create();
+		m_pShadowPlug->openOutput(0);
+		m_pShadowPlayer = GfxStreamPlayer::create(m_pShadowPlug->output[0], pShadowDevice, pShadowFactory);
+
+		Size canvasSize = pShadowDevice->canvasSize();
+
+		_writeInt(GfxStreamRecording::c_fileMagic);
+		_writeInt(GfxStreamRecording::c_version);
+		_writeInt(canvasSize.w);
+		_writeInt(canvasSize.h);
+		_writeInt(keyframeInterval);
+
+		m_frameOffsets.push_back(m_writeOfs);
+
+		// Initial keyframe, pending until the first BeginRender, makes seeking independent 
+		// of what the players canvas contained before.
+	}
+
+	//____ Destructor _________________________________________________________
+
+	GfxStreamRecorder::~GfxStreamRecorder()
+	{
+	}
+
+	//____ isInstanceOf() _________________________________________________________
+
+	bool GfxStreamRecorder::isInstanceOf( const char * pClassName ) const
+	{
+		if( pClassName==CLASSNAME )
+			return true;
+
+		return Object::isInstanceOf(pClassName);
+	}
+
+	//____ className() ____________________________________________________________
+
+	const char * GfxStreamRecorder::className( void ) const
+	{
+		return CLASSNAME;
+	}
+
+	//____ cast() _________________________________________________________________
+
+	GfxStreamRecorder_p GfxStreamRecorder::cast( Object * pObject )
+	{
+		if( pObject && pObject->isInstanceOf(CLASSNAME) )
+			return GfxStreamRecorder_p( static_cast<GfxStreamRecorder*>(pObject) );
+
+		return 0;
+	}
+
+	//____ _object() __________________________________________________________
+
+	Object * GfxStreamRecorder::_object()
+	{
+		return this;
+	}
+
+	//____ _flushStream() _____________________________________________________
+
+	void GfxStreamRecorder::_flushStream()
+	{
+		// Complete chunks are dispatched as soon as they are received, nothing to flush.
+	}
+
+	//____ _reserveStream() ___________________________________________________
+
+	void GfxStreamRecorder::_reserveStream(int bytes)
+	{
+		m_pending.reserve(m_pending.size() + bytes);
+	}
+
+	//____ _closeStream() _____________________________________________________
+
+	void GfxStreamRecorder::_closeStream()
+	{
+		if (!m_bOpen)
+			return;
+
+		_writeIndex();
+		m_bOpen = false;
+	}
+
+	//____ _reopenStream() ____________________________________________________
+
+	bool GfxStreamRecorder::_reopenStream()
+	{
+		return false;		// A closed recording can't be appended to.
+	}
+
+	//____ _isStreamOpen() ____________________________________________________
+
+	bool GfxStreamRecorder::_isStreamOpen()
+	{
+		return m_bOpen;
+	}
+
+	//____ _pushChar() ________________________________________________________
+
+	void GfxStreamRecorder::_pushChar(char c)
+	{
+		m_pending.push_back(c);
+		_processChunks();
+	}
+
+	//____ _pushShort() _______________________________________________________
+
+	void GfxStreamRecorder::_pushShort(short s)
+	{
+		m_pending.insert(m_pending.end(), (char*)&s, ((char*)&s) + 2);
+		_processChunks();
+	}
+
+	//____ _pushInt() _________________________________________________________
+
+	void GfxStreamRecorder::_pushInt(int i)
+	{
+		m_pending.insert(m_pending.end(), (char*)&i, ((char*)&i) + 4);
+		_processChunks();
+	}
+
+	//____ _pushFloat() _______________________________________________________
+
+	void GfxStreamRecorder::_pushFloat(float f)
+	{
+		m_pending.insert(m_pending.end(), (char*)&f, ((char*)&f) + 4);
+		_processChunks();
+	}
+
+	//____ _pushBytes() _______________________________________________________
+
+	void GfxStreamRecorder::_pushBytes(int nBytes, char * pBytes)
+	{
+		m_pending.insert(m_pending.end(), pBytes, pBytes + nBytes);
+		_processChunks();
+	}
+
+	//____ _processChunks() ___________________________________________________
+
+	void GfxStreamRecorder::_processChunks()
+	{
+		if (!m_bOpen)
+		{
+			m_pending.clear();
+			return;
+		}
+
+		int ofs = 0;
+		int available = (int) m_pending.size();
+
+		while (available - ofs >= 4)
+		{
+			int size = 4 + *(uint16_t*)&m_pending[ofs + 2];
+			if (available - ofs < size)
+				break;
+
+			_processChunk(&m_pending[ofs], size);
+			ofs += size;
+		}
+
+		if (ofs > 0)
+			m_pending.erase(m_pending.begin(), m_pending.begin() + ofs);
+	}
+
+	//____ _processChunk() ____________________________________________________
+
+	void GfxStreamRecorder::_processChunk(const char * pChunk, int bytes)
+	{
+		GfxChunkId type = (GfxChunkId) *(uint16_t*)pChunk;
+
+		// Keyframes are taken when the next frame actually begins, so that
+		// we don't end the recording with a keyframe for a frame that never comes.
+
+		if (type == GfxChunkId::BeginRender && m_bKeyframePending)
+		{
+			_writeKeyframe();
+			m_bKeyframePending = false;
+		}
+
+		_write(bytes, pChunk);
+
+		m_pShadowPlug->input.reserve(bytes);
+		m_pShadowPlug->input << GfxStream::DataChunk{ bytes, pChunk };
+		m_pShadowPlayer->playAll();
+
+		if (type == GfxChunkId::EndRender)
+		{
+			m_frameOffsets.push_back(m_writeOfs);
+
+			if (m_keyframeInterval > 0 && frames() % m_keyframeInterval == 0)
+				m_bKeyframePending = true;
+		}
+	}
+
+	//____ _writeKeyframe() ___________________________________________________
+
+	void GfxStreamRecorder::_writeKeyframe()
+	{
+		std::vector<char>	content;
+
+		auto pWriter = GfxStreamWriter::create([&content](int nBytes, const void * pData) 
+		{ 
+			content.insert(content.end(), (const char*)pData, ((const char*)pData) + nBytes); 
+		});
+
+		GfxOutStream& out = pWriter->stream;
+
+		// Recreate all surfaces alive in the stream.
+
+		std::vector<Surface_p>& surfaces = m_pShadowPlayer->m_vSurfaces;
+		Surface * pCanvas = m_pShadowDevice->canvas();
+
+		int canvasId = -1;
+		int freeId = (int) surfaces.size();
+
+		for (int id = 0; id < (int) surfaces.size(); id++)
+		{
+			Surface * pSurface = surfaces[id];
+			if (!pSurface)
+			{
+				if (freeId == (int) surfaces.size())
+					freeId = id;
+				continue;
+			}
+
+			_streamSurface(out, id, pSurface);
+
+			if (pSurface == pCanvas)
+				canvasId = id;
+		}
+
+		// Restore content of the players canvas by blitting a temporary copy
+		// of our default canvas. Player has reset its device to default canvas
+		// before playing the keyframe.
+
+		Surface * pDefaultCanvas = m_pShadowPlayer->m_pDefaultCanvas;
+		if (pDefaultCanvas)
+		{
+			uint16_t tempId = (uint16_t) freeId;
+
+			_streamSurface(out, tempId, pDefaultCanvas);
+
+			out << GfxStream::Header{ GfxChunkId::BeginRender, 0 };
+			out << GfxStream::Header{ GfxChunkId::SetTintColor, 4 };
+			out << Color::White;
+			out << GfxStream::Header{ GfxChunkId::SetBlendMode, 2 };
+			out << BlendMode::Replace;
+			out << GfxStream::Header{ GfxChunkId::Blit, 14 };
+			out << tempId;
+			out << Rect(0, 0, pDefaultCanvas->size());
+			out << Coord(0, 0);
+			out << GfxStream::Header{ GfxChunkId::EndRender, 0 };
+			out << GfxStream::Header{ GfxChunkId::DeleteSurface, 2 };
+			out << tempId;
+		}
+
+		// Restore device state
+
+		if (canvasId >= 0)
+		{
+			out << GfxStream::Header{ GfxChunkId::SetCanvas, 2 };
+			out << (uint16_t) canvasId;
+		}
+
+		out << GfxStream::Header{ GfxChunkId::SetTintColor, 4 };
+		out << m_pShadowDevice->tintColor();
+		out << GfxStream::Header{ GfxChunkId::SetBlendMode, 2 };
+		out << m_pShadowDevice->blendMode();
+
+		out.flush();
+
+		// Write the keyframe. Content is written chunk by chunk, each one wrapped in a KeyframeData 
+		// chunk. Chunks are at most GfxStream::c_maxBlockSize bytes, so the wrapper always fits.
+
+		int nChunks = 0;
+		for (int ofs = 0; ofs < (int) content.size(); ofs += 4 + *(uint16_t*)&content[ofs + 2])
+			nChunks++;
+
+		m_keyframes.push_back({ frames(), m_writeOfs });
+
+		uint16_t header[2] = { (uint16_t) GfxChunkId::BeginKeyframe, 8 };
+		_write(4, header);
+		_writeInt(frames());
+		_writeInt((int) content.size() + nChunks * 4 + 4);
+
+		int ofs = 0;
+		while (ofs < (int) content.size())
+		{
+			int chunkSize = 4 + *(uint16_t*)&content[ofs + 2];
+
+			header[0] = (uint16_t) GfxChunkId::KeyframeData;
+			header[1] = (uint16_t) chunkSize;
+			_write(4, header);
+			_write(chunkSize, &content[ofs]);
+			ofs += chunkSize;
+		}
+
+		header[0] = (uint16_t) GfxChunkId::EndKeyframe;
+		header[1] = 0;
+		_write(4, header);
+	}
+
+	//____ _streamSurface() ___________________________________________________
+
+	void GfxStreamRecorder::_streamSurface(GfxOutStream& out, uint16_t surfaceId, Surface * pSurface)
+	{
+		const Color * pClut = pSurface->clut();
+		Size size = pSurface->size();
+
+		out << GfxStream::Header{ GfxChunkId::CreateSurface, 8 + (pClut ? 4096 : 0) };
+		out << surfaceId;
+		out << pSurface->pixelFormat();
+		out << size;
+
+		if (pClut)
+			out << GfxStream::DataChunk{ 4096, pClut };
+
+		out << GfxStream::Header{ GfxChunkId::SetSurfaceScaleMode, 4 };
+		out << surfaceId;
+		out << pSurface->scaleMode();
+
+		// Stream pixels just like StreamSurface does, lines packed without padding.
+
+		out << GfxStream::Header{ GfxChunkId::BeginSurfaceUpdate, 10 };
+		out << surfaceId;
+		out << Rect(0, 0, size);
+
+		const uint8_t * pLine = pSurface->lock(AccessMode::ReadOnly);
+		int pitch = pSurface->pitch();
+		int lineBytes = size.w * pSurface->pixelDescription()->bits / 8;
+
+		int dataSize = lineBytes * size.h;
+		int ofs = 0;
+
+		while (dataSize > 0)
+		{
+			int chunkSize = min(dataSize, (int)(GfxStream::c_maxBlockSize - sizeof(GfxStream::Header)));
+			dataSize -= chunkSize;
+
+			out << GfxStream::Header{ GfxChunkId::SurfaceData, chunkSize };
+
+			while (chunkSize > 0)
+			{
+				int len = min(chunkSize, lineBytes - ofs);
+				out << GfxStream::DataChunk{ len, pLine + ofs };
+
+				chunkSize -= len;
+				ofs += len;
+				if (ofs == lineBytes)
+				{
+					ofs = 0;
+					pLine += pitch;
+				}
+			}
+		}
+
+		pSurface->unlock();
+
+		out << GfxStream::Header{ GfxChunkId::EndSurfaceUpdate, 0 };
+	}
+
+	//____ _writeIndex() ______________________________________________________
+
+	void GfxStreamRecorder::_writeIndex()
+	{
+		int64_t indexOfs = m_writeOfs;
+
+		int nFrames = frames();
+
+		_writeInt(nFrames);
+		for (int i = 0; i < nFrames; i++)
+			_writeInt64(m_frameOffsets[i]);
+
+		_writeInt((int) m_keyframes.size());
+		for (auto& kf : m_keyframes)
+		{
+			_writeInt(kf.frame);
+			_writeInt64(kf.offset);
+		}
+
+		_writeInt64(indexOfs);
+		_writeInt(GfxStreamRecording::c_indexMagic);
+	}
+
+	//____ _write() ___________________________________________________________
+
+	void GfxStreamRecorder::_write(int nBytes, const void * pData)
+	{
+		m_dispatcher(nBytes, pData);
+		m_writeOfs += nBytes;
+	}
+
+	//____ _writeInt() ________________________________________________________
+
+	void GfxStreamRecorder::_writeInt(int value)
+	{
+		_write(4, &value);
+	}
+
+	//____ _writeInt64() ______________________________________________________
+
+	void GfxStreamRecorder::_writeInt64(int64_t value)
+	{
+		_write(8, &value);
+	}
+
+} // namespace wg
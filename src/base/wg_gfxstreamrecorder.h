@@ -0,0 +1,123 @@
+/*=========================================================================
+
+                         >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+#ifndef	WG_GFXSTREAMRECORDER_DOT_H
+#define	WG_GFXSTREAMRECORDER_DOT_H
+#pragma once
+
+#include <wg_gfxoutstream.h>
+#include <wg_gfxstreamplug.h>
+#include <wg_gfxstreamplayer.h>
+#include <wg_gfxdevice.h>
+#include <wg_surfacefactory.h>
+
+#include <functional>
+#include <vector>
+
+namespace wg
+{
+
+	class GfxStreamRecorder;
+	typedef	StrongPtr<GfxStreamRecorder>	GfxStreamRecorder_p;
+	typedef	WeakPtr<GfxStreamRecorder>		GfxStreamRecorder_wp;
+
+	class GfxStreamRecorder : public Object, protected GfxOutStreamHolder
+	{
+	public:
+
+		//.____ Creation __________________________________________
+
+		static GfxStreamRecorder_p	create( std::function<void(int nBytes, const void * pData)> dispatcher, GfxDevice * pShadowDevice, 
+											SurfaceFactory * pShadowFactory, int keyframeInterval = 60 );
+
+		//.____ Interfaces _______________________________________
+
+		GfxOutStream		stream;
+
+		//.____ Identification __________________________________________
+
+		bool				isInstanceOf(const char * pClassName) const;
+		const char *		className(void) const;
+		static const char	CLASSNAME[];
+		static GfxStreamRecorder_p	cast(Object * pObject);
+
+		//.____ Content _______________________________________________________
+
+		inline int	frames() const { return (int) m_frameOffsets.size() - 1; }
+		inline int	keyframes() const { return (int) m_keyframes.size(); }
+		inline int64_t	bytesWritten() const { return m_writeOfs; }
+
+	protected:
+
+		GfxStreamRecorder(std::function<void(int nBytes, const void * pData)> dispatcher, GfxDevice * pShadowDevice, SurfaceFactory * pShadowFactory, int keyframeInterval);
+		~GfxStreamRecorder();
+
+		struct Keyframe
+		{
+			int			frame;
+			int64_t		offset;
+		};
+
+		Object *	_object() override;
+
+		void		_flushStream() override;
+		void		_reserveStream(int bytes) override;
+		void		_closeStream() override;
+		bool		_reopenStream() override;
+		bool		_isStreamOpen() override;
+
+		void		_pushChar(char c) override;
+		void		_pushShort(short s) override;
+		void		_pushInt(int i) override;
+		void		_pushFloat(float f) override;
+		void		_pushBytes(int nBytes, char * pBytes) override;
+
+		void		_processChunks();
+		void		_processChunk(const char * pChunk, int bytes);
+
+		void		_writeKeyframe();
+		void		_streamSurface(GfxOutStream& out, uint16_t surfaceId, Surface * pSurface);
+		void		_writeIndex();
+		void		_write(int nBytes, const void * pData);
+		void		_writeInt(int value);
+		void		_writeInt64(int64_t value);
+
+		std::function<void(int nBytes, const void * pData)>	m_dispatcher;
+
+		GfxDevice_p			m_pShadowDevice;
+		GfxStreamPlug_p		m_pShadowPlug;
+		GfxStreamPlayer_p	m_pShadowPlayer;
+
+		int					m_keyframeInterval;
+		bool				m_bOpen;
+		bool				m_bKeyframePending;		// Keyframe to be written before next BeginRender.
+		int64_t				m_writeOfs;				// Bytes written to file so far.
+
+		std::vector<char>	m_pending;				// Data of incomplete chunk.
+
+		std::vector<int64_t>	m_frameOffsets;		// Offsets of all frames started, last one not yet completed.
+		std::vector<Keyframe>	m_keyframes;
+	};
+
+
+} // namespace wg
+#endif //WG_GFXSTREAMRECORDER_DOT_H
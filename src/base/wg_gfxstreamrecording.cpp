@@ -0,0 +1,379 @@
+/*=========================================================================
+
+                         >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+#include <cstring>
+
+#include <wg_gfxstreamrecording.h>
+#include <assert.h>
+
+namespace wg
+{
+
+	const char GfxStreamRecording::CLASSNAME[] = {"GfxStreamRecording"};
+
+	//____ create() ___________________________________________________________
+	/**
+	 * @brief Opens a recording made by GfxStreamRecorder for playback.
+	 *
+	 * The recording is read directly from the blob, which therefore needs to contain the
+	 * whole file. A recording that was never closed properly (like when the recording
+	 * application crashed) lacks its index, which then is rebuilt by scanning the stream.
+	 *
+	 * Use isValid() to check that the blob contained a recording.
+	 */
+
+	GfxStreamRecording_p GfxStreamRecording::create( Blob * pBlob )
+	{
+		return new GfxStreamRecording(pBlob);
+	}
+
+	//____ Constructor _____________________________________________________________
+
+	GfxStreamRecording::GfxStreamRecording( Blob * pBlob ) : stream(this)
+	{
+		m_pBlob = pBlob;
+		m_pData = pBlob ? (const char*) pBlob->data() : nullptr;
+
+		m_bValid = false;
+		m_bHasIndex = false;
+		m_bOpen = true;
+		m_keyframeInterval = 0;
+		m_streamBegin = 0;
+		m_streamEnd = 0;
+		m_readOfs = 0;
+
+		if (!pBlob || pBlob->size() < c_headerSize || _readInt(0) != c_fileMagic || _readInt(4) != c_version)
+			return;
+
+		m_canvasSize.w = _readInt(8);
+		m_canvasSize.h = _readInt(12);
+		m_keyframeInterval = _readInt(16);
+
+		m_streamBegin = c_headerSize;
+		m_readOfs = c_headerSize;
+
+		m_bHasIndex = _readIndex();
+		if (!m_bHasIndex)
+			_scanIndex();
+
+		m_bValid = true;
+	}
+
+	//____ Destructor _________________________________________________________
+
+	GfxStreamRecording::~GfxStreamRecording()
+	{
+	}
+
+	//____ isInstanceOf() _________________________________________________________
+
+	bool GfxStreamRecording::isInstanceOf( const char * pClassName ) const
+	{
+		if( pClassName==CLASSNAME )
+			return true;
+
+		return Object::isInstanceOf(pClassName);
+	}
+
+	//____ className() ____________________________________________________________
+
+	const char * GfxStreamRecording::className( void ) const
+	{
+		return CLASSNAME;
+	}
+
+	//____ cast() _________________________________________________________________
+
+	GfxStreamRecording_p GfxStreamRecording::cast( Object * pObject )
+	{
+		if( pObject && pObject->isInstanceOf(CLASSNAME) )
+			return GfxStreamRecording_p( static_cast<GfxStreamRecording*>(pObject) );
+
+		return 0;
+	}
+
+	//____ _hasChunk() ________________________________________________________
+
+	bool GfxStreamRecording::_hasChunk()
+	{
+		if (!m_bOpen || m_readOfs + 4 > m_streamEnd)
+			return false;
+
+		return m_readOfs + 4 + *(uint16_t*)&m_pData[m_readOfs + 2] <= m_streamEnd;
+	}
+
+	//____ _peekChunk() _______________________________________________________
+
+	GfxStream::Header GfxStreamRecording::_peekChunk()
+	{
+		return { (GfxChunkId)(*(short*)&m_pData[m_readOfs]), *(uint16_t*)&m_pData[m_readOfs + 2] };
+	}
+
+	//____ _pullChar() ________________________________________________________
+
+	char GfxStreamRecording::_pullChar()
+	{
+		return m_pData[m_readOfs++];
+	}
+
+	//____ _pullShort() _______________________________________________________
+
+	short GfxStreamRecording::_pullShort()
+	{
+		short x;
+		std::memcpy(&x, &m_pData[m_readOfs], 2);
+		m_readOfs += 2;
+		return x;
+	}
+
+	//____ _pullInt() _________________________________________________________
+
+	int GfxStreamRecording::_pullInt()
+	{
+		int x;
+		std::memcpy(&x, &m_pData[m_readOfs], 4);
+		m_readOfs += 4;
+		return x;
+	}
+
+	//____ _pullFloat() _______________________________________________________
+
+	float GfxStreamRecording::_pullFloat()
+	{
+		float x;
+		std::memcpy(&x, &m_pData[m_readOfs], 4);
+		m_readOfs += 4;
+		return x;
+	}
+
+	//____ _pullBytes() _______________________________________________________
+
+	void GfxStreamRecording::_pullBytes(int nBytes, char * pBytes)
+	{
+		std::memcpy(pBytes, &m_pData[m_readOfs], nBytes);
+		m_readOfs += nBytes;
+	}
+
+	//____ _skipBytes() _______________________________________________________
+
+	void GfxStreamRecording::_skipBytes(int nBytes)
+	{
+		if (nBytes <= 0)
+			return;											// Corrupt data, never move backwards.
+
+		m_readOfs = nBytes > m_streamEnd - m_readOfs ? m_streamEnd : m_readOfs + nBytes;
+	}
+
+	//____ _isStreamOpen() ____________________________________________________
+
+	bool GfxStreamRecording::_isStreamOpen()
+	{
+		return m_bOpen;
+	}
+
+	//____ _closeStream() _____________________________________________________
+
+	void GfxStreamRecording::_closeStream()
+	{
+		m_bOpen = false;
+	}
+
+	//____ _reopenStream() ____________________________________________________
+
+	bool GfxStreamRecording::_reopenStream()
+	{
+		if (!m_bValid)
+			return false;
+
+		m_bOpen = true;
+		return true;
+	}
+
+	//____ _seekKeyframe() ____________________________________________________
+
+	int GfxStreamRecording::_seekKeyframe(int frame)
+	{
+		if (!m_bValid || frame < 0 || (frame > 0 && frame >= (int) m_frameOffsets.size()) )
+			return -1;
+
+		// Find the last keyframe at or before frame. Start of stream
+		// works as an implicit keyframe for frame 0.
+
+		int keyframe = 0;
+		int64_t offset = m_streamBegin;
+
+		for (auto& kf : m_keyframes)
+		{
+			if (kf.frame > frame)
+				break;
+
+			keyframe = kf.frame;
+			offset = kf.offset;
+		}
+
+		if (offset < m_streamBegin || offset + 4 > m_streamEnd)
+			return -1;
+
+		m_readOfs = offset;
+		return keyframe;
+	}
+
+	//____ _readIndex() _______________________________________________________
+
+	bool GfxStreamRecording::_readIndex()
+	{
+		int64_t fileSize = m_pBlob->size();
+
+		if (fileSize < c_headerSize + c_trailerSize || _readInt(fileSize - 4) != c_indexMagic)
+			return false;
+
+		int64_t indexOfs = _readInt64(fileSize - c_trailerSize);
+		if (indexOfs < c_headerSize || indexOfs > fileSize - c_trailerSize - 8)
+			return false;
+
+		int64_t ofs = indexOfs;
+		int nFrames = _readInt(ofs);
+		ofs += 4;
+
+		if (nFrames < 0 || nFrames > (fileSize - c_trailerSize - 4 - ofs) / 8)
+			return false;
+
+		// Frames must start within the stream, in order.
+
+		m_frameOffsets.resize(nFrames);
+		for (int i = 0; i < nFrames; i++)
+		{
+			int64_t frameOfs = _readInt64(ofs + i * 8);
+			if (frameOfs < m_streamBegin || frameOfs >= indexOfs || (i > 0 && frameOfs < m_frameOffsets[i-1]))
+			{
+				m_frameOffsets.clear();
+				return false;
+			}
+			m_frameOffsets[i] = frameOfs;
+		}
+		ofs += int64_t(nFrames) * 8;
+
+		int nKeyframes = _readInt(ofs);
+		ofs += 4;
+
+		if (nKeyframes < 0 || nKeyframes > (fileSize - c_trailerSize - ofs) / 12)
+		{
+			m_frameOffsets.clear();
+			return false;
+		}
+
+		// Keyframes must be in order and point at a BeginKeyframe chunk within the stream.
+
+		m_keyframes.resize(nKeyframes);
+		for (int i = 0; i < nKeyframes; i++)
+		{
+			int frame = _readInt(ofs + i * 12);
+			int64_t offset = _readInt64(ofs + i * 12 + 4);
+
+			if (frame < 0 || frame >= nFrames || (i > 0 && frame <= m_keyframes[i-1].frame) ||
+				offset < m_streamBegin || offset + 4 > indexOfs ||
+				*(uint16_t*)&m_pData[offset] != (uint16_t) GfxChunkId::BeginKeyframe)
+			{
+				m_frameOffsets.clear();
+				m_keyframes.clear();
+				return false;
+			}
+
+			m_keyframes[i].frame = frame;
+			m_keyframes[i].offset = offset;
+		}
+
+		m_streamEnd = indexOfs;
+		return true;
+	}
+
+	//____ _scanIndex() _______________________________________________________
+
+	void GfxStreamRecording::_scanIndex()
+	{
+		// No index, recording wasn't closed properly. We build the index ourselves
+		// and ignore any incomplete frame at the end.
+
+		m_streamEnd = m_pBlob->size();
+
+		int64_t ofs = m_streamBegin;
+		int64_t frameBegin = ofs;
+		int64_t lastComplete = ofs;
+
+		while (ofs + 4 <= m_streamEnd)
+		{
+			GfxChunkId type = (GfxChunkId) *(uint16_t*)&m_pData[ofs];
+			int size = *(uint16_t*)&m_pData[ofs + 2];
+
+			if (ofs + 4 + size > m_streamEnd)
+				break;
+
+			if (type == GfxChunkId::BeginKeyframe && size >= 8)
+			{
+				// Keyframe content always ends with an EndKeyframe chunk, so anything
+				// shorter than that means the data is corrupt.
+
+				int bytes = _readInt(ofs + 8);
+				if (bytes < 4 || bytes > m_streamEnd - (ofs + 4 + size))
+					break;
+
+				m_keyframes.push_back({ (int) m_frameOffsets.size(), ofs });
+				ofs += bytes;
+			}
+
+			ofs += 4 + size;
+
+			if (type == GfxChunkId::EndRender)
+			{
+				m_frameOffsets.push_back(frameBegin);
+				frameBegin = ofs;
+				lastComplete = ofs;
+			}
+		}
+
+		m_streamEnd = lastComplete;
+
+		// Drop a keyframe belonging to a frame that was never completed.
+
+		while (!m_keyframes.empty() && m_keyframes.back().offset >= m_streamEnd)
+			m_keyframes.pop_back();
+	}
+
+	//____ _readInt() _________________________________________________________
+
+	int GfxStreamRecording::_readInt(int64_t ofs) const
+	{
+		int x;
+		std::memcpy(&x, &m_pData[ofs], 4);
+		return x;
+	}
+
+	//____ _readInt64() _______________________________________________________
+
+	int64_t GfxStreamRecording::_readInt64(int64_t ofs) const
+	{
+		int64_t x;
+		std::memcpy(&x, &m_pData[ofs], 8);
+		return x;
+	}
+
+} // namespace wg
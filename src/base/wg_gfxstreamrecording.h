@@ -0,0 +1,136 @@
+/*=========================================================================
+
+                         >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+#ifndef	WG_GFXSTREAMRECORDING_DOT_H
+#define	WG_GFXSTREAMRECORDING_DOT_H
+#pragma once
+
+#include <wg_types.h>
+#include <wg_object.h>
+#include <wg_pointers.h>
+#include <wg_blob.h>
+#include <wg_geo.h>
+#include <wg_gfxinstream.h>
+
+#include <vector>
+
+namespace wg
+{
+
+	class GfxStreamRecording;
+	typedef	StrongPtr<GfxStreamRecording>	GfxStreamRecording_p;
+	typedef	WeakPtr<GfxStreamRecording>		GfxStreamRecording_wp;
+
+	class GfxStreamRecording : public Object, protected GfxInStreamHolder
+	{
+	public:
+
+		//.____ Creation __________________________________________
+
+		static GfxStreamRecording_p	create( Blob * pBlob );
+
+		//.____ Interfaces _______________________________________
+
+		GfxInStream		stream;
+
+		//.____ Identification __________________________________________
+
+		bool				isInstanceOf(const char * pClassName) const;
+		const char *		className(void) const;
+		static const char	CLASSNAME[];
+		static GfxStreamRecording_p	cast(Object * pObject);
+
+		//.____ Content _______________________________________________________
+
+		inline bool		isValid() const { return m_bValid; }
+		inline bool		hasIndex() const { return m_bHasIndex; }
+
+		inline Size		canvasSize() const { return m_canvasSize; }
+		inline int		keyframeInterval() const { return m_keyframeInterval; }
+
+		inline int		frames() const { return (int) m_frameOffsets.size(); }
+		inline int		keyframes() const { return (int) m_keyframes.size(); }
+
+		//.____ File format ___________________________________________________
+
+		const static int	c_fileMagic = 0x52534757;		// "WGSR" in little endian.
+		const static int	c_indexMagic = 0x49534757;		// "WGSI" in little endian.
+		const static int	c_version = 2;
+
+		const static int	c_headerSize = 20;				// magic, version, canvas width, canvas height, keyframe interval.
+		const static int	c_trailerSize = 12;				// 64-bit index offset, index magic.
+
+	protected:
+
+		GfxStreamRecording( Blob * pBlob );
+		~GfxStreamRecording();
+
+		struct Keyframe
+		{
+			int			frame;
+			int64_t		offset;
+		};
+
+		Object * _object() override { return this; }
+
+		bool		_hasChunk() override;
+		GfxStream::Header	_peekChunk() override;
+		char		_pullChar() override;
+		short		_pullShort() override;
+		int			_pullInt() override;
+		float		_pullFloat() override;
+		void		_pullBytes(int nBytes, char * pBytes) override;
+		void		_skipBytes(int nBytes) override;
+
+		bool		_isStreamOpen() override;
+		bool		_reopenStream() override;
+		void		_closeStream() override;
+
+		int			_seekKeyframe(int frame) override;
+
+		bool		_readIndex();
+		void		_scanIndex();
+		int			_readInt(int64_t ofs) const;
+		int64_t		_readInt64(int64_t ofs) const;
+
+		Blob_p		m_pBlob;
+		const char*	m_pData;
+
+		bool		m_bValid;
+		bool		m_bHasIndex;
+		bool		m_bOpen;
+
+		Size		m_canvasSize;
+		int			m_keyframeInterval;
+
+		int64_t		m_streamBegin;
+		int64_t		m_streamEnd;
+		int64_t		m_readOfs;
+
+		std::vector<int64_t>	m_frameOffsets;
+		std::vector<Keyframe>	m_keyframes;
+	};
+
+
+
+} // namespace wg
+#endif //WG_GFXSTREAMRECORDING_DOT_H
@@ -0,0 +1,267 @@
+/*=========================================================================
+
+                         >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+#include <wg_gfxstreamstatistics.h>
+
+#include <string.h>
+
+namespace wg
+{
+
+	const char GfxStreamStatistics::CLASSNAME[] = { "GfxStreamStatistics" };
+
+
+	//____ create() ___________________________________________________________
+
+	GfxStreamStatistics_p GfxStreamStatistics::create(GfxInStream& in)
+	{
+		return new GfxStreamStatistics(in);
+	}
+
+	//____ Constructor _____________________________________________________________
+
+	GfxStreamStatistics::GfxStreamStatistics(GfxInStream& in)
+	{
+		m_pGfxStream = in.ptr();
+		reset();
+	}
+
+	//____ Destructor _________________________________________________________
+
+	GfxStreamStatistics::~GfxStreamStatistics()
+	{
+	}
+
+	//____ isInstanceOf() _________________________________________________________
+
+	bool GfxStreamStatistics::isInstanceOf(const char * pClassName) const
+	{
+		if (pClassName == CLASSNAME)
+			return true;
+
+		return Object::isInstanceOf(pClassName);
+	}
+
+	//____ className() ____________________________________________________________
+
+	const char * GfxStreamStatistics::className(void) const
+	{
+		return CLASSNAME;
+	}
+
+	//____ cast() _________________________________________________________________
+
+	GfxStreamStatistics_p GfxStreamStatistics::cast(Object * pObject)
+	{
+		if (pObject && pObject->isInstanceOf(CLASSNAME))
+			return GfxStreamStatistics_p(static_cast<GfxStreamStatistics*>(pObject));
+
+		return 0;
+	}
+
+	//____ isEmpty() __________________________________________________________
+
+	bool GfxStreamStatistics::isEmpty() const
+	{
+		return m_pGfxStream->isEmpty();
+	}
+
+	//____ processAll() _______________________________________________________
+
+	/**
+	 * @brief Consume all chunks currently available in the stream.
+	 *
+	 * Counterpart of GfxStreamLogger::logAll(), but only updates the counters.
+	 * Connect it to an output of a GfxStreamPlug and call this regularly to keep
+	 * track of a live stream.
+	 */
+
+	void GfxStreamStatistics::processAll()
+	{
+		while (processChunk() == true);
+	}
+
+	//____ processChunk() _____________________________________________________
+
+	/**
+	 * @brief Consume the next chunk of the stream.
+	 *
+	 * Only the few bytes needed to calculate covered areas are read from drawing
+	 * chunks, the rest of the chunk is skipped.
+	 *
+	 * @return False if the stream is out of data.
+	 */
+
+	bool GfxStreamStatistics::processChunk()
+	{
+		GfxStream::Header header;
+
+		*m_pGfxStream >> header;
+
+		if (header.type == GfxChunkId::OutOfData)
+			return false;
+
+		int		bytes = 4 + header.size;
+		int		bytesRead = 0;
+
+		int64_t	fillArea = 0;
+		int64_t	blitArea = 0;
+		int		uploadBytes = 0;
+
+		switch (header.type)
+		{
+			case GfxChunkId::Fill:
+			{
+				Rect	rect;
+				*m_pGfxStream >> rect;
+				bytesRead = 8;
+				fillArea = rect.w * rect.h;
+				break;
+			}
+
+			case GfxChunkId::FillSubPixel:
+			{
+				RectF	rect;
+				*m_pGfxStream >> rect;
+				bytesRead = 16;
+				fillArea = (int64_t)(rect.w * rect.h + 0.5f);
+				break;
+			}
+
+			case GfxChunkId::ClipDrawSegments:
+			{
+				Rect	clip;
+				Rect	dest;
+				*m_pGfxStream >> clip;
+				*m_pGfxStream >> dest;
+				bytesRead = 16;
+
+				Rect	area(clip, dest);
+				fillArea = area.w * area.h;
+				break;
+			}
+
+			case GfxChunkId::Blit:
+			{
+				uint16_t	surfaceId;
+				Rect		source;
+				*m_pGfxStream >> surfaceId;
+				*m_pGfxStream >> source;
+				bytesRead = 10;
+				blitArea = source.w * source.h;
+				break;
+			}
+
+			case GfxChunkId::StretchBlit:
+			{
+				uint16_t	surfaceId;
+				RectF		source;
+				Rect		dest;
+				*m_pGfxStream >> surfaceId;
+				*m_pGfxStream >> source;
+				*m_pGfxStream >> dest;
+				bytesRead = 26;
+				blitArea = dest.w * dest.h;
+				break;
+			}
+
+			case GfxChunkId::SurfaceData:
+				uploadBytes = header.size;
+				break;
+
+			default:
+				break;
+		}
+
+		m_pGfxStream->skip(header.size - bytesRead);
+
+		// Update the counters
+
+		Counters * counters[2] = { &m_frame, &m_total };
+
+		for (Counters * p : counters)
+		{
+			p->chunks++;
+			p->bytes += bytes;
+
+			if (header.type <= GfxChunkId_max)
+			{
+				p->chunkCount[(int)header.type]++;
+				p->chunkBytes[(int)header.type] += bytes;
+			}
+
+			if (header.type == GfxChunkId::BeginSurfaceUpdate)
+				p->surfaceUpdates++;
+
+			p->uploadBytes += uploadBytes;
+			p->fillArea += fillArea;
+			p->blitArea += blitArea;
+		}
+
+		if (header.type == GfxChunkId::EndRender)
+		{
+			m_lastFrame = m_frame;
+			_clear(m_frame);
+			m_frames++;
+		}
+
+		return true;
+	}
+
+	//____ processFrame() _____________________________________________________
+
+	/**
+	 * @brief Consume chunks up to and including the next EndRender.
+	 *
+	 * @return True if a frame was completed, false if the stream ran out of data first.
+	 */
+
+	bool GfxStreamStatistics::processFrame()
+	{
+		int frames = m_frames;
+
+		while (processChunk() == true)
+		{
+			if (m_frames != frames)
+				return true;
+		}
+		return false;
+	}
+
+	//____ reset() ____________________________________________________________
+
+	void GfxStreamStatistics::reset()
+	{
+		m_frames = 0;
+		_clear(m_total);
+		_clear(m_lastFrame);
+		_clear(m_frame);
+	}
+
+	//____ _clear() ___________________________________________________________
+
+	void GfxStreamStatistics::_clear(Counters& counters)
+	{
+		memset(&counters, 0, sizeof(Counters));
+	}
+
+} //namespace wg
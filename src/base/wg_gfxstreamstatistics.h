@@ -0,0 +1,102 @@
+/*=========================================================================
+
+                         >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+#ifndef	WG_GFXSTREAMSTATISTICS_DOT_H
+#define	WG_GFXSTREAMSTATISTICS_DOT_H
+#pragma once
+
+#include <wg_types.h>
+#include <wg_enumextras.h>
+#include <wg_object.h>
+#include <wg_gfxinstream.h>
+
+namespace wg
+{
+
+	class GfxStreamStatistics;
+	typedef	StrongPtr<GfxStreamStatistics>	GfxStreamStatistics_p;
+	typedef	WeakPtr<GfxStreamStatistics>	GfxStreamStatistics_wp;
+
+	//____ GfxStreamStatistics ________________________________________________
+
+	class GfxStreamStatistics : public Object
+	{
+	public:
+
+		struct Counters
+		{
+			int			chunks;								// Number of chunks.
+			int64_t		bytes;								// Size of all chunks, including chunk headers.
+			int			chunkCount[GfxChunkId_size];		// Number of chunks per GfxChunkId.
+			int64_t		chunkBytes[GfxChunkId_size];		// Size of chunks per GfxChunkId, including chunk headers.
+			int			surfaceUpdates;						// Number of BeginSurfaceUpdate chunks.
+			int64_t		uploadBytes;						// Pixel data sent in SurfaceData chunks.
+			int64_t		fillArea;							// Pixels covered by Fill, FillSubPixel and ClipDrawSegments chunks.
+			int64_t		blitArea;							// Pixels covered by Blit and StretchBlit chunks.
+		};
+
+		//.____ Creation __________________________________________
+
+		static GfxStreamStatistics_p	create( GfxInStream& in );
+
+		//.____ Identification __________________________________________
+
+		bool				isInstanceOf(const char * pClassName) const;
+		const char *		className(void) const;
+		static const char	CLASSNAME[];
+		static GfxStreamStatistics_p	cast(Object * pObject);
+
+		//.____ Control _______________________________________________________
+
+		bool		isEmpty() const;
+
+		void		processAll();
+		bool		processChunk();
+		bool		processFrame();
+
+		void		reset();
+
+		//.____ State _________________________________________________________
+
+		inline int				frames() const { return m_frames; }
+
+		inline const Counters&	total() const { return m_total; }
+		inline const Counters&	lastFrame() const { return m_lastFrame; }
+		inline const Counters&	currentFrame() const { return m_frame; }
+
+	protected:
+		GfxStreamStatistics( GfxInStream& in );
+		~GfxStreamStatistics();
+
+		void			_clear(Counters& counters);
+
+		GfxInStream_p	m_pGfxStream;
+
+		int				m_frames;
+		Counters		m_total;				// All chunks processed.
+		Counters		m_lastFrame;			// Last frame completed by an EndRender chunk.
+		Counters		m_frame;				// Chunks processed since last EndRender.
+	};
+
+}
+
+#endif // WG_GFXSTREAMSTATISTICS_DOT_H
@@ -0,0 +1,140 @@
+/*=========================================================================
+
+                         >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+#include <algorithm>
+
+#include <wg_layoutqueue.h>
+#include <wg_container.h>
+
+namespace wg 
+{
+	/**
+	 * @class LayoutQueue
+	 * @brief Queue of widgets with deferred layout work.
+	 *
+	 * Resize requests from widgets and layout updates of panels are not carried out
+	 * immediately, but collected in the LayoutQueue owned by Base and handled together
+	 * when the queue is flushed. This is done by RootPanel before rendering and before
+	 * looking up widgets by coordinate, but can also be triggered through flush().
+	 *
+	 * Widgets are handled deepest first, so a panel whose children have requested resize
+	 * many times since the last flush only needs to update its layout once.
+	 */
+
+	//____ Constructor ____________________________________________________________
+
+	LayoutQueue::LayoutQueue() : m_bFlushing(false)
+	{
+	}
+
+	//____ add() __________________________________________________________________
+
+	void LayoutQueue::add( Widget * pWidget )
+	{
+		if( pWidget->m_layoutQueuePos >= 0 )
+			return;
+
+		pWidget->m_layoutQueuePos = (int) m_entries.size();
+		m_entries.push_back( pWidget );
+	}
+
+	//____ remove() _______________________________________________________________
+
+	void LayoutQueue::remove( Widget * pWidget )
+	{
+		int pos = pWidget->m_layoutQueuePos;
+		if( pos < 0 )
+			return;
+
+		m_entries[pos] = nullptr;
+		pWidget->m_layoutQueuePos = -1;
+	}
+
+	//____ flush() ________________________________________________________________
+	/**
+	 * @brief Perform all pending layout updates and resize requests.
+	 *
+	 * Handling a widget can make its parent request a layout update or resize in
+	 * turn. These are handled in the same flush, so the queue is empty when the
+	 * call returns.
+	 */
+
+	void LayoutQueue::flush()
+	{
+		if( m_bFlushing )
+			return;
+
+		m_bFlushing = true;
+
+		int beg = 0;
+		while( beg < (int) m_entries.size() )
+		{
+			int end = (int) m_entries.size();
+			_sortByDepth( beg, end );
+
+			for( int i = beg ; i < end ; i++ )
+			{
+				Widget * pWidget = m_entries[i];
+				if( pWidget )
+					pWidget->_flushLayout();
+			}
+			beg = end;
+		}
+
+		m_entries.clear();
+		m_bFlushing = false;
+	}
+
+	//____ _sortByDepth() _________________________________________________________
+
+	void LayoutQueue::_sortByDepth( int beg, int end )
+	{
+		std::vector<std::pair<int,Widget*>> sorted;
+		sorted.reserve( end - beg );
+
+		for( int i = beg ; i < end ; i++ )
+		{
+			Widget * pWidget = m_entries[i];
+			if( !pWidget )
+				continue;
+
+			int depth = 0;
+			for( Widget * p = pWidget->_parent() ; p != nullptr ; p = p->_parent() )
+				depth++;
+
+			sorted.push_back( std::make_pair( -depth, pWidget ) );
+		}
+
+		std::stable_sort( sorted.begin(), sorted.end(), [](const std::pair<int,Widget*>& a, const std::pair<int,Widget*>& b) { return a.first < b.first; } );
+
+		int pos = beg;
+		for( auto& entry : sorted )
+		{
+			m_entries[pos] = entry.second;
+			entry.second->m_layoutQueuePos = pos;
+			pos++;
+		}
+		while( pos < end )
+			m_entries[pos++] = nullptr;
+	}
+
+} // namespace wg
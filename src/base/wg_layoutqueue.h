@@ -0,0 +1,62 @@
+/*=========================================================================
+
+                         >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+#ifndef WG_LAYOUTQUEUE_DOT_H
+#define WG_LAYOUTQUEUE_DOT_H
+#pragma once
+
+#include <vector>
+
+namespace wg 
+{
+	class Widget;
+
+	//____ LayoutQueue ____________________________________________________________
+
+	class LayoutQueue
+	{
+	public:
+		//.____ Creation __________________________________________
+
+		LayoutQueue();
+		~LayoutQueue() {}
+
+		//.____ Control _______________________________________________________
+
+		void	add( Widget * pWidget );
+		void	remove( Widget * pWidget );
+		void	flush();
+
+		//.____ State _______________________________________________________
+
+		inline bool	isEmpty() const { return m_entries.empty(); }
+		inline bool	isFlushing() const { return m_bFlushing; }
+
+	private:
+		void	_sortByDepth( int beg, int end );
+
+		std::vector<Widget*>	m_entries;			// Widgets with pending requests, nullptr for removed ones.
+		bool					m_bFlushing;
+	};
+	
+
+} // namespace wg
+#endif //WG_LAYOUTQUEUE_DOT_H
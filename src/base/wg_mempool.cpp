@@ -1,6 +1,7 @@
 
 #include <wg_mempool.h>
 #include <stdlib.h>
+#include <thread>
 
 namespace wg 
 {
@@ -86,6 +87,158 @@ namespace wg
 		return pBlock;
 	}
 	
+	//____ AtomicMemPool::Constructor ____________________________________________
+
+	AtomicMemPool::AtomicMemPool( int entriesPerBlock, int entrySize, int maxBlocks )
+	{
+		m_nEntriesPerBlock	= entriesPerBlock;
+		m_entrySize			= entrySize < (int) sizeof(uint32_t) ? (int) sizeof(uint32_t) : entrySize;
+		m_maxBlocks			= maxBlocks;
+		m_pBlocks			= new uint8_t*[maxBlocks];
+
+		m_freeStack			= c_noEntry;
+		m_nAllocEntries		= 0;
+		m_nBlocks			= 0;
+		m_bAddingBlock		= false;
+	}
+
+	//____ AtomicMemPool::Destructor _____________________________________________
+
+	AtomicMemPool::~AtomicMemPool()
+	{
+		for( int i = 0 ; i < m_nBlocks ; i++ )
+			free( m_pBlocks[i] );
+		delete [] m_pBlocks;
+	}
+
+	//____ AtomicMemPool::allocEntry() ____________________________________________
+
+	void * AtomicMemPool::allocEntry()
+	{
+		uint64_t head = m_freeStack.load( std::memory_order_acquire );
+
+		while( true )
+		{
+			uint32_t index = (uint32_t) head;
+
+			if( index == c_noEntry )
+			{
+				// Stack is empty, add a block (or wait for another thread to do so) and try again.
+
+				if( !_addBlock() )
+					return nullptr;
+
+				head = m_freeStack.load( std::memory_order_acquire );
+				continue;
+			}
+
+			// Entries are never released back to the system, so reading the next index
+			// is safe even if another thread just popped the entry. The tag makes the
+			// CAS fail in that case.
+
+			uint32_t next = * (uint32_t*) _entry(index);
+			uint64_t newHead = ((head & 0xFFFFFFFF00000000ULL) + 0x100000000ULL) | next;
+
+			if( m_freeStack.compare_exchange_weak( head, newHead, std::memory_order_acq_rel, std::memory_order_acquire ) )
+			{
+				m_nAllocEntries++;
+				return _entry(index);
+			}
+		}
+	}
+
+	//____ AtomicMemPool::freeEntry() _____________________________________________
+
+	void AtomicMemPool::freeEntry( void * pEntry )
+	{
+		if( pEntry == 0 )
+			return;
+
+		uint32_t index = _index( pEntry );
+		if( index == c_noEntry )
+			return;								// ERROR!!! ENTRY HAS NOT BEEN RESERVED THROUGH US!!!!!!!!!!
+
+		_pushChain( index, index );
+		m_nAllocEntries--;
+	}
+
+	//____ AtomicMemPool::_index() ________________________________________________
+
+	uint32_t AtomicMemPool::_index( void * pEntry ) const
+	{
+		int nBlocks = m_nBlocks.load( std::memory_order_acquire );
+		int blockSize = m_nEntriesPerBlock*m_entrySize;
+
+		for( int i = nBlocks-1 ; i >= 0 ; i-- )
+		{
+			uint8_t * pBlock = m_pBlocks[i];
+			if( pEntry >= pBlock && pEntry < pBlock + blockSize )
+				return (uint32_t) (i*m_nEntriesPerBlock + (((uint8_t*)pEntry) - pBlock) / m_entrySize);
+		}
+		return c_noEntry;
+	}
+
+	//____ AtomicMemPool::_pushChain() ____________________________________________
+
+	void AtomicMemPool::_pushChain( uint32_t first, uint32_t last )
+	{
+		uint64_t head = m_freeStack.load( std::memory_order_acquire );
+		uint64_t newHead;
+		do
+		{
+			* (uint32_t*) _entry(last) = (uint32_t) head;
+			newHead = ((head & 0xFFFFFFFF00000000ULL) + 0x100000000ULL) | first;
+		}
+		while( !m_freeStack.compare_exchange_weak( head, newHead, std::memory_order_acq_rel, std::memory_order_acquire ) );
+	}
+
+	//____ AtomicMemPool::_addBlock() _____________________________________________
+
+	bool AtomicMemPool::_addBlock()
+	{
+		// Only one thread adds a block at a time, others just yield and retry.
+
+		bool bExpected = false;
+		if( !m_bAddingBlock.compare_exchange_strong( bExpected, true, std::memory_order_acq_rel ) )
+		{
+			std::this_thread::yield();			// Give the adding thread a chance to finish before we retry.
+			return true;
+		}
+
+		if( (uint32_t) m_freeStack.load( std::memory_order_acquire ) != c_noEntry )
+		{
+			m_bAddingBlock = false;				// Someone freed an entry while we got here.
+			return true;
+		}
+
+		int block = m_nBlocks.load( std::memory_order_relaxed );
+		if( block == m_maxBlocks )
+		{
+			m_bAddingBlock = false;
+			return false;
+		}
+
+		uint8_t * pBlock = (uint8_t*) malloc( m_nEntriesPerBlock*m_entrySize );
+		if( !pBlock )
+		{
+			m_bAddingBlock = false;				// Out of memory, let next caller try again.
+			return false;
+		}
+		m_pBlocks[block] = pBlock;
+
+		uint32_t first = block*m_nEntriesPerBlock;
+		uint32_t last = first + m_nEntriesPerBlock - 1;
+
+		for( int i = 0 ; i < m_nEntriesPerBlock - 1 ; i++ )
+			* (uint32_t*) (pBlock + i*m_entrySize) = first + i + 1;
+
+		m_nBlocks.store( block+1, std::memory_order_release );
+		_pushChain( first, last );
+
+		m_bAddingBlock = false;
+		return true;
+	}
+
 	//____ Block::Constructor _____________________________________________________
 	
 	MemPool::Block::Block( int _nEntries, int _entrySize )
@@ -27,6 +27,8 @@
 #include <wg_types.h>
 #include <wg_chain.h>
 
+#include <atomic>
+
 namespace wg 
 {
 	
@@ -90,6 +92,52 @@ namespace wg
 	};
 	
 	
+	//____ AtomicMemPool ______________________________________________________
+	/**
+	 * @brief Lock-free version of MemPool, allowing allocations from multiple threads.
+	 *
+	 * Free entries are kept in a lock-free stack, indexed by entry number and tagged
+	 * to avoid the ABA-problem. Blocks are never released until the pool is destroyed,
+	 * so the number of entries allocated at once is limited to maxBlocks*entriesPerBlock.
+	 */
+
+	class AtomicMemPool
+	{
+	public:
+		//.____ Creation __________________________________________
+
+		AtomicMemPool( int entriesPerBlock, int entrySize, int maxBlocks = 1024 );
+		virtual ~AtomicMemPool();
+
+		//.____ Misc _______________________________________________________
+
+		void *	allocEntry();
+		void	freeEntry( void * pEntry );
+	
+		inline int		entriesAllocated() const { return m_nAllocEntries; }
+		inline int		capacity() const { return m_nBlocks*m_nEntriesPerBlock; }
+		inline bool		isEmpty() const { return (m_nAllocEntries == 0); }
+
+	private:
+		const static uint32_t	c_noEntry = 0xFFFFFFFF;
+
+		inline uint8_t * 	_entry( uint32_t index ) const { return m_pBlocks[index / m_nEntriesPerBlock] + (index % m_nEntriesPerBlock) * m_entrySize; }
+		uint32_t			_index( void * pEntry ) const;
+		bool				_addBlock();
+		void				_pushChain( uint32_t first, uint32_t last );
+
+		std::atomic<uint64_t>	m_freeStack;		// Tag in upper 32 bits, index of first free entry in lower.
+		std::atomic<int>		m_nAllocEntries;
+		std::atomic<int>		m_nBlocks;
+		std::atomic<bool>		m_bAddingBlock;
+
+		uint8_t **		m_pBlocks;
+		int				m_maxBlocks;
+		int				m_nEntriesPerBlock;
+		int				m_entrySize;
+	};
+	
+	
 	
 	
 
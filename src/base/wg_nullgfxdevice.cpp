@@ -134,6 +134,10 @@ namespace wg
 	{
 	}
 
+	void NullGfxDevice::clipDrawSegments(const Rect& clip, const Rect& dest, int nEdgeStrips, const int * pEdgeStrips, const Color * pSegmentColors)
+	{
+	}
+
 	void NullGfxDevice::_drawStraightLine(Coord start, Orientation orientation, int _length, const Color& _col)
 	{
 	}
@@ -78,6 +78,7 @@ namespace wg
 		void	clipDrawLine( const Rect& clip, Coord begin, Coord end, Color color, float thickness = 1.f );
 
 		void	clipDrawHorrWave(const Rect&clip, Coord begin, int length, const WaveLine * pTopLine, const WaveLine * pBottomLine, Color front, Color back);
+		void	clipDrawSegments(const Rect& clip, const Rect& dest, int nEdgeStrips, const int * pEdgeStrips, const Color * pSegmentColors);
 
 	protected:
 		NullGfxDevice( Size size );
@@ -55,9 +55,7 @@ namespace wg
 	{
 		if( pHub )
 		{
-			pHub->refCnt--;
-	
-			if( pHub->refCnt == 0 && !pHub->pFinalizer )
+			if( --pHub->refCnt == 0 && !pHub->pFinalizer )
 			{
 				if( pHub->pObj )
 					pHub->pObj->m_pWeakPtrHub = nullptr;
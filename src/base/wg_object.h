@@ -23,8 +23,13 @@
 #define WG_OBJECT_DOT_H
 #pragma once
 
+#include <wg_userdefines.h>
 #include <wg_strongptr.h>
 
+#ifdef WG_ATOMIC_REFCOUNT
+#	include <atomic>
+#endif
+
 namespace wg 
 {
 	
@@ -34,10 +39,16 @@ namespace wg
 	
 	typedef	void(*Finalizer_p)(Object*);
 
+#ifdef WG_ATOMIC_REFCOUNT
+	typedef std::atomic<int>	RefCount;
+#else
+	typedef int					RefCount;
+#endif
+
 	class WeakPtrHub		/** @private */
 	{
 	public:
-		int				refCnt;
+		RefCount		refCnt;
 		Object *		pObj;
 		Finalizer_p		pFinalizer;
 
@@ -95,16 +106,16 @@ namespace wg
 		virtual ~Object() {};
 	
 		inline void _incRefCount() { m_refCount++; }
-		inline void _decRefCount() { m_refCount--; if( m_refCount == 0 ) _destroy(); }
+		inline void _decRefCount() { if( --m_refCount == 0 ) _destroy(); }
 
 		inline void _incRefCount(int amount) { m_refCount += amount; }
-		inline void _decRefCount(int amount) { m_refCount -= amount; if( m_refCount == 0 ) _destroy(); }
+		inline void _decRefCount(int amount) { if( (m_refCount -= amount) == 0 ) _destroy(); }
 	
 		WeakPtrHub *	m_pWeakPtrHub;
 	
 	private:
 		virtual void 	_destroy();			// Pointers should call destroy instead of destructor.
-		int				m_refCount;
+		RefCount		m_refCount;
 	};
 	
 	
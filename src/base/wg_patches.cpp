@@ -436,6 +436,17 @@ namespace wg
 		return Rect(x1,y1,x2-x1,y2-y1);
 	}
 	
+	//____ area() ___________________________________________________________________
+
+	int Patches::area() const
+	{
+		int area = 0;
+		for( int i = 0 ; i < m_size ; i++ )
+			area += m_pFirst[i].w * m_pFirst[i].h;
+
+		return area;
+	}
+
 	//____ repair() ________________________________________________________________
 	
 	int Patches::repair()
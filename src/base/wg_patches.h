@@ -64,6 +64,7 @@ namespace wg
 
 		void			clip( const Rect& clip );
 		Rect			getUnion() const;
+		int				area() const;														// Total area of all patches, overlap is counted twice.
 	
 		int				repair();															// Fixes any overlap that might have resulted from push()
 		int				optimize();															// Combines small patches into larger ones where possible
@@ -0,0 +1,310 @@
+/*=========================================================================
+
+                         >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+#include <string.h>
+
+#include <wg_pixelconverter.h>
+
+namespace wg 
+{
+	/**
+	 * @class PixelConverter
+	 * @brief Converts blocks of pixels between PixelFormats.
+	 *
+	 * Each supported PixelFormat has a kernel unpacking a row of pixels to BGRA_8 and
+	 * (except for I8) a kernel packing a row of BGRA_8 pixels into the format. Conversions
+	 * to or from BGRA_8 are done directly by one kernel, other pairs go through a small
+	 * BGRA_8 buffer that stays in cache.
+	 *
+	 * The kernels work on one channel layout each without table lookups or branches, so
+	 * the compiler can vectorize them. Channels are expanded and truncated exactly as
+	 * by the generic conversion in Surface, missing channels are set to full value.
+	 *
+	 * Custom and Unknown formats are not supported and conversions to I8 only between
+	 * identical formats.
+	 */
+
+	typedef void (*UnpackFunc)( const uint8_t * pSrc, uint32_t * pDst, int nPixels, const uint32_t * pCLUT );
+	typedef void (*PackFunc)( const uint32_t * pSrc, uint8_t * pDst, int nPixels );
+
+	//____ Unpack kernels _________________________________________________________
+
+	static void _unpack_BGR_8( const uint8_t * pSrc, uint32_t * pDst, int nPixels, const uint32_t * pCLUT )
+	{
+		for( int i = 0 ; i < nPixels ; i++ )
+			pDst[i] = uint32_t(pSrc[i*3]) | (uint32_t(pSrc[i*3+1]) << 8) | (uint32_t(pSrc[i*3+2]) << 16) | 0xFF000000;
+	}
+
+	static void _unpack_BGRX_8( const uint8_t * pSrc, uint32_t * pDst, int nPixels, const uint32_t * pCLUT )
+	{
+		const uint32_t * p = (const uint32_t*) pSrc;
+		for( int i = 0 ; i < nPixels ; i++ )
+			pDst[i] = p[i] | 0xFF000000;
+	}
+
+	static void _unpack_BGRA_8( const uint8_t * pSrc, uint32_t * pDst, int nPixels, const uint32_t * pCLUT )
+	{
+		memcpy( pDst, pSrc, nPixels*4 );
+	}
+
+	static void _unpack_BGRA_4( const uint8_t * pSrc, uint32_t * pDst, int nPixels, const uint32_t * pCLUT )
+	{
+		// Spread the nibbles to one byte each, multiplying by 17 then expands them to 8 bits.
+
+		const uint16_t * p = (const uint16_t*) pSrc;
+		for( int i = 0 ; i < nPixels ; i++ )
+		{
+			uint32_t v = p[i];
+			pDst[i] = ((v & 0xF) | ((v & 0xF0) << 4) | ((v & 0xF00) << 8) | ((v & 0xF000) << 12)) * 17;
+		}
+	}
+
+	static void _unpack_BGR_565( const uint8_t * pSrc, uint32_t * pDst, int nPixels, const uint32_t * pCLUT )
+	{
+		// Multiply and shift gives the same results as pixelConvTab_32 and pixelConvTab_64.
+
+		const uint16_t * p = (const uint16_t*) pSrc;
+		for( int i = 0 ; i < nPixels ; i++ )
+		{
+			uint32_t v = p[i];
+			uint32_t b = ((v & 0x1F) * 1053) >> 7;
+			uint32_t g = (((v >> 5) & 0x3F) * 4145) >> 10;
+			uint32_t r = ((v >> 11) * 1053) >> 7;
+			pDst[i] = b | (g << 8) | (r << 16) | 0xFF000000;
+		}
+	}
+
+	static void _unpack_I8( const uint8_t * pSrc, uint32_t * pDst, int nPixels, const uint32_t * pCLUT )
+	{
+		for( int i = 0 ; i < nPixels ; i++ )
+			pDst[i] = pCLUT[pSrc[i]];
+	}
+
+	static void _unpack_A8( const uint8_t * pSrc, uint32_t * pDst, int nPixels, const uint32_t * pCLUT )
+	{
+		for( int i = 0 ; i < nPixels ; i++ )
+			pDst[i] = (uint32_t(pSrc[i]) << 24) | 0x00FFFFFF;
+	}
+
+	//____ Pack kernels ___________________________________________________________
+
+	static void _pack_BGR_8( const uint32_t * pSrc, uint8_t * pDst, int nPixels )
+	{
+		for( int i = 0 ; i < nPixels ; i++ )
+		{
+			uint32_t v = pSrc[i];
+			pDst[i*3] = uint8_t(v);
+			pDst[i*3+1] = uint8_t(v >> 8);
+			pDst[i*3+2] = uint8_t(v >> 16);
+		}
+	}
+
+	static void _pack_BGRX_8( const uint32_t * pSrc, uint8_t * pDst, int nPixels )
+	{
+		uint32_t * p = (uint32_t*) pDst;
+		for( int i = 0 ; i < nPixels ; i++ )
+			p[i] = pSrc[i] | 0xFF000000;
+	}
+
+	static void _pack_BGRA_8( const uint32_t * pSrc, uint8_t * pDst, int nPixels )
+	{
+		memcpy( pDst, pSrc, nPixels*4 );
+	}
+
+	static void _pack_BGRA_4( const uint32_t * pSrc, uint8_t * pDst, int nPixels )
+	{
+		uint16_t * p = (uint16_t*) pDst;
+		for( int i = 0 ; i < nPixels ; i++ )
+		{
+			uint32_t v = pSrc[i];
+			p[i] = uint16_t( ((v >> 4) & 0xF) | ((v >> 8) & 0xF0) | ((v >> 12) & 0xF00) | ((v >> 16) & 0xF000) );
+		}
+	}
+
+	static void _pack_BGR_565( const uint32_t * pSrc, uint8_t * pDst, int nPixels )
+	{
+		uint16_t * p = (uint16_t*) pDst;
+		for( int i = 0 ; i < nPixels ; i++ )
+		{
+			uint32_t v = pSrc[i];
+			p[i] = uint16_t( ((v >> 3) & 0x1F) | ((v >> 5) & 0x7E0) | ((v >> 8) & 0xF800) );
+		}
+	}
+
+	static void _pack_A8( const uint32_t * pSrc, uint8_t * pDst, int nPixels )
+	{
+		for( int i = 0 ; i < nPixels ; i++ )
+			pDst[i] = uint8_t(pSrc[i] >> 24);
+	}
+
+	//____ Kernel lookup __________________________________________________________
+
+	static UnpackFunc _unpackFunc( PixelFormat format )
+	{
+		switch( format )
+		{
+			case PixelFormat::BGR_8:	return _unpack_BGR_8;
+			case PixelFormat::BGRX_8:	return _unpack_BGRX_8;
+			case PixelFormat::BGRA_8:	return _unpack_BGRA_8;
+			case PixelFormat::BGRA_4:	return _unpack_BGRA_4;
+			case PixelFormat::BGR_565:	return _unpack_BGR_565;
+			case PixelFormat::I8:		return _unpack_I8;
+			case PixelFormat::A8:		return _unpack_A8;
+			default:					return nullptr;
+		}
+	}
+
+	static PackFunc _packFunc( PixelFormat format )
+	{
+		switch( format )
+		{
+			case PixelFormat::BGR_8:	return _pack_BGR_8;
+			case PixelFormat::BGRX_8:	return _pack_BGRX_8;
+			case PixelFormat::BGRA_8:	return _pack_BGRA_8;
+			case PixelFormat::BGRA_4:	return _pack_BGRA_4;
+			case PixelFormat::BGR_565:	return _pack_BGR_565;
+			case PixelFormat::A8:		return _pack_A8;
+			default:					return nullptr;
+		}
+	}
+
+	static int _bytesPerPixel( PixelFormat format )
+	{
+		switch( format )
+		{
+			case PixelFormat::BGR_8:	return 3;
+			case PixelFormat::BGRX_8:
+			case PixelFormat::BGRA_8:	return 4;
+			case PixelFormat::BGRA_4:
+			case PixelFormat::BGR_565:	return 2;
+			case PixelFormat::I8:
+			case PixelFormat::A8:		return 1;
+			default:					return 0;
+		}
+	}
+
+	//____ isSupported() __________________________________________________________
+	/**
+	 * @brief Check if conversion between two formats is supported.
+	 */
+
+	bool PixelConverter::isSupported( PixelFormat srcFormat, PixelFormat dstFormat )
+	{
+		if( srcFormat == dstFormat )
+			return _bytesPerPixel( srcFormat ) != 0;
+
+		return _unpackFunc( srcFormat ) != nullptr && _packFunc( dstFormat ) != nullptr;
+	}
+
+	//____ convert() ______________________________________________________________
+	/**
+	 * @brief Convert a rectangular block of pixels.
+	 *
+	 * @param srcFormat	Format of source pixels.
+	 * @param pSrc		Pointer to first source pixel.
+	 * @param srcPitch	Bytes between start of source lines.
+	 * @param dstFormat	Format of destination pixels.
+	 * @param pDst		Pointer to first destination pixel.
+	 * @param dstPitch	Bytes between start of destination lines.
+	 * @param width		Width of block in pixels.
+	 * @param height	Height of block in pixels.
+	 * @param pCLUT		Color lookup table, needed if srcFormat is I8.
+	 *
+	 * @return False if conversion between the formats isn't supported.
+	 */
+
+	bool PixelConverter::convert( PixelFormat srcFormat, const uint8_t * pSrc, int srcPitch,
+								  PixelFormat dstFormat, uint8_t * pDst, int dstPitch,
+								  int width, int height, const Color * pCLUT )
+	{
+		if( !isSupported( srcFormat, dstFormat ) )
+			return false;
+
+		if( srcFormat == dstFormat )
+		{
+			int lineLength = width * _bytesPerPixel( srcFormat );
+			for( int y = 0 ; y < height ; y++ )
+			{
+				memcpy( pDst, pSrc, lineLength );
+				pSrc += srcPitch;
+				pDst += dstPitch;
+			}
+			return true;
+		}
+
+		uint32_t	clut[256];
+		if( srcFormat == PixelFormat::I8 )
+		{
+			if( !pCLUT )
+				return false;
+
+			for( int i = 0 ; i < 256 ; i++ )
+				clut[i] = pCLUT[i].argb;
+		}
+
+		UnpackFunc	pUnpack = _unpackFunc( srcFormat );
+		PackFunc	pPack = _packFunc( dstFormat );
+
+		if( dstFormat == PixelFormat::BGRA_8 || dstFormat == PixelFormat::BGRX_8 )
+		{
+			// BGRX_8 is unpacked in place, then gets its padding set.
+
+			for( int y = 0 ; y < height ; y++ )
+			{
+				pUnpack( pSrc, (uint32_t*) pDst, width, clut );
+				if( dstFormat == PixelFormat::BGRX_8 )
+					_pack_BGRX_8( (const uint32_t*) pDst, pDst, width );
+				pSrc += srcPitch;
+				pDst += dstPitch;
+			}
+		}
+		else if( srcFormat == PixelFormat::BGRA_8 )
+		{
+			for( int y = 0 ; y < height ; y++ )
+			{
+				pPack( (const uint32_t*) pSrc, pDst, width );
+				pSrc += srcPitch;
+				pDst += dstPitch;
+			}
+		}
+		else
+		{
+			uint32_t	buffer[c_chunkPixels];
+			int			srcBytes = _bytesPerPixel( srcFormat );
+			int			dstBytes = _bytesPerPixel( dstFormat );
+
+			for( int y = 0 ; y < height ; y++ )
+			{
+				for( int x = 0 ; x < width ; x += c_chunkPixels )
+				{
+					int nPixels = width - x < c_chunkPixels ? width - x : c_chunkPixels;
+					pUnpack( pSrc + x*srcBytes, buffer, nPixels, clut );
+					pPack( buffer, pDst + x*dstBytes, nPixels );
+				}
+				pSrc += srcPitch;
+				pDst += dstPitch;
+			}
+		}
+		return true;
+	}
+
+} // namespace wg
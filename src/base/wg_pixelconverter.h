@@ -0,0 +1,50 @@
+/*=========================================================================
+
+                         >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+#ifndef WG_PIXELCONVERTER_DOT_H
+#define WG_PIXELCONVERTER_DOT_H
+#pragma once
+
+#include <wg_types.h>
+#include <wg_color.h>
+
+namespace wg 
+{
+
+	//____ PixelConverter _________________________________________________________
+
+	class PixelConverter
+	{
+	public:
+		//.____ Misc _______________________________________________________
+
+		static bool	isSupported( PixelFormat srcFormat, PixelFormat dstFormat );
+
+		static bool	convert( PixelFormat srcFormat, const uint8_t * pSrc, int srcPitch,
+							 PixelFormat dstFormat, uint8_t * pDst, int dstPitch,
+							 int width, int height, const Color * pCLUT = nullptr );
+
+	private:
+		const static int	c_chunkPixels = 256;		// Pixels per chunk when converting through BGRA_8.
+	};
+
+} // namespace wg
+#endif //WG_PIXELCONVERTER_DOT_H
@@ -24,6 +24,7 @@
 #include <wg_resdb.h>
 //#include <wg_resources_xml.h>
 #include <wg_resloader.h>
+#include <wg_asyncloader.h>
 #include <assert.h>
 #include <wg_font.h>
 #include <wg_surface.h>
@@ -262,6 +263,52 @@ namespace wg
 	
 	
 	
+	//____ addSurfaceAsync() _________________________________________________
+	/**
+	 * Adds a surface resource that is loaded in the background by an AsyncLoader.
+	 *
+	 * The resource is added immediately with an empty surface, which is filled in
+	 * when the surface is delivered by AsyncLoader::update().
+	 *
+	 * Skins and other objects that are created from getSurface() before that hold
+	 * a null surface and are not updated. Create them from the callback instead,
+	 * which is called with the surface (or null if loading failed) once delivered.
+	 */
+	
+	bool ResDB::addSurfaceAsync( const std::string& id, const std::string& file, AsyncLoader * pLoader, MetaData * pMetaData, const std::function<void(Surface*)>& callback )
+	{
+		assert(m_mapSurfaces.find(id) == m_mapSurfaces.end());
+	
+		if(m_mapSurfaces.find(id) == m_mapSurfaces.end() && pLoader)
+		{
+			SurfaceRes* p = new SurfaceRes(id, nullptr, file, pMetaData);
+			m_surfaces.pushBack(p);
+			if(id.size())
+				m_mapSurfaces[id] = p;
+	
+			ResDB_wp pThis = this;
+			pLoader->loadSurface( file, SurfaceHint::Static, [pThis,p,callback](AsyncResource * pRes)
+			{
+				if( !pThis )
+					return;
+	
+				// Resource might have been removed while loading.
+	
+				SurfaceRes * pSurfRes = pThis->m_surfaces.first();
+				while( pSurfRes && pSurfRes != p )
+					pSurfRes = pSurfRes->next();
+	
+				if( pSurfRes && !pSurfRes->res )
+					pSurfRes->res = pRes->surface();
+
+				if( callback )
+					callback( pRes->surface().rawPtr() );
+			});
+			return true;
+		}
+		return false;
+	}
+	
 	//____ () _________________________________________________________
 	
 	bool ResDB::addFont( const std::string& id, Font * pFont, MetaData * pMetaData )
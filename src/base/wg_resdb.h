@@ -27,6 +27,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <functional>
 
 
 #include <wg_object.h>
@@ -42,6 +43,7 @@ namespace wg
 	
 	class Font;
 	class ResLoader;
+	class AsyncLoader;
 	
 	
 	class ResDB;
@@ -147,6 +149,7 @@ namespace wg
 	
 		bool				addSurface( const std::string& id, const std::string& file, MetaData * pMetaData, bool bRequired );
 		bool				addSurface( const std::string& id, Surface * pSurf, const std::string& filename, MetaData * pMetaData = 0 );
+		bool				addSurfaceAsync( const std::string& id, const std::string& file, AsyncLoader * pLoader, MetaData * pMetaData = 0, const std::function<void(Surface*)>& callback = nullptr );
 		
 		bool				addFont( const std::string& id, Font * pFont, MetaData * pMetaData = 0 );
 		bool				addGfxAnim( const std::string& id, GfxAnim * pAnim, MetaData * pMetaData = 0 );
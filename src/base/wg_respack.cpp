@@ -0,0 +1,366 @@
+/*=========================================================================
+
+                         >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+#include <wg_respack.h>
+#include <wg_resdb.h>
+#include <wg_util.h>
+
+#include <string.h>
+
+#ifdef _WIN32
+#	include <windows.h>
+#else
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <fcntl.h>
+#	include <unistd.h>
+#endif
+
+namespace wg 
+{
+	const char ResPack::CLASSNAME[] = {"ResPack"};
+
+
+	//____ open() _____________________________________________________________
+	/**
+	 * @brief Memory map a resource pack.
+	 *
+	 * @param path	Path of file written by ResPackWriter.
+	 *
+	 * @return Pointer to the ResPack or an empty pointer if file could not be
+	 *		   mapped or is not a valid resource pack.
+	 */
+
+	ResPack_p ResPack::open( const std::string& path )
+	{
+		ResPack_p p = new ResPack();
+		if( !p->_map(path) )
+			return nullptr;
+
+		return p;
+	}
+
+	//____ Constructor ________________________________________________________
+
+	ResPack::ResPack() : m_pData(nullptr), m_size(0), m_pHeader(nullptr), m_pIndex(nullptr), m_pStrings(nullptr)
+	{
+#ifdef _WIN32
+		m_hFile = INVALID_HANDLE_VALUE;
+		m_hMapping = nullptr;
+#endif
+	}
+
+	//____ Destructor _________________________________________________________
+
+	ResPack::~ResPack()
+	{
+		_unmap();
+	}
+
+	//____ isInstanceOf() _____________________________________________________
+
+	bool ResPack::isInstanceOf( const char * pClassName ) const
+	{ 
+		if( pClassName==CLASSNAME )
+			return true;
+
+		return Object::isInstanceOf(pClassName);
+	}
+
+	//____ className() ________________________________________________________
+
+	const char * ResPack::className( void ) const
+	{ 
+		return CLASSNAME; 
+	}
+
+	//____ cast() _____________________________________________________________
+
+	ResPack_p ResPack::cast( Object * pObject )
+	{
+		if( pObject && pObject->isInstanceOf(CLASSNAME) )
+			return ResPack_p( static_cast<ResPack*>(pObject) );
+
+		return 0;
+	}
+
+	//____ hashId() ___________________________________________________________
+	/**
+	 * @brief Hash function used for the index of the pack.
+	 *
+	 * 32-bit FNV-1a of the id.
+	 */
+
+	uint32_t ResPack::hashId( const char * pId, int len )
+	{
+		uint32_t hash = 2166136261u;
+		for( int i = 0 ; i < len ; i++ )
+		{
+			hash ^= (uint8_t) pId[i];
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+
+	//____ contains() _________________________________________________________
+
+	bool ResPack::contains( const std::string& id, Type type ) const
+	{
+		return _find(id, type) != nullptr;
+	}
+
+	//____ surface() __________________________________________________________
+	/**
+	 * @brief Create a surface from the pack.
+	 *
+	 * @param id		Id of the surface.
+	 * @param pFactory	Factory to create surface with. Surfaces from a SoftSurfaceFactory are
+	 *					created directly over the mapped pixels, other factories upload them.
+	 * @param preferred	PixelFormat to pick if surface has been stored in several formats.
+	 *					If not present, the first one stored is used.
+	 * @param hint		Surface hint passed on to the factory.
+	 *
+	 * @return New surface or empty pointer if id was not found.
+	 */
+
+	Surface_p ResPack::surface( const std::string& id, SurfaceFactory * pFactory, PixelFormat preferred, int hint )
+	{
+		if( !pFactory )
+			return nullptr;
+
+		const IndexEntry * pEntry = nullptr;
+		if( preferred != PixelFormat::Unknown )
+			pEntry = _find( id, Type::Surface, preferred );
+		if( !pEntry )
+			pEntry = _find( id, Type::Surface );
+		if( !pEntry )
+			return nullptr;
+
+		Blob_p pBlob = _wrap(pEntry);
+		const Color * pClut = pEntry->bClut ? (const Color*) (m_pData + pEntry->dataOffset + pEntry->pitch*pEntry->height) : nullptr;
+
+		return pFactory->createSurface( Size(pEntry->width,pEntry->height), (PixelFormat) pEntry->format, pBlob.rawPtr(), pEntry->pitch, hint, pClut );
+	}
+
+	//____ blob() _____________________________________________________________
+	/**
+	 * @brief Get a Blob referencing data of the pack.
+	 *
+	 * The blob points straight into the mapped file, no data is copied.
+	 *
+	 * @return Blob or empty pointer if id of given type was not found.
+	 */
+
+	Blob_p ResPack::blob( const std::string& id, Type type )
+	{
+		const IndexEntry * pEntry = _find(id, type);
+		if( !pEntry )
+			return nullptr;
+
+		return _wrap(pEntry);
+	}
+
+	//____ addSurfacesToResDB() _______________________________________________
+	/**
+	 * @brief Add all surfaces of the pack to a ResDB.
+	 *
+	 * Surfaces stored in several formats are only added once, in the preferred
+	 * format if present. Surfaces whose id already is in the ResDB are skipped.
+	 *
+	 * @return Number of surfaces added.
+	 */
+
+	int ResPack::addSurfacesToResDB( ResDB * pDB, SurfaceFactory * pFactory, PixelFormat preferred )
+	{
+		if( !pDB )
+			return 0;
+
+		int nAdded = 0;
+		for( uint32_t i = 0 ; i < m_pHeader->nbEntries ; i++ )
+		{
+			const IndexEntry * pEntry = &m_pIndex[i];
+			if( pEntry->type != (uint8_t) Type::Surface )
+				continue;
+
+			std::string id( m_pStrings + pEntry->idOffset, pEntry->idLength );
+			if( pDB->getResSurface(id) )
+				continue;
+
+			Surface_p pSurface = surface( id, pFactory, preferred );
+			if( pSurface && pDB->addSurface( id, pSurface, id ) )
+				nAdded++;
+		}
+		return nAdded;
+	}
+
+	//____ _find() ____________________________________________________________
+
+	const ResPack::IndexEntry * ResPack::_find( const std::string& id, Type type, PixelFormat format ) const
+	{
+		uint32_t hash = hashId( id.c_str(), (int) id.size() );
+
+		// Binary search for first entry with our hash.
+
+		uint32_t first = 0;
+		uint32_t last = m_pHeader->nbEntries;
+		while( first < last )
+		{
+			uint32_t mid = (first + last) / 2;
+			if( m_pIndex[mid].hash < hash )
+				first = mid + 1;
+			else
+				last = mid;
+		}
+
+		for( uint32_t i = first ; i < m_pHeader->nbEntries && m_pIndex[i].hash == hash ; i++ )
+		{
+			const IndexEntry * p = &m_pIndex[i];
+			if( p->type == (uint8_t) type && p->idLength == id.size() && memcmp( m_pStrings + p->idOffset, id.c_str(), id.size() ) == 0 &&
+				(format == PixelFormat::Unknown || p->format == (uint8_t) format) )
+				return p;
+		}
+		return nullptr;
+	}
+
+	//____ _wrap() ____________________________________________________________
+
+	Blob_p ResPack::_wrap( const IndexEntry * pEntry )
+	{
+		ResPack_p pKeepMapped = this;
+		return Blob::create( m_pData + pEntry->dataOffset, (int) pEntry->dataSize, [pKeepMapped]() {} );
+	}
+
+	//____ _map() _____________________________________________________________
+
+	bool ResPack::_map( const std::string& path )
+	{
+#ifdef _WIN32
+		m_hFile = CreateFileA( path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+		if( m_hFile == INVALID_HANDLE_VALUE )
+			return false;
+
+		LARGE_INTEGER size;
+		if( !GetFileSizeEx( m_hFile, &size ) )
+			return false;
+		m_size = size.QuadPart;
+
+		m_hMapping = CreateFileMappingA( m_hFile, NULL, PAGE_WRITECOPY, 0, 0, NULL );
+		if( !m_hMapping )
+			return false;
+
+		m_pData = (uint8_t*) MapViewOfFile( m_hMapping, FILE_MAP_COPY, 0, 0, 0 );
+		if( !m_pData )
+			return false;
+#else
+		int fd = ::open( path.c_str(), O_RDONLY );
+		if( fd < 0 )
+			return false;
+
+		struct stat st;
+		if( fstat( fd, &st ) != 0 || st.st_size < (off_t) sizeof(Header) )
+		{
+			close(fd);
+			return false;
+		}
+		m_size = st.st_size;
+
+		void * p = mmap( nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 );
+		close(fd);
+		if( p == MAP_FAILED )
+			return false;
+		m_pData = (uint8_t*) p;
+#endif
+
+		// Validate header and index
+
+		if( m_size < sizeof(Header) )
+			return false;
+
+		m_pHeader = (const Header*) m_pData;
+		if( memcmp( m_pHeader->magic, "WGRP", 4 ) != 0 || m_pHeader->version != c_version || m_pHeader->fileSize != m_size )
+			return false;
+
+		// Index must be aligned and fit in the file. Checked without risk of overflow since
+		// both indexOffset and nbEntries come straight from the file.
+
+		if( m_pHeader->indexOffset > m_size || m_pHeader->indexOffset % alignof(IndexEntry) != 0 ||
+			m_pHeader->nbEntries > (m_size - m_pHeader->indexOffset) / sizeof(IndexEntry) ||
+			m_pHeader->stringsOffset > m_size )
+			return false;
+
+		m_pIndex = (const IndexEntry*) (m_pData + m_pHeader->indexOffset);
+		m_pStrings = (const char*) (m_pData + m_pHeader->stringsOffset);
+
+		for( uint32_t i = 0 ; i < m_pHeader->nbEntries ; i++ )
+		{
+			const IndexEntry& e = m_pIndex[i];
+			if( e.dataSize > m_size || e.dataOffset > m_size - e.dataSize ||
+				uint64_t(m_pHeader->stringsOffset) + e.idOffset + e.idLength > m_size )
+				return false;
+
+			// Surface pixels (and CLUT) must fit in the data of the entry, otherwise
+			// createSurface() would read outside the mapped file.
+
+			if( e.type == (uint8_t) Type::Surface )
+			{
+				PixelDescription desc;
+				if( e.format < (uint8_t) PixelFormat::BGR_8 || e.format > (uint8_t) PixelFormat::A8 ||
+					!Util::pixelFormatToDescription( (PixelFormat) e.format, desc ) )
+					return false;
+
+				if( e.width <= 0 || e.height <= 0 || e.pitch < int64_t(e.width) * desc.bits / 8 )
+					return false;
+
+				if( e.format == (uint8_t) PixelFormat::I8 && !e.bClut )
+					return false;
+
+				if( uint64_t(e.pitch) * e.height + (e.bClut ? 4096 : 0) > e.dataSize )
+					return false;
+			}
+		}
+		return true;
+	}
+
+	//____ _unmap() ___________________________________________________________
+
+	void ResPack::_unmap()
+	{
+#ifdef _WIN32
+		if( m_pData )
+			UnmapViewOfFile( m_pData );
+		if( m_hMapping )
+			CloseHandle( m_hMapping );
+		if( m_hFile != INVALID_HANDLE_VALUE )
+			CloseHandle( m_hFile );
+		m_hMapping = nullptr;
+		m_hFile = INVALID_HANDLE_VALUE;
+#else
+		if( m_pData )
+			munmap( m_pData, m_size );
+#endif
+		m_pData = nullptr;
+		m_pHeader = nullptr;
+		m_pIndex = nullptr;
+		m_pStrings = nullptr;
+	}
+
+} // namespace wg
@@ -0,0 +1,152 @@
+/*=========================================================================
+
+                         >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+#ifndef	WG_RESPACK_DOT_H
+#define	WG_RESPACK_DOT_H
+#pragma once
+
+#include <string>
+
+#include <wg_pointers.h>
+#include <wg_types.h>
+#include <wg_blob.h>
+#include <wg_surface.h>
+#include <wg_surfacefactory.h>
+
+namespace wg 
+{
+	class ResDB;
+
+	class ResPack;
+	typedef	StrongPtr<ResPack>	ResPack_p;
+	typedef	WeakPtr<ResPack>	ResPack_wp;
+
+	//____ ResPack ____________________________________________________________
+	/**
+	 * @brief Memory mapped archive of prepared resources.
+	 *
+	 * A ResPack is a binary archive written by ResPackWriter, containing surfaces
+	 * with pixels already converted to their target PixelFormat, font files and other
+	 * data, indexed by a sorted table of hashed ids.
+	 *
+	 * The archive is memory mapped when opened, nothing is loaded or decoded up front.
+	 * Surfaces and blobs are created directly over the mapped data, so a SoftSurfaceFactory
+	 * creates its surfaces without copying any pixels. Pages are mapped copy-on-write, so
+	 * surfaces can still be locked and modified without affecting the file.
+	 *
+	 * Surfaces and blobs created from the pack keep it mapped until they are destroyed.
+	 */
+
+	class ResPack : public Object
+	{
+	public:
+
+		enum class Type : uint8_t
+		{
+			Surface,
+			Font,			///< Font file, for example to be used with FreeTypeFont.
+			TextStyle,		///< Text style definition in application specific format.
+			Skin,			///< Skin definition in application specific format.
+			Data			///< Any other data.
+		};
+
+		//.____ Creation __________________________________________
+
+		static ResPack_p	open( const std::string& path );
+
+		//.____ Identification __________________________________________
+
+		bool				isInstanceOf( const char * pClassName ) const;
+		const char *		className( void ) const;
+		static const char	CLASSNAME[];
+		static ResPack_p	cast( Object * pObject );
+
+		//.____ Content ________________________________________________
+
+		inline int			size() const { return m_pHeader->nbEntries; }
+
+		bool				contains( const std::string& id, Type type ) const;
+		Surface_p			surface( const std::string& id, SurfaceFactory * pFactory, PixelFormat preferred = PixelFormat::Unknown, int hint = SurfaceHint::Static );
+		Blob_p				blob( const std::string& id, Type type = Type::Data );
+
+		int					addSurfacesToResDB( ResDB * pDB, SurfaceFactory * pFactory, PixelFormat preferred = PixelFormat::Unknown );
+
+		//.____ Misc ___________________________________________________
+
+		static uint32_t		hashId( const char * pId, int len );
+
+		//____ File format _________________________________________________
+
+		static const uint32_t	c_version = 1;
+		static const int		c_dataAlignment = 64;
+
+		struct Header						// All values little-endian.
+		{
+			char		magic[4];			// "WGRP"
+			uint32_t	version;
+			uint32_t	nbEntries;
+			uint32_t	stringsOffset;		// Offset from start of file to string table with all ids.
+			uint64_t	indexOffset;		// Offset from start of file to array of nbEntries IndexEntries.
+			uint64_t	fileSize;
+		};
+
+		struct IndexEntry					// Sorted on hash.
+		{
+			uint32_t	hash;				// hashId() of id.
+			uint32_t	idOffset;			// Offset of id in string table.
+			uint32_t	idLength;
+			uint8_t		type;				// Type
+			uint8_t		format;				// PixelFormat of surfaces.
+			uint8_t		bClut;				// Surface has a 256 entry CLUT (4096 bytes) following the pixels.
+			uint8_t		reserved;
+			int32_t		width;
+			int32_t		height;
+			int32_t		pitch;
+			uint32_t	reserved2;
+			uint64_t	dataOffset;			// Offset from start of file, aligned to c_dataAlignment.
+			uint64_t	dataSize;
+		};
+
+	protected:
+		ResPack();
+		virtual ~ResPack();
+
+		bool				_map( const std::string& path );
+		void				_unmap();
+
+		const IndexEntry *	_find( const std::string& id, Type type, PixelFormat format = PixelFormat::Unknown ) const;
+		Blob_p				_wrap( const IndexEntry * pEntry );
+
+		uint8_t *			m_pData;
+		uint64_t			m_size;
+		const Header *		m_pHeader;
+		const IndexEntry *	m_pIndex;
+		const char *		m_pStrings;
+
+#ifdef _WIN32
+		void *				m_hFile;
+		void *				m_hMapping;
+#endif
+	};
+
+} // namespace wg
+#endif //WG_RESPACK_DOT_H
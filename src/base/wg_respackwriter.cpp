@@ -0,0 +1,300 @@
+/*=========================================================================
+
+                         >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+#include <wg_respackwriter.h>
+#include <wg_util.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+namespace wg 
+{
+	const char ResPackWriter::CLASSNAME[] = {"ResPackWriter"};
+
+
+	//____ Constructor ________________________________________________________
+
+	ResPackWriter::ResPackWriter( SurfaceFactory * pConversionFactory ) : m_pFactory(pConversionFactory)
+	{
+	}
+
+	//____ isInstanceOf() _____________________________________________________
+
+	bool ResPackWriter::isInstanceOf( const char * pClassName ) const
+	{ 
+		if( pClassName==CLASSNAME )
+			return true;
+
+		return Object::isInstanceOf(pClassName);
+	}
+
+	//____ className() ________________________________________________________
+
+	const char * ResPackWriter::className( void ) const
+	{ 
+		return CLASSNAME; 
+	}
+
+	//____ cast() _____________________________________________________________
+
+	ResPackWriter_p ResPackWriter::cast( Object * pObject )
+	{
+		if( pObject && pObject->isInstanceOf(CLASSNAME) )
+			return ResPackWriter_p( static_cast<ResPackWriter*>(pObject) );
+
+		return 0;
+	}
+
+	//____ addSurface() _______________________________________________________
+	/**
+	 * @brief Add a surface to the pack.
+	 *
+	 * @param id		Id of the surface. The same id can be added several times in
+	 *					different formats, ResPack picks the one asked for.
+	 * @param pSurface	Surface with the content.
+	 * @param format	Format to store pixels in, PixelFormat::Unknown for the format of the surface.
+	 *					Conversion is done through the factory given at creation. I8 surfaces can
+	 *					only be stored as they are.
+	 *
+	 * @return False if surface could not be converted or id already exists in that format.
+	 */
+
+	bool ResPackWriter::addSurface( const std::string& id, Surface * pSurface, PixelFormat format )
+	{
+		if( !pSurface )
+			return false;
+
+		if( format == PixelFormat::Unknown )
+			format = pSurface->pixelFormat();
+
+		if( format == PixelFormat::Unknown || format == PixelFormat::Custom || _exists(id, ResPack::Type::Surface, format) )
+			return false;
+
+		Surface_p pSource = pSurface;
+		if( format != pSurface->pixelFormat() )
+		{
+			if( !m_pFactory || format == PixelFormat::I8 )
+				return false;
+
+			pSource = m_pFactory->createSurface( pSurface->size(), format );
+			if( !pSource || !pSource->copyFrom( pSurface, Coord(0,0) ) )
+				return false;
+		}
+
+		Size size = pSource->size();
+
+		PixelDescription desc;
+		Util::pixelFormatToDescription( format, desc );
+		int lineBytes = size.w * desc.bits / 8;
+		int pitch = (lineBytes + 3) & ~3;
+		bool bClut = pSource->clut() != nullptr;
+
+		Entry entry;
+		entry.id = id;
+		memset( &entry.info, 0, sizeof(entry.info) );
+		entry.info.type = (uint8_t) ResPack::Type::Surface;
+		entry.info.format = (uint8_t) format;
+		entry.info.bClut = bClut ? 1 : 0;
+		entry.info.width = size.w;
+		entry.info.height = size.h;
+		entry.info.pitch = pitch;
+		entry.data.resize( pitch * size.h + (bClut ? 4096 : 0), 0 );
+
+		const uint8_t * pPixels = pSource->lock( AccessMode::ReadOnly );
+		if( !pPixels )
+			return false;
+
+		for( int y = 0 ; y < size.h ; y++ )
+			memcpy( &entry.data[y*pitch], pPixels + y*pSource->pitch(), lineBytes );
+		pSource->unlock();
+
+		if( bClut )
+			memcpy( &entry.data[pitch*size.h], pSource->clut(), 4096 );
+
+		m_entries.push_back( std::move(entry) );
+		return true;
+	}
+
+	//____ addBlob() __________________________________________________________
+	/**
+	 * @brief Add content of a blob to the pack.
+	 *
+	 * The blob needs to know its size. Content is copied, so the blob can be
+	 * released afterwards.
+	 *
+	 * @return False if blob is empty or id already exists for given type.
+	 */
+
+	bool ResPackWriter::addBlob( const std::string& id, Blob * pBlob, ResPack::Type type )
+	{
+		if( !pBlob || pBlob->size() <= 0 || type == ResPack::Type::Surface || _exists(id, type, PixelFormat::Unknown) )
+			return false;
+
+		Entry entry;
+		entry.id = id;
+		memset( &entry.info, 0, sizeof(entry.info) );
+		entry.info.type = (uint8_t) type;
+		entry.data.assign( (uint8_t*) pBlob->data(), ((uint8_t*) pBlob->data()) + pBlob->size() );
+
+		m_entries.push_back( std::move(entry) );
+		return true;
+	}
+
+	//____ addFile() __________________________________________________________
+	/**
+	 * @brief Add content of a file to the pack.
+	 *
+	 * Typically used for font files.
+	 *
+	 * @return False if file could not be read or id already exists for given type.
+	 */
+
+	bool ResPackWriter::addFile( const std::string& id, const std::string& path, ResPack::Type type )
+	{
+		if( type == ResPack::Type::Surface || _exists(id, type, PixelFormat::Unknown) )
+			return false;
+
+		FILE * fp = fopen( path.c_str(), "rb" );
+		if( !fp )
+			return false;
+
+		Entry entry;
+		entry.id = id;
+		memset( &entry.info, 0, sizeof(entry.info) );
+		entry.info.type = (uint8_t) type;
+
+		uint8_t	buffer[4096];
+		size_t	nRead;
+		while( (nRead = fread( buffer, 1, sizeof(buffer), fp )) > 0 )
+			entry.data.insert( entry.data.end(), buffer, buffer + nRead );
+
+		bool bError = ferror(fp) != 0;
+		fclose(fp);
+		if( bError )
+			return false;
+
+		m_entries.push_back( std::move(entry) );
+		return true;
+	}
+
+	//____ clear() ____________________________________________________________
+
+	void ResPackWriter::clear()
+	{
+		m_entries.clear();
+	}
+
+	//____ save() _____________________________________________________________
+	/**
+	 * @brief Write the pack to file.
+	 *
+	 * Layout of the file is header, index sorted on hashed id, string table with
+	 * all ids and finally the data, each entry aligned to ResPack::c_dataAlignment.
+	 */
+
+	bool ResPackWriter::save( const std::string& path )
+	{
+		const uint64_t align = ResPack::c_dataAlignment;
+
+		// Build index and string table
+
+		std::vector<ResPack::IndexEntry>	index;
+		std::string							strings;
+
+		for( auto& entry : m_entries )
+		{
+			ResPack::IndexEntry info = entry.info;
+			info.hash = ResPack::hashId( entry.id.c_str(), (int) entry.id.size() );
+			info.idOffset = (uint32_t) strings.size();
+			info.idLength = (uint32_t) entry.id.size();
+			info.dataSize = entry.data.size();
+			strings += entry.id;
+			index.push_back(info);
+		}
+
+		ResPack::Header header;
+		memcpy( header.magic, "WGRP", 4 );
+		header.version = ResPack::c_version;
+		header.nbEntries = (uint32_t) index.size();
+		header.indexOffset = sizeof(ResPack::Header);
+		header.stringsOffset = (uint32_t) (header.indexOffset + index.size() * sizeof(ResPack::IndexEntry));
+
+		uint64_t offset = (header.stringsOffset + strings.size() + align - 1) & ~(align - 1);
+		for( auto& info : index )
+		{
+			info.dataOffset = offset;
+			offset = (offset + info.dataSize + align - 1) & ~(align - 1);
+		}
+		header.fileSize = offset;
+
+		// Sort index on hash, keeping order of insertion for entries with same hash.
+
+		std::vector<int> order( index.size() );
+		for( int i = 0 ; i < (int) order.size() ; i++ )
+			order[i] = i;
+
+		std::stable_sort( order.begin(), order.end(), [&index](int a, int b) { return index[a].hash < index[b].hash; } );
+
+		// Write file
+
+		FILE * fp = fopen( path.c_str(), "wb" );
+		if( !fp )
+			return false;
+
+		bool bOk = fwrite( &header, sizeof(header), 1, fp ) == 1;
+		for( int i : order )
+			bOk = bOk && fwrite( &index[i], sizeof(ResPack::IndexEntry), 1, fp ) == 1;
+
+		bOk = bOk && fwrite( strings.data(), 1, strings.size(), fp ) == strings.size();
+
+		static const uint8_t padding[ResPack::c_dataAlignment] = { 0 };
+		uint64_t written = header.stringsOffset + strings.size();
+
+		for( int i = 0 ; i < (int) index.size() && bOk ; i++ )
+		{
+			int nPad = (int) (index[i].dataOffset - written);
+			bOk = fwrite( padding, 1, nPad, fp ) == (size_t) nPad;
+			bOk = bOk && fwrite( m_entries[i].data.data(), 1, m_entries[i].data.size(), fp ) == m_entries[i].data.size();
+			written = index[i].dataOffset + index[i].dataSize;
+		}
+
+		int nPad = (int) (header.fileSize - written);
+		bOk = bOk && fwrite( padding, 1, nPad, fp ) == (size_t) nPad;
+
+		fclose(fp);
+		return bOk;
+	}
+
+	//____ _exists() __________________________________________________________
+
+	bool ResPackWriter::_exists( const std::string& id, ResPack::Type type, PixelFormat format ) const
+	{
+		for( auto& entry : m_entries )
+		{
+			if( entry.id == id && entry.info.type == (uint8_t) type && (type != ResPack::Type::Surface || entry.info.format == (uint8_t) format) )
+				return true;
+		}
+		return false;
+	}
+
+} // namespace wg
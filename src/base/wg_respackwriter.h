@@ -0,0 +1,93 @@
+/*=========================================================================
+
+                         >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+#ifndef	WG_RESPACKWRITER_DOT_H
+#define	WG_RESPACKWRITER_DOT_H
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <wg_respack.h>
+
+namespace wg 
+{
+	class ResPackWriter;
+	typedef	StrongPtr<ResPackWriter>	ResPackWriter_p;
+	typedef	WeakPtr<ResPackWriter>		ResPackWriter_wp;
+
+	//____ ResPackWriter ______________________________________________________
+	/**
+	 * @brief Builds resource packs to be opened by ResPack.
+	 *
+	 * Collects surfaces and blobs and writes them to a resource pack file. Surfaces are
+	 * converted to the requested PixelFormats when added, using the SurfaceFactory given
+	 * at creation, so the pack contains pixels ready for use.
+	 */
+
+	class ResPackWriter : public Object
+	{
+	public:
+
+		//.____ Creation __________________________________________
+
+		static ResPackWriter_p	create( SurfaceFactory * pConversionFactory ) { return ResPackWriter_p(new ResPackWriter(pConversionFactory)); }
+
+		//.____ Identification __________________________________________
+
+		bool				isInstanceOf( const char * pClassName ) const;
+		const char *		className( void ) const;
+		static const char	CLASSNAME[];
+		static ResPackWriter_p	cast( Object * pObject );
+
+		//.____ Content ________________________________________________
+
+		bool				addSurface( const std::string& id, Surface * pSurface, PixelFormat format = PixelFormat::Unknown );
+		bool				addBlob( const std::string& id, Blob * pBlob, ResPack::Type type = ResPack::Type::Data );
+		bool				addFile( const std::string& id, const std::string& path, ResPack::Type type = ResPack::Type::Data );
+
+		inline int			size() const { return (int) m_entries.size(); }
+		void				clear();
+
+		//.____ Control ________________________________________________
+
+		bool				save( const std::string& path );
+
+	protected:
+		ResPackWriter( SurfaceFactory * pConversionFactory );
+		virtual ~ResPackWriter() {}
+
+		struct Entry
+		{
+			std::string				id;
+			ResPack::IndexEntry		info;
+			std::vector<uint8_t>	data;
+		};
+
+		bool				_exists( const std::string& id, ResPack::Type type, PixelFormat format ) const;
+
+		SurfaceFactory_p	m_pFactory;
+		std::vector<Entry>	m_entries;
+	};
+
+} // namespace wg
+#endif //WG_RESPACKWRITER_DOT_H
@@ -22,6 +22,8 @@
 
 #include <memory.h>
 #include <wg_surface.h>
+#include <wg_surfacefactory.h>
+#include <wg_pixelconverter.h>
 
 namespace wg 
 {
@@ -83,6 +85,8 @@ namespace wg
 	
 	Surface::~Surface()
 	{
+		if( m_pFactory )
+			m_pFactory->_untrack( this );
 	}
 	
 	//____ isInstanceOf() _________________________________________________________
@@ -301,24 +305,17 @@ namespace wg
 		int p = pitch();
 		uint8_t * pDest = m_pPixels + rect.y * p + rect.x*m_pixelDescription.bits / 8;
 
+		// Fill the first line, then copy it to the others.
+
 		bool ret = true;
 		switch( m_pixelDescription.bits )
 		{
 			case 8:
-				for( int y = 0 ; y < h ; y++ )
-				{
-					for( int x = 0 ; x < w ; x++ )
-						pDest[x] = (uint8_t) pixel;
-					pDest += p;
-				}
+				memset( pDest, (uint8_t) pixel, w );
 				break;
 			case 16:
-				for( int y = 0 ; y < h ; y++ )
-				{
-					for( int x = 0 ; x < w ; x++ )
-						((uint16_t*)pDest)[x] = (uint16_t) pixel;
-					pDest += p;
-				}
+				for( int x = 0 ; x < w ; x++ )
+					((uint16_t*)pDest)[x] = (uint16_t) pixel;
 				break;
 			case 24:
 			{
@@ -326,29 +323,28 @@ namespace wg
 				uint8_t two = (uint8_t) (pixel>>8);
 				uint8_t three = (uint8_t) (pixel>>16);
 	
-				for( int y = 0 ; y < h ; y++ )
+				for( int x = 0 ; x < w*3 ;  )
 				{
-					for( int x = 0 ; x < w*3 ;  )
-					{
-						pDest[x++] = one;
-						pDest[x++] = two;
-						pDest[x++] = three;
-					}
-					pDest += p;
+					pDest[x++] = one;
+					pDest[x++] = two;
+					pDest[x++] = three;
 				}
 				break;
 			}
 			case 32:
-				for( int y = 0 ; y < h ; y++ )
-				{
-					for( int x = 0 ; x < w ; x++ )
-						((uint32_t*)pDest)[x] = pixel;
-					pDest += p;
-				}
+				for( int x = 0 ; x < w ; x++ )
+					((uint32_t*)pDest)[x] = pixel;
 				break;
 			default:
 				ret = false;
 		}
+
+		if( ret )
+		{
+			int lineLength = w * m_pixelDescription.bits / 8;
+			for( int y = 1 ; y < h ; y++ )
+				memcpy( pDest + y*p, pDest, lineLength );
+		}
 	
 		//
 	
@@ -427,6 +423,33 @@ namespace wg
 	}
 
 
+	//____ _allocatedBytes() ____________________________________________________
+
+	// Bytes of memory allocated by the surface, as accounted by the factory that created it.
+	// Default assumes tightly packed pixels and a CLUT of its own, subclasses should return
+	// what they actually have allocated.
+
+	int64_t Surface::_allocatedBytes() const
+	{
+		Size sz = size();
+		return (int64_t) sz.w * sz.h * m_pixelDescription.bits / 8 + (m_pClut ? 4096 : 0);
+	}
+
+	//____ _updateMemoryUsage() _________________________________________________
+
+	// Called by subclasses when their allocations have changed after creation, like
+	// when mipmaps are generated or released.
+
+	void Surface::_updateMemoryUsage()
+	{
+		if( !m_pFactory )
+			return;
+
+		int64_t bytes = _allocatedBytes();
+		m_pFactory->_adjustMemoryUsage( bytes - m_memoryUsage );
+		m_memoryUsage = bytes;
+	}
+
 	//____ _copyFrom() _________________________________________________________
 	
 	/* 
@@ -465,46 +488,13 @@ namespace wg
 				pDst += dstPitch;
 			}
 		}
-		else if (pSrcFormat->format == PixelFormat::BGRA_8 && pDstFormat->format == PixelFormat::BGR_8)
-		{
-			// Standard 8-bit RGB values, we just need to lose the alpha channel
-
-			int		srcLineInc = srcPitch - 4 * srcRect.w;
-			int		dstLineInc = dstPitch - 3 * srcRect.w;
-
-			for (int y = 0; y < srcRect.h; y++)
-			{
-				for (int x = 0; x < srcRect.w; x++)
-				{
-					* pDst++ = * pSrc++;
-					* pDst++ = * pSrc++;
-					*pDst++ = *pSrc++;
-					pSrc++;
-				}
-				pSrc += srcLineInc;
-				pDst += dstLineInc;
-			}
-		}
-		else if(pSrcFormat->format == PixelFormat::BGR_8 && pDstFormat->format == PixelFormat::BGRA_8)
+		else if( PixelConverter::isSupported( pSrcFormat->format, pDstFormat->format ) )
 		{
-			// Standard 8-bit RGB values, We just needs to add an alpha channel
-
-			int		srcLineInc = srcPitch - 3 * srcRect.w;
-			int		dstLineInc = dstPitch - 4 * srcRect.w;
-
-			for (int y = 0; y < srcRect.h; y++)
-			{
-				for (int x = 0; x < srcRect.w; x++)
-				{
-					*pDst++ = *pSrc++;
-					*pDst++ = *pSrc++;
-					*pDst++ = *pSrc++;
-					*pDst++ = 255;
-				}
-				pSrc += srcLineInc;
-				pDst += dstLineInc;
-			}
+			// Both formats are known, so we let PixelConverter use its specialized kernels.
+			// It refuses e.g. CLUT-based sources without a CLUT.
 
+			if( !PixelConverter::convert( pSrcFormat->format, pSrc, srcPitch, pDstFormat->format, pDst, dstPitch, srcRect.w, srcRect.h, pCLUT ) )
+				return false;
 		}
 		else if (pDstFormat->format == PixelFormat::I8)
 		{
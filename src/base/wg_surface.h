@@ -38,6 +38,8 @@ namespace wg
 	class Surface;
 	typedef	StrongPtr<Surface>	Surface_p;
 	typedef	WeakPtr<Surface>	Surface_wp;
+
+	class SurfaceFactory;
 	
 	//____ Surface ______________________________________________________________
 	/**
@@ -215,12 +217,24 @@ namespace wg
 		virtual bool		copyFrom( Surface * pSrcSurf, const Rect& srcRect, Coord dst );	///< @brief Copy block of graphics from other surface
 		virtual bool		copyFrom( Surface * pSrcSurf, Coord dst );	///< @brief Copy other surface as a block
 
+		//.____ Misc __________________________________________________________
+
+		inline void			setCreator( const char * pCreator ) { m_pCreator = pCreator; }	///< @brief Name the owner of the surface for SurfaceFactory::dumpSurfaces().
+		inline const char *	creator() const { return m_pCreator; }
+		inline int64_t		memoryUsage() const { return m_memoryUsage; }	///< @brief Pixel memory accounted to the factory that created the surface.
+
 	
 	protected:
+		friend class SurfaceFactory;
+
 		Surface();
 		virtual ~Surface();
 	
 		Rect				_lockAndAdjustRegion( AccessMode modeNeeded, const Rect& region );
+
+		virtual int64_t		_allocatedBytes() const;
+		void				_updateMemoryUsage();
+
 		bool 				_copyFrom( const PixelDescription * pSrcFormat, uint8_t * pSrcPixels, int srcPitch, const Rect& srcRect, const Rect& dstRect, const Color * pCLUT = nullptr );
 	
 		PixelDescription			m_pixelDescription;
@@ -233,6 +247,12 @@ namespace wg
 		uint8_t *			m_pPixels;			// Pointer at pixels when surface locked.
 		Rect				m_lockRegion;		// Region of surface that is locked. Width/Height should be set to 0 when not locked.
 
+		SurfaceFactory *	m_pFactory = nullptr;			// Factory accounting for our memory. Cleared if factory is destroyed first.
+		Surface *			m_pPrevInFactory = nullptr;		// Links in factory's list of live surfaces.
+		Surface *			m_pNextInFactory = nullptr;
+		int64_t				m_memoryUsage = 0;
+		const char *		m_pCreator = nullptr;			// String literal naming owner, for debugging.
+
 	};
 	
 	//____ Surface::pitch() _______________________________________________
@@ -21,6 +21,12 @@
 =========================================================================*/
 
 #include <wg_surfacefactory.h>
+#include <wg_util.h>
+#include <wg_enumextras.h>
+
+#include <ostream>
+#include <vector>
+#include <algorithm>
 
 namespace wg 
 {
@@ -53,6 +59,208 @@ namespace wg
 	
 		return 0;
 	}
+
+	//____ Destructor _____________________________________________________________
+
+	SurfaceFactory::~SurfaceFactory()
+	{
+		// Surfaces might outlive us, make sure they don't report back.
+
+		Surface * p = m_pFirstSurface;
+		while( p )
+		{
+			Surface * pNext = p->m_pNextInFactory;
+			p->m_pFactory = nullptr;
+			p->m_pPrevInFactory = nullptr;
+			p->m_pNextInFactory = nullptr;
+			p = pNext;
+		}
+	}
+
+	//____ resetMemoryPeak() ______________________________________________________
+
+	/**
+	 * @brief Reset the high-water mark to current memory usage.
+	 */
+
+	void SurfaceFactory::resetMemoryPeak()
+	{
+		m_memoryPeak = m_memoryUsage;
+	}
+
+	//____ setMemoryBudget() ______________________________________________________
+
+	/**
+	 * @brief Set the amount of pixel memory surfaces of this factory should stay within.
+	 *
+	 * @param bytes		Budget in bytes, 0 for no budget.
+	 *
+	 * The budget is not enforced by refusing to create surfaces. Instead the eviction
+	 * callback is called before a surface is created that would bring the memory usage
+	 * over budget, giving owners of caches a chance to release surfaces first. The
+	 * callback is also called directly if the new budget is already exceeded.
+	 */
+
+	void SurfaceFactory::setMemoryBudget( int64_t bytes )
+	{
+		m_memoryBudget = bytes;
+		_reserveMemory(0);
+	}
+
+	//____ setEvictionCallback() __________________________________________________
+
+	/**
+	 * @brief Set function to call when memory budget is about to be exceeded.
+	 *
+	 * @param callback	Function to call, receiving the factory and the number of bytes
+	 *					that needs to be released to stay within budget.
+	 *
+	 * The callback is typically used to clear caches, like FreeTypeFont::clearCache() or
+	 * cached render layers. It is not called recursively if it creates surfaces itself.
+	 */
+
+	void SurfaceFactory::setEvictionCallback( const std::function<void(SurfaceFactory * pFactory, int64_t bytesNeeded)>& callback )
+	{
+		m_evictionCallback = callback;
+	}
+
+	//____ dumpSurfaces() _________________________________________________________
+
+	/**
+	 * @brief Write a summary of memory usage and the largest live surfaces to a stream.
+	 *
+	 * @param out			Stream to write to.
+	 * @param maxSurfaces	Maximum number of surfaces to list, largest first.
+	 *
+	 * Surfaces are listed with size, pixel format, class and the name set with
+	 * Surface::setCreator().
+	 */
+
+	void SurfaceFactory::dumpSurfaces( std::ostream& out, int maxSurfaces ) const
+	{
+		out << className() << ": " << m_nSurfaces << " surfaces, " << m_memoryUsage << " bytes (peak " << m_memoryPeak;
+		if( m_memoryBudget > 0 )
+			out << ", budget " << m_memoryBudget;
+		out << ")" << std::endl;
+
+		std::vector<Surface*>	surfaces;
+		surfaces.reserve(m_nSurfaces);
+		for( Surface * p = m_pFirstSurface ; p ; p = p->m_pNextInFactory )
+			surfaces.push_back(p);
+
+		int nListed = std::min( maxSurfaces, (int) surfaces.size() );
+		std::partial_sort( surfaces.begin(), surfaces.begin() + nListed, surfaces.end(), [](Surface * a, Surface * b) { return a->m_memoryUsage > b->m_memoryUsage; } );
+
+		for( int i = 0 ; i < nListed ; i++ )
+		{
+			Surface * p = surfaces[i];
+			Size sz = p->size();
+
+			out << "    " << p->m_memoryUsage << " bytes, " << sz.w << "x" << sz.h << " " << toString(p->pixelFormat()) << ", " << p->className();
+			out << ", " << (p->m_pCreator ? p->m_pCreator : "unknown creator") << std::endl;
+		}
+
+		if( nListed < (int) surfaces.size() )
+			out << "    ... and " << surfaces.size() - nListed << " more." << std::endl;
+	}
+
+	//____ _reserveMemory() _______________________________________________________
+
+	// Called by subclasses before creating a surface. Gives the eviction callback a chance
+	// to release memory if we would go over budget.
+
+	void SurfaceFactory::_reserveMemory( int64_t bytes ) const
+	{
+		if( m_memoryBudget <= 0 || !m_evictionCallback || m_bEvicting )
+			return;
+
+		int64_t overBudget = m_memoryUsage + bytes - m_memoryBudget;
+		if( overBudget > 0 )
+		{
+			m_bEvicting = true;
+			m_evictionCallback( const_cast<SurfaceFactory*>(this), overBudget );
+			m_bEvicting = false;
+		}
+	}
+
+	//____ _track() _______________________________________________________________
+
+	// Called by subclasses with the newly created surface before it is returned.
+
+	Surface_p SurfaceFactory::_track( Surface * pSurface ) const
+	{
+		if( !pSurface )
+			return nullptr;
+
+		int64_t bytes = pSurface->_allocatedBytes();
+
+		pSurface->m_pFactory = const_cast<SurfaceFactory*>(this);
+		pSurface->m_memoryUsage = bytes;
+		pSurface->m_pPrevInFactory = nullptr;
+		pSurface->m_pNextInFactory = m_pFirstSurface;
+		if( m_pFirstSurface )
+			m_pFirstSurface->m_pPrevInFactory = pSurface;
+		m_pFirstSurface = pSurface;
+
+		m_nSurfaces++;
+		m_memoryUsage += bytes;
+		if( m_memoryUsage > m_memoryPeak )
+			m_memoryPeak = m_memoryUsage;
+
+		return pSurface;
+	}
+
+	//____ _untrack() _____________________________________________________________
+
+	void SurfaceFactory::_untrack( Surface * pSurface ) const
+	{
+		if( pSurface->m_pPrevInFactory )
+			pSurface->m_pPrevInFactory->m_pNextInFactory = pSurface->m_pNextInFactory;
+		else
+			m_pFirstSurface = pSurface->m_pNextInFactory;
+
+		if( pSurface->m_pNextInFactory )
+			pSurface->m_pNextInFactory->m_pPrevInFactory = pSurface->m_pPrevInFactory;
+
+		m_nSurfaces--;
+		m_memoryUsage -= pSurface->m_memoryUsage;
+
+		pSurface->m_pFactory = nullptr;
+	}
+
+	//____ _adjustMemoryUsage() ___________________________________________________
+
+	// Called through Surface::_updateMemoryUsage() when a tracked surface has changed
+	// its allocations. Doesn't call the eviction callback, since this might happen
+	// in the middle of rendering.
+
+	void SurfaceFactory::_adjustMemoryUsage( int64_t bytes ) const
+	{
+		m_memoryUsage += bytes;
+		if( m_memoryUsage > m_memoryPeak )
+			m_memoryPeak = m_memoryUsage;
+	}
+
+	//____ _memoryNeeded() ________________________________________________________
+
+	// Estimate of the memory a surface about to be created will allocate, used for keeping
+	// within budget. Default assumes tightly packed pixels and a CLUT copied into the surface,
+	// factories should override it to match what their surfaces allocate.
+	//
+	// bSharedPixels is set when the surface will use pixels and CLUT in a Blob provided by the
+	// caller. That memory is owned by the Blob, possibly shared by several surfaces, and not
+	// accounted to the factory.
+
+	int64_t SurfaceFactory::_memoryNeeded( Size size, PixelFormat format, int hint, const Color * pClut, bool bSharedPixels ) const
+	{
+		if( bSharedPixels )
+			return 0;
+
+		PixelDescription	desc;
+		Util::pixelFormatToDescription( format, desc );
+
+		return (int64_t) size.w * size.h * desc.bits / 8 + (pClut ? 4096 : 0);
+	}
 	
 
 } // namespace wg
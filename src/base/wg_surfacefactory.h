@@ -28,6 +28,9 @@
 #include <wg_surface.h>
 #include <wg_blob.h>
 
+#include <functional>
+#include <iosfwd>
+
 
 namespace wg 
 {
@@ -46,6 +49,12 @@ namespace wg
 	 * are used by WonderGUI components that needs to dynamically create surfaces as
 	 * part of their operation, like FreeTypeFont.
 	 *
+	 * Each factory keeps track of the pixel memory held by the surfaces it has created
+	 * that are still alive, as allocated by each backend, including padding, CLUTs, mipmaps
+	 * and other extra buffers. Pixels in Blobs provided by the caller are not counted,
+	 * since they belong to the Blob and may be shared by several surfaces. A memory budget can be set, in which case an eviction callback
+	 * is called before a surface is created that would bring the factory over budget.
+	 *
 	 **/
 	class SurfaceFactory : public Object
 	{
@@ -68,8 +77,42 @@ namespace wg
         virtual Surface_p	createSurface( Size size, PixelFormat format, uint8_t * pPixels, int pitch, const PixelDescription * pPixelDescription = 0, int hint = SurfaceHint::Static, const Color * pClut = nullptr) const = 0;
         virtual Surface_p	createSurface( Surface * pOther, int hint = SurfaceHint::Static ) const = 0;
 
+		//.____ Memory _____________________________________________________
+
+		inline int64_t		memoryUsage() const { return m_memoryUsage; }	///< @brief Bytes of pixel memory held by live surfaces created by this factory.
+		inline int64_t		memoryPeak() const { return m_memoryPeak; }		///< @brief Highest memoryUsage() since creation or last resetMemoryPeak().
+		inline int			surfaceCount() const { return m_nSurfaces; }	///< @brief Number of live surfaces created by this factory.
+		void				resetMemoryPeak();
+
+		void				setMemoryBudget( int64_t bytes );
+		inline int64_t		memoryBudget() const { return m_memoryBudget; }
+
+		void				setEvictionCallback( const std::function<void(SurfaceFactory * pFactory, int64_t bytesNeeded)>& callback );
+
+		void				dumpSurfaces( std::ostream& out, int maxSurfaces = 16 ) const;
+
 	protected:
-		virtual ~SurfaceFactory() {}
+		friend class Surface;
+
+		virtual ~SurfaceFactory();
+
+		void				_reserveMemory( int64_t bytes ) const;
+		Surface_p			_track( Surface * pSurface ) const;
+		void				_untrack( Surface * pSurface ) const;
+		void				_adjustMemoryUsage( int64_t bytes ) const;
+
+		virtual int64_t		_memoryNeeded( Size size, PixelFormat format, int hint, const Color * pClut, bool bSharedPixels ) const;
+
+		// Accounting is updated from const createSurface() calls.
+
+		mutable int64_t		m_memoryUsage = 0;
+		mutable int64_t		m_memoryPeak = 0;
+		mutable int			m_nSurfaces = 0;
+		mutable Surface *	m_pFirstSurface = nullptr;
+		mutable bool		m_bEvicting = false;
+
+		int64_t				m_memoryBudget = 0;
+		std::function<void(SurfaceFactory * pFactory, int64_t bytesNeeded)>	m_evictionCallback;
 	};
 	
 	
@@ -0,0 +1,300 @@
+/*=========================================================================
+
+                         >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+#include <algorithm>
+
+#include <wg_tickscheduler.h>
+#include <wg_msgrouter.h>
+#include <wg_widget.h>
+#include <wg_base.h>
+
+namespace wg 
+{
+	
+	const char TickScheduler::CLASSNAME[] = {"TickScheduler"};
+	const int TickScheduler::c_hiddenRecheckInterval;
+
+	/**
+	 * @class TickScheduler
+	 * @brief Central scheduler for animation and timer ticks.
+	 *
+	 * Instead of routing every Tick message to every animated widget, receivers register
+	 * themselves as tickers with the TickScheduler owned by Base. Each ticker has its own
+	 * deadline for when it next needs a tick, which is either derived from a fixed interval
+	 * or set explicitly through setNextTick(). Deadlines are kept in a min-heap, so a Tick
+	 * message only touches the tickers that actually are due.
+	 *
+	 * A ticker receives at most one TickMsg per dispatched Tick, no matter how many of its
+	 * deadlines have passed, with timediff set to the time since its own previous tick.
+	 * Tickers that are widgets are skipped while not visible and their elapsed time is
+	 * carried over to the first tick they receive when visible again.
+	 *
+	 * The host application can call nextDeadline() to find out when the next tick is needed
+	 * and sleep until then instead of posting Tick messages at a fixed rate.
+	 */
+
+	//____ Constructor ____________________________________________________________
+
+	TickScheduler::TickScheduler()
+	{
+		m_idCounter = 0;
+		m_timestamp = -1;
+
+		m_tickRouteId = Base::msgRouter()->addRoute( MsgType::Tick, this );
+	}
+
+	//____ Destructor _____________________________________________________________
+
+	TickScheduler::~TickScheduler()
+	{
+		Base::msgRouter()->deleteRoute( m_tickRouteId );
+	}
+
+	//____ isInstanceOf() _________________________________________________________
+
+	bool TickScheduler::isInstanceOf( const char * pClassName ) const
+	{ 
+		if( pClassName==CLASSNAME )
+			return true;
+
+		return Receiver::isInstanceOf(pClassName);
+	}
+
+	//____ className() ____________________________________________________________
+
+	const char * TickScheduler::className( void ) const
+	{ 
+		return CLASSNAME; 
+	}
+
+	//____ cast() _________________________________________________________________
+
+	TickScheduler_p TickScheduler::cast( Object * pObject )
+	{
+		if( pObject && pObject->isInstanceOf(CLASSNAME) )
+			return TickScheduler_p( static_cast<TickScheduler*>(pObject) );
+
+		return 0;
+	}
+
+	//____ addTicker() ____________________________________________________________
+	/**
+	 * @brief Register a receiver for ticks.
+	 *
+	 * @param pReceiver	Receiver that should receive TickMsgs.
+	 * @param interval	Millisec between ticks. 0 results in a tick every time a Tick message is
+	 *					dispatched, as long as the ticker is due.
+	 *
+	 * The receiver is kept as a weak pointer. The ticker is removed automatically once the
+	 * receiver has been destroyed, but should preferably be removed by the receiver itself.
+	 *
+	 * @return Id of the new ticker, used in calls to removeTicker(), setTickInterval() and setNextTick().
+	 */
+
+	TickerId TickScheduler::addTicker( Receiver * pReceiver, int interval )
+	{
+		if( !pReceiver || interval < 0 )
+			return 0;
+
+		TickerId id = ++m_idCounter;
+
+		Ticker& ticker = m_tickers[id];
+		ticker.pReceiver	= pReceiver;
+		ticker.pWidget		= pReceiver->isInstanceOf( Widget::CLASSNAME ) ? static_cast<Widget*>(pReceiver) : nullptr;
+		ticker.interval		= interval;
+		ticker.lastTick		= m_timestamp;
+
+		_schedule( id, ticker, std::max(m_timestamp, (int64_t) 0) + interval );
+		return id;
+	}
+
+	//____ removeTicker() _________________________________________________________
+
+	bool TickScheduler::removeTicker( TickerId id )
+	{
+		return m_tickers.erase(id) > 0;
+	}
+
+	//____ setTickInterval() ______________________________________________________
+	/**
+	 * @brief Change the interval between ticks for a ticker.
+	 *
+	 * The new interval takes effect after the next tick. A suspended ticker stays suspended.
+	 */
+
+	bool TickScheduler::setTickInterval( TickerId id, int interval )
+	{
+		auto it = m_tickers.find(id);
+		if( it == m_tickers.end() || interval < 0 )
+			return false;
+
+		it->second.interval = interval;
+		return true;
+	}
+
+	//____ setNextTick() __________________________________________________________
+	/**
+	 * @brief Set when a ticker should receive its next tick.
+	 *
+	 * @param id		Id of the ticker.
+	 * @param delay		Millisec from the latest Tick until the next tick of this ticker.
+	 *					A negative value suspends the ticker until setNextTick() is called again.
+	 *
+	 * Overrides the interval for the next tick only. Can be called from within the
+	 * receivers handling of a tick, in which case the interval is not applied.
+	 */
+
+	bool TickScheduler::setNextTick( TickerId id, int delay )
+	{
+		auto it = m_tickers.find(id);
+		if( it == m_tickers.end() )
+			return false;
+
+		if( delay < 0 )
+			it->second.deadline = -1;
+		else
+			_schedule( id, it->second, std::max(m_timestamp, (int64_t) 0) + delay );
+		return true;
+	}
+
+	//____ nextDeadline() _________________________________________________________
+	/**
+	 * @brief Get timestamp of the earliest upcoming tick.
+	 *
+	 * Timestamps are in the same timebase as the Tick messages posted by the host.
+	 * A deadline that already has passed means that a Tick should be posted as soon as possible.
+	 *
+	 * @return Timestamp of the earliest deadline or -1 if no ticker is scheduled.
+	 */
+
+	int64_t TickScheduler::nextDeadline() const
+	{
+		while( !m_wakeups.empty() )
+		{
+			const Wakeup& wakeup = m_wakeups.front();
+			auto it = m_tickers.find(wakeup.id);
+			if( it != m_tickers.end() && it->second.deadline == wakeup.deadline )
+				return wakeup.deadline;
+
+			std::pop_heap( m_wakeups.begin(), m_wakeups.end() );
+			m_wakeups.pop_back();
+		}
+		return -1;
+	}
+
+	//____ receive() ______________________________________________________________
+
+	void TickScheduler::receive( Msg * pMsg )
+	{
+		if( pMsg->type() == MsgType::Tick )
+		{
+			TickMsg * pTick = static_cast<TickMsg*>(pMsg);
+			_tick( pTick->timestamp(), pTick->timediff() );
+		}
+	}
+
+	//____ _tick() ________________________________________________________________
+
+	void TickScheduler::_tick( int64_t timestamp, int timediff )
+	{
+		m_timestamp = timestamp;
+
+		// Collect all due tickers before delivering any ticks, so that tickers
+		// rescheduled during delivery can't be ticked twice.
+
+		while( !m_wakeups.empty() && m_wakeups.front().deadline <= timestamp )
+		{
+			Wakeup wakeup = m_wakeups.front();
+			std::pop_heap( m_wakeups.begin(), m_wakeups.end() );
+			m_wakeups.pop_back();
+
+			auto it = m_tickers.find(wakeup.id);
+			if( it == m_tickers.end() || it->second.deadline != wakeup.deadline )
+				continue;											// Stale entry.
+
+			it->second.deadline = -2;
+			m_dueTickers.push_back(wakeup.id);
+		}
+
+		for( TickerId id : m_dueTickers )
+		{
+			auto it = m_tickers.find(id);
+			if( it == m_tickers.end() )
+				continue;											// Removed by an earlier ticker.
+
+			Ticker& ticker = it->second;
+			Receiver_p pReceiver = ticker.pReceiver.rawPtr();
+			if( !pReceiver )
+			{
+				m_tickers.erase(it);
+				continue;
+			}
+
+			if( ticker.pWidget && !ticker.pWidget->_isVisible() )
+			{
+				_schedule( id, ticker, timestamp + std::max(ticker.interval, c_hiddenRecheckInterval) );
+				continue;
+			}
+
+			int diff = ticker.lastTick >= 0 ? (int) (timestamp - ticker.lastTick) : timediff;
+			ticker.lastTick = timestamp;
+
+			pReceiver->receive( TickMsg::create(timestamp, diff) );
+
+			it = m_tickers.find(id);
+			if( it != m_tickers.end() && it->second.deadline == -2 )
+				_schedule( id, it->second, timestamp + it->second.interval );
+		}
+
+		m_dueTickers.clear();
+	}
+
+	//____ _schedule() ____________________________________________________________
+
+	void TickScheduler::_schedule( TickerId id, Ticker& ticker, int64_t deadline )
+	{
+		ticker.deadline = deadline;
+
+		m_wakeups.push_back( { deadline, id } );
+		std::push_heap( m_wakeups.begin(), m_wakeups.end() );
+
+		if( m_wakeups.size() > m_tickers.size()*4 + 64 )
+			_compactWakeups();
+	}
+
+	//____ _compactWakeups() ______________________________________________________
+
+	void TickScheduler::_compactWakeups()
+	{
+		// Remove stale entries left by rescheduled and removed tickers.
+
+		auto newEnd = std::remove_if( m_wakeups.begin(), m_wakeups.end(), [this](const Wakeup& wakeup)
+		{
+			auto it = m_tickers.find(wakeup.id);
+			return it == m_tickers.end() || it->second.deadline != wakeup.deadline;
+		});
+
+		m_wakeups.erase( newEnd, m_wakeups.end() );
+		std::make_heap( m_wakeups.begin(), m_wakeups.end() );
+	}
+
+} // namespace wg
@@ -0,0 +1,111 @@
+/*=========================================================================
+
+                         >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+#ifndef WG_TICKSCHEDULER_DOT_H
+#define WG_TICKSCHEDULER_DOT_H
+#pragma once
+
+#include <vector>
+#include <map>
+
+#include <wg_receiver.h>
+#include <wg_types.h>
+
+namespace wg 
+{
+	class Widget;
+
+	class TickScheduler;
+	typedef	StrongPtr<TickScheduler>	TickScheduler_p;
+	typedef	WeakPtr<TickScheduler>		TickScheduler_wp;
+
+	//____ TickScheduler _______________________________________________________
+
+	class TickScheduler : public Receiver
+	{
+	public:
+		//.____ Creation __________________________________________
+
+		static TickScheduler_p	create() { return TickScheduler_p(new TickScheduler()); }
+
+		//.____ Identification __________________________________________
+
+		bool					isInstanceOf( const char * pClassName ) const;
+		const char *			className( void ) const;
+		static const char		CLASSNAME[];
+		static TickScheduler_p	cast( Object * pObject );
+
+		//.____ Control _______________________________________________________
+
+		TickerId	addTicker( Receiver * pReceiver, int interval = 0 );
+		bool		removeTicker( TickerId id );
+
+		bool		setTickInterval( TickerId id, int interval );
+		bool		setNextTick( TickerId id, int delay );
+
+		//.____ State _________________________________________________________
+
+		int64_t		nextDeadline() const;
+		int64_t		timestamp() const { return m_timestamp; }
+		int			nbTickers() const { return (int) m_tickers.size(); }
+
+		//.____ Misc __________________________________________________________
+
+		void		receive( Msg * pMsg );
+
+	protected:
+		TickScheduler();
+		virtual ~TickScheduler();
+
+		const static int	c_hiddenRecheckInterval = 100;		// Millisec between visibility checks of hidden widgets.
+
+		struct Ticker
+		{
+			Receiver_wp	pReceiver;
+			Widget *	pWidget;			// Set if receiver is a widget, only valid while pReceiver is alive.
+			int			interval;			// Millisec between ticks, 0 = every tick.
+			int64_t		deadline;			// -1 = suspended, waiting for setNextTick(). -2 = being ticked.
+			int64_t		lastTick;			// Timestamp of last delivered tick, -1 = none yet.
+		};
+
+		struct Wakeup
+		{
+			int64_t		deadline;
+			TickerId	id;
+
+			bool operator<( const Wakeup& other ) const { return deadline > other.deadline; }	// Reversed to make std heap a min-heap.
+		};
+
+		void		_tick( int64_t timestamp, int timediff );
+		void		_schedule( TickerId id, Ticker& ticker, int64_t deadline );
+		void		_compactWakeups();
+
+		RouteId							m_tickRouteId;
+		TickerId						m_idCounter;
+		int64_t							m_timestamp;		// Timestamp of latest tick, -1 before first tick.
+
+		std::map<TickerId,Ticker>		m_tickers;
+		std::vector<TickerId>			m_dueTickers;		// Tickers collected for the tick in progress.
+		mutable std::vector<Wakeup>		m_wakeups;			// Min-heap of deadlines. May contain stale entries.
+	};
+
+} // namespace wg
+#endif //WG_TICKSCHEDULER_DOT_H
@@ -134,6 +134,7 @@ namespace wg
 	
 	
 	typedef unsigned int	RouteId;
+	typedef unsigned int	TickerId;
 	
 	typedef uint16_t		TextStyle_h;
 		
@@ -532,6 +533,7 @@ namespace wg
 		ValueModified,
 		ValueEdited,
 		SpanModified,
+		BufferingChanged,
 		Other
 	};
 	
@@ -561,6 +563,8 @@ namespace wg
 		const int Static = 0;		// No content access/modification expected
 		const int Dynamic = 1;		// Expect content to be accessed and/or modified
 		const int  WriteOnly = 2;	// Can only be locked in WriteOnly mode. Alpha can still be read pixel by pixel if present.
+		const int  Mipmapped = 4;	// Keep mipmaps for smoother and faster downscaling, generated when first needed. Can be combined with the others.
+		const int  Premultiplied = 8;	// Store color premultiplied by alpha internally for faster blending, if supported. Can be combined with the others.
 	};
 
 	
@@ -700,7 +704,18 @@ namespace wg
 		EndSurfaceUpdate,
 		FillSurface,
 		CopySurface,
-		DeleteSurface
+		DeleteSurface,
+
+		// Chunks added later go last, so that ids of existing chunks in recorded streams don't change.
+
+		ClipDrawPolyline,					// Draw anti-aliased line through a series of points.
+
+		BeginKeyframe,						// Start of a state snapshot in a GfxStreamRecording, skipped during normal playback.
+		EndKeyframe,
+
+		ClipDrawSegments,					// Fill rectangle with segments separated by anti-aliased edges.
+
+		KeyframeData						// One chunk of a keyframes content, wrapped so that it is skipped by size.
 	};
 
 
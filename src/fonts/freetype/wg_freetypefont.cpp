@@ -706,6 +706,7 @@ namespace wg
 		Size texSize = calcTextureSize( slotSize, 16 );
 	
 		Surface_p pSurf = s_pSurfaceFactory->createSurface( texSize );
+		pSurf->setCreator( "FreeTypeFont glyph cache" );
 		pSurf->fill( Color( 255,255,255,0 ) );
 	
 		CacheSurf * pCache = new CacheSurf( pSurf );
@@ -22,6 +22,9 @@
 
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
+#include <cstddef>
+#include <algorithm>
 
 #include <wg_glgfxdevice.h>
 #include <wg_glsurface.h>
@@ -36,6 +39,9 @@ namespace wg
 {
 	const char GlGfxDevice::CLASSNAME[] = { "GlGfxDevice" };
 
+	GLuint	GlGfxDevice::s_activeProgram = 0;
+	GlGfxDevice * GlGfxDevice::s_pBatchingDevice = nullptr;
+
 
 
 	//____ Vertex and Fragment shaders ____________________________________________
@@ -163,6 +169,43 @@ namespace wg
 		"   outColor.b = aFrac*topBorderColor.b + bFrac*frontColor.b + cFrac*bottomBorderColor.b + dFrac*backColor.b;  "
 		"}                                      ";
 
+	// Texture buffer starts with the segment colors packed as ARGB, followed by
+	// start amount and increment of each edge for every column.
+
+	const char segmentsFragmentShader[] =
+
+		"#version 330 core\n"
+		"layout(origin_upper_left, pixel_center_integer) in vec4 gl_FragCoord;"
+		"uniform isamplerBuffer texId;          "
+		"uniform vec2 windowOfs;				"
+		"uniform int edges;                     "
+		"out vec4 outColor;                     "
+		"vec4 segmentColor(int segment)         "
+		"{                                      "
+		"   int c = texelFetch(texId, segment).r;"
+		"   return vec4((c >> 16) & 255, (c >> 8) & 255, c & 255, (c >> 24) & 255) / 255.0;"
+		"}                                      "
+		"void main()                            "
+		"{										"
+		"   ivec2 ofs = ivec2(gl_FragCoord.xy - windowOfs);"
+		"   int column = edges + 1 + ofs.x*edges*2;"
+		"   float prevFrac = 1.0;               "
+		"   vec4 acc = vec4(0.0);               "
+		"   for (int i = 0; i < edges; i++)     "
+		"   {                                   "
+		"      int amount = texelFetch(texId, column + i*2).r + texelFetch(texId, column + i*2 + 1).r * ofs.y;"
+		"      float frac = clamp(amount/65536.0, 0.0, 1.0);"
+		"      vec4 col = segmentColor(i);      "
+		"      acc += vec4(col.rgb, 1.0) * col.a * (prevFrac - frac);"
+		"      prevFrac = frac;                 "
+		"   }                                   "
+		"   vec4 col = segmentColor(edges);     "
+		"   acc += vec4(col.rgb, 1.0) * col.a * prevFrac;"
+		"   if (acc.a == 0.0)                   "
+		"      discard;                         "
+		"   outColor = vec4(acc.rgb / acc.a, acc.a);"
+		"}                                      ";
+
 
 /* Original, unoptimized versions
     
@@ -283,6 +326,55 @@ namespace wg
     "   color = texture(texId, texUV) * tint;     "
     "}                                      ";
 
+	// Batched fills and blits, with tint per vertex. Fills are drawn as untextured blits.
+
+	const char batchVertexShader[] =
+
+		"#version 330 core\n"
+		"uniform vec2 dimensions;                                   "
+		"layout(location = 0) in vec2 pos;                          "
+		"layout(location = 1) in vec2 texPos;                       "
+		"layout(location = 2) in vec4 color;                        "
+		"layout(location = 3) in float textured;                    "
+		"out vec2 texUV;                                            "
+		"out vec4 tint;                                             "
+		"out float texMix;                                          "
+		"void main()                                                "
+		"{                                                          "
+		"   gl_Position.x = pos.x*2/dimensions.x - 1.0;             "
+		"   gl_Position.y = pos.y*2/dimensions.y - 1.0;             "
+		"   gl_Position.z = 0.0;                                    "
+		"   gl_Position.w = 1.0;                                    "
+		"   texUV = texPos;                                         "
+		"   tint = color;                                           "
+		"   texMix = textured;                                      "
+		"}                                                          ";
+
+	const char batchFragmentShader[] =
+
+		"#version 330 core\n"
+		"uniform sampler2D texId;               "
+		"in vec2 texUV;                         "
+		"in vec4 tint;                          "
+		"in float texMix;                       "
+		"out vec4 outColor;                     "
+		"void main()                            "
+		"{                                      "
+		"   outColor = mix(vec4(1.0), texture(texId, texUV), texMix) * tint; "
+		"}                                      ";
+
+	// Used instead when a batch has no blits, so fills don't pay for a texture lookup per pixel.
+
+	const char batchFillFragmentShader[] =
+
+		"#version 330 core\n"
+		"in vec4 tint;                          "
+		"out vec4 outColor;                     "
+		"void main()                            "
+		"{                                      "
+		"   outColor = tint;                    "
+		"}                                      ";
+
     const char plotVertexShader[] =
     
     "#version 330 core\n"
@@ -311,6 +403,36 @@ namespace wg
     "   outColor = color * tint;            "
     "}                                      ";
 
+	const char polylineVertexShader[] =
+
+		"#version 330 core\n"
+		"uniform vec2 dimensions;                                  "
+		"layout(location = 0) in vec2 pos;                          "
+		"layout(location = 1) in float dist;                        "
+		"out float fragDist;                                        "
+		"void main()                                                "
+		"{                                                          "
+		"   gl_Position.x = pos.x*2/dimensions.x - 1.0;             "
+		"   gl_Position.y = pos.y*2/dimensions.y - 1.0;             "
+		"   gl_Position.z = 0.0;                                    "
+		"   gl_Position.w = 1.0;                                    "
+		"   fragDist = dist;                                        "
+		"}                                                          ";
+
+
+	const char polylineFragmentShader[] =
+
+		"#version 330 core\n"
+		"uniform vec4 color;                    "
+		"uniform float w;                       "
+		"in float fragDist;                     "
+		"out vec4 outColor;                     "
+		"void main()                            "
+		"{                                      "
+		"   outColor.rgb = color.rgb;           "
+		"   outColor.a = color.a * clamp(w - abs(fragDist), 0.0, 1.0);  "
+		"}                                      ";
+
     
     
     
@@ -382,6 +504,11 @@ namespace wg
         m_blitProgTintLoc = glGetUniformLocation( m_blitProg, "tint" );
         m_blitProgTexIdLoc = glGetUniformLocation( m_blitProg, "texId" );
 
+		m_batchProg = _createGLProgram( batchVertexShader, batchFragmentShader );
+		m_batchProgTexIdLoc = glGetUniformLocation( m_batchProg, "texId" );
+
+		m_batchFillProg = _createGLProgram( batchVertexShader, batchFillFragmentShader );
+
 		m_horrWaveProg = _createGLProgram(fillVertexShader, horrWaveFragmentShader);
 		m_horrWaveProgTexIdLoc = glGetUniformLocation(m_horrWaveProg, "texId");
 		m_horrWaveProgWindowOfsLoc = glGetUniformLocation(m_horrWaveProg, "windowOfs");
@@ -390,10 +517,20 @@ namespace wg
 		m_horrWaveProgFrontFillLoc = glGetUniformLocation(m_horrWaveProg, "frontColor");
 		m_horrWaveProgBackFillLoc = glGetUniformLocation(m_horrWaveProg, "backColor");
 
+		m_segmentsProg = _createGLProgram(fillVertexShader, segmentsFragmentShader);
+		m_segmentsProgTexIdLoc = glGetUniformLocation(m_segmentsProg, "texId");
+		m_segmentsProgWindowOfsLoc = glGetUniformLocation(m_segmentsProg, "windowOfs");
+		m_segmentsProgEdgesLoc = glGetUniformLocation(m_segmentsProg, "edges");
+
         assert( glGetError() == 0 );
         m_plotProg = _createGLProgram( plotVertexShader, plotFragmentShader );
         m_plotProgTintLoc = glGetUniformLocation( m_plotProg, "tint" );
         assert( glGetError() == 0 );
+
+		m_polylineProg = _createGLProgram(polylineVertexShader, polylineFragmentShader);
+		m_polylineProgColorLoc = glGetUniformLocation(m_polylineProg, "color");
+		m_polylineProgWLoc = glGetUniformLocation(m_polylineProg, "w");
+		assert(glGetError() == 0);
         
         glGenVertexArrays(1, &m_vertexArrayId);
         glBindVertexArray(m_vertexArrayId);
@@ -404,6 +541,38 @@ namespace wg
         glGenBuffers(1, &m_texCoordBufferId);
         glBindVertexArray(0);
  
+		// Vertex array for batches, with the ring buffer and the quad indices, which never change.
+
+		glGenVertexArrays(1, &m_batchVertexArrayId);
+		glBindVertexArray(m_batchVertexArrayId);
+
+		glGenBuffers(1, &m_batchVertexBufferId);
+		glBindBuffer(GL_ARRAY_BUFFER, m_batchVertexBufferId);
+		glBufferData(GL_ARRAY_BUFFER, c_batchRingVertices * sizeof(BatchVertex), NULL, GL_STREAM_DRAW);
+
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(BatchVertex), (void*) offsetof(BatchVertex, x));
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(BatchVertex), (void*) offsetof(BatchVertex, u));
+		glVertexAttribPointer(2, GL_BGRA, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(BatchVertex), (void*) offsetof(BatchVertex, color));
+		glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(BatchVertex), (void*) offsetof(BatchVertex, textured));
+		for( int i = 0 ; i < 4 ; i++ )
+			glEnableVertexAttribArray(i);
+
+		GLushort * pIndices = new GLushort[c_maxBatchQuads*6];
+		for( int i = 0 ; i < c_maxBatchQuads ; i++ )
+		{
+			GLushort * p = pIndices + i*6;
+			GLushort v = (GLushort) (i*4);
+			p[0] = v; p[1] = v+1; p[2] = v+2;
+			p[3] = v; p[4] = v+2; p[5] = v+3;
+		}
+
+		glGenBuffers(1, &m_batchIndexBufferId);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_batchIndexBufferId);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, c_maxBatchQuads * 6 * sizeof(GLushort), pIndices, GL_STATIC_DRAW);
+		delete [] pIndices;
+
+		glBindVertexArray(0);
+
 		glGenFramebuffers(1, &m_framebufferId);
 
     	// For some unknown reason this causes issues with techture bliting in the second open instance
@@ -413,6 +582,8 @@ namespace wg
 			glGenTextures(1, &m_horrWaveBufferTexture);
 			glGenBuffers(1, &m_horrWaveBufferTextureData);
         	glGenBuffers(1, &m_dummyBuffer);
+			glGenTextures(1, &m_segmentsBufferTexture);
+			glGenBuffers(1, &m_segmentsBufferTextureData);
 		
         }
         setTintColor( Color::White );        
@@ -425,9 +596,18 @@ namespace wg
 	GlGfxDevice::~GlGfxDevice()
 	{
 		assert( glGetError() == 0 );
+
+		if( s_pBatchingDevice == this )
+			s_pBatchingDevice = nullptr;			// Too late to draw whatever is left.
+
+		glDeleteBuffers(1, &m_batchVertexBufferId);
+		glDeleteBuffers(1, &m_batchIndexBufferId);
+		glDeleteVertexArrays(1, &m_batchVertexArrayId);
 		glDeleteBuffers(1, &m_vertexBufferId);
 		glDeleteBuffers(1, &m_texCoordBufferId);
 		glDeleteBuffers(1, &m_dummyBuffer);
+		glDeleteBuffers(1, &m_segmentsBufferTextureData);
+		glDeleteTextures(1, &m_segmentsBufferTexture);
 		assert( glGetError() == 0 );
 		glDeleteVertexArrays(1, &m_vertexArrayId);
 		assert( glGetError() == 0 );
@@ -485,6 +665,9 @@ namespace wg
 	{
 		// Do NOT add any gl-calls here, INCLUDING glGetError()!!!
 		// This method can be called without us having our GL-context.
+
+		if (m_bRendering)
+			_flushBatch();					// Queued quads belong to the old canvas.
         
 		m_pCanvas					= nullptr;
 		m_bFlipY					= true;
@@ -514,6 +697,9 @@ namespace wg
 		if (!pSurface)
 			return false;			// Surface must be of type GlSurface!
 
+		if (m_bRendering)
+			_flushBatch();					// Queued quads belong to the old canvas.
+
 		m_pCanvas		= pSurface;
 		m_bFlipY		= false;
 		m_canvasViewport = { 0,0,pSurface->size() };
@@ -536,7 +722,12 @@ namespace wg
 		if (m_pCanvas)
 		{
 			auto pCanvas = GlSurface::cast(m_pCanvas);
+
+			if( pCanvas->m_pAtlasPage )
+				pCanvas->_leaveAtlas();			// Can't render into a shared atlas page.
+
 			pCanvas->m_bBackingBufferStale = true;
+			pCanvas->m_bMipmapsStale = true;
 
 			glBindFramebuffer(GL_FRAMEBUFFER, m_framebufferId);
 			glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, pCanvas->getTexture(), 0);
@@ -567,35 +758,52 @@ namespace wg
 	{
         assert( glGetError() == 0 );
 
-		glUseProgram(m_fillProg);
+		_useProgram(m_fillProg);
 		GLint dimLoc = glGetUniformLocation(m_fillProg, "dimensions");
 		glUniform2f(dimLoc, (GLfloat)m_canvasSize.w, (GLfloat)m_canvasSize.h);
 
-		glUseProgram(m_aaFillProg);
+		_useProgram(m_aaFillProg);
 		dimLoc = glGetUniformLocation(m_aaFillProg, "dimensions");
 		glUniform2f(dimLoc, (GLfloat)m_canvasSize.w, (GLfloat)m_canvasSize.h);
 
-		glUseProgram(m_mildSlopeProg);
+		_useProgram(m_mildSlopeProg);
 		dimLoc = glGetUniformLocation(m_mildSlopeProg, "dimensions");
 		glUniform2f(dimLoc, (GLfloat)m_canvasSize.w, (GLfloat)m_canvasSize.h);
 
-		glUseProgram(m_steepSlopeProg);
+		_useProgram(m_steepSlopeProg);
 		dimLoc = glGetUniformLocation(m_steepSlopeProg, "dimensions");
 		glUniform2f(dimLoc, (GLfloat)m_canvasSize.w, (GLfloat)m_canvasSize.h);
 
-		glUseProgram(m_blitProg);
+		_useProgram(m_blitProg);
 		dimLoc = glGetUniformLocation(m_blitProg, "dimensions");
 		glUniform2f(dimLoc, (GLfloat)m_canvasSize.w, (GLfloat)m_canvasSize.h);
 		glUniform1i(m_blitProgTexIdLoc, 0);
 
-		glUseProgram(m_plotProg);
+		_useProgram(m_batchProg);
+		dimLoc = glGetUniformLocation(m_batchProg, "dimensions");
+		glUniform2f(dimLoc, (GLfloat)m_canvasSize.w, (GLfloat)m_canvasSize.h);
+		glUniform1i(m_batchProgTexIdLoc, 0);
+
+		_useProgram(m_batchFillProg);
+		dimLoc = glGetUniformLocation(m_batchFillProg, "dimensions");
+		glUniform2f(dimLoc, (GLfloat)m_canvasSize.w, (GLfloat)m_canvasSize.h);
+
+		_useProgram(m_plotProg);
 		dimLoc = glGetUniformLocation(m_plotProg, "dimensions");
 		glUniform2f(dimLoc, (GLfloat)m_canvasSize.w, (GLfloat)m_canvasSize.h);
 
-		glUseProgram(m_horrWaveProg);
+		_useProgram(m_horrWaveProg);
 		dimLoc = glGetUniformLocation(m_horrWaveProg, "dimensions");
 		glUniform2f(dimLoc, (GLfloat)m_canvasSize.w, (GLfloat)m_canvasSize.h);
 
+		_useProgram(m_polylineProg);
+		dimLoc = glGetUniformLocation(m_polylineProg, "dimensions");
+		glUniform2f(dimLoc, (GLfloat)m_canvasSize.w, (GLfloat)m_canvasSize.h);
+
+		_useProgram(m_segmentsProg);
+		dimLoc = glGetUniformLocation(m_segmentsProg, "dimensions");
+		glUniform2f(dimLoc, (GLfloat)m_canvasSize.w, (GLfloat)m_canvasSize.h);
+
         assert( glGetError() == 0 );
 	}
 
@@ -606,9 +814,9 @@ namespace wg
 	{
 		GfxDevice::setTintColor(color);
 
-        glUseProgram( m_blitProg );
+        _useProgram( m_blitProg );
         glUniform4f( m_blitProgTintLoc, m_tintColor.r/255.f, m_tintColor.g/255.f, m_tintColor.b/255.f, m_tintColor.a/255.f );
-        glUseProgram( m_plotProg );
+        _useProgram( m_plotProg );
         glUniform4f( m_plotProgTintLoc, m_tintColor.r/255.f, m_tintColor.g/255.f, m_tintColor.b/255.f, m_tintColor.a/255.f );
     }
 
@@ -623,9 +831,12 @@ namespace wg
 			blendMode != BlendMode::Invert )
 				return false;
 	 
-		GfxDevice::setBlendMode(blendMode);
-		if( m_bRendering )
+		if( m_bRendering && blendMode != m_blendMode )
+		{
+			_flushBatch();
 			_setBlendMode(blendMode);
+		}
+		GfxDevice::setBlendMode(blendMode);
 
         assert( glGetError() == 0 );
 		return true;
@@ -640,7 +851,15 @@ namespace wg
         if( m_bRendering == true )
 			return false;
 
-		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		// Another device might be in the middle of rendering, let it draw what it has
+		// queued before we change framebuffer.
+
+		_flushPendingBatch();
+
+		// A surface canvas gets its own framebuffer in _setFramebuffer(), which checks it.
+		// The context might not have a default framebuffer at all (e.g. surfaceless EGL).
+
+		if (!m_pCanvas && glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
 			return false;
 
 		// Remember GL states so we can restore in EndRender()
@@ -661,6 +880,12 @@ namespace wg
 		glDisable(GL_DEPTH_TEST);
         glEnable(GL_SCISSOR_TEST);
 
+		// Others might have changed program and texture bindings since our last frame.
+
+		s_activeProgram = 0;
+		GlSurface::s_boundTexture = 0;
+		glActiveTexture(GL_TEXTURE0);
+
 		// Update program dimensions
 
 		_updateProgramDimensions();
@@ -688,6 +913,7 @@ namespace wg
 		if( m_bRendering == false )
 			return false;
 
+		_flushBatch();
         glFlush();
 
 		if( m_glDepthTest )
@@ -722,41 +948,13 @@ namespace wg
 			return;
  
         Color fillColor = _col * m_tintColor;
-        
-        int	dx1 = _rect.x;
-		int	dy1 = m_canvasSize.h - _rect.y;
-		int dx2 = _rect.x + _rect.w;
-		int dy2 = m_canvasSize.h - (_rect.y + _rect.h);
 
-        m_vertexBufferData[0] = (GLfloat) dx1;
-        m_vertexBufferData[1] = (GLfloat) dy1;
-        m_vertexBufferData[2] = (GLfloat) dx2;
-        m_vertexBufferData[3] = (GLfloat) dy1;
-        m_vertexBufferData[4] = (GLfloat) dx2;
-        m_vertexBufferData[5] = (GLfloat) dy2;
-        m_vertexBufferData[6] = (GLfloat) dx1;
-        m_vertexBufferData[7] = (GLfloat) dy2;
-        
-        glUseProgram( m_fillProg );
-        glUniform4f( m_fillProgColorLoc, fillColor.r/255.f, fillColor.g/255.f, fillColor.b/255.f, fillColor.a/255.f );
-        
-        glBindVertexArray(m_vertexArrayId);
+		float	dx1 = (float) _rect.x;
+		float	dy1 = (float) (m_canvasSize.h - _rect.y);
+		float	dx2 = (float) (_rect.x + _rect.w);
+		float	dy2 = (float) (m_canvasSize.h - (_rect.y + _rect.h));
 
-        glEnableVertexAttribArray(0);
-        glBindBuffer(GL_ARRAY_BUFFER, m_vertexBufferId);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(m_vertexBufferData), m_vertexBufferData, GL_DYNAMIC_DRAW);
-        glVertexAttribPointer(
-                              0,                  // attribute 0. No particular reason for 0, but must match the layout in the shader.
-                              2,                  // size
-                              GL_FLOAT,           // type
-                              GL_FALSE,           // normalized?
-                              0,                  // stride
-                              (void*)0            // array buffer offset
-                              );
-        
-        glDrawArrays(GL_TRIANGLE_FAN, 0, 4); // Starting from vertex 0; 4 vertices total -> 2 triangles in the strip
-        glDisableVertexAttribArray(0);
-  
+		_addBatchQuad( dx1, dy1, dx2, dy2, 0.f, 0.f, 0.f, 0.f, fillColor, 0 );
 		return;
 	}
 
@@ -767,84 +965,38 @@ namespace wg
         if( !_pSrc )
 			return;
 
-		float sw = (float) _pSrc->width();
-		float sh = (float) _pSrc->height();
+		GlSurface * pSrc = (GlSurface*) _pSrc;
 
-		float	sx1 = _src.x/sw;
-		float	sx2 = (_src.x+_src.w)/sw;
-		float	sy1 = _src.y/sh;
-		float	sy2 = (_src.y+_src.h)/sh;
+		// Source might be packed into an atlas page, so offset and scale by texture rather than surface.
 
-		int		dx1 = dest.x;
-		int		dx2 = dest.x + _src.w;
-		int		dy1 = m_canvasSize.h - dest.y;
-		int		dy2 = dy1 - _src.h;
+		float tw = (float) pSrc->m_textureSize.w;
+		float th = (float) pSrc->m_textureSize.h;
+		int   sx = pSrc->m_textureOfs.x + _src.x;
+		int   sy = pSrc->m_textureOfs.y + _src.y;
 
-        m_vertexBufferData[0] = (GLfloat) dx1;
-        m_vertexBufferData[1] = (GLfloat) dy1;
-        m_vertexBufferData[2] = (GLfloat) dx2;
-        m_vertexBufferData[3] = (GLfloat) dy1;
-        m_vertexBufferData[4] = (GLfloat) dx2;
-        m_vertexBufferData[5] = (GLfloat) dy2;
-        m_vertexBufferData[6] = (GLfloat) dx1;
-        m_vertexBufferData[7] = (GLfloat) dy2;
-        
-        m_texCoordBufferData[0] = (GLfloat) sx1;
-        m_texCoordBufferData[1] = (GLfloat) sy1;
-        m_texCoordBufferData[2] = (GLfloat) sx2;
-        m_texCoordBufferData[3] = (GLfloat) sy1;
-        m_texCoordBufferData[4] = (GLfloat) sx2;
-        m_texCoordBufferData[5] = (GLfloat) sy2;
-        m_texCoordBufferData[6] = (GLfloat) sx1;
-        m_texCoordBufferData[7] = (GLfloat) sy2;
-        
-        glActiveTexture(GL_TEXTURE0 );
-        glBindTexture(GL_TEXTURE_2D, ((GlSurface*)(_pSrc))->getTexture());
-
-        glUseProgram( m_blitProg );
-        
-        glBindVertexArray(m_vertexArrayId);
-        
-        
-        glBindBuffer(GL_ARRAY_BUFFER, m_vertexBufferId);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(m_vertexBufferData), m_vertexBufferData, GL_DYNAMIC_DRAW);
-        glVertexAttribPointer(
-                              0,                  // attribute 0. No particular reason for 0, but must match the layout in the shader.
-                              2,                  // size
-                              GL_FLOAT,           // type
-                              GL_FALSE,           // normalized?
-                              0,                  // stride
-                              (void*)0            // array buffer offset
-                              );
+		float	sx1 = sx/tw;
+		float	sx2 = (sx+_src.w)/tw;
+		float	sy1 = sy/th;
+		float	sy2 = (sy+_src.h)/th;
 
-        glBindBuffer(GL_ARRAY_BUFFER, m_texCoordArrayId);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(m_texCoordBufferData), m_texCoordBufferData, GL_DYNAMIC_DRAW);
-        glVertexAttribPointer(
-                              1,                  // attribute 0. No particular reason for 0, but must match the layout in the shader.
-                              2,                  // size
-                              GL_FLOAT,           // type
-                              GL_FALSE,           // normalized?
-                              0,                  // stride
-                              (void*)0            // array buffer offset
-                              );
+		float	dx1 = (float) dest.x;
+		float	dx2 = (float) (dest.x + _src.w);
+		float	dy1 = (float) (m_canvasSize.h - dest.y);
+		float	dy2 = (float) (dy1 - _src.h);
 
-        
-        glEnableVertexAttribArray(0);
-        glEnableVertexAttribArray(1);
-        glDrawArrays(GL_TRIANGLE_FAN, 0, 4); // Starting from vertex 0; 4 vertices total -> 2 triangles in the strip
-        glDisableVertexAttribArray(1);
-        glDisableVertexAttribArray(0);
-       
+		_addBatchQuad( dx1, dy1, dx2, dy2, sx1, sy1, sx2, sy2, m_tintColor, pSrc->m_texture );
 	}
 
 	//____ fillSubPixel() ______________________________________________________
 
 	void GlGfxDevice::fillSubPixel( const RectF& rect, const Color& col )
 	{
+		_flushBatch();
+
         if( col.a  == 0 )
             return;
         
-        glUseProgram( m_aaFillProg );
+        _useProgram( m_aaFillProg );
 
         // Set color
         
@@ -929,8 +1081,19 @@ namespace wg
 		if( !pSrc )
 			return;
 
-		float tw = (float) pSrc->width();
-		float th = (float) pSrc->height();
+		// Mipmapped surfaces are sampled trilinearly when shrunk to half size or less.
+
+		if( sw >= dest.w * 2.f || sh >= dest.h * 2.f )
+			((GlSurface*)(pSrc))->_updateMipmaps();
+
+		// Source might be packed into an atlas page, so offset and scale by texture rather than surface.
+
+		GlSurface * pGlSrc = (GlSurface*) pSrc;
+
+		float tw = (float) pGlSrc->m_textureSize.w;
+		float th = (float) pGlSrc->m_textureSize.h;
+		sx += pGlSrc->m_textureOfs.x;
+		sy += pGlSrc->m_textureOfs.y;
 
 		float	sx1 = sx/tw;
 		float	sx2 = (sx+sw)/tw;
@@ -942,60 +1105,7 @@ namespace wg
 		float	dy1 = (float) (m_canvasSize.h - dest.y);
 		float	dy2 = (float) (dy1 - dest.h);
 
-        m_vertexBufferData[0] = dx1;
-        m_vertexBufferData[1] = dy1;
-        m_vertexBufferData[2] = dx2;
-        m_vertexBufferData[3] = dy1;
-        m_vertexBufferData[4] = dx2;
-        m_vertexBufferData[5] = dy2;
-        m_vertexBufferData[6] = dx1;
-        m_vertexBufferData[7] = dy2;
-        
-        m_texCoordBufferData[0] = sx1;
-        m_texCoordBufferData[1] = sy1;
-        m_texCoordBufferData[2] = sx2;
-        m_texCoordBufferData[3] = sy1;
-        m_texCoordBufferData[4] = sx2;
-        m_texCoordBufferData[5] = sy2;
-        m_texCoordBufferData[6] = sx1;
-        m_texCoordBufferData[7] = sy2;
-        
-        glActiveTexture(GL_TEXTURE0 );
-        glBindTexture(GL_TEXTURE_2D, ((GlSurface*)(pSrc))->getTexture());
-        
-        glUseProgram( m_blitProg );
-        
-        glBindVertexArray(m_vertexArrayId);
-        
-        
-        glBindBuffer(GL_ARRAY_BUFFER, m_vertexBufferId);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(m_vertexBufferData), m_vertexBufferData, GL_DYNAMIC_DRAW);
-        glVertexAttribPointer(
-                              0,                  // attribute 0. No particular reason for 0, but must match the layout in the shader.
-                              2,                  // size
-                              GL_FLOAT,           // type
-                              GL_FALSE,           // normalized?
-                              0,                  // stride
-                              (void*)0            // array buffer offset
-                              );
-        
-        glBindBuffer(GL_ARRAY_BUFFER, m_texCoordArrayId);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(m_texCoordBufferData), m_texCoordBufferData, GL_DYNAMIC_DRAW);
-        glVertexAttribPointer(
-                              1,                  // attribute 0. No particular reason for 0, but must match the layout in the shader.
-                              2,                  // size
-                              GL_FLOAT,           // type
-                              GL_FALSE,           // normalized?
-                              0,                  // stride
-                              (void*)0            // array buffer offset
-                              );
-        
-        
-        glEnableVertexAttribArray(0);
-        glEnableVertexAttribArray(1);
-        glDrawArrays(GL_TRIANGLE_FAN, 0, 4); // Starting from vertex 0; 4 vertices total -> 2 triangles in the strip
-        glDisableVertexAttribArray(1);
-        glDisableVertexAttribArray(0);
+		_addBatchQuad( dx1, dy1, dx2, dy2, sx1, sy1, sx2, sy2, m_tintColor, pGlSrc->m_texture );
     }
 
 	//____ clipBlitFromCanvas() _______________________________________________________
@@ -1046,6 +1156,8 @@ namespace wg
 	void GlGfxDevice::stretchBlitSubPixelWithInvert(Surface * pSrc, float sx, float sy,
 		float sw, float sh, float dx, float dy, float dw, float dh)
 	{
+		_flushBatch();
+
 		if (pSrc->scaleMode() == ScaleMode::Interpolate)
 		{
 			if (sw < dw)
@@ -1089,10 +1201,8 @@ namespace wg
 		m_texCoordBufferData[6] = sx1;
 		m_texCoordBufferData[7] = sy2;
 
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, ((GlSurface*)(pSrc))->getTexture());
-
-		glUseProgram(m_blitProg);
+		_bindTexture(((GlSurface*)pSrc)->m_texture);
+		_useProgram(m_blitProg);
 
 		glBindVertexArray(m_vertexArrayId);
 
@@ -1128,6 +1238,121 @@ namespace wg
 	}
 
 
+	//____ _useProgram() ___________________________________________________________
+
+	// Outside beginRender()/endRender() others might have changed program behind our back.
+
+	void GlGfxDevice::_useProgram( GLuint program )
+	{
+		if( program != s_activeProgram || !m_bRendering )
+		{
+			glUseProgram( program );
+			s_activeProgram = program;
+		}
+	}
+
+	//____ _bindTexture() __________________________________________________________
+
+	// Skins packed into the same atlas page share texture, so consecutive blits
+	// from them need no rebinding.
+
+	void GlGfxDevice::_bindTexture( GLuint texture )
+	{
+		if( texture != GlSurface::s_boundTexture )
+		{
+			glBindTexture( GL_TEXTURE_2D, texture );
+			GlSurface::s_boundTexture = texture;
+		}
+	}
+
+	//____ _addBatchQuad() _________________________________________________________
+
+	// Coordinates are in GL space, texture coordinates normalized. Texture is 0 for fills.
+
+	void GlGfxDevice::_addBatchQuad( float dx1, float dy1, float dx2, float dy2, float sx1, float sy1, float sx2, float sy2, Color color, GLuint texture )
+	{
+		if( texture != 0 && texture != m_batchTexture )
+		{
+			if( m_batchTexture != 0 )
+				_flushBatch();
+			m_batchTexture = texture;
+		}
+
+		if( m_nBatchQuads == c_maxBatchQuads )
+		{
+			GLuint batchTexture = m_batchTexture;
+			_flushBatch();
+			m_batchTexture = batchTexture;
+		}
+
+		s_pBatchingDevice = this;
+
+		GLfloat textured = texture != 0 ? 1.f : 0.f;
+
+		BatchVertex * p = &m_batchVertices[m_nBatchQuads*4];
+		p[0] = { dx1, dy1, sx1, sy1, color, textured };
+		p[1] = { dx2, dy1, sx2, sy1, color, textured };
+		p[2] = { dx2, dy2, sx2, sy2, color, textured };
+		p[3] = { dx1, dy2, sx1, sy2, color, textured };
+
+		m_nBatchQuads++;
+	}
+
+	//____ _flushBatch() ___________________________________________________________
+
+	// Draws queued quads with one call. Vertices are appended to the ring buffer with
+	// unsynchronized mapping, since the GPU never reads the part we write to. When
+	// the ring is full we orphan it and let the driver give us fresh storage.
+
+	void GlGfxDevice::_flushBatch()
+	{
+		if( m_nBatchQuads == 0 )
+			return;
+
+		int nVertices = m_nBatchQuads * 4;
+
+		glBindVertexArray(m_batchVertexArrayId);
+		glBindBuffer(GL_ARRAY_BUFFER, m_batchVertexBufferId);
+
+		if( m_batchRingOfs + nVertices > c_batchRingVertices )
+		{
+			glBufferData(GL_ARRAY_BUFFER, c_batchRingVertices * sizeof(BatchVertex), NULL, GL_STREAM_DRAW);
+			m_batchRingOfs = 0;
+		}
+
+		void * pDest = glMapBufferRange(GL_ARRAY_BUFFER, m_batchRingOfs * sizeof(BatchVertex), nVertices * sizeof(BatchVertex),
+										GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+		memcpy(pDest, m_batchVertices, nVertices * sizeof(BatchVertex));
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+
+		if( m_batchTexture != 0 )
+		{
+			_useProgram(m_batchProg);
+			_bindTexture(m_batchTexture);
+		}
+		else
+			_useProgram(m_batchFillProg);
+
+		glDrawElementsBaseVertex(GL_TRIANGLES, m_nBatchQuads * 6, GL_UNSIGNED_SHORT, 0, m_batchRingOfs);
+		glBindVertexArray(0);
+
+		m_batchRingOfs += nVertices;
+		m_nBatchQuads = 0;
+		m_batchTexture = 0;
+		s_pBatchingDevice = nullptr;
+	}
+
+	//____ _flushPendingBatch() ____________________________________________________
+
+	// Draws whatever any device has queued. Called by GlSurface before textures are
+	// modified or deleted, since queued quads might sample them.
+
+	void GlGfxDevice::_flushPendingBatch()
+	{
+		if( s_pBatchingDevice )
+			s_pBatchingDevice->_flushBatch();
+	}
+
 	//____ _setBlendMode() _________________________________________________________
 
 	void GlGfxDevice::_setBlendMode( BlendMode blendMode )
@@ -1217,6 +1442,8 @@ namespace wg
 	
 	void GlGfxDevice::clipPlotPixels( const Rect& clip, int nCoords, const Coord * pCoords, const Color * pColors)
     {
+    	_flushBatch();
+
         glScissor(m_canvasViewport.x + clip.x, m_canvasViewport.y + m_canvasSize.h - clip.y - clip.h, clip.w, clip.h );
         plotPixels( nCoords, pCoords, pColors );
         glScissor(m_canvasViewport.x, m_canvasViewport.y, m_canvasSize.w, m_canvasSize.h );
@@ -1227,10 +1454,12 @@ namespace wg
     
     void GlGfxDevice::plotPixels( int nCoords, const Coord * pCoords, const Color * pColors)
     {
+    	_flushBatch();
+
         if( nCoords == 0 )
             return;
         
-        glUseProgram( m_plotProg );
+        _useProgram( m_plotProg );
         
         glBindVertexArray(m_vertexArrayId);
         
@@ -1268,6 +1497,8 @@ namespace wg
 
 	void GlGfxDevice::drawLine( Coord beg, Coord end, Color color, float thickness )
 	{
+		_flushBatch();
+
         int 	length;
         float   width;
         float	slope;
@@ -1285,7 +1516,7 @@ namespace wg
             width = _scaleThickness( thickness, slope );
  
             
-            glUseProgram( m_mildSlopeProg );
+            _useProgram( m_mildSlopeProg );
             
             Color fillColor = color * m_tintColor;
             glUniform4f( m_mildSlopeProgColorLoc, fillColor.r/255.f, fillColor.g/255.f, fillColor.b/255.f, fillColor.a/255.f );            
@@ -1323,7 +1554,7 @@ namespace wg
             slope = ((float)(end.x - beg.x)) / length;
             width = _scaleThickness( thickness, slope );
  
-            glUseProgram( m_steepSlopeProg );
+            _useProgram( m_steepSlopeProg );
             
             Color fillColor = color * m_tintColor;
             glUniform4f( m_steepSlopeProgColorLoc, fillColor.r/255.f, fillColor.g/255.f, fillColor.b/255.f, fillColor.a/255.f );
@@ -1377,15 +1608,161 @@ namespace wg
 	
 	void GlGfxDevice::clipDrawLine( const Rect& clip, Coord begin, Coord end, Color color, float thickness )
 	{
+		_flushBatch();
+
         glScissor(m_canvasViewport.x + clip.x, m_canvasViewport.y + m_canvasSize.h - clip.y - clip.h, clip.w, clip.h );
         drawLine( begin, end, color, thickness );
         glScissor(m_canvasViewport.x, m_canvasViewport.y, m_canvasSize.w, m_canvasSize.h );
 	}
 
+	//____ drawPolyline() ______________________________________________________
+
+	// The line is drawn as one triangle strip with two vertices per point, offset along the miter
+	// of the joint. Each vertex carries its distance from the center of the line, which the fragment
+	// shader turns into coverage for the anti-aliased edges.
+	//
+	// At sharp joints the quads of adjacent segments overlap on the inside of the corner, so those
+	// pixels are blended twice. Avoiding that would need a stencil or depth buffer, which we can't
+	// count on for the canvas.
+
+	void GlGfxDevice::drawPolyline( int nPoints, const CoordF * pPoints, Color color, float thickness )
+	{
+		_flushBatch();
+
+		if( nPoints < 2 || thickness <= 0.f )
+			return;
+
+		Color fillColor = color * m_tintColor;
+		if( fillColor.a == 0 && m_blendMode == BlendMode::Blend )
+			return;
+
+		float	halfWidth = thickness / 2;
+		float	expanse = halfWidth + 1.f;			// Include one extra pixel for anti-aliasing.
+		const float	miterLimit = 4.f;
+
+		int allocSize = sizeof(GLfloat) * 6 * nPoints;
+		GLfloat * pVertices = reinterpret_cast<GLfloat*>(Base::memStackAlloc(allocSize));
+		GLfloat * pVertex = pVertices;
+		int		nVertices = 0;
+
+		float	prevDirX = 0.f, prevDirY = 0.f;
+		int		prev = -1;
+
+		for( int i = 0 ; i < nPoints ; i++ )
+		{
+			// Find direction to next point, skipping points on top of each other.
+
+			float dirX = 0.f, dirY = 0.f;
+			int next = i + 1;
+			while( next < nPoints )
+			{
+				dirX = pPoints[next].x - pPoints[i].x;
+				dirY = pPoints[next].y - pPoints[i].y;
+				float len = std::sqrt(dirX*dirX + dirY*dirY);
+				if( len >= 0.001f )
+				{
+					dirX /= len;
+					dirY /= len;
+					break;
+				}
+				next++;
+			}
+
+			if( next == nPoints )
+			{
+				if( prev == -1 )
+					break;						// All points on top of each other.
+
+				dirX = prevDirX;
+				dirY = prevDirY;
+			}
+			else if( prev == -1 )
+			{
+				prevDirX = dirX;
+				prevDirY = dirY;
+			}
+
+			// Calculate the miter, limiting its length on sharp joints.
+
+			float tanX = prevDirX + dirX;
+			float tanY = prevDirY + dirY;
+			float tanLen = std::sqrt(tanX*tanX + tanY*tanY);
+
+			float normX, normY, scale;
+			if( tanLen < 0.001f )
+			{
+				normX = -prevDirY;
+				normY = prevDirX;
+				scale = 1.f;
+			}
+			else
+			{
+				normX = -tanY / tanLen;
+				normY = tanX / tanLen;
+				scale = std::min(miterLimit, 1.f / (normX * -prevDirY + normY * prevDirX));
+			}
+
+			float ofsX = normX * expanse * scale;
+			float ofsY = normY * expanse * scale;
+
+			float x = pPoints[i].x + 0.5f;
+			float y = m_canvasSize.h - (pPoints[i].y + 0.5f);
+
+			pVertex[0] = x + ofsX;
+			pVertex[1] = y - ofsY;
+			pVertex[2] = expanse;
+			pVertex[3] = x - ofsX;
+			pVertex[4] = y + ofsY;
+			pVertex[5] = -expanse;
+			pVertex += 6;
+			nVertices += 2;
+
+			prevDirX = dirX;
+			prevDirY = dirY;
+			prev = i;
+			i = next - 1;
+		}
+
+		if( nVertices >= 4 )
+		{
+			_useProgram( m_polylineProg );
+			glUniform4f( m_polylineProgColorLoc, fillColor.r/255.f, fillColor.g/255.f, fillColor.b/255.f, fillColor.a/255.f );
+			glUniform1f( m_polylineProgWLoc, halfWidth + 0.5f );
+
+			glBindVertexArray(m_vertexArrayId);
+
+			glEnableVertexAttribArray(0);
+			glEnableVertexAttribArray(1);
+			glBindBuffer(GL_ARRAY_BUFFER, m_vertexBufferId);
+			glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 3 * nVertices, pVertices, GL_DYNAMIC_DRAW);
+			glVertexAttribPointer( 0, 2, GL_FLOAT, GL_FALSE, sizeof(GLfloat) * 3, (void*)0 );
+			glVertexAttribPointer( 1, 1, GL_FLOAT, GL_FALSE, sizeof(GLfloat) * 3, (void*)(sizeof(GLfloat) * 2) );
+
+			glDrawArrays(GL_TRIANGLE_STRIP, 0, nVertices);
+			glDisableVertexAttribArray(1);
+			glDisableVertexAttribArray(0);
+		}
+
+		Base::memStackRelease(allocSize);
+	}
+
+	//____ clipDrawPolyline() ____________________________________________________
+
+	void GlGfxDevice::clipDrawPolyline( const Rect& clip, int nPoints, const CoordF * pPoints, Color color, float thickness )
+	{
+		_flushBatch();
+
+		glScissor(m_canvasViewport.x + clip.x, m_canvasViewport.y + m_canvasSize.h - clip.y - clip.h, clip.w, clip.h );
+		drawPolyline( nPoints, pPoints, color, thickness );
+		glScissor(m_canvasViewport.x, m_canvasViewport.y, m_canvasSize.w, m_canvasSize.h );
+	}
+
 	//____ clipDrawHorrWave() _____________________________________________________
 
 	void GlGfxDevice::clipDrawHorrWave(const Rect&clip, Coord begin, int length, const WaveLine * pTopBorder, const WaveLine * pBottomBorder, Color frontFill, Color backFill)
 	{
+		_flushBatch();
+
 		// Do early rough X-clipping with margin (need to trace lines with margin of thickest line).
 
 		int ofs = 0;
@@ -1572,7 +1949,7 @@ namespace wg
 		m_vertexBufferData[6] = (GLfloat)dx1;
 		m_vertexBufferData[7] = (GLfloat)dy2;
 
-		glUseProgram(m_horrWaveProg);
+		_useProgram(m_horrWaveProg);
 
 		glActiveTexture(GL_TEXTURE0);
 		glBindTexture(GL_TEXTURE_BUFFER, m_horrWaveBufferTexture);
@@ -1607,43 +1984,83 @@ namespace wg
 		Base::memStackRelease(traceBufferSize);
 	}
 
-	//____ _drawStraightLine() ________________________________________________
+	//____ clipDrawSegments() _____________________________________________________
 
-	void GlGfxDevice::_drawStraightLine(Coord start, Orientation orientation, int length, const Color& col )
+	void GlGfxDevice::clipDrawSegments(const Rect& clip, const Rect& dest, int nEdgeStrips, const int * pEdgeStrips, const Color * pSegmentColors)
 	{
-		if (length <= 0)
+		_flushBatch();
+
+		Rect box(Rect(clip, Rect(0, 0, m_canvasSize)), dest);
+		if (box.w <= 0 || box.h <= 0 || nEdgeStrips < 0)
 			return;
 
-		GLenum err;
-		assert(0 == (err = glGetError()));
+		int nSegments = nEdgeStrips + 1;
 
-		Color fillColor = col * m_tintColor;
+		// Generate texture buffer data, same coverage calculations as SoftGfxDevice.
 
-		if (orientation == Orientation::Horizontal)
-		{
-			float	dx1 = start.x + 0.5f;
-			float	dy = m_canvasSize.h - (start.y + 0.5f);
-			float   dx2 = start.x + length + 0.5f;
-
-			m_vertexBufferData[0] = dx1;
-			m_vertexBufferData[1] = dy;
-			m_vertexBufferData[2] = dx2;
-			m_vertexBufferData[3] = dy;
-		}
-		else
+		int textureBufferDataSize = (nSegments + box.w * nEdgeStrips * 2) * sizeof(int);
+		int * pTextureBufferData = (int*)Base::memStackAlloc(textureBufferDataSize);
+		int * wpBuffer = pTextureBufferData;
+
+		for (int i = 0; i < nSegments; i++)
+			*wpBuffer++ = (int)(pSegmentColors[i] * m_tintColor).argb;
+
+		int maxPos = dest.h * 256;
+
+		for (int x = box.x; x < box.x + box.w; x++)
 		{
-			float	dx = start.x + 0.5f;
-			float	dy1 = m_canvasSize.h - (start.y + 0.5f);
-			float   dy2 = m_canvasSize.h - (start.y + length + 0.5f);
-
-			m_vertexBufferData[0] = dx;
-			m_vertexBufferData[1] = dy1;
-			m_vertexBufferData[2] = dx;
-			m_vertexBufferData[3] = dy2;
+			const int * pLeft = pEdgeStrips + (x - dest.x) * nEdgeStrips;
+			const int * pRight = pLeft + nEdgeStrips;
+
+			int prevLeft = 0;
+			int prevRight = 0;
+
+			for (int i = 0; i < nEdgeStrips; i++)
+			{
+				int left = pLeft[i];
+				int right = pRight[i];
+				limit(left, prevLeft, maxPos);
+				limit(right, prevRight, maxPos);
+				prevLeft = left;
+				prevRight = right;
+
+				int edgeBeg = min(left, right);
+				int edgeEnd = max(left, right);
+
+				int coverageInc = (65536 * 256) / (edgeEnd - edgeBeg + 256);
+
+				*wpBuffer++ = coverageInc - (int)((int64_t(coverageInc) * edgeBeg) >> 8);
+				*wpBuffer++ = coverageInc;
+			}
 		}
 
-		glUseProgram(m_fillProg);
-		glUniform4f(m_fillProgColorLoc, fillColor.r / 255.f, fillColor.g / 255.f, fillColor.b / 255.f, fillColor.a / 255.f);
+		// Now we have the data generated, setup GL to operate on it
+
+		glBindBuffer(GL_TEXTURE_BUFFER, m_segmentsBufferTextureData);
+		glBufferData(GL_TEXTURE_BUFFER, textureBufferDataSize, pTextureBufferData, GL_STREAM_DRAW);
+
+		int	dx1 = box.x;
+		int	dy1 = m_canvasSize.h - box.y;
+		int dx2 = box.x + box.w;
+		int dy2 = m_canvasSize.h - (box.y + box.h);
+
+		m_vertexBufferData[0] = (GLfloat)dx1;
+		m_vertexBufferData[1] = (GLfloat)dy1;
+		m_vertexBufferData[2] = (GLfloat)dx2;
+		m_vertexBufferData[3] = (GLfloat)dy1;
+		m_vertexBufferData[4] = (GLfloat)dx2;
+		m_vertexBufferData[5] = (GLfloat)dy2;
+		m_vertexBufferData[6] = (GLfloat)dx1;
+		m_vertexBufferData[7] = (GLfloat)dy2;
+
+		_useProgram(m_segmentsProg);
+
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_BUFFER, m_segmentsBufferTexture);
+		glTexBuffer(GL_TEXTURE_BUFFER, GL_R32I, m_segmentsBufferTextureData);
+		glUniform1i(m_segmentsProgTexIdLoc, 0);
+		glUniform2f(m_segmentsProgWindowOfsLoc, (GLfloat)(box.x + m_canvasViewport.x), (GLfloat)(dest.y + m_canvasViewport.y));        // This fragment shader has top-left coordinate system.
+		glUniform1i(m_segmentsProgEdgesLoc, nEdgeStrips);
 
 		glBindVertexArray(m_vertexArrayId);
 
@@ -1659,11 +2076,39 @@ namespace wg
 			(void*)0            // array buffer offset
 		);
 
-		glDrawArrays(GL_LINES, 0, 2); // Starting from vertex 0; 2 vertices total -> 1 line
+		glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
 		glDisableVertexAttribArray(0);
 
-		assert(0 == (err = glGetError()));
-		return;
+		Base::memStackRelease(textureBufferDataSize);
+	}
+
+	//____ _drawStraightLine() ________________________________________________
+
+	void GlGfxDevice::_drawStraightLine(Coord start, Orientation orientation, int length, const Color& col )
+	{
+		if (length <= 0)
+			return;
+
+		// Drawn as a one pixel wide fill, so it can be batched with fills and blits.
+
+		Color fillColor = col * m_tintColor;
+
+		float	dx1 = (float) start.x;
+		float	dy1 = (float) (m_canvasSize.h - start.y);
+		float	dx2, dy2;
+
+		if (orientation == Orientation::Horizontal)
+		{
+			dx2 = dx1 + length;
+			dy2 = dy1 - 1;
+		}
+		else
+		{
+			dx2 = dx1 + 1;
+			dy2 = dy1 - length;
+		}
+
+		_addBatchQuad( dx1, dy1, dx2, dy2, 0.f, 0.f, 0.f, 0.f, fillColor, 0 );
 	}
 
     //____ _initTables() ___________________________________________________________
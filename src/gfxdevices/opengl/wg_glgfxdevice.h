@@ -47,6 +47,8 @@ namespace wg
 
 	class GlGfxDevice : public GfxDevice
 	{
+		friend class GlSurface;
+
 	public:
 
 		//.____ Creation __________________________________________
@@ -89,7 +91,11 @@ namespace wg
 		void	drawLine( Coord begin, Coord end, Color color, float thickness = 1.f ) override;
 		void	clipDrawLine( const Rect& clip, Coord begin, Coord end, Color color, float thickness = 1.f ) override;
 
+		void	drawPolyline( int nPoints, const CoordF * pPoints, Color color, float thickness = 1.f ) override;
+		void	clipDrawPolyline( const Rect& clip, int nPoints, const CoordF * pPoints, Color color, float thickness = 1.f ) override;
+
 		void	clipDrawHorrWave(const Rect&clip, Coord begin, int length, const WaveLine * pTopLine, const WaveLine * pBottomLine, Color front, Color back);
+		void	clipDrawSegments(const Rect& clip, const Rect& dest, int nEdgeStrips, const int * pEdgeStrips, const Color * pSegmentColors);
 
 
 		void	blit( Surface * src, const Rect& srcrect, Coord dest  ) override;
@@ -118,6 +124,13 @@ namespace wg
         GLuint  _createGLProgram( const char * pVertexShader, const char * pFragmentShader );
 		void	_updateProgramDimensions();
 		bool	_setFramebuffer();
+
+		void	_useProgram( GLuint program );
+		void	_bindTexture( GLuint texture );
+
+		void	_addBatchQuad( float dx1, float dy1, float dx2, float dy2, float sx1, float sy1, float sx2, float sy2, Color color, GLuint texture );
+		void	_flushBatch();
+		static void	_flushPendingBatch();
        
         SurfaceFactory_p	m_pSurfaceFactory;
 	    float	_scaleThickness( float thickeness, float slope );
@@ -150,6 +163,10 @@ namespace wg
         GLuint  m_plotProg;
         GLint   m_plotProgTintLoc;
 
+		GLuint  m_polylineProg;
+		GLint   m_polylineProgColorLoc;
+		GLint   m_polylineProgWLoc;
+
         GLuint  m_mildSlopeProg;
         GLint   m_mildSlopeProgColorLoc;
         GLint   m_mildSlopeProgSLoc;
@@ -172,8 +189,45 @@ namespace wg
 		GLint	m_horrWaveProgFrontFillLoc;
 		GLint	m_horrWaveProgBackFillLoc;
 
+		GLuint  m_segmentsProg;
+		GLuint	m_segmentsBufferTexture;
+		GLuint	m_segmentsBufferTextureData;
+		GLint	m_segmentsProgTexIdLoc;
+		GLint	m_segmentsProgWindowOfsLoc;
+		GLint	m_segmentsProgEdgesLoc;
+
 		GLuint  m_dummyBuffer;
 
+		static GLuint	s_activeProgram;	// Program last set by _useProgram(), 0 if unknown.
+
+		// Batching of fills and blits. Quads are collected with per-vertex tint and drawn
+		// with one call when state changes, through a ring buffer that is orphaned when full.
+
+		struct BatchVertex
+		{
+			GLfloat	x, y;
+			GLfloat	u, v;
+			Color	color;
+			GLfloat	textured;				// 1.0 for blits, 0.0 for fills.
+		};
+
+		static const int c_maxBatchQuads = 1024;
+		static const int c_batchRingVertices = c_maxBatchQuads * 4 * 16;
+
+		GLuint  m_batchProg;
+		GLint   m_batchProgTexIdLoc;
+		GLuint  m_batchFillProg;			// For batches without blits.
+		GLuint	m_batchVertexArrayId;
+		GLuint	m_batchVertexBufferId;		// Ring buffer.
+		GLuint	m_batchIndexBufferId;		// Static indices for c_maxBatchQuads quads.
+		int		m_batchRingOfs = 0;			// First free vertex in ring buffer.
+
+		BatchVertex	m_batchVertices[c_maxBatchQuads*4];
+		int		m_nBatchQuads = 0;
+		GLuint	m_batchTexture = 0;			// Texture of blits in batch, 0 if only fills so far.
+
+		static GlGfxDevice * s_pBatchingDevice;	// Device with quads waiting to be drawn, if any.
+
         GLuint  m_vertexArrayId;
         GLuint  m_vertexBufferId;
         GLfloat m_vertexBufferData[8];         // Space to store a quad (through triangle strip)
@@ -22,10 +22,12 @@
 
 #include <memory.h>
 
+#include <wg_glgfxdevice.h>
 #include <wg_glsurface.h>
 #include <wg_util.h>
 #include <wg_blob.h>
 #include <assert.h>
+#include <algorithm>
 
 
 
@@ -35,6 +37,37 @@ namespace wg
 
 	Size	GlSurface::s_maxSize;
 
+	bool	GlSurface::s_bAtlasEnabled = true;
+	GLuint	GlSurface::s_boundTexture = 0;
+
+	// Static surfaces up to c_maxAtlasSurfaceSize pixels in both directions are packed
+	// into shared textures of c_atlasPageSize pixels, one set of pages per pixel format.
+	// Each surface gets a one pixel gutter of duplicated edge pixels so that sampling
+	// never bleeds in from neighbours. Pages are packed in shelves, where space is not
+	// reused until the whole page is empty.
+
+	static const int c_atlasPageSize = 1024;
+	static const int c_maxAtlasSurfaceSize = 128;
+
+	struct GlSurface::AtlasPage
+	{
+		struct Shelf
+		{
+			int		y;
+			int		h;
+			int		usedW;
+		};
+
+		PixelFormat			format;
+		GLuint				texture;
+		Size				size;
+		int					nSurfaces;
+		int					shelvesH;		// Height used by shelves so far.
+		std::vector<Shelf>	shelves;
+	};
+
+	std::vector<GlSurface::AtlasPage*>	GlSurface::s_atlasPages;
+
 
 	//____ maxSize() _______________________________________________________________
 
@@ -124,16 +157,10 @@ namespace wg
 		else
 			m_pClut = nullptr;
 
-        glGenTextures( 1, &m_texture );
-        glBindTexture( GL_TEXTURE_2D, m_texture );
-        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_S,GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_T,GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+        m_bMipmapped = (hint & SurfaceHint::Mipmapped) && m_pixelDescription.format != PixelFormat::I8;
 
-        glTexImage2D( GL_TEXTURE_2D, 0, m_internalFormat, m_size.w, m_size.h, 0,
-                     m_accessFormat, m_pixelDataType, NULL );
+		if( !_enterAtlas(hint) )
+			_createTexture( nullptr );
 
         assert( glGetError() == 0 );
     }
@@ -147,18 +174,13 @@ namespace wg
         m_size	= size;
         m_pitch = pitch;
 		m_pBlob = pBlob;
+		m_bSharedBlob = true;
 		m_pClut = const_cast<Color*>(pClut);
 
-		glGenTextures( 1, &m_texture );
-        glBindTexture( GL_TEXTURE_2D, m_texture );
-		glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_NEAREST);
-		glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_S,GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_T,GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+		m_bMipmapped = (hint & SurfaceHint::Mipmapped) && m_pixelDescription.format != PixelFormat::I8;
 
-		glTexImage2D( GL_TEXTURE_2D, 0, m_internalFormat, m_size.w, m_size.h, 0,
-			m_accessFormat, m_pixelDataType, m_pBlob->data() );
+		if( !_enterAtlas(hint) )
+			_createTexture( m_pBlob->data() );
 
 		assert( glGetError() == 0);
 	}
@@ -182,16 +204,10 @@ namespace wg
 		else
 			m_pClut = nullptr;
 
-        glGenTextures( 1, &m_texture );
-        glBindTexture( GL_TEXTURE_2D, m_texture );
-        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_S,GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_T,GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
-		
-        glTexImage2D( GL_TEXTURE_2D, 0, m_internalFormat, m_size.w, m_size.h, 0,
-                     m_accessFormat, m_pixelDataType, m_pBlob->data() );
+        m_bMipmapped = (hint & SurfaceHint::Mipmapped) && m_pixelDescription.format != PixelFormat::I8;
+
+		if( !_enterAtlas(hint) )
+			_createTexture( m_pBlob->data() );
         
  		assert( glGetError() == 0);
     }
@@ -216,16 +232,10 @@ namespace wg
 		else
 			m_pClut = nullptr;
 
-        glGenTextures( 1, &m_texture );
-        glBindTexture( GL_TEXTURE_2D, m_texture );
-        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_S,GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_T,GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
-		
-        glTexImage2D( GL_TEXTURE_2D, 0, m_internalFormat, m_size.w, m_size.h, 0,
-                     m_accessFormat, m_pixelDataType, m_pBlob->data() );
+        m_bMipmapped = (hint & SurfaceHint::Mipmapped) && m_pixelDescription.format != PixelFormat::I8;
+
+		if( !_enterAtlas(hint) )
+			_createTexture( m_pBlob->data() );
         
 		assert( glGetError() == 0);
     }
@@ -301,7 +311,27 @@ namespace wg
 	{
 		// Free the stuff
 
-		glDeleteTextures( 1, &m_texture );
+		if( m_pAtlasPage )
+			_releaseAtlasSlot();
+		else
+			_deleteTexture( m_texture );
+	}
+
+	//____ setAtlasEnabled() ______________________________________________________
+	/**
+	 * @brief Enable or disable packing of small static surfaces into shared textures.
+	 *
+	 * When enabled (default) surfaces created with SurfaceHint::Static that are no larger
+	 * than 128x128 pixels are packed into shared atlas textures, which lets consecutive
+	 * blits from different skins use the same texture binding. A surface leaves its atlas
+	 * if it is used as a canvas or set to ScaleMode::Interpolate.
+	 *
+	 * Only affects surfaces created after the call.
+	 */
+
+	void GlSurface::setAtlasEnabled( bool bEnabled )
+	{
+		s_bAtlasEnabled = bEnabled;
 	}
 
 	//____ isInstanceOf() _________________________________________________________
@@ -336,18 +366,23 @@ namespace wg
 	void GlSurface::setScaleMode( ScaleMode mode )
 	{
         assert( glGetError() == 0 );
+		// Atlas pages are shared, so we need our own texture to change its filtering.
+
+		if( m_pAtlasPage && mode != ScaleMode::Nearest )
+			_leaveAtlas();
+
 		switch( mode )
 		{
 			case ScaleMode::Interpolate:
-				glBindTexture( GL_TEXTURE_2D, m_texture );
-				glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_LINEAR);
+				_bindTexture( m_texture );
+				glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER, m_bHasMipmaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
 				glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_LINEAR);
 				break;
 				
 			case ScaleMode::Nearest:
 			default:
-				glBindTexture( GL_TEXTURE_2D, m_texture );
-				glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_NEAREST);
+				_bindTexture( m_texture );
+				glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER, m_bHasMipmaps ? GL_NEAREST_MIPMAP_NEAREST : GL_NEAREST);
 				glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_NEAREST);
 				break;
 		}
@@ -419,8 +454,14 @@ namespace wg
 
 		if( m_accessMode != AccessMode::ReadOnly )
 		{
-			glBindTexture( GL_TEXTURE_2D, m_texture );
-        	glTexSubImage2D( GL_TEXTURE_2D, 0, 0, 0, m_size.w, m_size.h, m_accessFormat, m_pixelDataType, m_pBlob->data() );
+			if( m_pAtlasPage )
+				_uploadToAtlas();
+			else
+			{
+				_bindTexture( m_texture );
+				glTexSubImage2D( GL_TEXTURE_2D, 0, 0, 0, m_size.w, m_size.h, m_accessFormat, m_pixelDataType, m_pBlob->data() );
+			}
+			m_bMipmapsStale = true;
 	//		glTexSubImage2D( GL_TEXTURE_2D, 0, m_lockRegion.x, m_lockRegion.y, m_lockRegion.w, m_lockRegion.h, GL_RGBA, GL_UNSIGNED_BYTE, 0 );
 		}
 		m_accessMode = AccessMode::None;
@@ -485,9 +526,13 @@ namespace wg
 	{
 		if( m_texture == 0 )
 			return true;
-                
-		glDeleteTextures( 1, &m_texture );
+
+		if( m_pAtlasPage )
+			_releaseAtlasSlot();
+		else
+			_deleteTexture( m_texture );
 		m_texture = 0;
+		_updateMemoryUsage();
                 
 		assert(glGetError() == 0);	
 		return true;
@@ -506,20 +551,35 @@ namespace wg
 	{
 		assert(glGetError() == 0);
 
-		glGenTextures( 1, &m_texture );
-		glBindTexture( GL_TEXTURE_2D, m_texture );
-		glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_NEAREST);
-		glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_NEAREST);
-		glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_S,GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_T,GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
-	
-		glTexImage2D( GL_TEXTURE_2D, 0, m_internalFormat, m_size.w, m_size.h, 0,
-					 m_accessFormat, m_pixelDataType, m_pBlob->data() );
+		m_bMipmapsStale = true;
+		m_bHasMipmaps = false;
+
+		_createTexture( m_pBlob->data() );
+		_updateMemoryUsage();
     
 		assert( glGetError() == 0);	
 	}
 
+	//____ _allocatedBytes() _________________________________________________
+
+	int64_t GlSurface::_allocatedBytes() const
+	{
+		int64_t bytes = m_bSharedBlob ? 0 : m_pBlob->size();		// Backing buffer, includes the CLUT.
+
+		// Our texture, or our part of the atlas page we are packed into.
+
+		if( m_texture != 0 )
+		{
+			int64_t textureBytes = (int64_t) m_size.w * m_size.h * m_pixelSize;
+			if( m_bMipmapped && !m_pAtlasPage )
+				textureBytes += textureBytes / 3;
+
+			bytes += textureBytes;
+		}
+
+		return bytes;
+	}
+
 	//____ _refreshBackingBuffer() ____________________________________________
 
 	void GlSurface::_refreshBackingBuffer()
@@ -555,7 +615,7 @@ namespace wg
 		}
 
 
-		glBindTexture(GL_TEXTURE_2D, m_texture);
+		_bindTexture( m_texture );
 		glGetTexImage(GL_TEXTURE_2D, 0, m_accessFormat, type, m_pBlob->data());
 
 		GLenum err;
@@ -564,6 +624,239 @@ namespace wg
 		m_bBackingBufferStale = false;
 	}
 
+	//____ _updateMipmaps() ________________________________________________________
+	/*
+		Regenerates mipmaps of a mipmapped surface if content has changed since last time.
+		Called by GlGfxDevice before the surface is used for downscaling, so mipmaps
+		are not generated for surfaces that never are shrunk.
+	*/
+
+	void GlSurface::_updateMipmaps()
+	{
+		if( !m_bMipmapped || !m_bMipmapsStale )
+			return;
+
+		_bindTexture( m_texture );
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 1000);
+		glGenerateMipmap( GL_TEXTURE_2D );
+
+		if( !m_bHasMipmaps )
+		{
+			m_bHasMipmaps = true;
+			setScaleMode( m_scaleMode );		// Switch to a mipmapped minification filter.
+		}
+
+		m_bMipmapsStale = false;
+        assert( glGetError() == 0 );
+	}
+
+	//____ _createTexture() ________________________________________________________
+	/*
+		Creates a texture of our own and fills it with pPixels, which may be null.
+	*/
+
+	void GlSurface::_createTexture( const void * pPixels )
+	{
+		m_textureOfs = { 0,0 };
+		m_textureSize = m_size;
+
+		glGenTextures( 1, &m_texture );
+		_bindTexture( m_texture );
+		glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_S,GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_T,GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+
+		glTexImage2D( GL_TEXTURE_2D, 0, m_internalFormat, m_size.w, m_size.h, 0,
+					 m_accessFormat, m_pixelDataType, pPixels );
+	}
+
+	//____ _enterAtlas() ___________________________________________________________
+	/*
+		Tries to pack a newly created surface into an atlas page and upload our pixels
+		there. Returns false if the surface is not eligible, in which case it needs
+		a texture of its own.
+	*/
+
+	bool GlSurface::_enterAtlas( int hint )
+	{
+		if( !s_bAtlasEnabled || (hint & (SurfaceHint::Dynamic | SurfaceHint::WriteOnly | SurfaceHint::Mipmapped)) != 0 )
+			return false;
+
+		if( m_pixelDescription.format == PixelFormat::I8 || m_size.w > c_maxAtlasSurfaceSize || m_size.h > c_maxAtlasSurfaceSize )
+			return false;
+
+		int w = m_size.w + 2;				// Including gutter.
+		int h = m_size.h + 2;
+
+		AtlasPage *			pPage = nullptr;
+		AtlasPage::Shelf *	pShelf = nullptr;
+
+		// Best fitting shelf with room left, ignoring shelves twice our height or more.
+
+		for( auto pCandidate : s_atlasPages )
+		{
+			if( pCandidate->format != m_pixelDescription.format )
+				continue;
+
+			for( auto& shelf : pCandidate->shelves )
+			{
+				if( shelf.h >= h && shelf.h < h*2 && shelf.usedW + w <= pCandidate->size.w && (!pShelf || shelf.h < pShelf->h) )
+				{
+					pPage = pCandidate;
+					pShelf = &shelf;
+				}
+			}
+		}
+
+		// Otherwise start a new shelf, in a new page if needed.
+
+		if( !pShelf )
+		{
+			int shelfH = (h + 3) & ~3;
+
+			for( auto pCandidate : s_atlasPages )
+			{
+				if( pCandidate->format == m_pixelDescription.format && pCandidate->shelvesH + shelfH <= pCandidate->size.h )
+				{
+					pPage = pCandidate;
+					break;
+				}
+			}
+
+			if( !pPage )
+			{
+				Size max = maxSize();
+				Size pageSize( std::min(c_atlasPageSize, max.w), std::min(c_atlasPageSize, max.h) );
+				if( pageSize.w < w || pageSize.h < shelfH )
+					return false;
+
+				pPage = new AtlasPage();
+				pPage->format = m_pixelDescription.format;
+				pPage->size = pageSize;
+				pPage->nSurfaces = 0;
+				pPage->shelvesH = 0;
+
+				glGenTextures( 1, &pPage->texture );
+				_bindTexture( pPage->texture );
+				glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_NEAREST);
+				glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_NEAREST);
+				glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_S,GL_CLAMP_TO_EDGE);
+				glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_T,GL_CLAMP_TO_EDGE);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+				glTexImage2D( GL_TEXTURE_2D, 0, m_internalFormat, pageSize.w, pageSize.h, 0,
+							 m_accessFormat, m_pixelDataType, NULL );
+
+				s_atlasPages.push_back(pPage);
+			}
+
+			pPage->shelves.push_back( { pPage->shelvesH, shelfH, 0 } );
+			pPage->shelvesH += shelfH;
+			pShelf = &pPage->shelves.back();
+		}
+
+		m_pAtlasPage = pPage;
+		m_texture = pPage->texture;
+		m_textureOfs = { pShelf->usedW + 1, pShelf->y + 1 };
+		m_textureSize = pPage->size;
+
+		pShelf->usedW += w;
+		pPage->nSurfaces++;
+
+		_uploadToAtlas();
+		return true;
+	}
+
+	//____ _leaveAtlas() ___________________________________________________________
+	/*
+		Moves our content from the atlas page to a texture of our own. Needed before
+		we are rendered to or our texture parameters are changed.
+	*/
+
+	void GlSurface::_leaveAtlas()
+	{
+		_releaseAtlasSlot();
+		_createTexture( m_pBlob->data() );
+		_updateMemoryUsage();
+	}
+
+	//____ _releaseAtlasSlot() _____________________________________________________
+
+	void GlSurface::_releaseAtlasSlot()
+	{
+		AtlasPage * pPage = m_pAtlasPage;
+		m_pAtlasPage = nullptr;
+		m_texture = 0;
+
+		if( --pPage->nSurfaces == 0 )
+		{
+			_deleteTexture( pPage->texture );
+			s_atlasPages.erase( std::find( s_atlasPages.begin(), s_atlasPages.end(), pPage ) );
+			delete pPage;
+		}
+	}
+
+	//____ _uploadToAtlas() ________________________________________________________
+	/*
+		Uploads content of backing buffer to our area of the atlas page, surrounded
+		by a gutter of duplicated edge pixels.
+	*/
+
+	void GlSurface::_uploadToAtlas()
+	{
+		int w = m_size.w + 2;
+		int h = m_size.h + 2;
+		int ps = m_pixelSize;
+		int linePitch = (w*ps + 3) & ~3;		// Matches default GL_UNPACK_ALIGNMENT.
+
+		std::vector<uint8_t>	buffer( linePitch * h );
+		const uint8_t * pPixels = (const uint8_t *) m_pBlob->data();
+
+		for( int y = 0 ; y < h ; y++ )
+		{
+			const uint8_t * pSrc = pPixels + std::min( std::max(y-1, 0), m_size.h-1 ) * m_pitch;
+			uint8_t * pDst = &buffer[y*linePitch];
+
+			memcpy( pDst, pSrc, ps );
+			memcpy( pDst + ps, pSrc, m_size.w*ps );
+			memcpy( pDst + (w-1)*ps, pSrc + (m_size.w-1)*ps, ps );
+		}
+
+		_bindTexture( m_texture );
+		glTexSubImage2D( GL_TEXTURE_2D, 0, m_textureOfs.x - 1, m_textureOfs.y - 1, w, h, m_accessFormat, m_pixelDataType, buffer.data() );
+	}
+
+	//____ _bindTexture() __________________________________________________________
+	/*
+		Binds texture to GL_TEXTURE_2D and remembers it, so that GlGfxDevice can skip
+		rebinding the same texture while rendering. We always bind here since we
+		might be called between frames, when others can have changed the binding.
+
+		We only bind textures to modify them, so this is also where quads queued by
+		GlGfxDevice are drawn, before they might see the changes.
+	*/
+
+	void GlSurface::_bindTexture( GLuint texture )
+	{
+		GlGfxDevice::_flushPendingBatch();
+
+		glBindTexture( GL_TEXTURE_2D, texture );
+		s_boundTexture = texture;
+	}
+
+	//____ _deleteTexture() ________________________________________________________
+
+	void GlSurface::_deleteTexture( GLuint texture )
+	{
+		GlGfxDevice::_flushPendingBatch();
+
+		if( texture == s_boundTexture )
+			s_boundTexture = 0;
+
+		glDeleteTextures( 1, &texture );
+	}
+
 
 
 
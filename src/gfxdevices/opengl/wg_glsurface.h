@@ -40,6 +40,8 @@
 
 #include <wg_surface.h>
 
+#include <vector>
+
 namespace wg
 {
 
@@ -99,6 +101,10 @@ namespace wg
 		//.____ Misc __________________________________________________________
 
 		inline	GLuint	getTexture() const { return m_texture; }
+		inline	bool	isInAtlas() const { return m_pAtlasPage != nullptr; }
+
+		static void		setAtlasEnabled( bool bEnabled );
+		static bool		isAtlasEnabled() { return s_bAtlasEnabled; }
 
 	private:
         GlSurface( Size size, PixelFormat format = PixelFormat::BGRA_8, int hint = SurfaceHint::Static, const Color * pClut = nullptr);
@@ -109,20 +115,46 @@ namespace wg
 
 
 		void		_setPixelDetails( PixelFormat format );
+		void		_createTexture( const void * pPixels );
+
+		int64_t		_allocatedBytes() const override;
+
+		struct AtlasPage;
+
+		bool		_enterAtlas( int hint );
+		void		_leaveAtlas();
+		void		_releaseAtlasSlot();
+		void		_uploadToAtlas();
+
+		static void	_bindTexture( GLuint texture );
+		static void	_deleteTexture( GLuint texture );
 
 		bool		m_bBackingBufferStale = false;
 		void		_refreshBackingBuffer();
 
-        GLuint 		m_texture;			// GL texture handle.
+		bool		m_bMipmapped = false;		// Created with SurfaceHint::Mipmapped.
+		bool		m_bMipmapsStale = true;		// Content has changed since mipmaps were generated.
+		bool		m_bHasMipmaps = false;		// Mipmaps have been generated at least once.
+		void		_updateMipmaps();
+
+        GLuint 		m_texture;			// GL texture handle, shared with other surfaces when packed into an atlas.
+		AtlasPage *	m_pAtlasPage = nullptr;	// Atlas page we are packed into, if any.
+		Coord		m_textureOfs;		// Position of our pixels in the texture. Non-zero only when packed into an atlas.
+		Size		m_textureSize;		// Size of the texture, which is the atlas page when packed into one.
         GLint       m_internalFormat;   // GL_RGB8 or GL_RGBA8.
         GLenum		m_accessFormat;		// GL_BGR or GL_BGRA.
         Blob_p      m_pBlob;
+		bool		m_bSharedBlob = false;	// m_pBlob was provided at creation, not allocated by us.
 		
 		Size		m_size;				// Width and height in pixels.
 		uint32_t	m_pixelSize;		// Size in bytes of a pixel.
 		GLenum		m_pixelDataType;
 		static Size	s_maxSize;
 
+		static bool		s_bAtlasEnabled;
+		static std::vector<AtlasPage*>	s_atlasPages;
+		static GLuint	s_boundTexture;		// Texture last bound to GL_TEXTURE_2D by us, 0 if unknown.
+
 	};
 } // namespace wg
 #endif //WG_GLSURFACE_DOT_H
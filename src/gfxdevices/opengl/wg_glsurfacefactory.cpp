@@ -71,23 +71,47 @@ namespace wg
 
 	Surface_p GlSurfaceFactory::createSurface( Size size, PixelFormat format, int hint, const Color * pClut ) const
 	{
-        return GlSurface::create(size,format,hint,pClut);
+        _reserveMemory(_memoryNeeded(size, format, hint, pClut, false));
+        return _track(GlSurface::create(size,format,hint,pClut));
 	}
 
 
 	Surface_p GlSurfaceFactory::createSurface( Size size, PixelFormat format, Blob * pBlob, int pitch, int hint, const Color * pClut ) const
 	{
-		return GlSurface::create(size, format, pBlob, pitch, hint, pClut);
+		_reserveMemory(_memoryNeeded(size, format, hint, pClut, true));
+		return _track(GlSurface::create(size, format, pBlob, pitch, hint, pClut));
 	}
 	
 	Surface_p GlSurfaceFactory::createSurface( Size size, PixelFormat format, uint8_t * pPixels, int pitch, const PixelDescription * pPixelDescription, int hint, const Color * pClut ) const
 	{
-		return GlSurface::create(size,format, pPixels, pitch, pPixelDescription, hint, pClut);
+		_reserveMemory(_memoryNeeded(size, format, hint, pClut, false));
+		return _track(GlSurface::create(size,format, pPixels, pitch, pPixelDescription, hint, pClut));
 	}
 	
 	Surface_p GlSurfaceFactory::createSurface( Surface * pOther, int hint ) const
 	{
-		return GlSurface::create( pOther,hint );
+		_reserveMemory(_memoryNeeded(pOther->size(), pOther->pixelFormat(), hint, pOther->clut(), false));
+		return _track(GlSurface::create( pOther,hint ));
+	}
+
+	//____ _memoryNeeded() __________________________________________________________
+
+	// Surfaces keep a backing buffer with lines padded to 4 bytes and CLUT, in addition to
+	// their texture, which gets a third larger with mipmaps. Surfaces packed into an
+	// atlas page count their part of the page instead, but that is not known in advance.
+
+	int64_t GlSurfaceFactory::_memoryNeeded( Size size, PixelFormat format, int hint, const Color * pClut, bool bSharedPixels ) const
+	{
+		PixelDescription	desc;
+		Util::pixelFormatToDescription( format, desc );
+
+		int64_t bytes = bSharedPixels ? 0 : (int64_t) (((size.w*desc.bits/8)+3)&0xFFFFFFFC) * size.h + (pClut ? 4096 : 0);
+
+		int64_t textureBytes = (int64_t) size.w * size.h * ((desc.bits+7)/8);
+		if( (hint & SurfaceHint::Mipmapped) && format != PixelFormat::I8 )
+			textureBytes += textureBytes / 3;
+
+		return bytes + textureBytes;
 	}
 
 
@@ -59,6 +59,9 @@ namespace wg
         Surface_p	createSurface( Size size, PixelFormat format, Blob * pBlob, int pitch, int hint = SurfaceHint::Static, const Color * pClut = nullptr ) const override;
         Surface_p	createSurface( Size size, PixelFormat format, uint8_t * pPixels, int pitch, const PixelDescription * pPixelDescription = 0, int hint = SurfaceHint::Static, const Color * pClut = nullptr ) const override;
         Surface_p	createSurface( Surface * pOther, int hint = SurfaceHint::Static ) const;
+
+	protected:
+		int64_t		_memoryNeeded( Size size, PixelFormat format, int hint, const Color * pClut, bool bSharedPixels ) const override;
 	};
 }
 
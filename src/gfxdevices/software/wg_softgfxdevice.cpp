@@ -26,6 +26,7 @@
 #include <cmath>
 #include <algorithm>
 #include <cstdlib>
+#include <cstring>
 #include <wg_base.h>
 
 #include <cassert>
@@ -39,6 +40,7 @@ namespace wg
 	const char SoftGfxDevice::CLASSNAME[] = {"SoftGfxDevice"};
 	
 	int SoftGfxDevice::s_mulTab[256];
+	int SoftGfxDevice::s_unpremulTab[256];
 
 	SoftGfxDevice::PlotOp_p		SoftGfxDevice::s_plotOpTab[BlendMode_size][PixelFormat_size];
 	SoftGfxDevice::FillOp_p		SoftGfxDevice::s_fillOpTab[BlendMode_size][TintMode_size][PixelFormat_size];
@@ -46,6 +48,7 @@ namespace wg
 	SoftGfxDevice::ClipLineOp_p SoftGfxDevice::s_clipLineOpTab[BlendMode_size][PixelFormat_size];
 	SoftGfxDevice::PlotListOp_p SoftGfxDevice::s_plotListOpTab[BlendMode_size][PixelFormat_size];
 	SoftGfxDevice::WaveOp_p		SoftGfxDevice::s_waveOpTab[BlendMode_size][PixelFormat_size];
+	SoftGfxDevice::SegmentOp_p	SoftGfxDevice::s_segmentOpTab[BlendMode_size][PixelFormat_size];
 
 	SoftGfxDevice::BlitOp_p		SoftGfxDevice::s_pass2OpTab[BlendMode_size][PixelFormat_size];
 
@@ -61,6 +64,26 @@ namespace wg
 	SoftGfxDevice::TransformOp_p		SoftGfxDevice::s_stretchBlendTo_BGRA_8_OpTab[PixelFormat_size][2][2];
 	SoftGfxDevice::TransformOp_p		SoftGfxDevice::s_stretchBlendTo_BGR_8_OpTab[PixelFormat_size][2][2];
 
+	SoftGfxDevice::BlitOp_p		SoftGfxDevice::s_moveTo_BGR_565_OpTab[PixelFormat_size][2];
+	SoftGfxDevice::BlitOp_p		SoftGfxDevice::s_moveTo_BGRA_4_OpTab[PixelFormat_size][2];
+
+	SoftGfxDevice::BlitOp_p		SoftGfxDevice::s_blendTo_BGR_565_OpTab[PixelFormat_size][2];
+	SoftGfxDevice::BlitOp_p		SoftGfxDevice::s_blendTo_BGRA_4_OpTab[PixelFormat_size][2];
+
+	SoftGfxDevice::TransformOp_p		SoftGfxDevice::s_stretchTo_BGR_565_OpTab[PixelFormat_size][2][2];
+	SoftGfxDevice::TransformOp_p		SoftGfxDevice::s_stretchTo_BGRA_4_OpTab[PixelFormat_size][2][2];
+
+	SoftGfxDevice::TransformOp_p		SoftGfxDevice::s_stretchBlendTo_BGR_565_OpTab[PixelFormat_size][2][2];
+	SoftGfxDevice::TransformOp_p		SoftGfxDevice::s_stretchBlendTo_BGRA_4_OpTab[PixelFormat_size][2][2];
+
+	SoftGfxDevice::BlitOp_p		SoftGfxDevice::s_movePremultTo_BGRA_8_OpTab[2];
+	SoftGfxDevice::BlitOp_p		SoftGfxDevice::s_blendPremultTo_BGRA_8_OpTab[2];
+	SoftGfxDevice::BlitOp_p		SoftGfxDevice::s_blendPremultTo_BGR_8_OpTab[2];
+
+	SoftGfxDevice::TransformOp_p		SoftGfxDevice::s_stretchPremultTo_BGRA_8_OpTab[2][2];
+	SoftGfxDevice::TransformOp_p		SoftGfxDevice::s_stretchBlendPremultTo_BGRA_8_OpTab[2][2];
+	SoftGfxDevice::TransformOp_p		SoftGfxDevice::s_stretchBlendPremultTo_BGR_8_OpTab[2][2];
+
 
 
 	const uint8_t s_channel_4_1[256] = {	0, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,
@@ -132,6 +155,14 @@ namespace wg
 											0xc2, 0xc6, 0xca, 0xce, 0xd2, 0xd6, 0xda, 0xde, 0xe2, 0xe6, 0xea, 0xee, 0xf2, 0xf6, 0xfa, 0xff	};
 
 
+	// 4x4 Bayer matrix for ordered dithering, values 0-15.
+
+	const uint8_t s_dither_4x4[4][4] = {	{ 0, 8, 2, 10 },
+											{ 12, 4, 14, 6 },
+											{ 3, 11, 1, 9 },
+											{ 15, 7, 13, 5 } };
+
+
 	//____ read_pixel() _______________________________________________________
 
 	inline void SoftGfxDevice::_read_pixel(const uint8_t * pPixel, PixelFormat format, const Color * pClut, uint8_t& outB, uint8_t& outG, uint8_t& outR, uint8_t& outA)
@@ -261,9 +292,9 @@ namespace wg
 		{
 			int alpha = s_mulTab[srcA];
 
-			outB = limitUint8(backB + (srcB * alpha << 16));
-			outG = limitUint8(backG + (srcG * alpha << 16));
-			outR = limitUint8(backR + (srcR * alpha << 16));
+			outB = limitUint8(backB + (srcB * alpha >> 16));
+			outG = limitUint8(backG + (srcG * alpha >> 16));
+			outR = limitUint8(backR + (srcR * alpha >> 16));
 			outA = backA;
 		}
 
@@ -271,9 +302,9 @@ namespace wg
 		{
 			int alpha = s_mulTab[srcA];
 
-			outB = limitUint8(backB + (srcB * alpha << 16));
-			outG = limitUint8(backG + (srcG * alpha << 16));
-			outR = limitUint8(backR + (srcR * alpha << 16));
+			outB = limitUint8(backB - (srcB * alpha >> 16));
+			outG = limitUint8(backG - (srcG * alpha >> 16));
+			outR = limitUint8(backR - (srcR * alpha >> 16));
 			outA = backA;
 		}
 
@@ -299,6 +330,65 @@ namespace wg
 	}
 
 
+	//____ _dither_pixel() ____________________________________________________
+	/*
+		Adds the dither threshold for canvas position x, y to a color before it is
+		truncated by _write_pixel(), spreading the rounding error of 16-bit formats
+		over a 4x4 pixel pattern.
+	*/
+
+	inline void SoftGfxDevice::_dither_pixel(PixelFormat format, int x, int y, uint8_t& b, uint8_t& g, uint8_t& r, uint8_t& a)
+	{
+		int threshold = s_dither_4x4[y & 3][x & 3];
+
+		if (format == PixelFormat::BGR_565)
+		{
+			b = limitUint8(b + (threshold >> 1));
+			g = limitUint8(g + (threshold >> 2));
+			r = limitUint8(r + (threshold >> 1));
+		}
+
+		if (format == PixelFormat::BGRA_4)
+		{
+			b = limitUint8(b + threshold);
+			g = limitUint8(g + threshold);
+			r = limitUint8(r + threshold);
+			a = limitUint8(a + threshold);
+		}
+	}
+
+	//____ _blend_premultiplied_pixels() ______________________________________
+	/*
+		Same as _blend_pixels(), but for source colors premultiplied by alpha.
+		Blend becomes dst = src + dst*(1-a), other modes get the source color
+		converted back to straight alpha first.
+	*/
+
+	inline void	SoftGfxDevice::_blend_premultiplied_pixels(	BlendMode mode, uint8_t srcB, uint8_t srcG, uint8_t srcR, uint8_t srcA,
+												uint8_t backB, uint8_t backG, uint8_t backR, uint8_t backA,
+												uint8_t& outB, uint8_t& outG, uint8_t& outR, uint8_t& outA)
+	{
+		if (mode == BlendMode::Blend)
+		{
+			int invAlpha = 65536 - s_mulTab[srcA];
+
+			outB = srcB + ((backB * invAlpha) >> 16);
+			outG = srcG + ((backG * invAlpha) >> 16);
+			outR = srcR + ((backR * invAlpha) >> 16);
+			outA = srcA + ((backA * invAlpha) >> 16);
+		}
+		else
+		{
+			int unpremul = s_unpremulTab[srcA];
+
+			srcB = (srcB * unpremul) >> 16;
+			srcG = (srcG * unpremul) >> 16;
+			srcR = (srcR * unpremul) >> 16;
+
+			_blend_pixels(mode, srcB, srcG, srcR, srcA, backB, backG, backR, backA, outB, outG, outR, outA);
+		}
+	}
+
 	//____ _init_tint_color() _________________________________________________
 
 	inline void	SoftGfxDevice::_init_tint_color(TintMode tintMode, const ColTrans& tint, uint8_t inB, uint8_t inG, uint8_t inR, uint8_t inA, uint8_t& outB, uint8_t& outG, uint8_t& outR, uint8_t& outA)
@@ -548,6 +638,14 @@ namespace wg
 				uint8_t outB, outG, outR, outA;
 				_blend_pixels(BLEND, srcB, srcG, srcR, srcA, backB, backG, backR, backA, outB, outG, outR, outA);
 
+				// Step 3.5: Apply any ordered dithering
+
+				if (DSTFORMAT == PixelFormat::BGR_565 || DSTFORMAT == PixelFormat::BGRA_4)
+				{
+					if (tint.bDither)
+						_dither_pixel(DSTFORMAT, tint.ditherOrigin.x + x, tint.ditherOrigin.y + y, outB, outG, outR, outA);
+				}
+
 				// Step 4: Write resulting pixel to destination
 
 				_write_pixel(pDst, DSTFORMAT, outB, outG, outR, outA);
@@ -833,6 +931,14 @@ namespace wg
 				uint8_t outB, outG, outR, outA;
 				_blend_pixels(BLEND, srcB, srcG, srcR, srcA, backB, backG, backR, backA, outB, outG, outR, outA);
 
+				// Step 5.5: Apply any ordered dithering
+
+				if (DSTFORMAT == PixelFormat::BGR_565 || DSTFORMAT == PixelFormat::BGRA_4)
+				{
+					if (tint.bDither)
+						_dither_pixel(DSTFORMAT, tint.ditherOrigin.x + x, tint.ditherOrigin.y + y, outB, outG, outR, outA);
+				}
+
 				// Step 6: Write resulting pixel to destination
 
 				_write_pixel(pDst, DSTFORMAT, outB, outG, outR, outA);
@@ -846,6 +952,132 @@ namespace wg
 
 	}
 
+	//____ _clip_draw_segment_column() ________________________________________
+	/*
+		Renders rows clipBeg to clipEnd of one column for clipDrawSegments(), pColumn pointing
+		at the pixel of row clipBeg. Rows are counted from the top of dest. For edge i,
+		begin and end are 24.8 offsets of the rows crossed by the edge and the coverage of the
+		segment below the edge for row n is coverage + coverageInc*n, in 16 binals.
+
+		Rows between edges are filled with a single color, coverage is only calculated for
+		the rows actually crossed by one or more edges.
+	*/
+
+	template<BlendMode BLEND, PixelFormat DSTFORMAT>
+	void SoftGfxDevice::_clip_draw_segment_column(int clipBeg, int clipEnd, uint8_t * pColumn, int linePitch, int nEdges, const SegmentEdge * pEdges, const Color * pSegmentColors, const ColTrans& tint)
+	{
+		const bool bSkipTransparent = (BLEND == BlendMode::Blend || BLEND == BlendMode::Add || BLEND == BlendMode::Subtract);
+
+		uint8_t * pDst = pColumn;
+		int row = clipBeg;
+		int edge = 0;											// First edge we haven't fully passed yet.
+
+		while (row < clipEnd)
+		{
+			while (edge < nEdges && ((pEdges[edge].end + 255) >> 8) <= row)
+				edge++;
+
+			if (edge == nEdges || (pEdges[edge].begin >> 8) > row)
+			{
+				// We are fully inside a segment, no need to take any edge into account.
+
+				int runEnd = edge == nEdges ? clipEnd : min(clipEnd, pEdges[edge].begin >> 8);
+				Color col = pSegmentColors[edge];
+
+				if (col.a == 0 && bSkipTransparent)
+				{
+					pDst += (runEnd - row) * linePitch;
+					row = runEnd;
+					continue;
+				}
+
+				const bool bOpaque = (BLEND == BlendMode::Replace || (BLEND == BlendMode::Blend && col.a == 255));
+
+				for (; row < runEnd; row++)
+				{
+					uint8_t outB, outG, outR, outA;
+
+					if (bOpaque)
+					{
+						outB = col.b;
+						outG = col.g;
+						outR = col.r;
+						outA = col.a;
+					}
+					else
+					{
+						uint8_t backB, backG, backR, backA;
+						_read_pixel(pDst, DSTFORMAT, nullptr, backB, backG, backR, backA);
+						_blend_pixels(BLEND, col.b, col.g, col.r, col.a, backB, backG, backR, backA, outB, outG, outR, outA);
+					}
+
+					if (DSTFORMAT == PixelFormat::BGR_565 || DSTFORMAT == PixelFormat::BGRA_4)
+					{
+						if (tint.bDither)
+							_dither_pixel(DSTFORMAT, tint.ditherOrigin.x, tint.ditherOrigin.y + row, outB, outG, outR, outA);
+					}
+
+					_write_pixel(pDst, DSTFORMAT, outB, outG, outR, outA);
+					pDst += linePitch;
+				}
+			}
+			else
+			{
+				// Row is crossed by one or more edges. Sum up the colors of all segments
+				// present, weighted by coverage and alpha, into a premultiplied color.
+
+				int accB = 0, accG = 0, accR = 0, accA = 0;
+				int prevFrac = 65536;
+
+				int i = edge;
+				for (; i < nEdges && (pEdges[i].begin >> 8) <= row; i++)
+				{
+					int frac = pEdges[i].coverage + pEdges[i].coverageInc * row;
+					limit(frac, 0, 65536);
+
+					const Color& col = pSegmentColors[i];
+					int weight = (int)(((int64_t)(prevFrac - frac) * s_mulTab[col.a]) >> 16);
+
+					accB += col.b * weight;
+					accG += col.g * weight;
+					accR += col.r * weight;
+					accA += weight;
+
+					prevFrac = frac;
+				}
+
+				const Color& col = pSegmentColors[i];
+				int weight = (int)(((int64_t)prevFrac * s_mulTab[col.a]) >> 16);
+
+				accB += col.b * weight;
+				accG += col.g * weight;
+				accR += col.r * weight;
+				accA += weight;
+
+				uint8_t srcB = accB >> 16;
+				uint8_t srcG = accG >> 16;
+				uint8_t srcR = accR >> 16;
+				uint8_t srcA = (accA * 255) >> 16;
+
+				uint8_t backB, backG, backR, backA;
+				_read_pixel(pDst, DSTFORMAT, nullptr, backB, backG, backR, backA);
+
+				uint8_t outB, outG, outR, outA;
+				_blend_premultiplied_pixels(BLEND, srcB, srcG, srcR, srcA, backB, backG, backR, backA, outB, outG, outR, outA);
+
+				if (DSTFORMAT == PixelFormat::BGR_565 || DSTFORMAT == PixelFormat::BGRA_4)
+				{
+					if (tint.bDither)
+						_dither_pixel(DSTFORMAT, tint.ditherOrigin.x, tint.ditherOrigin.y + row, outB, outG, outR, outA);
+				}
+
+				_write_pixel(pDst, DSTFORMAT, outB, outG, outR, outA);
+				pDst += linePitch;
+				row++;
+			}
+		}
+	}
+
 	//____ draw_wave_column() _________________________________________________
 /*
 	template<BlendMode BLEND, int TINTFLAGS, PixelFormat DSTFORMAT>
@@ -1036,6 +1268,15 @@ namespace wg
 			tintG = s_mulTab[tint.baseTint.g];
 			tintR = s_mulTab[tint.baseTint.r];
 			tintA = s_mulTab[tint.baseTint.a];
+
+			if (TINTFLAGS & 0x2)
+			{
+				// Source is premultiplied, so color tint needs to be premultiplied as well.
+
+				tintB = (tintB * tint.baseTint.a) / 255;
+				tintG = (tintG * tint.baseTint.a) / 255;
+				tintR = (tintR * tint.baseTint.a) / 255;
+			}
 		}
 
 		for (int y = 0; y < nLines; y++)
@@ -1066,7 +1307,18 @@ namespace wg
 				// Step 3: Blend srcX and backX into outX
 
 				uint8_t outB, outG, outR, outA;
-				_blend_pixels(BLEND, srcB, srcG, srcR, srcA, backB, backG, backR, backA, outB, outG, outR, outA);
+				if (TINTFLAGS & 0x2)
+					_blend_premultiplied_pixels(BLEND, srcB, srcG, srcR, srcA, backB, backG, backR, backA, outB, outG, outR, outA);
+				else
+					_blend_pixels(BLEND, srcB, srcG, srcR, srcA, backB, backG, backR, backA, outB, outG, outR, outA);
+
+				// Step 3.5: Apply any ordered dithering
+
+				if (DSTFORMAT == PixelFormat::BGR_565 || DSTFORMAT == PixelFormat::BGRA_4)
+				{
+					if (tint.bDither)
+						_dither_pixel(DSTFORMAT, tint.ditherOrigin.x + x, tint.ditherOrigin.y + y, outB, outG, outR, outA);
+				}
 
 				// Step 4: Write resulting pixel to destination
 
@@ -1106,6 +1358,15 @@ namespace wg
 			tintG = s_mulTab[tint.baseTint.g];
 			tintR = s_mulTab[tint.baseTint.r];
 			tintA = s_mulTab[tint.baseTint.a];
+
+			if (TINTFLAGS & 0x2)
+			{
+				// Source is premultiplied, so color tint needs to be premultiplied as well.
+
+				tintB = (tintB * tint.baseTint.a) / 255;
+				tintG = (tintG * tint.baseTint.a) / 255;
+				tintR = (tintR * tint.baseTint.a) / 255;
+			}
 		}
 
 		for (int y = 0; y < nLines; y++)
@@ -1179,7 +1440,18 @@ namespace wg
 				// Step 4: Blend srcX and backX into outX
 
 				uint8_t outB, outG, outR, outA;
-				_blend_pixels(BLEND, srcB, srcG, srcR, srcA, backB, backG, backR, backA, outB, outG, outR, outA);
+				if (TINTFLAGS & 0x2)
+					_blend_premultiplied_pixels(BLEND, srcB, srcG, srcR, srcA, backB, backG, backR, backA, outB, outG, outR, outA);
+				else
+					_blend_pixels(BLEND, srcB, srcG, srcR, srcA, backB, backG, backR, backA, outB, outG, outR, outA);
+
+				// Step 4.5: Apply any ordered dithering
+
+				if (DSTFORMAT == PixelFormat::BGR_565 || DSTFORMAT == PixelFormat::BGRA_4)
+				{
+					if (tint.bDither)
+						_dither_pixel(DSTFORMAT, tint.ditherOrigin.x + x, tint.ditherOrigin.y + y, outB, outG, outR, outA);
+				}
 
 				// Step 5: Write resulting pixel to destination
 
@@ -1196,15 +1468,25 @@ namespace wg
 	}
 
 	//____ _stretch_blit __________________________________________
+	/*
+		Axis-aligned version of _transform_blit(), only using matrix[0][0] and matrix[1][1].
+
+		Source position is stepped incrementally in 16.16 fixed point. Source offsets and interpolation
+		weights only depend on the column, so they are calculated once per call and reused for all lines.
+		Bilinear interpolation is done horizontally, then vertically, with 8-bit integer weights.
+		Neighbours are clamped to the surface, so edge pixels never read outside of it.
+	*/
 
 	template<PixelFormat SRCFORMAT, ScaleMode SCALEMODE, int TINTFLAGS, BlendMode BLEND, PixelFormat DSTFORMAT>
 	void SoftGfxDevice::_stretch_blit(const SoftSurface * pSrcSurf, CoordF pos, const float matrix[2][2], uint8_t * pDst, int dstPitchX, int dstPitchY, int nLines, int lineLength, const SoftGfxDevice::ColTrans& tint)
 	{
 		int srcPixelBytes = pSrcSurf->m_pixelDescription.bits / 8;
 		int	srcPitch = pSrcSurf->m_pitch;
+		int srcMaxX = pSrcSurf->m_size.w - 1;
+		int srcMaxY = pSrcSurf->m_size.h - 1;
 
-		int pixelIncX = (int)(matrix[0][0] * 32768);
-		int lineIncY = (int)(matrix[1][1] * 32768);
+		int pixelIncX = (int)(matrix[0][0] * 65536);
+		int lineIncY = (int)(matrix[1][1] * 65536);
 
 		int tintB, tintG, tintR, tintA;
 
@@ -1214,22 +1496,50 @@ namespace wg
 			tintG = s_mulTab[tint.baseTint.g];
 			tintR = s_mulTab[tint.baseTint.r];
 			tintA = s_mulTab[tint.baseTint.a];
+
+			if (TINTFLAGS & 0x2)
+			{
+				// Source is premultiplied, so color tint needs to be premultiplied as well.
+
+				tintB = (tintB * tint.baseTint.a) / 255;
+				tintG = (tintG * tint.baseTint.a) / 255;
+				tintR = (tintR * tint.baseTint.a) / 255;
+			}
+		}
+
+		// Precalculate source offsets and weights for all columns.
+
+		int columnTabSize = lineLength * sizeof(StretchColumn);
+		StretchColumn * pColumns = (StretchColumn*) Base::memStackAlloc(columnTabSize);
+
+		int ofsX = (int)(pos.x * 65536);
+		for (int x = 0; x < lineLength; x++)
+		{
+			int srcX = min(ofsX >> 16, srcMaxX);
+
+			pColumns[x].ofs = srcX * srcPixelBytes;
+			pColumns[x].nextOfs = srcX < srcMaxX ? srcPixelBytes : 0;
+			pColumns[x].weight = srcX < srcMaxX ? (ofsX >> 8) & 0xFF : 0;
+			ofsX += pixelIncX;
 		}
 
-		int ofsY = (int)(pos.y * 32768);		// We use 15 binals for all calculations 
+		int ofsY = (int)(pos.y * 65536);
 
 		for (int y = 0; y < nLines; y++)
 		{
-			int ofsX = (int)(pos.x * 32768);
+			int srcY = min(ofsY >> 16, srcMaxY);
 
-			uint8_t * pSrc = pSrcSurf->m_pData + (ofsY >> 15) * srcPitch;
+			const uint8_t * pSrc = pSrcSurf->m_pData + srcY * srcPitch;
+			int nextLine = srcY < srcMaxY ? srcPitch : 0;
+			int fracY2 = srcY < srcMaxY ? (ofsY >> 8) & 0xFF : 0;
+			int fracY1 = 256 - fracY2;
 
 			for (int x = 0; x < lineLength; x++)
 			{
 				// Step 1: Read source color.
 
 				uint8_t srcB, srcG, srcR, srcA;
-				uint8_t * p = pSrc + (ofsX >> 15)*srcPixelBytes;
+				const uint8_t * p = pSrc + pColumns[x].ofs;
 
 				if (SCALEMODE == ScaleMode::Interpolate)
 				{
@@ -1240,28 +1550,22 @@ namespace wg
 					uint8_t src21_b, src21_g, src21_r, src21_a;
 					uint8_t src22_b, src22_g, src22_r, src22_a;
 
+					int nextPixel = pColumns[x].nextOfs;
+
 					_read_pixel(p, SRCFORMAT, pSrcSurf->m_pClut, src11_b, src11_g, src11_r, src11_a);
-					_read_pixel(p + srcPixelBytes, SRCFORMAT, pSrcSurf->m_pClut, src12_b, src12_g, src12_r, src12_a);
-					_read_pixel(p + srcPitch, SRCFORMAT, pSrcSurf->m_pClut, src21_b, src21_g, src21_r, src21_a);
-					_read_pixel(p + srcPitch + srcPixelBytes, SRCFORMAT, pSrcSurf->m_pClut, src22_b, src22_g, src22_r, src22_a);
+					_read_pixel(p + nextPixel, SRCFORMAT, pSrcSurf->m_pClut, src12_b, src12_g, src12_r, src12_a);
+					_read_pixel(p + nextLine, SRCFORMAT, pSrcSurf->m_pClut, src21_b, src21_g, src21_r, src21_a);
+					_read_pixel(p + nextLine + nextPixel, SRCFORMAT, pSrcSurf->m_pClut, src22_b, src22_g, src22_r, src22_a);
 
 					// Interpolate our 2x2 source colors into one source color, srcX
 
-					int fracX2 = ofsX & 0x7FFF;
-					int fracX1 = 32768 - fracX2;
-
-					int fracY2 = ofsY & 0x7FFF;
-					int fracY1 = 32768 - fracY2;
-
-					int mul11 = fracX1 * fracY1 >> 15;
-					int mul12 = fracX2 * fracY1 >> 15;
-					int mul21 = fracX1 * fracY2 >> 15;
-					int mul22 = fracX2 * fracY2 >> 15;
+					int fracX2 = pColumns[x].weight;
+					int fracX1 = 256 - fracX2;
 
-					srcB = (src11_b * mul11 + src12_b * mul12 + src21_b * mul21 + src22_b * mul22) >> 15;
-					srcG = (src11_g * mul11 + src12_g * mul12 + src21_g * mul21 + src22_g * mul22) >> 15;
-					srcR = (src11_r * mul11 + src12_r * mul12 + src21_r * mul21 + src22_r * mul22) >> 15;
-					srcA = (src11_a * mul11 + src12_a * mul12 + src21_a * mul21 + src22_a * mul22) >> 15;
+					srcB = ((src11_b * fracX1 + src12_b * fracX2) * fracY1 + (src21_b * fracX1 + src22_b * fracX2) * fracY2) >> 16;
+					srcG = ((src11_g * fracX1 + src12_g * fracX2) * fracY1 + (src21_g * fracX1 + src22_g * fracX2) * fracY2) >> 16;
+					srcR = ((src11_r * fracX1 + src12_r * fracX2) * fracY1 + (src21_r * fracX1 + src22_r * fracX2) * fracY2) >> 16;
+					srcA = ((src11_a * fracX1 + src12_a * fracX2) * fracY1 + (src21_a * fracX1 + src22_a * fracX2) * fracY2) >> 16;
 				}
 				else
 				{
@@ -1287,21 +1591,33 @@ namespace wg
 				// Step 4: Blend srcX and backX into outX
 
 				uint8_t outB, outG, outR, outA;
-				_blend_pixels(BLEND, srcB, srcG, srcR, srcA, backB, backG, backR, backA, outB, outG, outR, outA);
+				if (TINTFLAGS & 0x2)
+					_blend_premultiplied_pixels(BLEND, srcB, srcG, srcR, srcA, backB, backG, backR, backA, outB, outG, outR, outA);
+				else
+					_blend_pixels(BLEND, srcB, srcG, srcR, srcA, backB, backG, backR, backA, outB, outG, outR, outA);
+
+				// Step 4.5: Apply any ordered dithering
+
+				if (DSTFORMAT == PixelFormat::BGR_565 || DSTFORMAT == PixelFormat::BGRA_4)
+				{
+					if (tint.bDither)
+						_dither_pixel(DSTFORMAT, tint.ditherOrigin.x + x, tint.ditherOrigin.y + y, outB, outG, outR, outA);
+				}
 
 				// Step 5: Write resulting pixel to destination
 
 				_write_pixel(pDst, DSTFORMAT, outB, outG, outR, outA);
 
-				// Step 6: Increment source and destination pointers
+				// Step 6: Increment destination pointer
 
-				ofsX += pixelIncX;
 				pDst += dstPitchX;
 			}
 
 			ofsY += lineIncY;
 			pDst += dstPitchY;
 		}
+
+		Base::memStackRelease(columnTabSize);
 	}
 
 
@@ -1322,6 +1638,7 @@ namespace wg
 	
 	SoftGfxDevice::SoftGfxDevice() : GfxDevice(Size(0,0))
 	{
+		m_bDither = false;
 		m_bEnableCustomFunctions = false;
 		m_bUseCustomFunctions = false;
 		m_pCanvas = nullptr;
@@ -1335,6 +1652,7 @@ namespace wg
 	
 	SoftGfxDevice::SoftGfxDevice( Surface * pCanvas ) : GfxDevice( pCanvas?pCanvas->size():Size() )
 	{
+		m_bDither = false;
 		m_bEnableCustomFunctions = false;
 		m_bUseCustomFunctions = false;
 		m_pCanvas = pCanvas;
@@ -1504,6 +1822,22 @@ namespace wg
 	}
 
 
+	//____ setDithering() ___________________________________________________________
+	/**
+	 * @brief Enable ordered dithering when rendering to 16-bit canvases.
+	 *
+	 * When enabled, fills, blits and plotted pixels written to BGR_565 and BGRA_4 canvases
+	 * are dithered with a 4x4 ordered pattern, hiding the banding caused by the reduced
+	 * color depth. Lines and waveforms are not dithered. Has no effect on other canvas formats.
+	 *
+	 * Dithering is disabled by default.
+	 */
+
+	void SoftGfxDevice::setDithering(bool bDither)
+	{
+		m_bDither = bDither;
+	}
+
 	//____ fill() ____________________________________________________________________
 
 	void SoftGfxDevice::fill(const Rect& rect, const Color& col)
@@ -1512,7 +1846,7 @@ namespace wg
 			return;
 
 		Color fillColor = col * m_tintColor;
-		ColTrans	colTrans{ Color::White, nullptr, nullptr };
+		ColTrans	colTrans{ Color::White, nullptr, nullptr, m_bDither, rect.pos() };
 
 		// Skip calls that won't affect destination
 
@@ -1783,7 +2117,7 @@ namespace wg
 
 				int bodyThickness = endY - beginY - 2;
 				pBegin = m_pCanvasPixels + (beginY+1) * m_canvasPitch + begin.x * pixelBytes;
-				pOp(pBegin, pixelBytes, m_canvasPitch-bodyThickness*pixelBytes, bodyThickness, length, _col, colTrans);
+				pOp(pBegin, pixelBytes, m_canvasPitch - length*pixelBytes, bodyThickness, length, _col, colTrans);
 
 //				_drawStraightLine({ begin.x, beginY }, Orientation::Horizontal, length, edgeColor);
 //				_drawStraightLine({ begin.x, endY - 1 }, Orientation::Horizontal, length, edgeColor);
@@ -1819,7 +2153,7 @@ namespace wg
 
 				int bodyThickness = endX - beginX - 2;
 				pBegin = m_pCanvasPixels + begin.y * m_canvasPitch + (beginX+1) * pixelBytes;
-				pOp(pBegin, m_canvasPitch, pixelBytes - m_canvasPitch-bodyThickness, bodyThickness, length, _col, colTrans);
+				pOp(pBegin, m_canvasPitch, pixelBytes - m_canvasPitch*length, bodyThickness, length, _col, colTrans);
 
 //				_drawStraightLine({ beginX, begin.y }, Orientation::Vertical, length, edgeColor);
 //				_drawStraightLine({ endX - 1, begin.y }, Orientation::Vertical, length, edgeColor);
@@ -2018,7 +2352,7 @@ namespace wg
 
 				int bodyThickness = endY - beginY - 2;
 				uint8_t * pBegin = m_pCanvasPixels + (beginY + 1) * m_canvasPitch + begin.x * pixelBytes;
-				pOp(pBegin, pixelBytes, m_canvasPitch - bodyThickness * pixelBytes, bodyThickness, length, _col, colTrans);
+				pOp(pBegin, pixelBytes, m_canvasPitch - length * pixelBytes, bodyThickness, length, _col, colTrans);
 //				fill({ begin.x, beginY + 1, length, endY - beginY - 2 }, _col);
 			}
 
@@ -2089,7 +2423,7 @@ namespace wg
 
 				int bodyThickness = endX - beginX - 2;
 				uint8_t * pBegin = m_pCanvasPixels + begin.y * m_canvasPitch + (beginX + 1) * pixelBytes;
-				pOp(pBegin, m_canvasPitch, pixelBytes - m_canvasPitch - bodyThickness, bodyThickness, length, _col, colTrans);
+				pOp(pBegin, m_canvasPitch, pixelBytes - m_canvasPitch * length, bodyThickness, length, _col, colTrans);
 //				fill({ beginX + 1, begin.y, endX - beginX - 2, length }, _col);
 			}
 
@@ -2098,13 +2432,407 @@ namespace wg
 	}
 
 
+	//____ clipDrawPolyline() _________________________________________________
+
+	// The line is outlined as one quad per segment plus a bevel triangle on the outside of each joint, all with
+	// the same winding. The outline is rasterized by accumulating signed edge coverage per pixel and summing it
+	// along each row, which gives exact anti-aliasing without any pixel being blended more than once.
+	// Cells are grouped in blocks of 16 per line, so empty stretches of long lines can be skipped quickly.
+
+	void SoftGfxDevice::clipDrawPolyline(const Rect& _clip, int nPoints, const CoordF * pPoints, Color color, float thickness)
+	{
+		if (!m_pCanvas || !m_pCanvasPixels || nPoints < 2 || thickness <= 0.f)
+			return;
+
+		Color fillColor = color * m_tintColor;
+		ColTrans	colTrans{ Color::White, nullptr, nullptr, false, Coord() };
+
+		// Skip calls that won't affect destination
+
+		if (fillColor.a == 0 && (m_blendMode == BlendMode::Blend || m_blendMode == BlendMode::Add || m_blendMode == BlendMode::Subtract))
+			return;
+
+		Rect clip(_clip, Rect(0, 0, m_canvasSize));
+		if (clip.w <= 0 || clip.h <= 0)
+			return;
+
+		// Fully covered pixels of an opaque line can be written without blending.
+
+		BlendMode	fullBlendMode = m_blendMode;
+		if (fullBlendMode == BlendMode::Blend && fillColor.a == 255)
+			fullBlendMode = BlendMode::Replace;
+
+		PlotOp_p	pPlotOp = s_plotOpTab[(int)m_blendMode][(int)m_pCanvas->pixelFormat()];
+		PlotOp_p	pFullPlotOp = s_plotOpTab[(int)fullBlendMode][(int)m_pCanvas->pixelFormat()];
+		FillOp_p	pFullFillOp = s_fillOpTab[(int)fullBlendMode][0][(int)m_pCanvas->pixelFormat()];
+		if (!pPlotOp || !pFullPlotOp || !pFullFillOp)
+			return;
+
+		// Generate the edges of the outline
+
+		int maxEdges = (nPoints - 1) * 4 + (nPoints - 2) * 3;
+		int edgeBytes = maxEdges * sizeof(PolyEdge);
+		PolyEdge * pEdges = (PolyEdge*)Base::memStackAlloc(edgeBytes);
+		int nEdges = 0;
+
+		float	halfThickness = thickness / 2;
+		CoordF	prevNormal;
+		CoordF	prevDir;
+		bool	bHasPrev = false;
+
+		for (int i = 0; i < nPoints - 1; i++)
+		{
+			CoordF p0(pPoints[i].x + 0.5f, pPoints[i].y + 0.5f);
+			CoordF p1(pPoints[i + 1].x + 0.5f, pPoints[i + 1].y + 0.5f);
+
+			float dx = p1.x - p0.x;
+			float dy = p1.y - p0.y;
+			float len = std::sqrt(dx*dx + dy*dy);
+			if (len < 0.001f)
+				continue;
+
+			CoordF n(-dy * halfThickness / len, dx * halfThickness / len);
+
+			if (bHasPrev)
+			{
+				// Bevel the outer side of the joint, the inner side is already covered by the segments.
+
+				float side = (prevNormal.x * dx + prevNormal.y * dy) > 0.f ? -1.f : 1.f;
+				nEdges = _addPolylineTriangle(pEdges, nEdges, p0, CoordF(p0.x + prevNormal.x * side, p0.y + prevNormal.y * side),
+																	CoordF(p0.x + n.x * side, p0.y + n.y * side));
+			}
+
+			CoordF a(p0.x + n.x, p0.y + n.y);
+			CoordF b(p1.x + n.x, p1.y + n.y);
+			CoordF c(p1.x - n.x, p1.y - n.y);
+			CoordF d(p0.x - n.x, p0.y - n.y);
+
+			nEdges = _addPolylineEdge(pEdges, nEdges, a, b);
+			nEdges = _addPolylineEdge(pEdges, nEdges, b, c);
+			nEdges = _addPolylineEdge(pEdges, nEdges, c, d);
+			nEdges = _addPolylineEdge(pEdges, nEdges, d, a);
+
+			prevNormal = n;
+			bHasPrev = true;
+		}
+
+		// Sort edges into bands of lines, so each band only needs to process the edges crossing it.
+
+		const int bandHeight = 16;
+		int nBands = (clip.h + bandHeight - 1) / bandHeight;
+
+		int bandTabBytes = (nBands + 1) * sizeof(int);
+		int * pBandOfs = (int*)Base::memStackAlloc(bandTabBytes);
+		memset(pBandOfs, 0, bandTabBytes);
+
+		for (int i = 0; i < nEdges; i++)
+		{
+			PolyEdge& e = pEdges[i];
+			float top = e.y0 - clip.y;
+			float bottom = e.y1 - clip.y;
+			if (bottom <= 0.f || top >= (float)clip.h)
+			{
+				e.firstBand = 1;
+				e.lastBand = 0;
+				continue;
+			}
+
+			e.firstBand = top < 0.f ? 0 : ((int)top) / bandHeight;
+			e.lastBand = std::min(nBands - 1, ((int)std::ceil(bottom) - 1) / bandHeight);
+
+			for (int band = e.firstBand; band <= e.lastBand; band++)
+				pBandOfs[band + 1]++;
+		}
+
+		for (int band = 0; band < nBands; band++)
+			pBandOfs[band + 1] += pBandOfs[band];
+
+		int bandListBytes = std::max(1, pBandOfs[nBands]) * sizeof(int);
+		int * pBandList = (int*)Base::memStackAlloc(bandListBytes);
+		int * pBandFill = (int*)Base::memStackAlloc(bandTabBytes);
+		memcpy(pBandFill, pBandOfs, bandTabBytes);
+
+		for (int i = 0; i < nEdges; i++)
+		{
+			for (int band = pEdges[i].firstBand; band <= pEdges[i].lastBand; band++)
+				pBandList[pBandFill[band]++] = i;
+		}
+
+		// Accumulate and render band by band
+
+		int accPitch = clip.w + 2;
+		int accBytes = accPitch * bandHeight * sizeof(float);
+		float * pAcc = (float*)Base::memStackAlloc(accBytes);
+
+		int blockPitch = (accPitch + 15) / 16;
+		int blockBytes = blockPitch * bandHeight;
+		uint8_t * pBlocks = (uint8_t*)Base::memStackAlloc(blockBytes);
+
+		int pixelBytes = m_canvasPixelBits / 8;
+
+		for (int band = 0; band < nBands; band++)
+		{
+			int bandBeg = pBandOfs[band];
+			int bandEnd = pBandOfs[band + 1];
+			if (bandBeg == bandEnd)
+				continue;
+
+			int bandY = clip.y + band * bandHeight;
+			int nLines = std::min(bandHeight, clip.y + clip.h - bandY);
+
+			// Find horizontal extent of the band, so we only clear and scan what is needed.
+
+			float minX = (float)clip.w, maxX = 0.f;
+			for (int i = bandBeg; i < bandEnd; i++)
+			{
+				const PolyEdge& e = pEdges[pBandList[i]];
+				minX = std::min(minX, std::min(e.x0, e.x1) - clip.x);
+				maxX = std::max(maxX, std::max(e.x0, e.x1) - clip.x);
+			}
+
+			int begX = std::max(0, (int)std::floor(minX));
+			int endX = std::min(clip.w, (int)std::ceil(maxX) + 1);
+			if (begX >= endX)
+				continue;
+
+			for (int y = 0; y < nLines; y++)
+				memset(pAcc + y * accPitch + begX, 0, (endX + 2 - begX) * sizeof(float));
+			memset(pBlocks, 0, blockBytes);
+
+			for (int i = bandBeg; i < bandEnd; i++)
+			{
+				const PolyEdge& e = pEdges[pBandList[i]];
+				_accumulatePolylineEdge(pAcc, accPitch, pBlocks, blockPitch, clip.w, nLines, e.x0 - clip.x, e.y0 - bandY, e.x1 - clip.x, e.y1 - bandY, e.dir);
+			}
+
+			for (int y = 0; y < nLines; y++)
+			{
+				const float * pCoverage = pAcc + y * accPitch;
+				const uint8_t * pTouched = pBlocks + y * blockPitch;
+				uint8_t * pDst = m_pCanvasPixels + (bandY + y) * m_canvasPitch + clip.x * pixelBytes;
+
+				float sum = 0.f;
+				int x = begX;
+				while (x < endX)
+				{
+					if ((x & 15) == 0 && !pTouched[x >> 4] && std::abs(sum) < 0.002f)
+					{
+						x += 16;
+						continue;
+					}
+
+					sum += pCoverage[x];
+					float coverage = std::abs(sum);
+
+					if (coverage >= 0.998f)
+					{
+						int runBeg = x++;
+						while (x < endX && std::abs(sum + pCoverage[x]) >= 0.998f)
+							sum += pCoverage[x++];
+
+						if (x - runBeg < 4)
+						{
+							for (int i = runBeg; i < x; i++)
+								pFullPlotOp(pDst + i * pixelBytes, fillColor, colTrans);
+						}
+						else
+							pFullFillOp(pDst + runBeg * pixelBytes, pixelBytes, 0, 1, x - runBeg, fillColor, colTrans);
+					}
+					else
+					{
+						int alpha = (int)(coverage * fillColor.a + 0.5f);
+						if (alpha > 0)
+						{
+							Color col = fillColor;
+							col.a = (uint8_t)alpha;
+							pPlotOp(pDst + x * pixelBytes, col, colTrans);
+						}
+						x++;
+					}
+				}
+			}
+		}
+
+		Base::memStackRelease(blockBytes);
+		Base::memStackRelease(accBytes);
+		Base::memStackRelease(bandTabBytes);
+		Base::memStackRelease(bandListBytes);
+		Base::memStackRelease(bandTabBytes);
+		Base::memStackRelease(edgeBytes);
+	}
+
+	//____ _addPolylineEdge() _________________________________________________
+
+	int SoftGfxDevice::_addPolylineEdge(PolyEdge * pEdges, int nEdges, CoordF beg, CoordF end)
+	{
+		if (beg.y == end.y)
+			return nEdges;
+
+		PolyEdge& e = pEdges[nEdges];
+		if (beg.y < end.y)
+		{
+			e.x0 = beg.x; e.y0 = beg.y; e.x1 = end.x; e.y1 = end.y;
+			e.dir = 1.f;
+		}
+		else
+		{
+			e.x0 = end.x; e.y0 = end.y; e.x1 = beg.x; e.y1 = beg.y;
+			e.dir = -1.f;
+		}
+		return nEdges + 1;
+	}
+
+	//____ _addPolylineTriangle() _____________________________________________
+
+	// Adds triangle with same winding as the segment quads, skipping degenerated ones.
+
+	int SoftGfxDevice::_addPolylineTriangle(PolyEdge * pEdges, int nEdges, CoordF a, CoordF b, CoordF c)
+	{
+		float cross = (b.x - a.x)*(c.y - a.y) - (b.y - a.y)*(c.x - a.x);
+
+		if (std::abs(cross) < 0.0001f)
+			return nEdges;
+
+		if (cross > 0.f)
+			std::swap(b, c);
+
+		nEdges = _addPolylineEdge(pEdges, nEdges, a, b);
+		nEdges = _addPolylineEdge(pEdges, nEdges, b, c);
+		nEdges = _addPolylineEdge(pEdges, nEdges, c, a);
+		return nEdges;
+	}
+
+	//____ _accumulatePolylineEdge() __________________________________________
+
+	// Adds the signed area covered to the right of the edge to each cell it passes through and marks the blocks
+	// of cells touched. Coordinates are relative to the accumulation buffer, y0 < y1. Parts of the edge left of
+	// the buffer are added to the first cell and parts right of it are dropped, which keeps each row exact.
+
+	void SoftGfxDevice::_accumulatePolylineEdge(float * pAcc, int pitch, uint8_t * pBlocks, int blockPitch, int width, int nLines,
+												float x0, float y0, float x1, float y1, float dir)
+	{
+		float dxdy = (x1 - x0) / (y1 - y0);
+		float x = x0;
+
+		if (y0 < 0.f)
+		{
+			x -= y0 * dxdy;
+			y0 = 0.f;
+		}
+
+		if (y1 > (float)nLines)
+			y1 = (float)nLines;
+
+		if (y0 >= y1)
+			return;
+
+		int yBeg = (int)y0;
+		int yEnd = (int)std::ceil(y1);
+
+		float xMax = (float)width;
+		bool bClipX = std::min(x0, x1) < 0.f || std::max(x0, x1) > xMax;
+
+		for (int y = yBeg; y < yEnd; y++)
+		{
+			float dy = 1.f;
+			if (y == yBeg || y == yEnd - 1)
+				dy = std::min((float)(y + 1), y1) - std::max((float)y, y0);
+
+			float xa = std::min(x, x + dxdy * dy);
+			float xb = std::max(x, x + dxdy * dy);
+			float d = dy * dir;
+			x += dxdy * dy;
+
+			float * pRow = pAcc + y * pitch;
+			uint8_t * pBlockRow = pBlocks + y * blockPitch;
+
+			if (bClipX)
+			{
+				if (xa >= xMax)
+					continue;
+
+				if (xa < 0.f)
+				{
+					float dLeft = xb <= 0.f ? d : d * (-xa) / (xb - xa);
+
+					pRow[0] += dLeft;
+					pBlockRow[0] = 1;
+
+					if (xb <= 0.f)
+						continue;
+
+					d -= dLeft;
+					xa = 0.f;
+				}
+
+				if (xb > xMax)
+				{
+					d *= (xMax - xa) / (xb - xa);
+					xb = xMax;
+				}
+			}
+
+			// xa and xb are never negative here, so we can truncate instead of calling floor() and ceil().
+
+			int xai = (int)xa;
+			float xaFloor = (float)xai;
+			int xbi = (int)xb;
+			if ((float)xbi < xb)
+				xbi++;
+			float xbCeil = (float)xbi;
+
+			pBlockRow[xai >> 4] = 1;
+
+			if (xbi <= xai + 1)
+			{
+				pBlockRow[(xai + 1) >> 4] = 1;
+				float xmf = 0.5f * (xa + xb) - xaFloor;
+				pRow[xai] += d - d * xmf;
+				pRow[xai + 1] += d * xmf;
+			}
+			else
+			{
+				for (int block = (xai >> 4) + 1; block <= xbi >> 4; block++)
+					pBlockRow[block] = 1;
+
+				float s = 1.f / (xb - xa);
+				float xaf = xa - xaFloor;
+				float a0 = 0.5f * s * (1.f - xaf) * (1.f - xaf);
+				float xbf = xb - xbCeil + 1.f;
+				float am = 0.5f * s * xbf * xbf;
+
+				pRow[xai] += d * a0;
+
+				if (xbi == xai + 2)
+					pRow[xai + 1] += d * (1.f - a0 - am);
+				else
+				{
+					float a1 = s * (1.5f - xaf);
+					pRow[xai + 1] += d * (a1 - a0);
+					for (int xi = xai + 2; xi < xbi - 1; xi++)
+						pRow[xi] += d * s;
+					float a2 = a1 + (xbi - xai - 3) * s;
+					pRow[xbi - 1] += d * (1.f - a2 - am);
+				}
+				pRow[xbi] += d * am;
+			}
+		}
+	}
+
 	//____ clipDrawHorrWave() _____________________________________________________
 
-	void SoftGfxDevice::clipDrawHorrWave(const Rect&clip, Coord begin, int length, const WaveLine * pTopBorder, const WaveLine * pBottomBorder, Color frontFill, Color backFill)
+	void SoftGfxDevice::clipDrawHorrWave(const Rect&_clip, Coord begin, int length, const WaveLine * pTopBorder, const WaveLine * pBottomBorder, Color frontFill, Color backFill)
 	{
 		if (!m_pCanvas || !m_pCanvasPixels)
 			return;
 
+		// Limit clip to canvas. The column renderer works in 16.16 fixed point, which overflows
+		// on the huge dummy clip used by drawHorrWave().
+
+		Rect clip(_clip, Rect(0, 0, m_canvasSize));
+		if (clip.w <= 0 || clip.h <= 0)
+			return;
+
 		// Do early rough X-clipping with margin (need to trace lines with margin of thickest line).
 
 		int ofs = 0;
@@ -2230,6 +2958,99 @@ namespace wg
 		Base::memStackRelease(bufferSize);
 	}
 
+	//____ clipDrawSegments() _________________________________________________
+
+	void SoftGfxDevice::clipDrawSegments(const Rect& clip, const Rect& dest, int nEdgeStrips, const int * pEdgeStrips, const Color * pSegmentColors)
+	{
+		if (!m_pCanvas || !m_pCanvasPixels || nEdgeStrips < 0)
+			return;
+
+		Rect area(Rect(clip, Rect(0, 0, m_canvasSize)), dest);
+		if (area.w <= 0 || area.h <= 0)
+			return;
+
+		SegmentOp_p pOp = s_segmentOpTab[(int)m_blendMode][(int)m_pCanvas->pixelFormat()];
+		if (pOp == nullptr)
+			return;
+
+		int nSegments = nEdgeStrips + 1;
+
+		// Apply tint to our segment colors, skip everything if all are invisible.
+
+		int bufferSize = nSegments * sizeof(Color) + nEdgeStrips * sizeof(SegmentEdge);
+		uint8_t * pBuffer = (uint8_t*) Base::memStackAlloc(bufferSize);
+
+		Color * pColors = (Color*) pBuffer;
+		SegmentEdge * pEdges = (SegmentEdge*) (pBuffer + nSegments * sizeof(Color));
+
+		bool bVisible = !(m_blendMode == BlendMode::Blend || m_blendMode == BlendMode::Add || m_blendMode == BlendMode::Subtract);
+		for (int i = 0; i < nSegments; i++)
+		{
+			pColors[i] = pSegmentColors[i] * m_tintColor;
+			if (pColors[i].a != 0)
+				bVisible = true;
+		}
+
+		if (!bVisible)
+		{
+			Base::memStackRelease(bufferSize);
+			return;
+		}
+
+		// Render column by column
+
+		int clipBeg = area.y - dest.y;
+		int clipEnd = clipBeg + area.h;
+		int maxPos = dest.h * 256;
+
+		ColTrans colTrans{ Color::White, nullptr, nullptr, m_bDither, Coord(area.x, dest.y) };
+
+		int pixelBytes = m_canvasPixelBits / 8;
+		uint8_t * pColumn = m_pCanvasPixels + area.y * m_canvasPitch + area.x * pixelBytes;
+
+		for (int x = area.x; x < area.x + area.w; x++)
+		{
+			const int * pLeft = pEdgeStrips + (x - dest.x) * nEdgeStrips;
+			const int * pRight = pLeft + nEdgeStrips;
+
+			int prevLeft = 0;
+			int prevRight = 0;
+
+			for (int i = 0; i < nEdgeStrips; i++)
+			{
+				// Clamp edge to dest and to the edge above it.
+
+				int left = pLeft[i];
+				int right = pRight[i];
+				limit(left, prevLeft, maxPos);
+				limit(right, prevRight, maxPos);
+				prevLeft = left;
+				prevRight = right;
+
+				// Coverage of segment below edge grows linearly from the row where edge begins
+				// to the row where it ends, reaching 50% where the edge crosses the middle of
+				// the column.
+
+				int edgeBeg = min(left, right);
+				int edgeEnd = max(left, right);
+
+				int coverageInc = (65536 * 256) / (edgeEnd - edgeBeg + 256);
+
+				pEdges[i].begin = edgeBeg;
+				pEdges[i].end = edgeEnd;
+				pEdges[i].coverage = coverageInc - (int)((int64_t(coverageInc) * edgeBeg) >> 8);
+				pEdges[i].coverageInc = coverageInc;
+			}
+
+			pOp(clipBeg, clipEnd, pColumn, m_canvasPitch, nEdgeStrips, pEdges, pColors, colTrans);
+
+			pColumn += pixelBytes;
+			colTrans.ditherOrigin.x++;
+		}
+
+		Base::memStackRelease(bufferSize);
+	}
+
 
 	//_____ _clip_wave_blend_24() ________________________________________________
 
@@ -3176,7 +3997,7 @@ namespace wg
 		const int pitch =m_canvasPitch;
 		const int pixelBytes = m_canvasPixelBits/8;
 
-		ColTrans	colTrans{ Color::White, nullptr, nullptr };
+		ColTrans	colTrans{ Color::White, nullptr, nullptr, m_bDither, Coord() };
 
 		PlotListOp_p pOp = s_plotListOpTab[(int)m_blendMode][(int)m_pCanvas->pixelFormat()];
 
@@ -3205,7 +4026,7 @@ namespace wg
 		if (!m_pCanvasPixels || !pSrcSurf->m_pData)
 			return;
 
-		ColTrans			colTrans{ m_tintColor, nullptr, nullptr };
+		ColTrans			colTrans{ m_tintColor, nullptr, nullptr, m_bDither, dest };
 
 		int				tintMode = m_tintColor == Color::White ? 0 : 1;
 		PixelFormat		srcFormat = pSrcSurf->m_pixelDescription.format;
@@ -3215,12 +4036,28 @@ namespace wg
 
 		BlitOp_p	pOnePassOp = nullptr;
 
-		if (m_blendMode == BlendMode::Blend)
+		if (pSrcSurf->m_bPremultiplied)
+		{
+			if (m_blendMode == BlendMode::Blend)
+			{
+				if (dstFormat == PixelFormat::BGRA_8)
+					pOnePassOp = s_blendPremultTo_BGRA_8_OpTab[tintMode];
+				else if (dstFormat == PixelFormat::BGR_8 || dstFormat == PixelFormat::BGRX_8)
+					pOnePassOp = s_blendPremultTo_BGR_8_OpTab[tintMode];
+			}
+			else if (m_blendMode == BlendMode::Replace && dstFormat == PixelFormat::BGRA_8)
+				pOnePassOp = s_movePremultTo_BGRA_8_OpTab[tintMode];
+		}
+		else if (m_blendMode == BlendMode::Blend)
 		{
 			if(dstFormat == PixelFormat::BGRA_8)
 				pOnePassOp = s_blendTo_BGRA_8_OpTab[(int)srcFormat][tintMode];
 			else if (dstFormat == PixelFormat::BGR_8 || dstFormat == PixelFormat::BGRX_8)
 				pOnePassOp = s_blendTo_BGR_8_OpTab[(int)srcFormat][tintMode];
+			else if (dstFormat == PixelFormat::BGR_565)
+				pOnePassOp = s_blendTo_BGR_565_OpTab[(int)srcFormat][tintMode];
+			else if (dstFormat == PixelFormat::BGRA_4)
+				pOnePassOp = s_blendTo_BGRA_4_OpTab[(int)srcFormat][tintMode];
 		}
 		else if (m_blendMode == BlendMode::Replace)
 		{
@@ -3228,6 +4065,10 @@ namespace wg
 				pOnePassOp = s_moveTo_BGRA_8_OpTab[(int)srcFormat][tintMode];
 			else if (dstFormat == PixelFormat::BGR_8 || dstFormat == PixelFormat::BGRX_8)
 				pOnePassOp = s_moveTo_BGR_8_OpTab[(int)srcFormat][tintMode];
+			else if (dstFormat == PixelFormat::BGR_565)
+				pOnePassOp = s_moveTo_BGR_565_OpTab[(int)srcFormat][tintMode];
+			else if (dstFormat == PixelFormat::BGRA_4)
+				pOnePassOp = s_moveTo_BGRA_4_OpTab[(int)srcFormat][tintMode];
 		}
 
 		if(pOnePassOp)
@@ -3238,7 +4079,7 @@ namespace wg
 
 		// Fall back to two-pass rendering.
 
-		BlitOp_p pReader = s_moveTo_BGRA_8_OpTab[(int)srcFormat][tintMode];
+		BlitOp_p pReader = pSrcSurf->m_bPremultiplied ? s_movePremultTo_BGRA_8_OpTab[tintMode] : s_moveTo_BGRA_8_OpTab[(int)srcFormat][tintMode];
 		BlitOp_p pWriter = s_pass2OpTab[(int)m_blendMode][(int)dstFormat];
 
 		if (pReader == nullptr || pWriter == nullptr)
@@ -3302,6 +4143,8 @@ namespace wg
 
 		uint8_t * pChunkBuffer = (uint8_t*) Base::memStackAlloc(memBufferSize);
 
+		ColTrans writerTint = tint;
+
 		int line = 0;
 
 		while (line < srcrect.h)
@@ -3311,8 +4154,10 @@ namespace wg
 			uint8_t * pDst = m_pCanvasPixels + (dest.y+line) * m_canvasPitch + dest.x * dstPixelBytes;
 			uint8_t * pSrc = pSource->m_pData + (srcrect.y+line) * pSource->m_pitch + srcrect.x * srcPixelBytes;
 
+			writerTint.ditherOrigin = { dest.x, dest.y + line };
+
 			pReader(pSrc, pChunkBuffer, pSource->m_pClut, pitchesPass1, thisChunkLines, srcrect.w, tint);
-			pWriter(pChunkBuffer, pDst, nullptr, pitchesPass2, thisChunkLines, srcrect.w, tint);
+			pWriter(pChunkBuffer, pDst, nullptr, pitchesPass2, thisChunkLines, srcrect.w, writerTint);
 
 			line += thisChunkLines;
 		}
@@ -3360,6 +4205,8 @@ namespace wg
 
 		uint8_t * pChunkBuffer = (uint8_t*)Base::memStackAlloc(memBufferSize);
 
+		ColTrans writerTint = tint;
+
 		int line = 0;
 
 		while (line < dest.h)
@@ -3368,8 +4215,10 @@ namespace wg
 
 			uint8_t * pDst = m_pCanvasPixels + (dest.y + line) * m_canvasPitch + dest.x * dstPixelBytes;
 
+			writerTint.ditherOrigin = { dest.x, dest.y + line };
+
 			pReader(pSource, pos, transformMatrix, pChunkBuffer, 4, 0, thisChunkLines, dest.w, tint);
-			pWriter(pChunkBuffer, pDst, nullptr, pitchesPass2, thisChunkLines, dest.w, tint);
+			pWriter(pChunkBuffer, pDst, nullptr, pitchesPass2, thisChunkLines, dest.w, writerTint);
 
 			pos.x += transformMatrix[1][0] * thisChunkLines;
 			pos.y += transformMatrix[1][1] * thisChunkLines;
@@ -3392,25 +4241,69 @@ namespace wg
 		if (!m_pCanvasPixels || !pSrcSurf->m_pData)
 			return;
 
-		ColTrans			colTrans{ m_tintColor, nullptr, nullptr };
+		ColTrans			colTrans{ m_tintColor, nullptr, nullptr, m_bDither, dest.pos() };
 
 		int				tintMode = m_tintColor == Color::White ? 0 : 1;
 		ScaleMode		scaleMode = pSrcSurf->scaleMode();
+
+		// Blit from a mipmap when shrinking mipmapped surfaces to half size or less.
+
+		RectF	src = source;
+
+		if (pSrcSurf->m_bMipmapped)
+		{
+			float ratio = min(source.w / dest.w, source.h / dest.h);
+
+			int level = 0;
+			while (ratio >= 2.f)
+			{
+				ratio /= 2.f;
+				level++;
+			}
+
+			if (level > 0)
+			{
+				SoftSurface * pMip = pSrcSurf->_mipmap(level);
+
+				float scaleX = pMip->m_size.w / (float) pSrcSurf->m_size.w;
+				float scaleY = pMip->m_size.h / (float) pSrcSurf->m_size.h;
+
+				src = RectF(source.x * scaleX, source.y * scaleY, source.w * scaleX, source.h * scaleY);
+				pSrcSurf = pMip;
+			}
+		}
+
 		PixelFormat		srcFormat = pSrcSurf->m_pixelDescription.format;
 		PixelFormat		dstFormat = m_pCanvas->pixelFormat();
 
-		float transform[2][2] = { { source.w / dest.w, 0.f },{ 0.f, source.h / dest.h } };
+		float transform[2][2] = { { src.w / dest.w, 0.f },{ 0.f, src.h / dest.h } };
 
 		// Try to find a suitable one-pass operation
 
 		TransformOp_p	pOnePassOp = nullptr;
 
-		if (m_blendMode == BlendMode::Blend)
+		if (pSrcSurf->m_bPremultiplied)
+		{
+			if (m_blendMode == BlendMode::Blend)
+			{
+				if (dstFormat == PixelFormat::BGRA_8)
+					pOnePassOp = s_stretchBlendPremultTo_BGRA_8_OpTab[(int)scaleMode][tintMode];
+				else if (dstFormat == PixelFormat::BGR_8 || dstFormat == PixelFormat::BGRX_8)
+					pOnePassOp = s_stretchBlendPremultTo_BGR_8_OpTab[(int)scaleMode][tintMode];
+			}
+			else if (m_blendMode == BlendMode::Replace && dstFormat == PixelFormat::BGRA_8)
+				pOnePassOp = s_stretchPremultTo_BGRA_8_OpTab[(int)scaleMode][tintMode];
+		}
+		else if (m_blendMode == BlendMode::Blend)
 		{
 			if (dstFormat == PixelFormat::BGRA_8)
 				pOnePassOp = s_stretchBlendTo_BGRA_8_OpTab[(int)srcFormat][(int)scaleMode][tintMode];
 			else if (dstFormat == PixelFormat::BGR_8 || dstFormat == PixelFormat::BGRX_8)
 				pOnePassOp = s_stretchBlendTo_BGR_8_OpTab[(int)srcFormat][(int)scaleMode][tintMode];
+			else if (dstFormat == PixelFormat::BGR_565)
+				pOnePassOp = s_stretchBlendTo_BGR_565_OpTab[(int)srcFormat][(int)scaleMode][tintMode];
+			else if (dstFormat == PixelFormat::BGRA_4)
+				pOnePassOp = s_stretchBlendTo_BGRA_4_OpTab[(int)srcFormat][(int)scaleMode][tintMode];
 		}
 		else if (m_blendMode == BlendMode::Replace)
 		{
@@ -3418,23 +4311,27 @@ namespace wg
 				pOnePassOp = s_stretchTo_BGRA_8_OpTab[(int)srcFormat][(int)scaleMode][tintMode];
 			else if (dstFormat == PixelFormat::BGR_8 || dstFormat == PixelFormat::BGRX_8)
 				pOnePassOp = s_stretchTo_BGR_8_OpTab[(int)srcFormat][(int)scaleMode][tintMode];
+			else if (dstFormat == PixelFormat::BGR_565)
+				pOnePassOp = s_stretchTo_BGR_565_OpTab[(int)srcFormat][(int)scaleMode][tintMode];
+			else if (dstFormat == PixelFormat::BGRA_4)
+				pOnePassOp = s_stretchTo_BGRA_4_OpTab[(int)srcFormat][(int)scaleMode][tintMode];
 		}
 
 		if (pOnePassOp)
 		{
-			_onePassTransformBlit(pOnePassOp, static_cast<SoftSurface*>(_pSrcSurf), source, transform, dest, colTrans);
+			_onePassTransformBlit(pOnePassOp, pSrcSurf, src, transform, dest, colTrans);
 			return;
 		}
 
 		// Fall back to two-pass rendering.
 
-		TransformOp_p pReader = s_stretchTo_BGRA_8_OpTab[(int)srcFormat][(int)scaleMode][tintMode];
+		TransformOp_p pReader = pSrcSurf->m_bPremultiplied ? s_stretchPremultTo_BGRA_8_OpTab[(int)scaleMode][tintMode] : s_stretchTo_BGRA_8_OpTab[(int)srcFormat][(int)scaleMode][tintMode];
 		BlitOp_p pWriter = s_pass2OpTab[(int)m_blendMode][(int)m_pCanvas->pixelFormat()];
 
 		if (pReader == nullptr || pWriter == nullptr)
 			return;
 
-		_twoPassTransformBlit(pReader, pWriter, static_cast<SoftSurface*>(_pSrcSurf), source, transform, dest, colTrans);
+		_twoPassTransformBlit(pReader, pWriter, pSrcSurf, src, transform, dest, colTrans);
 	}
 
 	//____ _initTables() ___________________________________________________________
@@ -3446,6 +4343,12 @@ namespace wg
 		for (int i = 0; i < 256; i++)
 			s_mulTab[i] = i * 256 + i + 1;
 
+		// Init unpremulTab, for converting premultiplied colors back to straight alpha.
+
+		s_unpremulTab[0] = 0;
+		for (int i = 1; i < 256; i++)
+			s_unpremulTab[i] = (255 * 65536 + i - 1) / i;
+
 		// Init lineThicknessTable
 		
 		for( int i = 0 ; i < 17 ; i++ )
@@ -3472,6 +4375,7 @@ namespace wg
 				s_clipLineOpTab[i][j] = nullptr;
 				s_plotListOpTab[i][j] = nullptr;
 				s_waveOpTab[i][j] = nullptr;
+				s_segmentOpTab[i][j] = nullptr;
 			}
 		}
 
@@ -3494,6 +4398,22 @@ namespace wg
 				s_stretchBlendTo_BGRA_8_OpTab[i][1][j] = nullptr;
 				s_stretchBlendTo_BGR_8_OpTab[i][0][j] = nullptr;
 				s_stretchBlendTo_BGR_8_OpTab[i][1][j] = nullptr;
+
+				s_moveTo_BGR_565_OpTab[i][j] = nullptr;
+				s_moveTo_BGRA_4_OpTab[i][j] = nullptr;
+
+				s_blendTo_BGR_565_OpTab[i][j] = nullptr;
+				s_blendTo_BGRA_4_OpTab[i][j] = nullptr;
+
+				s_stretchTo_BGR_565_OpTab[i][0][j] = nullptr;
+				s_stretchTo_BGR_565_OpTab[i][1][j] = nullptr;
+				s_stretchTo_BGRA_4_OpTab[i][0][j] = nullptr;
+				s_stretchTo_BGRA_4_OpTab[i][1][j] = nullptr;
+
+				s_stretchBlendTo_BGR_565_OpTab[i][0][j] = nullptr;
+				s_stretchBlendTo_BGR_565_OpTab[i][1][j] = nullptr;
+				s_stretchBlendTo_BGRA_4_OpTab[i][0][j] = nullptr;
+				s_stretchBlendTo_BGRA_4_OpTab[i][1][j] = nullptr;
 			}
 		}
 
@@ -4122,12 +5042,302 @@ namespace wg
 		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::A8][1][0] = _stretch_blit < PixelFormat::A8, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGR_8>;
 		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::A8][1][1] = _stretch_blit < PixelFormat::A8, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGR_8>;
 
+		// Init operation tables for 16-bit destinations
+
+		s_moveTo_BGR_565_OpTab[(int)PixelFormat::BGRA_8][0] = _blit < PixelFormat::BGRA_8, 0, BlendMode::Replace, PixelFormat::BGR_565>;
+		s_moveTo_BGR_565_OpTab[(int)PixelFormat::BGRA_8][1] = _blit < PixelFormat::BGRA_8, 1, BlendMode::Replace, PixelFormat::BGR_565>;
+
+		s_moveTo_BGR_565_OpTab[(int)PixelFormat::BGRX_8][0] = _blit < PixelFormat::BGR_8, 0, BlendMode::Replace, PixelFormat::BGR_565>;
+		s_moveTo_BGR_565_OpTab[(int)PixelFormat::BGRX_8][1] = _blit < PixelFormat::BGR_8, 1, BlendMode::Replace, PixelFormat::BGR_565>;
+
+		s_moveTo_BGR_565_OpTab[(int)PixelFormat::BGR_8][0] = _blit < PixelFormat::BGR_8, 0, BlendMode::Replace, PixelFormat::BGR_565>;
+		s_moveTo_BGR_565_OpTab[(int)PixelFormat::BGR_8][1] = _blit < PixelFormat::BGR_8, 1, BlendMode::Replace, PixelFormat::BGR_565>;
+
+		s_moveTo_BGR_565_OpTab[(int)PixelFormat::BGR_565][0] = _blit < PixelFormat::BGR_565, 0, BlendMode::Replace, PixelFormat::BGR_565>;
+		s_moveTo_BGR_565_OpTab[(int)PixelFormat::BGR_565][1] = _blit < PixelFormat::BGR_565, 1, BlendMode::Replace, PixelFormat::BGR_565>;
+
+		s_moveTo_BGR_565_OpTab[(int)PixelFormat::BGRA_4][0] = _blit < PixelFormat::BGRA_4, 0, BlendMode::Replace, PixelFormat::BGR_565>;
+		s_moveTo_BGR_565_OpTab[(int)PixelFormat::BGRA_4][1] = _blit < PixelFormat::BGRA_4, 1, BlendMode::Replace, PixelFormat::BGR_565>;
+
+		s_moveTo_BGR_565_OpTab[(int)PixelFormat::I8][0] = _blit < PixelFormat::I8, 0, BlendMode::Replace, PixelFormat::BGR_565>;
+		s_moveTo_BGR_565_OpTab[(int)PixelFormat::I8][1] = _blit < PixelFormat::I8, 1, BlendMode::Replace, PixelFormat::BGR_565>;
+
+		s_moveTo_BGR_565_OpTab[(int)PixelFormat::A8][0] = _blit < PixelFormat::A8, 0, BlendMode::Replace, PixelFormat::BGR_565>;
+		s_moveTo_BGR_565_OpTab[(int)PixelFormat::A8][1] = _blit < PixelFormat::A8, 1, BlendMode::Replace, PixelFormat::BGR_565>;
+
+		s_blendTo_BGR_565_OpTab[(int)PixelFormat::BGRA_8][0] = _blit < PixelFormat::BGRA_8, 0, BlendMode::Blend, PixelFormat::BGR_565>;
+		s_blendTo_BGR_565_OpTab[(int)PixelFormat::BGRA_8][1] = _blit < PixelFormat::BGRA_8, 1, BlendMode::Blend, PixelFormat::BGR_565>;
+
+		s_blendTo_BGR_565_OpTab[(int)PixelFormat::BGRX_8][0] = _blit < PixelFormat::BGR_8, 0, BlendMode::Blend, PixelFormat::BGR_565>;
+		s_blendTo_BGR_565_OpTab[(int)PixelFormat::BGRX_8][1] = _blit < PixelFormat::BGR_8, 1, BlendMode::Blend, PixelFormat::BGR_565>;
+
+		s_blendTo_BGR_565_OpTab[(int)PixelFormat::BGR_8][0] = _blit < PixelFormat::BGR_8, 0, BlendMode::Blend, PixelFormat::BGR_565>;
+		s_blendTo_BGR_565_OpTab[(int)PixelFormat::BGR_8][1] = _blit < PixelFormat::BGR_8, 1, BlendMode::Blend, PixelFormat::BGR_565>;
+
+		s_blendTo_BGR_565_OpTab[(int)PixelFormat::BGR_565][0] = _blit < PixelFormat::BGR_565, 0, BlendMode::Blend, PixelFormat::BGR_565>;
+		s_blendTo_BGR_565_OpTab[(int)PixelFormat::BGR_565][1] = _blit < PixelFormat::BGR_565, 1, BlendMode::Blend, PixelFormat::BGR_565>;
+
+		s_blendTo_BGR_565_OpTab[(int)PixelFormat::BGRA_4][0] = _blit < PixelFormat::BGRA_4, 0, BlendMode::Blend, PixelFormat::BGR_565>;
+		s_blendTo_BGR_565_OpTab[(int)PixelFormat::BGRA_4][1] = _blit < PixelFormat::BGRA_4, 1, BlendMode::Blend, PixelFormat::BGR_565>;
+
+		s_blendTo_BGR_565_OpTab[(int)PixelFormat::I8][0] = _blit < PixelFormat::I8, 0, BlendMode::Blend, PixelFormat::BGR_565>;
+		s_blendTo_BGR_565_OpTab[(int)PixelFormat::I8][1] = _blit < PixelFormat::I8, 1, BlendMode::Blend, PixelFormat::BGR_565>;
+
+		s_blendTo_BGR_565_OpTab[(int)PixelFormat::A8][0] = _blit < PixelFormat::A8, 0, BlendMode::Blend, PixelFormat::BGR_565>;
+		s_blendTo_BGR_565_OpTab[(int)PixelFormat::A8][1] = _blit < PixelFormat::A8, 1, BlendMode::Blend, PixelFormat::BGR_565>;
+
+		s_stretchTo_BGR_565_OpTab[(int)PixelFormat::BGRA_8][0][0] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Nearest, 0, BlendMode::Replace, PixelFormat::BGR_565>;
+		s_stretchTo_BGR_565_OpTab[(int)PixelFormat::BGRA_8][0][1] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Nearest, 1, BlendMode::Replace, PixelFormat::BGR_565>;
+		s_stretchTo_BGR_565_OpTab[(int)PixelFormat::BGRA_8][1][0] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGR_565>;
+		s_stretchTo_BGR_565_OpTab[(int)PixelFormat::BGRA_8][1][1] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGR_565>;
+
+		s_stretchTo_BGR_565_OpTab[(int)PixelFormat::BGRX_8][0][0] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Nearest, 0, BlendMode::Replace, PixelFormat::BGR_565>;
+		s_stretchTo_BGR_565_OpTab[(int)PixelFormat::BGRX_8][0][1] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Nearest, 1, BlendMode::Replace, PixelFormat::BGR_565>;
+		s_stretchTo_BGR_565_OpTab[(int)PixelFormat::BGRX_8][1][0] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGR_565>;
+		s_stretchTo_BGR_565_OpTab[(int)PixelFormat::BGRX_8][1][1] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGR_565>;
+
+		s_stretchTo_BGR_565_OpTab[(int)PixelFormat::BGR_8][0][0] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Nearest, 0, BlendMode::Replace, PixelFormat::BGR_565>;
+		s_stretchTo_BGR_565_OpTab[(int)PixelFormat::BGR_8][0][1] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Nearest, 1, BlendMode::Replace, PixelFormat::BGR_565>;
+		s_stretchTo_BGR_565_OpTab[(int)PixelFormat::BGR_8][1][0] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGR_565>;
+		s_stretchTo_BGR_565_OpTab[(int)PixelFormat::BGR_8][1][1] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGR_565>;
+
+		s_stretchTo_BGR_565_OpTab[(int)PixelFormat::BGR_565][0][0] = _stretch_blit < PixelFormat::BGR_565, ScaleMode::Nearest, 0, BlendMode::Replace, PixelFormat::BGR_565>;
+		s_stretchTo_BGR_565_OpTab[(int)PixelFormat::BGR_565][0][1] = _stretch_blit < PixelFormat::BGR_565, ScaleMode::Nearest, 1, BlendMode::Replace, PixelFormat::BGR_565>;
+		s_stretchTo_BGR_565_OpTab[(int)PixelFormat::BGR_565][1][0] = _stretch_blit < PixelFormat::BGR_565, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGR_565>;
+		s_stretchTo_BGR_565_OpTab[(int)PixelFormat::BGR_565][1][1] = _stretch_blit < PixelFormat::BGR_565, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGR_565>;
+
+		s_stretchTo_BGR_565_OpTab[(int)PixelFormat::BGRA_4][0][0] = _stretch_blit < PixelFormat::BGRA_4, ScaleMode::Nearest, 0, BlendMode::Replace, PixelFormat::BGR_565>;
+		s_stretchTo_BGR_565_OpTab[(int)PixelFormat::BGRA_4][0][1] = _stretch_blit < PixelFormat::BGRA_4, ScaleMode::Nearest, 1, BlendMode::Replace, PixelFormat::BGR_565>;
+		s_stretchTo_BGR_565_OpTab[(int)PixelFormat::BGRA_4][1][0] = _stretch_blit < PixelFormat::BGRA_4, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGR_565>;
+		s_stretchTo_BGR_565_OpTab[(int)PixelFormat::BGRA_4][1][1] = _stretch_blit < PixelFormat::BGRA_4, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGR_565>;
+
+		s_stretchTo_BGR_565_OpTab[(int)PixelFormat::I8][0][0] = _stretch_blit < PixelFormat::I8, ScaleMode::Nearest, 0, BlendMode::Replace, PixelFormat::BGR_565>;
+		s_stretchTo_BGR_565_OpTab[(int)PixelFormat::I8][0][1] = _stretch_blit < PixelFormat::I8, ScaleMode::Nearest, 1, BlendMode::Replace, PixelFormat::BGR_565>;
+		s_stretchTo_BGR_565_OpTab[(int)PixelFormat::I8][1][0] = _stretch_blit < PixelFormat::I8, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGR_565>;
+		s_stretchTo_BGR_565_OpTab[(int)PixelFormat::I8][1][1] = _stretch_blit < PixelFormat::I8, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGR_565>;
+
+		s_stretchTo_BGR_565_OpTab[(int)PixelFormat::A8][0][0] = _stretch_blit < PixelFormat::A8, ScaleMode::Nearest, 0, BlendMode::Replace, PixelFormat::BGR_565>;
+		s_stretchTo_BGR_565_OpTab[(int)PixelFormat::A8][0][1] = _stretch_blit < PixelFormat::A8, ScaleMode::Nearest, 1, BlendMode::Replace, PixelFormat::BGR_565>;
+		s_stretchTo_BGR_565_OpTab[(int)PixelFormat::A8][1][0] = _stretch_blit < PixelFormat::A8, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGR_565>;
+		s_stretchTo_BGR_565_OpTab[(int)PixelFormat::A8][1][1] = _stretch_blit < PixelFormat::A8, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGR_565>;
+
+		s_stretchBlendTo_BGR_565_OpTab[(int)PixelFormat::BGRA_8][0][0] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Nearest, 0, BlendMode::Blend, PixelFormat::BGR_565>;
+		s_stretchBlendTo_BGR_565_OpTab[(int)PixelFormat::BGRA_8][0][1] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Nearest, 1, BlendMode::Blend, PixelFormat::BGR_565>;
+		s_stretchBlendTo_BGR_565_OpTab[(int)PixelFormat::BGRA_8][1][0] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGR_565>;
+		s_stretchBlendTo_BGR_565_OpTab[(int)PixelFormat::BGRA_8][1][1] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGR_565>;
+
+		s_stretchBlendTo_BGR_565_OpTab[(int)PixelFormat::BGRX_8][0][0] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Nearest, 0, BlendMode::Blend, PixelFormat::BGR_565>;
+		s_stretchBlendTo_BGR_565_OpTab[(int)PixelFormat::BGRX_8][0][1] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Nearest, 1, BlendMode::Blend, PixelFormat::BGR_565>;
+		s_stretchBlendTo_BGR_565_OpTab[(int)PixelFormat::BGRX_8][1][0] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGR_565>;
+		s_stretchBlendTo_BGR_565_OpTab[(int)PixelFormat::BGRX_8][1][1] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGR_565>;
+
+		s_stretchBlendTo_BGR_565_OpTab[(int)PixelFormat::BGR_8][0][0] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Nearest, 0, BlendMode::Blend, PixelFormat::BGR_565>;
+		s_stretchBlendTo_BGR_565_OpTab[(int)PixelFormat::BGR_8][0][1] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Nearest, 1, BlendMode::Blend, PixelFormat::BGR_565>;
+		s_stretchBlendTo_BGR_565_OpTab[(int)PixelFormat::BGR_8][1][0] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGR_565>;
+		s_stretchBlendTo_BGR_565_OpTab[(int)PixelFormat::BGR_8][1][1] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGR_565>;
+
+		s_stretchBlendTo_BGR_565_OpTab[(int)PixelFormat::BGR_565][0][0] = _stretch_blit < PixelFormat::BGR_565, ScaleMode::Nearest, 0, BlendMode::Blend, PixelFormat::BGR_565>;
+		s_stretchBlendTo_BGR_565_OpTab[(int)PixelFormat::BGR_565][0][1] = _stretch_blit < PixelFormat::BGR_565, ScaleMode::Nearest, 1, BlendMode::Blend, PixelFormat::BGR_565>;
+		s_stretchBlendTo_BGR_565_OpTab[(int)PixelFormat::BGR_565][1][0] = _stretch_blit < PixelFormat::BGR_565, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGR_565>;
+		s_stretchBlendTo_BGR_565_OpTab[(int)PixelFormat::BGR_565][1][1] = _stretch_blit < PixelFormat::BGR_565, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGR_565>;
+
+		s_stretchBlendTo_BGR_565_OpTab[(int)PixelFormat::BGRA_4][0][0] = _stretch_blit < PixelFormat::BGRA_4, ScaleMode::Nearest, 0, BlendMode::Blend, PixelFormat::BGR_565>;
+		s_stretchBlendTo_BGR_565_OpTab[(int)PixelFormat::BGRA_4][0][1] = _stretch_blit < PixelFormat::BGRA_4, ScaleMode::Nearest, 1, BlendMode::Blend, PixelFormat::BGR_565>;
+		s_stretchBlendTo_BGR_565_OpTab[(int)PixelFormat::BGRA_4][1][0] = _stretch_blit < PixelFormat::BGRA_4, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGR_565>;
+		s_stretchBlendTo_BGR_565_OpTab[(int)PixelFormat::BGRA_4][1][1] = _stretch_blit < PixelFormat::BGRA_4, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGR_565>;
+
+		s_stretchBlendTo_BGR_565_OpTab[(int)PixelFormat::I8][0][0] = _stretch_blit < PixelFormat::I8, ScaleMode::Nearest, 0, BlendMode::Blend, PixelFormat::BGR_565>;
+		s_stretchBlendTo_BGR_565_OpTab[(int)PixelFormat::I8][0][1] = _stretch_blit < PixelFormat::I8, ScaleMode::Nearest, 1, BlendMode::Blend, PixelFormat::BGR_565>;
+		s_stretchBlendTo_BGR_565_OpTab[(int)PixelFormat::I8][1][0] = _stretch_blit < PixelFormat::I8, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGR_565>;
+		s_stretchBlendTo_BGR_565_OpTab[(int)PixelFormat::I8][1][1] = _stretch_blit < PixelFormat::I8, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGR_565>;
+
+		s_stretchBlendTo_BGR_565_OpTab[(int)PixelFormat::A8][0][0] = _stretch_blit < PixelFormat::A8, ScaleMode::Nearest, 0, BlendMode::Blend, PixelFormat::BGR_565>;
+		s_stretchBlendTo_BGR_565_OpTab[(int)PixelFormat::A8][0][1] = _stretch_blit < PixelFormat::A8, ScaleMode::Nearest, 1, BlendMode::Blend, PixelFormat::BGR_565>;
+		s_stretchBlendTo_BGR_565_OpTab[(int)PixelFormat::A8][1][0] = _stretch_blit < PixelFormat::A8, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGR_565>;
+		s_stretchBlendTo_BGR_565_OpTab[(int)PixelFormat::A8][1][1] = _stretch_blit < PixelFormat::A8, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGR_565>;
+
+		s_moveTo_BGRA_4_OpTab[(int)PixelFormat::BGRA_8][0] = _blit < PixelFormat::BGRA_8, 0, BlendMode::Replace, PixelFormat::BGRA_4>;
+		s_moveTo_BGRA_4_OpTab[(int)PixelFormat::BGRA_8][1] = _blit < PixelFormat::BGRA_8, 1, BlendMode::Replace, PixelFormat::BGRA_4>;
+
+		s_moveTo_BGRA_4_OpTab[(int)PixelFormat::BGRX_8][0] = _blit < PixelFormat::BGR_8, 0, BlendMode::Replace, PixelFormat::BGRA_4>;
+		s_moveTo_BGRA_4_OpTab[(int)PixelFormat::BGRX_8][1] = _blit < PixelFormat::BGR_8, 1, BlendMode::Replace, PixelFormat::BGRA_4>;
+
+		s_moveTo_BGRA_4_OpTab[(int)PixelFormat::BGR_8][0] = _blit < PixelFormat::BGR_8, 0, BlendMode::Replace, PixelFormat::BGRA_4>;
+		s_moveTo_BGRA_4_OpTab[(int)PixelFormat::BGR_8][1] = _blit < PixelFormat::BGR_8, 1, BlendMode::Replace, PixelFormat::BGRA_4>;
+
+		s_moveTo_BGRA_4_OpTab[(int)PixelFormat::BGR_565][0] = _blit < PixelFormat::BGR_565, 0, BlendMode::Replace, PixelFormat::BGRA_4>;
+		s_moveTo_BGRA_4_OpTab[(int)PixelFormat::BGR_565][1] = _blit < PixelFormat::BGR_565, 1, BlendMode::Replace, PixelFormat::BGRA_4>;
+
+		s_moveTo_BGRA_4_OpTab[(int)PixelFormat::BGRA_4][0] = _blit < PixelFormat::BGRA_4, 0, BlendMode::Replace, PixelFormat::BGRA_4>;
+		s_moveTo_BGRA_4_OpTab[(int)PixelFormat::BGRA_4][1] = _blit < PixelFormat::BGRA_4, 1, BlendMode::Replace, PixelFormat::BGRA_4>;
+
+		s_moveTo_BGRA_4_OpTab[(int)PixelFormat::I8][0] = _blit < PixelFormat::I8, 0, BlendMode::Replace, PixelFormat::BGRA_4>;
+		s_moveTo_BGRA_4_OpTab[(int)PixelFormat::I8][1] = _blit < PixelFormat::I8, 1, BlendMode::Replace, PixelFormat::BGRA_4>;
+
+		s_moveTo_BGRA_4_OpTab[(int)PixelFormat::A8][0] = _blit < PixelFormat::A8, 0, BlendMode::Replace, PixelFormat::BGRA_4>;
+		s_moveTo_BGRA_4_OpTab[(int)PixelFormat::A8][1] = _blit < PixelFormat::A8, 1, BlendMode::Replace, PixelFormat::BGRA_4>;
+
+		s_blendTo_BGRA_4_OpTab[(int)PixelFormat::BGRA_8][0] = _blit < PixelFormat::BGRA_8, 0, BlendMode::Blend, PixelFormat::BGRA_4>;
+		s_blendTo_BGRA_4_OpTab[(int)PixelFormat::BGRA_8][1] = _blit < PixelFormat::BGRA_8, 1, BlendMode::Blend, PixelFormat::BGRA_4>;
+
+		s_blendTo_BGRA_4_OpTab[(int)PixelFormat::BGRX_8][0] = _blit < PixelFormat::BGR_8, 0, BlendMode::Blend, PixelFormat::BGRA_4>;
+		s_blendTo_BGRA_4_OpTab[(int)PixelFormat::BGRX_8][1] = _blit < PixelFormat::BGR_8, 1, BlendMode::Blend, PixelFormat::BGRA_4>;
+
+		s_blendTo_BGRA_4_OpTab[(int)PixelFormat::BGR_8][0] = _blit < PixelFormat::BGR_8, 0, BlendMode::Blend, PixelFormat::BGRA_4>;
+		s_blendTo_BGRA_4_OpTab[(int)PixelFormat::BGR_8][1] = _blit < PixelFormat::BGR_8, 1, BlendMode::Blend, PixelFormat::BGRA_4>;
+
+		s_blendTo_BGRA_4_OpTab[(int)PixelFormat::BGR_565][0] = _blit < PixelFormat::BGR_565, 0, BlendMode::Blend, PixelFormat::BGRA_4>;
+		s_blendTo_BGRA_4_OpTab[(int)PixelFormat::BGR_565][1] = _blit < PixelFormat::BGR_565, 1, BlendMode::Blend, PixelFormat::BGRA_4>;
+
+		s_blendTo_BGRA_4_OpTab[(int)PixelFormat::BGRA_4][0] = _blit < PixelFormat::BGRA_4, 0, BlendMode::Blend, PixelFormat::BGRA_4>;
+		s_blendTo_BGRA_4_OpTab[(int)PixelFormat::BGRA_4][1] = _blit < PixelFormat::BGRA_4, 1, BlendMode::Blend, PixelFormat::BGRA_4>;
+
+		s_blendTo_BGRA_4_OpTab[(int)PixelFormat::I8][0] = _blit < PixelFormat::I8, 0, BlendMode::Blend, PixelFormat::BGRA_4>;
+		s_blendTo_BGRA_4_OpTab[(int)PixelFormat::I8][1] = _blit < PixelFormat::I8, 1, BlendMode::Blend, PixelFormat::BGRA_4>;
+
+		s_blendTo_BGRA_4_OpTab[(int)PixelFormat::A8][0] = _blit < PixelFormat::A8, 0, BlendMode::Blend, PixelFormat::BGRA_4>;
+		s_blendTo_BGRA_4_OpTab[(int)PixelFormat::A8][1] = _blit < PixelFormat::A8, 1, BlendMode::Blend, PixelFormat::BGRA_4>;
+
+		s_stretchTo_BGRA_4_OpTab[(int)PixelFormat::BGRA_8][0][0] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Nearest, 0, BlendMode::Replace, PixelFormat::BGRA_4>;
+		s_stretchTo_BGRA_4_OpTab[(int)PixelFormat::BGRA_8][0][1] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Nearest, 1, BlendMode::Replace, PixelFormat::BGRA_4>;
+		s_stretchTo_BGRA_4_OpTab[(int)PixelFormat::BGRA_8][1][0] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGRA_4>;
+		s_stretchTo_BGRA_4_OpTab[(int)PixelFormat::BGRA_8][1][1] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGRA_4>;
+
+		s_stretchTo_BGRA_4_OpTab[(int)PixelFormat::BGRX_8][0][0] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Nearest, 0, BlendMode::Replace, PixelFormat::BGRA_4>;
+		s_stretchTo_BGRA_4_OpTab[(int)PixelFormat::BGRX_8][0][1] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Nearest, 1, BlendMode::Replace, PixelFormat::BGRA_4>;
+		s_stretchTo_BGRA_4_OpTab[(int)PixelFormat::BGRX_8][1][0] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGRA_4>;
+		s_stretchTo_BGRA_4_OpTab[(int)PixelFormat::BGRX_8][1][1] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGRA_4>;
+
+		s_stretchTo_BGRA_4_OpTab[(int)PixelFormat::BGR_8][0][0] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Nearest, 0, BlendMode::Replace, PixelFormat::BGRA_4>;
+		s_stretchTo_BGRA_4_OpTab[(int)PixelFormat::BGR_8][0][1] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Nearest, 1, BlendMode::Replace, PixelFormat::BGRA_4>;
+		s_stretchTo_BGRA_4_OpTab[(int)PixelFormat::BGR_8][1][0] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGRA_4>;
+		s_stretchTo_BGRA_4_OpTab[(int)PixelFormat::BGR_8][1][1] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGRA_4>;
+
+		s_stretchTo_BGRA_4_OpTab[(int)PixelFormat::BGR_565][0][0] = _stretch_blit < PixelFormat::BGR_565, ScaleMode::Nearest, 0, BlendMode::Replace, PixelFormat::BGRA_4>;
+		s_stretchTo_BGRA_4_OpTab[(int)PixelFormat::BGR_565][0][1] = _stretch_blit < PixelFormat::BGR_565, ScaleMode::Nearest, 1, BlendMode::Replace, PixelFormat::BGRA_4>;
+		s_stretchTo_BGRA_4_OpTab[(int)PixelFormat::BGR_565][1][0] = _stretch_blit < PixelFormat::BGR_565, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGRA_4>;
+		s_stretchTo_BGRA_4_OpTab[(int)PixelFormat::BGR_565][1][1] = _stretch_blit < PixelFormat::BGR_565, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGRA_4>;
+
+		s_stretchTo_BGRA_4_OpTab[(int)PixelFormat::BGRA_4][0][0] = _stretch_blit < PixelFormat::BGRA_4, ScaleMode::Nearest, 0, BlendMode::Replace, PixelFormat::BGRA_4>;
+		s_stretchTo_BGRA_4_OpTab[(int)PixelFormat::BGRA_4][0][1] = _stretch_blit < PixelFormat::BGRA_4, ScaleMode::Nearest, 1, BlendMode::Replace, PixelFormat::BGRA_4>;
+		s_stretchTo_BGRA_4_OpTab[(int)PixelFormat::BGRA_4][1][0] = _stretch_blit < PixelFormat::BGRA_4, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGRA_4>;
+		s_stretchTo_BGRA_4_OpTab[(int)PixelFormat::BGRA_4][1][1] = _stretch_blit < PixelFormat::BGRA_4, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGRA_4>;
+
+		s_stretchTo_BGRA_4_OpTab[(int)PixelFormat::I8][0][0] = _stretch_blit < PixelFormat::I8, ScaleMode::Nearest, 0, BlendMode::Replace, PixelFormat::BGRA_4>;
+		s_stretchTo_BGRA_4_OpTab[(int)PixelFormat::I8][0][1] = _stretch_blit < PixelFormat::I8, ScaleMode::Nearest, 1, BlendMode::Replace, PixelFormat::BGRA_4>;
+		s_stretchTo_BGRA_4_OpTab[(int)PixelFormat::I8][1][0] = _stretch_blit < PixelFormat::I8, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGRA_4>;
+		s_stretchTo_BGRA_4_OpTab[(int)PixelFormat::I8][1][1] = _stretch_blit < PixelFormat::I8, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGRA_4>;
+
+		s_stretchTo_BGRA_4_OpTab[(int)PixelFormat::A8][0][0] = _stretch_blit < PixelFormat::A8, ScaleMode::Nearest, 0, BlendMode::Replace, PixelFormat::BGRA_4>;
+		s_stretchTo_BGRA_4_OpTab[(int)PixelFormat::A8][0][1] = _stretch_blit < PixelFormat::A8, ScaleMode::Nearest, 1, BlendMode::Replace, PixelFormat::BGRA_4>;
+		s_stretchTo_BGRA_4_OpTab[(int)PixelFormat::A8][1][0] = _stretch_blit < PixelFormat::A8, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGRA_4>;
+		s_stretchTo_BGRA_4_OpTab[(int)PixelFormat::A8][1][1] = _stretch_blit < PixelFormat::A8, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGRA_4>;
+
+		s_stretchBlendTo_BGRA_4_OpTab[(int)PixelFormat::BGRA_8][0][0] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Nearest, 0, BlendMode::Blend, PixelFormat::BGRA_4>;
+		s_stretchBlendTo_BGRA_4_OpTab[(int)PixelFormat::BGRA_8][0][1] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Nearest, 1, BlendMode::Blend, PixelFormat::BGRA_4>;
+		s_stretchBlendTo_BGRA_4_OpTab[(int)PixelFormat::BGRA_8][1][0] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGRA_4>;
+		s_stretchBlendTo_BGRA_4_OpTab[(int)PixelFormat::BGRA_8][1][1] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGRA_4>;
+
+		s_stretchBlendTo_BGRA_4_OpTab[(int)PixelFormat::BGRX_8][0][0] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Nearest, 0, BlendMode::Blend, PixelFormat::BGRA_4>;
+		s_stretchBlendTo_BGRA_4_OpTab[(int)PixelFormat::BGRX_8][0][1] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Nearest, 1, BlendMode::Blend, PixelFormat::BGRA_4>;
+		s_stretchBlendTo_BGRA_4_OpTab[(int)PixelFormat::BGRX_8][1][0] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGRA_4>;
+		s_stretchBlendTo_BGRA_4_OpTab[(int)PixelFormat::BGRX_8][1][1] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGRA_4>;
+
+		s_stretchBlendTo_BGRA_4_OpTab[(int)PixelFormat::BGR_8][0][0] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Nearest, 0, BlendMode::Blend, PixelFormat::BGRA_4>;
+		s_stretchBlendTo_BGRA_4_OpTab[(int)PixelFormat::BGR_8][0][1] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Nearest, 1, BlendMode::Blend, PixelFormat::BGRA_4>;
+		s_stretchBlendTo_BGRA_4_OpTab[(int)PixelFormat::BGR_8][1][0] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGRA_4>;
+		s_stretchBlendTo_BGRA_4_OpTab[(int)PixelFormat::BGR_8][1][1] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGRA_4>;
+
+		s_stretchBlendTo_BGRA_4_OpTab[(int)PixelFormat::BGR_565][0][0] = _stretch_blit < PixelFormat::BGR_565, ScaleMode::Nearest, 0, BlendMode::Blend, PixelFormat::BGRA_4>;
+		s_stretchBlendTo_BGRA_4_OpTab[(int)PixelFormat::BGR_565][0][1] = _stretch_blit < PixelFormat::BGR_565, ScaleMode::Nearest, 1, BlendMode::Blend, PixelFormat::BGRA_4>;
+		s_stretchBlendTo_BGRA_4_OpTab[(int)PixelFormat::BGR_565][1][0] = _stretch_blit < PixelFormat::BGR_565, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGRA_4>;
+		s_stretchBlendTo_BGRA_4_OpTab[(int)PixelFormat::BGR_565][1][1] = _stretch_blit < PixelFormat::BGR_565, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGRA_4>;
+
+		s_stretchBlendTo_BGRA_4_OpTab[(int)PixelFormat::BGRA_4][0][0] = _stretch_blit < PixelFormat::BGRA_4, ScaleMode::Nearest, 0, BlendMode::Blend, PixelFormat::BGRA_4>;
+		s_stretchBlendTo_BGRA_4_OpTab[(int)PixelFormat::BGRA_4][0][1] = _stretch_blit < PixelFormat::BGRA_4, ScaleMode::Nearest, 1, BlendMode::Blend, PixelFormat::BGRA_4>;
+		s_stretchBlendTo_BGRA_4_OpTab[(int)PixelFormat::BGRA_4][1][0] = _stretch_blit < PixelFormat::BGRA_4, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGRA_4>;
+		s_stretchBlendTo_BGRA_4_OpTab[(int)PixelFormat::BGRA_4][1][1] = _stretch_blit < PixelFormat::BGRA_4, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGRA_4>;
+
+		s_stretchBlendTo_BGRA_4_OpTab[(int)PixelFormat::I8][0][0] = _stretch_blit < PixelFormat::I8, ScaleMode::Nearest, 0, BlendMode::Blend, PixelFormat::BGRA_4>;
+		s_stretchBlendTo_BGRA_4_OpTab[(int)PixelFormat::I8][0][1] = _stretch_blit < PixelFormat::I8, ScaleMode::Nearest, 1, BlendMode::Blend, PixelFormat::BGRA_4>;
+		s_stretchBlendTo_BGRA_4_OpTab[(int)PixelFormat::I8][1][0] = _stretch_blit < PixelFormat::I8, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGRA_4>;
+		s_stretchBlendTo_BGRA_4_OpTab[(int)PixelFormat::I8][1][1] = _stretch_blit < PixelFormat::I8, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGRA_4>;
+
+		s_stretchBlendTo_BGRA_4_OpTab[(int)PixelFormat::A8][0][0] = _stretch_blit < PixelFormat::A8, ScaleMode::Nearest, 0, BlendMode::Blend, PixelFormat::BGRA_4>;
+		s_stretchBlendTo_BGRA_4_OpTab[(int)PixelFormat::A8][0][1] = _stretch_blit < PixelFormat::A8, ScaleMode::Nearest, 1, BlendMode::Blend, PixelFormat::BGRA_4>;
+		s_stretchBlendTo_BGRA_4_OpTab[(int)PixelFormat::A8][1][0] = _stretch_blit < PixelFormat::A8, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGRA_4>;
+		s_stretchBlendTo_BGRA_4_OpTab[(int)PixelFormat::A8][1][1] = _stretch_blit < PixelFormat::A8, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGRA_4>;
+
+		// Init premultiplied source operation tables
+
+		s_movePremultTo_BGRA_8_OpTab[0] = _blit < PixelFormat::BGRA_8, 2, BlendMode::Replace, PixelFormat::BGRA_8>;
+		s_movePremultTo_BGRA_8_OpTab[1] = _blit < PixelFormat::BGRA_8, 3, BlendMode::Replace, PixelFormat::BGRA_8>;
+
+		s_blendPremultTo_BGRA_8_OpTab[0] = _blit < PixelFormat::BGRA_8, 2, BlendMode::Blend, PixelFormat::BGRA_8>;
+		s_blendPremultTo_BGRA_8_OpTab[1] = _blit < PixelFormat::BGRA_8, 3, BlendMode::Blend, PixelFormat::BGRA_8>;
+
+		s_blendPremultTo_BGR_8_OpTab[0] = _blit < PixelFormat::BGRA_8, 2, BlendMode::Blend, PixelFormat::BGR_8>;
+		s_blendPremultTo_BGR_8_OpTab[1] = _blit < PixelFormat::BGRA_8, 3, BlendMode::Blend, PixelFormat::BGR_8>;
+
+		s_stretchPremultTo_BGRA_8_OpTab[0][0] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Nearest, 2, BlendMode::Replace, PixelFormat::BGRA_8>;
+		s_stretchPremultTo_BGRA_8_OpTab[0][1] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Nearest, 3, BlendMode::Replace, PixelFormat::BGRA_8>;
+		s_stretchPremultTo_BGRA_8_OpTab[1][0] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Interpolate, 2, BlendMode::Replace, PixelFormat::BGRA_8>;
+		s_stretchPremultTo_BGRA_8_OpTab[1][1] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Interpolate, 3, BlendMode::Replace, PixelFormat::BGRA_8>;
+
+		s_stretchBlendPremultTo_BGRA_8_OpTab[0][0] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Nearest, 2, BlendMode::Blend, PixelFormat::BGRA_8>;
+		s_stretchBlendPremultTo_BGRA_8_OpTab[0][1] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Nearest, 3, BlendMode::Blend, PixelFormat::BGRA_8>;
+		s_stretchBlendPremultTo_BGRA_8_OpTab[1][0] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Interpolate, 2, BlendMode::Blend, PixelFormat::BGRA_8>;
+		s_stretchBlendPremultTo_BGRA_8_OpTab[1][1] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Interpolate, 3, BlendMode::Blend, PixelFormat::BGRA_8>;
+
+		s_stretchBlendPremultTo_BGR_8_OpTab[0][0] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Nearest, 2, BlendMode::Blend, PixelFormat::BGR_8>;
+		s_stretchBlendPremultTo_BGR_8_OpTab[0][1] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Nearest, 3, BlendMode::Blend, PixelFormat::BGR_8>;
+		s_stretchBlendPremultTo_BGR_8_OpTab[1][0] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Interpolate, 2, BlendMode::Blend, PixelFormat::BGR_8>;
+		s_stretchBlendPremultTo_BGR_8_OpTab[1][1] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Interpolate, 3, BlendMode::Blend, PixelFormat::BGR_8>;
+
 
 		// Init Wave Operation Table
 
 		s_waveOpTab[(int)BlendMode::Blend][(int)PixelFormat::BGRA_8] = _clip_wave_blend_32;
 		s_waveOpTab[(int)BlendMode::Blend][(int)PixelFormat::BGR_8] = _clip_wave_blend_24;
 
+		// Init Segment Operation Table
+
+		s_segmentOpTab[(int)BlendMode::Replace][(int)PixelFormat::BGRA_8] = _clip_draw_segment_column<BlendMode::Replace, PixelFormat::BGRA_8>;
+		s_segmentOpTab[(int)BlendMode::Replace][(int)PixelFormat::BGRX_8] = _clip_draw_segment_column<BlendMode::Replace, PixelFormat::BGR_8>;
+		s_segmentOpTab[(int)BlendMode::Replace][(int)PixelFormat::BGR_8] = _clip_draw_segment_column<BlendMode::Replace, PixelFormat::BGR_8>;
+		s_segmentOpTab[(int)BlendMode::Replace][(int)PixelFormat::BGR_565] = _clip_draw_segment_column<BlendMode::Replace, PixelFormat::BGR_565>;
+		s_segmentOpTab[(int)BlendMode::Replace][(int)PixelFormat::BGRA_4] = _clip_draw_segment_column<BlendMode::Replace, PixelFormat::BGRA_4>;
+
+		s_segmentOpTab[(int)BlendMode::Blend][(int)PixelFormat::BGRA_8] = _clip_draw_segment_column<BlendMode::Blend, PixelFormat::BGRA_8>;
+		s_segmentOpTab[(int)BlendMode::Blend][(int)PixelFormat::BGRX_8] = _clip_draw_segment_column<BlendMode::Blend, PixelFormat::BGR_8>;
+		s_segmentOpTab[(int)BlendMode::Blend][(int)PixelFormat::BGR_8] = _clip_draw_segment_column<BlendMode::Blend, PixelFormat::BGR_8>;
+		s_segmentOpTab[(int)BlendMode::Blend][(int)PixelFormat::BGR_565] = _clip_draw_segment_column<BlendMode::Blend, PixelFormat::BGR_565>;
+		s_segmentOpTab[(int)BlendMode::Blend][(int)PixelFormat::BGRA_4] = _clip_draw_segment_column<BlendMode::Blend, PixelFormat::BGRA_4>;
+
+		s_segmentOpTab[(int)BlendMode::Add][(int)PixelFormat::BGRA_8] = _clip_draw_segment_column<BlendMode::Add, PixelFormat::BGRA_8>;
+		s_segmentOpTab[(int)BlendMode::Add][(int)PixelFormat::BGRX_8] = _clip_draw_segment_column<BlendMode::Add, PixelFormat::BGR_8>;
+		s_segmentOpTab[(int)BlendMode::Add][(int)PixelFormat::BGR_8] = _clip_draw_segment_column<BlendMode::Add, PixelFormat::BGR_8>;
+		s_segmentOpTab[(int)BlendMode::Add][(int)PixelFormat::BGR_565] = _clip_draw_segment_column<BlendMode::Add, PixelFormat::BGR_565>;
+		s_segmentOpTab[(int)BlendMode::Add][(int)PixelFormat::BGRA_4] = _clip_draw_segment_column<BlendMode::Add, PixelFormat::BGRA_4>;
+
+		s_segmentOpTab[(int)BlendMode::Subtract][(int)PixelFormat::BGRA_8] = _clip_draw_segment_column<BlendMode::Subtract, PixelFormat::BGRA_8>;
+		s_segmentOpTab[(int)BlendMode::Subtract][(int)PixelFormat::BGRX_8] = _clip_draw_segment_column<BlendMode::Subtract, PixelFormat::BGR_8>;
+		s_segmentOpTab[(int)BlendMode::Subtract][(int)PixelFormat::BGR_8] = _clip_draw_segment_column<BlendMode::Subtract, PixelFormat::BGR_8>;
+		s_segmentOpTab[(int)BlendMode::Subtract][(int)PixelFormat::BGR_565] = _clip_draw_segment_column<BlendMode::Subtract, PixelFormat::BGR_565>;
+		s_segmentOpTab[(int)BlendMode::Subtract][(int)PixelFormat::BGRA_4] = _clip_draw_segment_column<BlendMode::Subtract, PixelFormat::BGRA_4>;
+
+		s_segmentOpTab[(int)BlendMode::Multiply][(int)PixelFormat::BGRA_8] = _clip_draw_segment_column<BlendMode::Multiply, PixelFormat::BGRA_8>;
+		s_segmentOpTab[(int)BlendMode::Multiply][(int)PixelFormat::BGRX_8] = _clip_draw_segment_column<BlendMode::Multiply, PixelFormat::BGR_8>;
+		s_segmentOpTab[(int)BlendMode::Multiply][(int)PixelFormat::BGR_8] = _clip_draw_segment_column<BlendMode::Multiply, PixelFormat::BGR_8>;
+		s_segmentOpTab[(int)BlendMode::Multiply][(int)PixelFormat::BGR_565] = _clip_draw_segment_column<BlendMode::Multiply, PixelFormat::BGR_565>;
+		s_segmentOpTab[(int)BlendMode::Multiply][(int)PixelFormat::BGRA_4] = _clip_draw_segment_column<BlendMode::Multiply, PixelFormat::BGRA_4>;
+
+		s_segmentOpTab[(int)BlendMode::Invert][(int)PixelFormat::BGRA_8] = _clip_draw_segment_column<BlendMode::Invert, PixelFormat::BGRA_8>;
+		s_segmentOpTab[(int)BlendMode::Invert][(int)PixelFormat::BGRX_8] = _clip_draw_segment_column<BlendMode::Invert, PixelFormat::BGR_8>;
+		s_segmentOpTab[(int)BlendMode::Invert][(int)PixelFormat::BGR_8] = _clip_draw_segment_column<BlendMode::Invert, PixelFormat::BGR_8>;
+		s_segmentOpTab[(int)BlendMode::Invert][(int)PixelFormat::BGR_565] = _clip_draw_segment_column<BlendMode::Invert, PixelFormat::BGR_565>;
+		s_segmentOpTab[(int)BlendMode::Invert][(int)PixelFormat::BGRA_4] = _clip_draw_segment_column<BlendMode::Invert, PixelFormat::BGRA_4>;
+
 	}
 
 	//____ _clearCustomFunctionTable() ________________________________________
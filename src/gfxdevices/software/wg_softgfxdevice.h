@@ -35,7 +35,7 @@ namespace wg
 	{
 		int			begin;				// Pixeloffset, 24.8 format.
 		int			end;				// Pixeloffset, 24.8 format. First pixel after edge (segment after the edge has 100% coverage)
-		int			coverage;			// 0-65536
+		int			coverage;			// 0-65536 at begin. Segments drawn by clipDrawSegments() keep the unclamped coverage at pixel row 0 here.
 		int			coverageInc;		// Increment of coverage for each full pixel we progress
 	};
 
@@ -98,6 +98,11 @@ namespace wg
 		inline void						enableCustomFunctions(bool enable) { m_bEnableCustomFunctions = enable; };
 		inline bool						customFunctionsEnabled() const { return m_bEnableCustomFunctions; }
 
+		//.____ Rendering ________________________________________________
+
+		void			setDithering(bool bDither);
+		inline bool		isDithering() const { return m_bDither; }
+
 		//.____ Geometry _________________________________________________
 
 		bool	setCanvas(Surface * pCanvas);
@@ -118,12 +123,15 @@ namespace wg
 		void	clipDrawLine(const Rect& clip, Coord begin, Coord end, Color color, float thickness = 1.f) override;
 		void	clipDrawLine(const Rect& clip, Coord begin, Direction dir, int length, Color col, float thickness = 1.f) override;
 
+		void	clipDrawPolyline(const Rect& clip, int nPoints, const CoordF * pPoints, Color color, float thickness = 1.f) override;
+
 		void    clipPlotPixels(const Rect& clip, int nCoords, const Coord * pCoords, const Color * pColors) override;
 
 		void	fillSubPixel(const RectF& rect, const Color& col) override;
 		void	stretchBlit(Surface * pSrc, const RectF& source, const Rect& dest) override;
 
 		void	clipDrawHorrWave(const Rect&clip, Coord begin, int length, const WaveLine * PTopBorder, const WaveLine * pBottomBorder, Color frontFill, Color backFill);
+		void	clipDrawSegments(const Rect& clip, const Rect& dest, int nEdgeStrips, const int * pEdgeStrips, const Color * pSegmentColors);
 
 
 		struct ColTrans
@@ -131,6 +139,8 @@ namespace wg
 			Color	baseTint;
 			Color * pTintX;
 			Color * pTintY;
+			bool	bDither;			// Ordered dithering when writing to BGR_565 or BGRA_4.
+			Coord	ditherOrigin;		// Canvas position of first pixel written by operation.
 		};
 
 
@@ -163,6 +173,22 @@ namespace wg
 			int dstY;
 		};
 
+		struct StretchColumn
+		{
+			int ofs;			// Byte offset of source pixel in line.
+			int nextOfs;		// Byte offset from source pixel to its right neighbour, 0 at right edge.
+			int weight;			// Weight of right neighbour, 0-255.
+		};
+
+		struct PolyEdge
+		{
+			float x0, y0;		// Top of edge.
+			float x1, y1;		// Bottom of edge.
+			float dir;			// 1.f if edge goes downwards, -1.f if upwards.
+			int firstBand;		// First and last band of lines crossed by the edge.
+			int lastBand;
+		};
+
 		inline static void _read_pixel(const uint8_t * pPixel, PixelFormat format, const Color * pClut, uint8_t& outB, uint8_t& outG, uint8_t& outR, uint8_t& outA);
 		inline static void _write_pixel(uint8_t * pPixel, PixelFormat format, uint8_t b, uint8_t g, uint8_t r, uint8_t a);
 
@@ -170,6 +196,12 @@ namespace wg
 											uint8_t backB, uint8_t backG, uint8_t backR, uint8_t backA,
 											uint8_t& outB, uint8_t& outG, uint8_t& outR, uint8_t& outA);
 
+		inline static void	_dither_pixel(PixelFormat format, int x, int y, uint8_t& b, uint8_t& g, uint8_t& r, uint8_t& a);
+
+		inline static void	_blend_premultiplied_pixels(BlendMode mode, uint8_t srcB, uint8_t srcG, uint8_t srcR, uint8_t srcA,
+											uint8_t backB, uint8_t backG, uint8_t backR, uint8_t backA,
+											uint8_t& outB, uint8_t& outG, uint8_t& outR, uint8_t& outA);
+
 		inline static void _init_tint_color(TintMode tintMode, const ColTrans& tint, uint8_t inB, uint8_t inG, uint8_t inR, uint8_t inA, 
 											uint8_t& outB, uint8_t& outG, uint8_t& outR, uint8_t& outA);
 
@@ -209,8 +241,13 @@ namespace wg
 		template<BlendMode BLEND, int TINTFLAGS, PixelFormat DSTFORMAT>
 		static void _draw_wave_column(int clipBeg, int clipLen, uint8_t * pColumn, int leftPos[4], int rightPos[4], Color col[3], int linePitch);
 
+		template<BlendMode BLEND, PixelFormat DSTFORMAT>
+		static void _clip_draw_segment_column(int clipBeg, int clipEnd, uint8_t * pColumn, int linePitch, int nEdges, const SegmentEdge * pEdges, const Color * pSegmentColors, const ColTrans& tint);
+
 
 
+		// Blit operations: Bit 0 of TINTFLAGS is set for color tint, bit 1 for premultiplied BGRA_8 source.
+
 		template<PixelFormat SRCFORMAT, int TINTFLAGS, BlendMode BLEND, PixelFormat DSTFORMAT>
 		static void	_blit(const uint8_t * pSrc, uint8_t * pDst, const Color * pClut, const Pitches& pitches, int nLines, int lineLength, const ColTrans& tint);
 
@@ -232,11 +269,17 @@ namespace wg
 		void	_clearCustomFunctionTable();
 		int 	_scaleLineThickness(float thickness, int slope);
 
+		static int	_addPolylineEdge(PolyEdge * pEdges, int nEdges, CoordF beg, CoordF end);
+		static int	_addPolylineTriangle(PolyEdge * pEdges, int nEdges, CoordF a, CoordF b, CoordF c);
+		static void	_accumulatePolylineEdge(float * pAcc, int pitch, uint8_t * pBlocks, int blockPitch, int width, int nLines,
+											float x0, float y0, float x1, float y1, float dir);
+
 
 		//		void	_clipDrawSegmentColumn(int clipBeg, int clipEnd, uint8_t * pColumn, int linePitch, int nEdges, SegmentEdge * pEdges, Color * pSegmentColors);
 
 
 		typedef	void(*WaveOp_p)(int clipBeg, int clipLen, uint8_t * pColumn, int leftPos[4], int rightPos[4], Color col[3], int linePitch);
+		typedef	void(*SegmentOp_p)(int clipBeg, int clipEnd, uint8_t * pColumn, int linePitch, int nEdges, const SegmentEdge * pEdges, const Color * pSegmentColors, const ColTrans& tint);
 
 		static void	_clip_wave_blend_24(int clipBeg, int clipLen, uint8_t * pColumn, int leftPos[4], int rightPos[4], Color col[3], int linePitch);
 		static void	_clip_wave_blend_32(int clipBeg, int clipLen, uint8_t * pColumn, int leftPos[4], int rightPos[4], Color col[3], int linePitch);
@@ -268,6 +311,7 @@ namespace wg
 		static FillOp_p			s_fillOpTab[BlendMode_size][TintMode_size][PixelFormat_size];		//[BlendMode][TintMode][DestFormat]
 		static PlotListOp_p		s_plotListOpTab[BlendMode_size][PixelFormat_size];
 		static WaveOp_p			s_waveOpTab[BlendMode_size][PixelFormat_size];
+		static SegmentOp_p		s_segmentOpTab[BlendMode_size][PixelFormat_size];
 
 		static BlitOp_p			s_pass2OpTab[BlendMode_size][PixelFormat_size];
 
@@ -283,8 +327,33 @@ namespace wg
 		static TransformOp_p	s_stretchBlendTo_BGRA_8_OpTab[PixelFormat_size][2][2];	// [SourceFormat][ScaleMode][TintMode]
 		static TransformOp_p	s_stretchBlendTo_BGR_8_OpTab[PixelFormat_size][2][2];	// [SourceFormat][ScaleMode][TintMode]
 
+		// Operations for 16-bit destinations.
+
+		static BlitOp_p			s_moveTo_BGR_565_OpTab[PixelFormat_size][2];			// [SourceFormat][TintMode]
+		static BlitOp_p			s_moveTo_BGRA_4_OpTab[PixelFormat_size][2];				// [SourceFormat][TintMode]
+
+		static BlitOp_p			s_blendTo_BGR_565_OpTab[PixelFormat_size][2];			// [SourceFormat][TintMode]
+		static BlitOp_p			s_blendTo_BGRA_4_OpTab[PixelFormat_size][2];			// [SourceFormat][TintMode]
+
+		static TransformOp_p	s_stretchTo_BGR_565_OpTab[PixelFormat_size][2][2];		// [SourceFormat][ScaleMode][TintMode]
+		static TransformOp_p	s_stretchTo_BGRA_4_OpTab[PixelFormat_size][2][2];		// [SourceFormat][ScaleMode][TintMode]
+
+		static TransformOp_p	s_stretchBlendTo_BGR_565_OpTab[PixelFormat_size][2][2];	// [SourceFormat][ScaleMode][TintMode]
+		static TransformOp_p	s_stretchBlendTo_BGRA_4_OpTab[PixelFormat_size][2][2];	// [SourceFormat][ScaleMode][TintMode]
+
+		// Operations for premultiplied BGRA_8 sources, which set bit 1 of TINTFLAGS.
+
+		static BlitOp_p			s_movePremultTo_BGRA_8_OpTab[2];						// [TintMode]
+		static BlitOp_p			s_blendPremultTo_BGRA_8_OpTab[2];						// [TintMode]
+		static BlitOp_p			s_blendPremultTo_BGR_8_OpTab[2];						// [TintMode]
+
+		static TransformOp_p	s_stretchPremultTo_BGRA_8_OpTab[2][2];					// [ScaleMode][TintMode]
+		static TransformOp_p	s_stretchBlendPremultTo_BGRA_8_OpTab[2][2];				// [ScaleMode][TintMode]
+		static TransformOp_p	s_stretchBlendPremultTo_BGR_8_OpTab[2][2];				// [ScaleMode][TintMode]
+
 
 		static int		s_mulTab[256];
+		static int		s_unpremulTab[256];
 
 		SurfaceFactory_p	m_pSurfaceFactory;
 
@@ -294,6 +363,8 @@ namespace wg
 		int				m_canvasPixelBits;	// PixelBits of m_pCanvas when locked
 		int				m_canvasPitch;
 
+		bool			m_bDither;					// Ordered dithering on 16-bit canvases.
+
 		bool			m_bEnableCustomFunctions;	// Externally set.
 		bool			m_bUseCustomFunctions;		// Internally set, based on m_bEnableCustomFunctions and return values from custom calls to beginRender and setCanvas.
 													//Use overrided drawing primitives if available. 
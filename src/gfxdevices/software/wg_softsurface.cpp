@@ -46,7 +46,11 @@ namespace wg
 		if (format == PixelFormat::Unknown || format == PixelFormat::Custom || format < PixelFormat_min || format > PixelFormat_max || (format == PixelFormat::I8 && pClut == nullptr) )
 			return SoftSurface_p(); 
 
-		return SoftSurface_p(new SoftSurface(size,format,pClut));
+		SoftSurface_p p = new SoftSurface(size,format,pClut);
+		p->m_bMipmapped = (hint & SurfaceHint::Mipmapped) != 0;
+		if( hint & SurfaceHint::Premultiplied )
+			p->setPremultiplied(true);
+		return p;
 	}
 	
 	SoftSurface_p SoftSurface::create( Size size, PixelFormat format, Blob * pBlob, int pitch, int hint, const Color * pClut)
@@ -54,7 +58,11 @@ namespace wg
 		if (format == PixelFormat::Unknown || format == PixelFormat::Custom || format < PixelFormat_min || format > PixelFormat_max || (format == PixelFormat::I8 && pClut == nullptr) || !pBlob || pitch % 4 != 0 )
 			return SoftSurface_p();
 		
-		return SoftSurface_p(new SoftSurface(size,format,pBlob,pitch,pClut));
+		SoftSurface_p p = new SoftSurface(size,format,pBlob,pitch,pClut);
+		p->m_bMipmapped = (hint & SurfaceHint::Mipmapped) != 0;
+		if( hint & SurfaceHint::Premultiplied )
+			p->setPremultiplied(true);
+		return p;
 	}
 		
 	SoftSurface_p SoftSurface::create( Size size, PixelFormat format, uint8_t * pPixels, int pitch, const PixelDescription * pPixelDescription, int hint, const Color * pClut )
@@ -63,7 +71,11 @@ namespace wg
 		     (format == PixelFormat::I8 && pClut == nullptr) || pPixels == nullptr || pitch <= 0 || pPixelDescription == nullptr) 
 			return SoftSurface_p();
 
-		return  SoftSurface_p(new SoftSurface(size,format,pPixels,pitch,pPixelDescription,pClut)); 
+		SoftSurface_p p = new SoftSurface(size,format,pPixels,pitch,pPixelDescription,pClut);
+		p->m_bMipmapped = (hint & SurfaceHint::Mipmapped) != 0;
+		if( hint & SurfaceHint::Premultiplied )
+			p->setPremultiplied(true);
+		return p;
 	};
 
 	SoftSurface_p SoftSurface::create( Surface * pOther, int hint )
@@ -71,7 +83,11 @@ namespace wg
 		if( !pOther )
 			return SoftSurface_p();
 			
-		return SoftSurface_p(new SoftSurface( pOther )); 
+		SoftSurface_p p = new SoftSurface( pOther );
+		p->m_bMipmapped = (hint & SurfaceHint::Mipmapped) != 0;
+		if( hint & SurfaceHint::Premultiplied )
+			p->setPremultiplied(true);
+		return p;
 	}
 	
 	
@@ -105,6 +121,7 @@ namespace wg
 		m_pitch = pitch;
 		m_size = size;
 		m_pBlob = pBlob;
+		m_bSharedBlob = true;
 		m_pData = (uint8_t*) m_pBlob->data();
 		m_pClut = const_cast<Color*>(pClut);
 	}
@@ -202,7 +219,22 @@ namespace wg
 	{
 		if( m_pixelDescription.format == PixelFormat::BGRA_8 )
 	    {
+			if( !m_straightData.empty() )
+				return * ((uint32_t*) &m_straightData[ m_pitch*coord.y+coord.x*4 ]);
+
 			uint32_t k = * ((uint32_t*) &m_pData[ m_pitch*coord.y+coord.x*4 ]);
+
+			if( m_bPremultiplied )
+			{
+				uint8_t * p = (uint8_t*) &k;
+				int a = p[3];
+				if( a != 0 )
+				{
+					p[0] = (p[0] * 255 + a / 2) / a;
+					p[1] = (p[1] * 255 + a / 2) / a;
+					p[2] = (p[2] * 255 + a / 2) / a;
+				}
+			}
 			return k;
 	    }
 		else
@@ -247,12 +279,58 @@ namespace wg
 		return m_pixelDescription.A_bits==0?true:false;
 	}
 	
+	//____ setPremultiplied() _____________________________________________________
+	/**
+	 * @brief Store color premultiplied by alpha internally.
+	 *
+	 * Premultiplied surfaces are blended by SoftGfxDevice without multiplying each source
+	 * pixel by its alpha and are interpolated without dark fringes. The conversion is
+	 * transparent: a straight alpha copy of the content is kept, which is what lock() gives
+	 * access to, and only the region locked for writing is premultiplied again when the
+	 * surface is unlocked. Locking is therefore lossless and ReadOnly locks are free, at
+	 * the cost of twice the memory.
+	 *
+	 * Only supported for BGRA_8 surfaces. The same is achieved by creating the surface
+	 * with SurfaceHint::Premultiplied.
+	 *
+	 * @param bPremultiplied	True to convert the content to premultiplied alpha, false to convert it back.
+	 *
+	 * @return False if surface is not BGRA_8 or is locked.
+	 */
+
+	bool SoftSurface::setPremultiplied( bool bPremultiplied )
+	{
+		if( m_pixelDescription.format != PixelFormat::BGRA_8 || m_accessMode != AccessMode::None )
+			return false;
+
+		if( bPremultiplied != m_bPremultiplied )
+		{
+			int bytes = m_pitch*m_size.h;
+
+			if( bPremultiplied )
+			{
+				m_straightData.assign( m_pData, m_pData + bytes );
+				_premultiply( Rect(m_size) );
+			}
+			else
+			{
+				memcpy( m_pData, m_straightData.data(), bytes );
+				std::vector<uint8_t>().swap( m_straightData );
+			}
+
+			m_bPremultiplied = bPremultiplied;
+			m_mipmaps.clear();
+			_updateMemoryUsage();
+		}
+		return true;
+	}
+
 	//____ lock() __________________________________________________________________
 	
 	uint8_t * SoftSurface::lock( AccessMode mode )
 	{
-		m_accessMode = AccessMode::ReadWrite;
-		m_pPixels = m_pData;
+		m_accessMode = mode;
+		m_pPixels = m_bPremultiplied ? m_straightData.data() : m_pData;
 		m_lockRegion = Rect(0,0,m_size);
 		return m_pPixels;
 	}
@@ -262,7 +340,7 @@ namespace wg
 	uint8_t * SoftSurface::lockRegion( AccessMode mode, const Rect& region )
 	{
 		m_accessMode = mode;
-		m_pPixels = m_pData + m_pitch*region.y + region.x*m_pixelDescription.bits/8;
+		m_pPixels = (m_bPremultiplied ? m_straightData.data() : m_pData) + m_pitch*region.y + region.x*m_pixelDescription.bits/8;
 		m_lockRegion = region;
 		return m_pPixels;
 	}
@@ -271,6 +349,12 @@ namespace wg
 	
 	void SoftSurface::unlock()
 	{
+		if( m_accessMode != AccessMode::ReadOnly )
+			_clearMipmaps();
+
+		if( m_bPremultiplied && m_accessMode != AccessMode::None && m_accessMode != AccessMode::ReadOnly )
+			_premultiply( Rect( m_lockRegion, Rect(m_size) ) );
+
 		m_accessMode = AccessMode::None;
 		m_pPixels = 0;
 		m_lockRegion.clear();
@@ -285,6 +369,8 @@ namespace wg
 		Color color1;
 		Color color2;
 		int ind;
+
+		_clearMipmaps();
 	
 		switch(m_pixelDescription.format)
 		{
@@ -316,4 +402,172 @@ namespace wg
 	    }
 	}
 
+	//____ _mipmap() ______________________________________________________________
+	/*
+		Returns mipmap of given level, where each level is half the size of the previous one.
+		Levels are generated when first asked for. If surface is too small for the level,
+		the smallest available level is returned.
+
+		Mipmaps are always BGRA_8, or BGR_8 if surface has no alpha, no matter our own format.
+	*/
+
+	SoftSurface * SoftSurface::_mipmap( int level )
+	{
+		if( level <= 0 )
+			return this;
+
+		size_t nMipmaps = m_mipmaps.size();
+
+		while( (int) m_mipmaps.size() < level )
+		{
+			SoftSurface * pPrev = m_mipmaps.empty() ? this : m_mipmaps.back().rawPtr();
+			if( pPrev->m_size.w == 1 && pPrev->m_size.h == 1 )
+				break;
+
+			Size size( max(1, pPrev->m_size.w / 2), max(1, pPrev->m_size.h / 2) );
+			PixelFormat format = m_pixelDescription.A_bits == 0 && m_pixelDescription.format != PixelFormat::I8 ? PixelFormat::BGR_8 : PixelFormat::BGRA_8;
+
+			SoftSurface_p pMip = new SoftSurface( size, format, nullptr );
+			pMip->m_scaleMode = m_scaleMode;
+			pMip->m_bPremultiplied = m_bPremultiplied;
+			_generateMipmap( pPrev, pMip );
+			m_mipmaps.push_back( pMip );
+		}
+
+		if( m_mipmaps.size() != nMipmaps )
+			_updateMemoryUsage();
+
+		return m_mipmaps.empty() ? this : m_mipmaps[min(level,(int)m_mipmaps.size())-1].rawPtr();
+	}
+
+	//____ _generateMipmap() ______________________________________________________
+	/*
+		Box filters pSource down into pDest, which is half its size and of format BGRA_8 or BGR_8.
+
+		Straight alpha colors are weighted by alpha so that the color of transparent pixels doesn't
+		bleed into their neighbours. At odd sizes the last column and row are folded into the last
+		pixel of pDest instead of being dropped.
+	*/
+
+	void SoftSurface::_generateMipmap( SoftSurface * pSource, SoftSurface * pDest )
+	{
+		// Sources not in our mipmap format are converted first.
+
+		SoftSurface_p pConverted;
+		if( pSource->m_pixelDescription.format != pDest->m_pixelDescription.format )
+		{
+			pConverted = new SoftSurface( pSource->m_size, pDest->m_pixelDescription.format, nullptr );
+			pConverted->m_pPixels = pConverted->m_pData;		// Simulate a lock
+			pConverted->_copyFrom( &pSource->m_pixelDescription, pSource->m_pData, pSource->m_pitch, Rect(pSource->m_size), Rect(pSource->m_size), pSource->m_pClut );
+			pConverted->m_pPixels = 0;
+			pSource = pConverted.rawPtr();
+		}
+
+		int pixelBytes = pDest->m_pixelDescription.bits / 8;
+		int srcPitch = pSource->m_pitch;
+		bool bAlphaWeighted = pixelBytes == 4 && !pDest->m_bPremultiplied;
+
+		for( int y = 0 ; y < pDest->m_size.h ; y++ )
+		{
+			int srcY1 = y * 2;
+			int srcY2 = y == pDest->m_size.h - 1 ? pSource->m_size.h - 1 : srcY1 + 1;
+
+			uint8_t * pDst = pDest->m_pData + y * pDest->m_pitch;
+
+			for( int x = 0 ; x < pDest->m_size.w ; x++ )
+			{
+				int srcX1 = x * 2;
+				int srcX2 = x == pDest->m_size.w - 1 ? pSource->m_size.w - 1 : srcX1 + 1;
+
+				int sum[4] = { 0, 0, 0, 0 };
+				int nPixels = (srcX2 - srcX1 + 1) * (srcY2 - srcY1 + 1);
+
+				for( int srcY = srcY1 ; srcY <= srcY2 ; srcY++ )
+				{
+					const uint8_t * pSrc = pSource->m_pData + srcY * srcPitch + srcX1 * pixelBytes;
+					for( int srcX = srcX1 ; srcX <= srcX2 ; srcX++ )
+					{
+						if( bAlphaWeighted )
+						{
+							int a = pSrc[3];
+							sum[0] += pSrc[0] * a;
+							sum[1] += pSrc[1] * a;
+							sum[2] += pSrc[2] * a;
+							sum[3] += a;
+						}
+						else
+						{
+							for( int i = 0 ; i < pixelBytes ; i++ )
+								sum[i] += pSrc[i];
+						}
+						pSrc += pixelBytes;
+					}
+				}
+
+				if( bAlphaWeighted )
+				{
+					int alphaSum = sum[3];
+					for( int i = 0 ; i < 3 ; i++ )
+						pDst[i] = alphaSum == 0 ? 0 : (sum[i] + alphaSum / 2) / alphaSum;
+					pDst[3] = (alphaSum + nPixels / 2) / nPixels;
+				}
+				else
+				{
+					for( int i = 0 ; i < pixelBytes ; i++ )
+						pDst[i] = (sum[i] + nPixels / 2) / nPixels;
+				}
+
+				pDst += pixelBytes;
+			}
+		}
+	}
+
+	//____ _clearMipmaps() ________________________________________________________
+
+	void SoftSurface::_clearMipmaps()
+	{
+		if( m_mipmaps.empty() )
+			return;
+
+		m_mipmaps.clear();
+		_updateMemoryUsage();
+	}
+
+	//____ _allocatedBytes() ______________________________________________________
+
+	int64_t SoftSurface::_allocatedBytes() const
+	{
+		int64_t bytes = m_bSharedBlob ? 0 : m_pBlob->size();		// Includes the CLUT.
+		bytes += m_straightData.size();
+
+		for( auto& pMipmap : m_mipmaps )
+			bytes += pMipmap->_allocatedBytes();
+
+		return bytes;
+	}
+
+	//____ _premultiply() _________________________________________________________
+	/*
+		Premultiplies region of the straight alpha copy into our pixels.
+	*/
+
+	void SoftSurface::_premultiply( const Rect& region )
+	{
+		for( int y = region.y ; y < region.y + region.h ; y++ )
+		{
+			const uint8_t * pSrc = m_straightData.data() + y * m_pitch + region.x * 4;
+			uint8_t * pDst = m_pData + y * m_pitch + region.x * 4;
+			for( int x = 0 ; x < region.w ; x++ )
+			{
+				int a = pSrc[3];
+				pDst[0] = ((pSrc[0] * a + 128) * 257) >> 16;
+				pDst[1] = ((pSrc[1] * a + 128) * 257) >> 16;
+				pDst[2] = ((pSrc[2] * a + 128) * 257) >> 16;
+				pDst[3] = a;
+				pSrc += 4;
+				pDst += 4;
+			}
+		}
+	}
+
 } // namespace wg
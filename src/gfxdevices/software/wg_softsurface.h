@@ -65,6 +65,9 @@ namespace wg
 		//.____ Appearance ____________________________________________________
 
 		bool		isOpaque() const;
+
+		bool		setPremultiplied( bool bPremultiplied );
+		bool		isPremultiplied() const { return m_bPremultiplied; }
 	
 		//.____ Content _______________________________________________________
 
@@ -89,10 +92,24 @@ namespace wg
 		SoftSurface( Surface * pOther );
 
 		virtual ~SoftSurface();
+
+		SoftSurface *	_mipmap( int level );
+		void			_generateMipmap( SoftSurface * pSource, SoftSurface * pDest );
+
+		void			_premultiply( const Rect& region );
+		void			_clearMipmaps();
+
+		int64_t			_allocatedBytes() const override;
 		
 		Blob_p		m_pBlob;
 		Size		m_size;
 		uint8_t*	m_pData;
+
+		bool						m_bSharedBlob = false;			// Pixels are in a Blob provided at creation, not allocated by us.
+		bool						m_bMipmapped = false;
+		bool						m_bPremultiplied = false;		// BGRA_8 content is stored premultiplied by alpha.
+		std::vector<uint8_t>		m_straightData;	// Straight alpha copy of content while premultiplied, which is what lock() gives access to.
+		std::vector<SoftSurface_p>	m_mipmaps;		// Level 1 and up, generated when needed and cleared on modification.
 	};
 	
 	
@@ -69,22 +69,46 @@ namespace wg
 	
 	Surface_p SoftSurfaceFactory::createSurface( Size size, PixelFormat format, int hint, const Color * pClut ) const
 	{
-        return SoftSurface::create(size,format,hint,pClut);
+        _reserveMemory(_memoryNeeded(size, format, hint, pClut, false));
+        return _track(SoftSurface::create(size,format,hint,pClut));
 	}
 
 	Surface_p SoftSurfaceFactory::createSurface( Size size, PixelFormat format, Blob * pBlob, int pitch, int hint, const Color * pClut ) const
 	{
-		return SoftSurface::create(size,format, pBlob, pitch, hint, pClut);
+		_reserveMemory(_memoryNeeded(size, format, hint, pClut, true));
+		return _track(SoftSurface::create(size,format, pBlob, pitch, hint, pClut));
 	}
 	
 	Surface_p SoftSurfaceFactory::createSurface( Size size, PixelFormat format, uint8_t * pPixels, int pitch, const PixelDescription * pPixelDescription, int hint, const Color * pClut ) const
 	{
-		return SoftSurface::create(size,format, pPixels, pitch, pPixelDescription, hint, pClut);
+		_reserveMemory(_memoryNeeded(size, format, hint, pClut, false));
+		return _track(SoftSurface::create(size,format, pPixels, pitch, pPixelDescription, hint, pClut));
 	}
 	
 	Surface_p SoftSurfaceFactory::createSurface( Surface * pOther, int hint ) const
 	{
-		return SoftSurface::create( pOther, hint );
+		_reserveMemory(_memoryNeeded(pOther->size(), pOther->pixelFormat(), hint, pOther->clut(), false));
+		return _track(SoftSurface::create( pOther, hint ));
+	}
+
+	//____ _memoryNeeded() __________________________________________________________
+
+	// Pixel lines are padded to a multiple of 4 pixels and a CLUT is copied into 4096 bytes
+	// after the pixels, see SoftSurface constructors. Premultiplied surfaces keep an extra straight
+	// alpha copy of their pixels. Mipmaps are accounted for when generated.
+
+	int64_t SoftSurfaceFactory::_memoryNeeded( Size size, PixelFormat format, int hint, const Color * pClut, bool bSharedPixels ) const
+	{
+		PixelDescription	desc;
+		Util::pixelFormatToDescription( format, desc );
+
+		int64_t pixelBytes = (int64_t) ((size.w+3)&0xFFFFFFFC) * desc.bits/8 * size.h;
+
+		int64_t bytes = bSharedPixels ? 0 : pixelBytes + (pClut ? 4096 : 0);
+		if( (hint & SurfaceHint::Premultiplied) && format == PixelFormat::BGRA_8 )
+			bytes += pixelBytes;
+
+		return bytes;
 	}
 	
 } // namespace wg
@@ -61,6 +61,8 @@ namespace wg
 		
 	protected:
 		virtual ~SoftSurfaceFactory() {}
+
+		int64_t		_memoryNeeded( Size size, PixelFormat format, int hint, const Color * pClut, bool bSharedPixels ) const override;
 	};
 	
 	//========================================================================================
@@ -131,7 +131,7 @@ namespace wg
 	{
 		GfxDevice::setTintColor(color);
 
-		(*m_pStream) << GfxStream::Header{ GfxChunkId::SetTintColor, 2 };
+		(*m_pStream) << GfxStream::Header{ GfxChunkId::SetTintColor, 4 };
 		(*m_pStream) << color;
     }
 
@@ -336,6 +336,89 @@ namespace wg
 		(*m_pStream) << thickness;
 	}
 
+	//____ drawPolyline() ______________________________________________________
+
+	void StreamGfxDevice::drawPolyline( int nPoints, const CoordF * pPoints, Color color, float thickness )
+	{
+		clipDrawPolyline( Rect(0, 0, m_canvasSize), nPoints, pPoints, color, thickness );
+	}
+
+	//____ clipDrawPolyline() __________________________________________________
+
+	void StreamGfxDevice::clipDrawPolyline( const Rect& clip, int nPoints, const CoordF * pPoints, Color color, float thickness )
+	{
+		// First point of each chunk is stored as two floats, the rest as int16_t x, int16_t y deltas
+		// in 1/64 pixels. Steps too long for one delta are split up.
+		// Long lines are split into several chunks, each starting with the last point of the previous one.
+		// A segment needing more steps than fit in what is left of a chunk is continued in the next one.
+
+		if( nPoints < 2 )
+			return;
+
+		int maxChunkDeltas = (int)(GfxStream::c_maxBlockSize - sizeof(GfxStream::Header) - 24) / 4;
+
+		int bufferSize = maxChunkDeltas*4;
+
+		int16_t * pBuffer = reinterpret_cast<int16_t*>(Base::memStackAlloc(bufferSize));
+
+		CoordF	begin = pPoints[0];
+		int		point = 0;
+		while( point < nPoints - 1 )
+		{
+			int16_t * p = pBuffer;
+			int		nDeltas = 0;
+			int		posX = 0, posY = 0;				// Current position relative to begin in 1/64 pixels.
+			bool	bSplitSegment = false;
+
+			while( point < nPoints - 1 )
+			{
+				int dx = (int) floor((pPoints[point+1].x - begin.x)*64 + 0.5f) - posX;
+				int dy = (int) floor((pPoints[point+1].y - begin.y)*64 + 0.5f) - posY;
+
+				int nSteps = max( 1, (max(abs(dx), abs(dy)) + 32766) / 32767 );
+				int nFitting = min( nSteps, maxChunkDeltas - nDeltas );
+				if( nFitting == 0 )
+					break;
+
+				int stepX = 0, stepY = 0;
+				for( int i = 1; i <= nFitting; i++ )
+				{
+					int x = (int) ((int64_t)dx * i / nSteps);
+					int y = (int) ((int64_t)dy * i / nSteps);
+					*p++ = (int16_t) (x - stepX);
+					*p++ = (int16_t) (y - stepY);
+					stepX = x;
+					stepY = y;
+				}
+
+				posX += stepX;
+				posY += stepY;
+				nDeltas += nFitting;
+
+				if( nFitting < nSteps )
+				{
+					bSplitSegment = true;
+					break;
+				}
+				point++;
+			}
+
+			*m_pStream << GfxStream::Header{ GfxChunkId::ClipDrawPolyline, 24 + nDeltas*4 };
+			*m_pStream << clip;
+			*m_pStream << color;
+			*m_pStream << thickness;
+			*m_pStream << begin.x;
+			*m_pStream << begin.y;
+			*m_pStream << GfxStream::DataChunk{ nDeltas*4, pBuffer };
+
+			if( bSplitSegment )
+				begin = CoordF( begin.x + posX / 64.f, begin.y + posY / 64.f );
+			else
+				begin = pPoints[point];
+		}
+
+		Base::memStackRelease(bufferSize);
+	}
 
 	//____ clipDrawHorrWave() _____________________________________________________
 
@@ -343,6 +426,44 @@ namespace wg
 	{
 		// Need some smart optimizations here, so we don't send wave-values far outside clip or length.
 	}
+
+	//____ clipDrawSegments() _____________________________________________________
+
+	void StreamGfxDevice::clipDrawSegments(const Rect& clip, const Rect& dest, int nEdgeStrips, const int * pEdgeStrips, const Color * pSegmentColors)
+	{
+		// Colors of all segments are followed by the edge strips of the columns, as int32_t in 24.8 format.
+		// Only columns inside clip are sent. Wide areas are split into several chunks, each covering a
+		// range of columns and repeating the colors.
+
+		Rect area(clip, dest);
+		if (area.w <= 0 || area.h <= 0 || nEdgeStrips < 0)
+			return;
+
+		int nSegments = nEdgeStrips + 1;
+		int spaceForEdges = (int)(GfxStream::c_maxBlockSize - sizeof(GfxStream::Header)) - 18 - nSegments * 4;
+		int maxChunkColumns = nEdgeStrips == 0 ? area.w : spaceForEdges / (nEdgeStrips * 4) - 1;
+
+		if (maxChunkColumns < 1)
+			return;													// Too many edges for a single column to fit in a chunk.
+
+		int column = area.x - dest.x;
+		int columnEnd = column + area.w;
+
+		while (column < columnEnd)
+		{
+			int nColumns = min(columnEnd - column, maxChunkColumns);
+			int edgeBytes = (nColumns + 1) * nEdgeStrips * 4;
+
+			*m_pStream << GfxStream::Header{ GfxChunkId::ClipDrawSegments, 18 + nSegments * 4 + edgeBytes };
+			*m_pStream << area;
+			*m_pStream << Rect(dest.x + column, dest.y, nColumns, dest.h);
+			*m_pStream << (uint16_t)nEdgeStrips;
+			*m_pStream << GfxStream::DataChunk{ nSegments * 4, pSegmentColors };
+			*m_pStream << GfxStream::DataChunk{ edgeBytes, pEdgeStrips + column * nEdgeStrips };
+
+			column += nColumns;
+		}
+	}
 	
 	
 	
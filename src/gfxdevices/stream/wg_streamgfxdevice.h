@@ -78,7 +78,11 @@ namespace wg
 		void	clipDrawLine( const Rect& clip, Coord begin, Coord end, Color color, float thickness = 1.f ) override;
 		void	clipDrawLine(const Rect& clip, Coord begin, Direction dir, int length, Color col, float thickness = 1.f) override;
 
+		void	drawPolyline( int nPoints, const CoordF * pPoints, Color color, float thickness = 1.f ) override;
+		void	clipDrawPolyline( const Rect& clip, int nPoints, const CoordF * pPoints, Color color, float thickness = 1.f ) override;
+
 		void	clipDrawHorrWave(const Rect&clip, Coord begin, int length, const WaveLine* topLine, const WaveLine* bottomLine, Color front, Color back);
+		void	clipDrawSegments(const Rect& clip, const Rect& dest, int nEdgeStrips, const int * pEdgeStrips, const Color * pSegmentColors);
 
 
 		void	blit( Surface * src, const Rect& srcrect, Coord dest  ) override;
@@ -135,6 +135,7 @@ namespace wg
 		else
 		{
 			m_pBlob = pBlob;
+			m_bSharedBlob = true;
 			m_pClut = const_cast<Color*>(pClut);
 			m_pAlphaLayer = nullptr;
 		}
@@ -177,7 +178,7 @@ namespace wg
 
 			if (pClut)
 			{
-				m_pClut = (Color*)((uint8_t)m_pBlob->data() + m_pitch * size.h);
+				m_pClut = (Color*)((uint8_t*)m_pBlob->data() + m_pitch * size.h);
 				memcpy(m_pClut, pClut, 4096);
 			}
 			else
@@ -219,7 +220,7 @@ namespace wg
 
 			if (pOther->clut())
 			{
-				m_pClut = (Color*)((uint8_t)m_pBlob->data() + m_pitch * m_size.h);
+				m_pClut = (Color*)((uint8_t*)m_pBlob->data() + m_pitch * m_size.h);
 				memcpy(m_pClut, pOther->clut(), 4096);
 			}
 			else
@@ -331,7 +332,7 @@ namespace wg
 		if (!m_pBlob && mode != AccessMode::WriteOnly)
 			return 0;
 
-		if( region.x + region.w > m_size.w || region.y + region.w > m_size.h || region.x < 0 || region.y < 0 )
+		if( region.x + region.w > m_size.w || region.y + region.h > m_size.h || region.x < 0 || region.y < 0 )
 			return 0;
 
 		if( m_pBlob )
@@ -426,7 +427,7 @@ namespace wg
 	{
 		// Stream the call
 
-		*m_pStream << GfxStream::Header{ GfxChunkId::CreateSurface, 14 };
+		*m_pStream << GfxStream::Header{ GfxChunkId::FillSurface, 14 };
 		*m_pStream << m_inStreamId;
 		*m_pStream << region;
 		*m_pStream << col;
@@ -597,6 +598,18 @@ namespace wg
 		return pAlphaLayer;
 	}
 
+	//____ _allocatedBytes() ______________________________________________________
+
+	int64_t StreamSurface::_allocatedBytes() const
+	{
+		int64_t bytes = m_pBlob && !m_bSharedBlob ? m_pBlob->size() : 0;		// Includes the CLUT.
+
+		if( m_pAlphaLayer )
+			bytes += m_size.w * m_size.h;
+
+		return bytes;
+	}
+
 	//____ _sendPixels() _________________________________________________________
 
 	void StreamSurface::_sendPixels(Rect rect, const uint8_t * pSource, int pitch)
@@ -102,10 +102,13 @@ namespace wg
 		void		_sendDeleteSurface();
 		uint8_t*	_genAlphaLayer(const char * pSource, int pitch);
 
+		int64_t		_allocatedBytes() const override;
+
 		GfxOutStream_p	m_pStream;
 		short			m_inStreamId;		// Id of this surface in the stream.
 
         Blob_p			m_pBlob;			
+		bool			m_bSharedBlob = false;	// m_pBlob was provided at creation, not allocated by us.
 		uint8_t*		m_pAlphaLayer;		// Separate alpha layer if whole blob was not kept.
 
 		Size			m_size;				// Width and height in pixels.
@@ -78,23 +78,46 @@ namespace wg
 
 	Surface_p StreamSurfaceFactory::createSurface( Size size, PixelFormat format, int hint, const Color * pClut ) const
 	{
-        return StreamSurface::create(m_pStream,size,format,hint,pClut);
+        _reserveMemory(_memoryNeeded(size, format, hint, pClut, false));
+        return _track(StreamSurface::create(m_pStream,size,format,hint,pClut));
 	}
 
 
 	Surface_p StreamSurfaceFactory::createSurface( Size size, PixelFormat format, Blob * pBlob, int pitch, int hint, const Color * pClut ) const
 	{
-		return StreamSurface::create(m_pStream,size,format, pBlob,pitch,hint,pClut);
+		_reserveMemory(_memoryNeeded(size, format, hint, pClut, true));
+		return _track(StreamSurface::create(m_pStream,size,format, pBlob,pitch,hint,pClut));
 	}
 	
 	Surface_p StreamSurfaceFactory::createSurface( Size size, PixelFormat format, uint8_t * pPixels, int pitch, const PixelDescription * pPixelDescription, int hint, const Color * pClut ) const
 	{
-		return StreamSurface::create(m_pStream,size,format, pPixels, pitch, pPixelDescription,hint,pClut);
+		_reserveMemory(_memoryNeeded(size, format, hint, pClut, false));
+		return _track(StreamSurface::create(m_pStream,size,format, pPixels, pitch, pPixelDescription,hint,pClut));
 	}
 	
 	Surface_p StreamSurfaceFactory::createSurface( Surface * pOther, int hint ) const
 	{
-		return StreamSurface::create(m_pStream,pOther,hint );
+		_reserveMemory(_memoryNeeded(pOther->size(), pOther->pixelFormat(), hint, pOther->clut(), false));
+		return _track(StreamSurface::create(m_pStream,pOther,hint ));
+	}
+
+	//____ _memoryNeeded() __________________________________________________________
+
+	// WriteOnly surfaces of more than 8 bits only keep an alpha layer of one byte per pixel,
+	// if they have alpha. Others keep a copy of their pixels, padded like SoftSurface, and CLUT.
+
+	int64_t StreamSurfaceFactory::_memoryNeeded( Size size, PixelFormat format, int hint, const Color * pClut, bool bSharedPixels ) const
+	{
+		PixelDescription	desc;
+		Util::pixelFormatToDescription( format, desc );
+
+		if( desc.bits > 8 && (hint & SurfaceHint::WriteOnly) )
+			return desc.A_bits > 0 ? (int64_t) size.w * size.h : 0;
+
+		if( bSharedPixels )
+			return 0;
+
+		return (int64_t) ((size.w+3)&0xFFFFFFFC) * desc.bits/8 * size.h + (pClut ? 4096 : 0);
 	}
 
 
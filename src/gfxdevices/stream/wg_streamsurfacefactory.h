@@ -63,6 +63,8 @@ namespace wg
 	protected:
 		StreamSurfaceFactory( GfxOutStream * pStream);
 
+		int64_t		_memoryNeeded( Size size, PixelFormat format, int hint, const Color * pClut, bool bSharedPixels ) const override;
+
 
 		GfxOutStream_p	m_pStream;
 	};
@@ -211,7 +211,7 @@ namespace wg
 
 	Size ModSurface::size() const 
 	{ 
-		return m_pItem->m_pSurface ? m_pItem->m_pSurface->size() : m_pItem->m_fixedSize; 
+		return m_pItem->backSurface() ? m_pItem->backSurface()->size() : m_pItem->m_fixedSize; 
 	}
 
 	//____ setBackColor() _____________________________________________________
@@ -301,6 +301,49 @@ namespace wg
 		return m_pItem->m_origo; 
 	}
 
+	//____ setBufferCount() ___________________________________________________
+	/**
+	*	@brief	Sets number of surfaces used for double or triple buffering.
+	*
+	*	@param	nBuffers	1 (default) for a single surface, 2 for double buffering or 3 for
+	*						triple buffering.
+	*
+	*	With a single surface, the surface you draw onto is also the one being displayed.
+	*
+	*	With double or triple buffering you draw onto a back buffer while a front buffer is
+	*	being displayed. The call to present() makes the back buffer the displayed one and hands
+	*	you an older buffer to continue drawing on, which is the one returned by surface() and used
+	*	as canvas by the GfxDevice set for this ModSurface. Therefore you should
+	*	not keep pointers to the surface between frames.
+	*
+	*	With triple buffering, drawing and the calls to present() may be done from a thread
+	*	other than the one updating and rendering the GUI. The latest presented frame is picked up by
+	*	the next update of the GUI, while the producer can immediately continue with the next frame.
+	*	Changing any other property of the ModSurface while the producer thread is running is
+	*	not allowed.
+	*
+	*	Changing the number of buffers will discard and recreate the surfaces.
+	*
+	*	@return False if nBuffers is out of range.
+	**/
+
+	bool ModSurface::setBufferCount(int nBuffers)
+	{
+		return m_pItem->setBufferCount(nBuffers);
+	}
+
+	//____ bufferCount() ______________________________________________________
+	/**
+	*	@brief	Gets the number of surfaces used for buffering.
+	*
+	*	@return	1, 2 or 3.
+	**/
+
+	int ModSurface::bufferCount() const
+	{
+		return m_pItem->m_nBuffers;
+	}
+
 	//____ present() ____________________________________________________________
 	/**
 	*	@brief	Redraw the component with the content of the surface.
@@ -311,6 +354,10 @@ namespace wg
 	*	If only parts of the surface has been changed, you can use one or several calls to
 	*	present(Rect) instead to increase performance.
 	*
+	*	When double or triple buffered, the surface is swapped for another one without any
+	*	pixels being copied. The content of the new surface is undefined and needs to be
+	*	redrawn completely.
+	*
 	**/
 
 	void ModSurface::present()
@@ -326,6 +373,10 @@ namespace wg
 	*	Marks the area of the component displaying the specified part of the surface as dirty,
 	*	forcing a redraw with the content of the surface during its next render update.
 	*
+	*	When double or triple buffered, the surface is swapped for another one, onto which the
+	*	areas it is missing from the presented frame are copied. The new surface is therefore
+	*	identical to the presented one and you only need to redraw what changes.
+	*
 	**/
 	void ModSurface::present(Rect area)
 	{ 
@@ -336,7 +387,8 @@ namespace wg
 	/**
 	*	@brief	Gets a weakpointer to the surface
 	*
-	*	Gets a pointer to the Surface presented by this component. Please note
+	*	Gets a pointer to the Surface to draw on. Unless double or triple buffered, this
+	*	is also the Surface presented by this component. Please note
 	*	that the pointer returned is a weakpointer and will turn to null when
 	*	the surface is discared by ModSurface.
 	*
@@ -349,7 +401,7 @@ namespace wg
 
 	Surface_wp ModSurface::surface() const 
 	{ 
-		return m_pItem->m_pSurface.rawPtr(); 
+		return m_pItem->backSurface(); 
 	}
 
 } // namespace wg
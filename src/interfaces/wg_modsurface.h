@@ -50,6 +50,10 @@ namespace wg
 	* The size of the surface can be specified. If it is not specified, it will have the same size
 	* as the ModSurface component and be replaced each time the size of the component is changed.
 	*
+	* For continuously updated content, such as video or plots, the ModSurface can be double or
+	* triple buffered through setBufferCount(), in which case present() swaps surfaces instead of
+	* drawing on the one being displayed. Triple buffering allows drawing from a separate thread.
+	*
 	**/
 
 
@@ -85,6 +89,9 @@ namespace wg
 		void			setOrigo(Origo origo);
 		Origo			origo() const;
 
+		bool			setBufferCount(int nBuffers);
+		int				bufferCount() const;
+
 		void			present();
 		void			present(Rect area);
 
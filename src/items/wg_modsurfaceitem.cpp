@@ -28,6 +28,7 @@ namespace wg
 	ModSurfaceItem::ModSurfaceItem(ItemHolder * pHolder, ModSurface * pInterface) : Item(pHolder)
 	{
 		m_pInterface = pInterface;
+		m_bFramePending = false;
 	}
 
 
@@ -39,7 +40,7 @@ namespace wg
 	
 		Rect canvas = calcPresentationArea() + _canvas.pos();
 
-		pDevice->clipStretchBlit(Rect(canvas, _clip), m_pSurface, canvas);
+		pDevice->clipStretchBlit(Rect(canvas, _clip), m_buffers[m_frontBuffer], canvas);
 	}
 
 	//____ alphaTest() _______________________________________________________
@@ -47,9 +48,9 @@ namespace wg
 	bool ModSurfaceItem::alphaTest(const Coord& ofs, int markOpacity)
 	{
 		Rect canvas = calcPresentationArea();
-		Size bmpSize = m_pSurface->size();
+		Size bmpSize = m_buffers[m_frontBuffer]->size();
 
-		return Util::markTestStretchRect(ofs, m_pSurface, bmpSize, canvas, markOpacity);
+		return Util::markTestStretchRect(ofs, m_buffers[m_frontBuffer], bmpSize, canvas, markOpacity);
 	}
 
 
@@ -65,13 +66,33 @@ namespace wg
 		if (sz.w == 0 && sz.h == 0)
 			sz = _size();
 
-		bool bSurfaceLost = m_pSurface;
+		bool bSurfaceLost = m_buffers[0];
 
 		SurfaceFactory * pFactory = m_pFactory ? m_pFactory : m_pDevice->surfaceFactory();
-		m_pSurface = pFactory->createSurface(sz, m_pixelFormat);
-		m_pSurface->fill(m_backColor);
 
-		m_pDevice->setCanvas(m_pSurface);
+		std::lock_guard<std::mutex> lock(m_presentMutex);
+
+		for (int i = 0; i < 3; i++)
+		{
+			if (i < m_nBuffers)
+			{
+				m_buffers[i] = pFactory->createSurface(sz, m_pixelFormat);
+				m_buffers[i]->setCreator("ModSurface");
+				m_buffers[i]->fill(m_backColor);
+			}
+			else
+				m_buffers[i] = nullptr;
+
+			m_missingArea[i] = Rect();
+		}
+
+		m_backBuffer = 0;
+		m_frontBuffer = m_nBuffers > 1 ? 1 : 0;
+		m_spareBuffer = m_nBuffers > 2 ? 2 : m_frontBuffer;
+		m_bFramePending = false;
+		m_pendingArea = Rect();
+
+		m_pDevice->setCanvas(m_buffers[m_backBuffer]);
 
 		if (m_surfaceLostCallback != nullptr)
 			m_surfaceLostCallback(m_pInterface);
@@ -82,7 +103,7 @@ namespace wg
 	Rect ModSurfaceItem::calcPresentationArea() const
 	{
 		Size window = _size();
-		Size bitmapSize = m_pSurface->size();
+		Size bitmapSize = m_buffers[m_frontBuffer]->size();
 
 		switch (m_presentationScaling)
 		{
@@ -186,8 +207,8 @@ namespace wg
 
 	void ModSurfaceItem::clear()
 	{
-		if (m_pSurface)
-			m_pSurface->fill(m_backColor);
+		if (m_buffers[m_backBuffer])
+			m_buffers[m_backBuffer]->fill(m_backColor);
 	}
 
 	//____ setPresentationScaling() ____________________________________
@@ -226,26 +247,137 @@ namespace wg
 		}
 	}
 
+	//____ setBufferCount() ___________________________________________
+
+	bool ModSurfaceItem::setBufferCount(int nBuffers)
+	{
+		if (nBuffers < 1 || nBuffers > 3)
+			return false;
+
+		if (nBuffers != m_nBuffers)
+		{
+			m_nBuffers = nBuffers;
+			regenSurface();
+			_notify(ItemNotif::BufferingChanged, nullptr);
+		}
+		return true;
+	}
+
 	//____ present() ___________________________________________________
 
 	void ModSurfaceItem::present()
 	{
-		_requestRender(calcPresentationArea());
+		if (!m_buffers[m_backBuffer])
+			return;
+
+		if (m_nBuffers == 1)
+		{
+			_requestRender(calcPresentationArea());
+			return;
+		}
+
+		_swapBuffers(Rect(0, 0, m_buffers[m_backBuffer]->size()), false);
+
+		if (m_nBuffers == 2)
+			_requestRender(calcPresentationArea());
 	}
 
 	void ModSurfaceItem::present(Rect area)
 	{
-		Rect dest = calcPresentationArea();
-		Size bitmapSize = m_pSurface->size();
+		if (!m_buffers[m_backBuffer])
+			return;
+
+		if (m_nBuffers == 1)
+		{
+			_requestRender(_surfaceToItemArea(area));
+			return;
+		}
+
+		_swapBuffers(area, true);
 
-		int x1 = area.x * dest.w / bitmapSize.w;
-		int x2 = (area.x + area.w) * dest.w / bitmapSize.w + 1;
-		int y1 = area.y * dest.h / bitmapSize.h;
-		int y2 = (area.y + area.h) * dest.h / bitmapSize.h + 1;
+		if (m_nBuffers == 2)
+			_requestRender(_surfaceToItemArea(area));
+	}
+
+	//____ update() ____________________________________________________
+	/*
+		Called from the UI thread when triple buffering. Displays the latest
+		frame presented by the producer, if any.
+	*/
+
+	void ModSurfaceItem::update()
+	{
+		if (!m_bFramePending)
+			return;
+
+		Rect area;
+		{
+			std::lock_guard<std::mutex> lock(m_presentMutex);
+
+			std::swap(m_frontBuffer, m_spareBuffer);
+			area = m_pendingArea;
+			m_pendingArea = Rect();
+			m_bFramePending = false;
+		}
+
+		_requestRender(_surfaceToItemArea(area));
+	}
+
+	//____ _swapBuffers() ______________________________________________
+	/*
+		Makes the back buffer the newly presented frame and a buffer with
+		an older frame the new back buffer. Only the areas that the new back
+		buffer is missing are copied from the presented frame, which for
+		bKeepContent == false is nothing at all.
+	*/
+
+	void ModSurfaceItem::_swapBuffers(const Rect& area, bool bKeepContent)
+	{
+		std::lock_guard<std::mutex> lock(m_presentMutex);
+
+		for (int i = 0; i < m_nBuffers; i++)
+		{
+			if (i != m_backBuffer)
+				m_missingArea[i] = m_missingArea[i].isEmpty() ? area : Rect::getUnion(m_missingArea[i], area);
+		}
+
+		int presented = m_backBuffer;
+
+		if (m_nBuffers == 2)
+		{
+			m_backBuffer = m_frontBuffer;
+			m_frontBuffer = presented;
+		}
+		else
+		{
+			m_backBuffer = m_spareBuffer;
+			m_spareBuffer = presented;
+
+			m_pendingArea = m_pendingArea.isEmpty() ? area : Rect::getUnion(m_pendingArea, area);
+			m_bFramePending = true;
+		}
+
+		Rect& missing = m_missingArea[m_backBuffer];
+		if (bKeepContent && !missing.isEmpty())
+			m_buffers[m_backBuffer]->copyFrom(m_buffers[presented], missing, missing.pos());
+		missing = Rect();
+
+		m_pDevice->setCanvas(m_buffers[m_backBuffer]);
+	}
+
+	//____ _surfaceToItemArea() ________________________________________
+
+	Rect ModSurfaceItem::_surfaceToItemArea(const Rect& area) const
+	{
+		Rect dest = calcPresentationArea();
+		Size bitmapSize = m_buffers[m_frontBuffer]->size();
 
-		Rect a2 = Rect::getUnion(dest, { x1,y1,x2 - x1,y2 - y1 });
+		int x1 = dest.x + area.x * dest.w / bitmapSize.w;
+		int x2 = dest.x + (area.x + area.w) * dest.w / bitmapSize.w + 1;
+		int y1 = dest.y + area.y * dest.h / bitmapSize.h;
+		int y2 = dest.y + (area.y + area.h) * dest.h / bitmapSize.h + 1;
 
-		_requestRender(a2);
+		return Rect(dest, { x1,y1,x2 - x1,y2 - y1 });
 	}
 
 	//____ preferredSize() ____________________________________________________
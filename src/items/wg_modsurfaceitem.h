@@ -24,6 +24,8 @@
 #pragma once
 
 #include <functional>
+#include <mutex>
+#include <atomic>
 
 #include <wg_types.h>
 #include <wg_item.h>
@@ -67,15 +69,32 @@ namespace wg
 		void			clear();
 		void			setPresentationScaling(SizePolicy2D policy);
 		void			setOrigo(Origo origo);
+		bool			setBufferCount(int nBuffers);
 		void			present();
 		void			present(Rect area);
+		void			update();
 		Size			preferredSize() const;
 
+		inline Surface *	backSurface() const { return m_buffers[m_backBuffer]; }
+		inline Surface *	frontSurface() const { return m_buffers[m_frontBuffer]; }
 
 	protected:
+		void			_swapBuffers(const Rect& area, bool bKeepContent);
+		Rect			_surfaceToItemArea(const Rect& area) const;
+
 		GfxDevice_p		m_pDevice;
 		SurfaceFactory_p m_pFactory;
-		Surface_p		m_pSurface;
+
+		Surface_p		m_buffers[3];
+		Rect			m_missingArea[3];					// Area of each buffer that is older than last presented frame.
+		int				m_nBuffers					= 1;
+		int				m_backBuffer				= 0;	// Buffer drawn into by the producer.
+		int				m_frontBuffer				= 0;	// Buffer displayed by render().
+		int				m_spareBuffer				= 0;	// Third buffer when triple buffering, holds any pending frame.
+
+		std::mutex		m_presentMutex;
+		std::atomic<bool> m_bFramePending;				// Triple buffering: spare buffer holds a frame not yet displayed.
+		Rect			m_pendingArea;					// Triple buffering: area of pending frame(s) not yet rendered.
 		Size			m_fixedSize;
 		PixelFormat		m_pixelFormat				= PixelFormat::BGR_8;
 		SizePolicy2D	m_presentationScaling	= SizePolicy2D::Original;
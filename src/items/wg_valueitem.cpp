@@ -121,10 +121,61 @@ namespace wg
 	void ValueItem::_regenText()
 	{
 		ValueFormatter * pFormatter = m_pFormatter ? m_pFormatter.rawPtr() : Base::defaultValueFormatter().rawPtr();
+		if( !pFormatter )
+			return;
 
-		if( m_pFormatter )
-			m_charBuffer = pFormatter->format(m_value, m_scale);
-		_requestRender();
+		pFormatter->formatInto( m_formatBuffer, m_value, m_scale );
+
+		int oldLen = m_charBuffer.length();
+		int newLen = m_formatBuffer.length();
+		const Char * pNew = m_formatBuffer.chars();
+
+		// If only digits have changed we copy them in place and let the textmapper
+		// decide if layout needs to be updated.
+
+		if( oldLen == newLen )
+		{
+			const Char * pOld = m_charBuffer.chars();
+
+			int		beg = -1;
+			int		end = 0;
+			bool	bOnlyDigits = true;
+
+			for( int i = 0 ; i < newLen ; i++ )
+			{
+				if( !pOld[i].equals(pNew[i]) )
+				{
+					if( pOld[i].styleHandle() != pNew[i].styleHandle() || pOld[i].code() < '0' || pOld[i].code() > '9' ||
+						pNew[i].code() < '0' || pNew[i].code() > '9' )
+					{
+						bOnlyDigits = false;
+						break;
+					}
+
+					if( beg == -1 )
+						beg = i;
+					end = i+1;
+				}
+			}
+
+			if( bOnlyDigits )
+			{
+				if( beg == -1 )
+					return;									// Nothing has changed.
+
+				Char * pWrite = m_charBuffer.beginWrite();
+				for( int i = beg ; i < end ; i++ )
+					pWrite[i].setCode( pNew[i].code() );
+				m_charBuffer.endWrite();
+
+				_textMapper()->onDigitsModified( this, beg, end - beg );
+				return;
+			}
+		}
+
+		m_charBuffer.clear();
+		m_charBuffer.pushBack( pNew, newLen );
+		_textMapper()->onTextModified( this, 0, oldLen, newLen );
 		
 		//TODO: Conditional call to _requestResize();
 	}
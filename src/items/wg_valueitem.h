@@ -54,6 +54,7 @@ namespace wg
 		int					m_scale;
 		
 		ValueFormatter_p	m_pFormatter;
+		CharBuffer			m_formatBuffer;			// Reused between calls to _regenText() to avoid allocations.
 	};
 	
 	
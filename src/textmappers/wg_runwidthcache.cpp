@@ -0,0 +1,162 @@
+/*=========================================================================
+
+                         >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+#include <wg_runwidthcache.h>
+#include <wg_char.h>
+
+namespace wg 
+{
+
+	//____ Constructor ____________________________________________________________
+
+	RunWidthCache::RunWidthCache( int capacity )
+	{
+		m_capacity = capacity > 0 ? capacity : 1;
+		m_first = -1;
+		m_last = -1;
+	}
+
+	//____ find() _________________________________________________________________
+	/**
+	 * @brief Look up width of a run.
+	 *
+	 * @return Width in pixels or -1 if run isn't cached.
+	 */
+
+	int RunWidthCache::find( uint32_t fontSerial, int fontSize, uint64_t hash, int length )
+	{
+		auto it = m_index.find( _key( fontSerial, fontSize, hash, length ) );
+		if( it == m_index.end() )
+			return -1;
+
+		Entry& entry = m_entries[it->second];
+		if( entry.hash != hash || entry.fontSerial != fontSerial || entry.fontSize != fontSize || entry.length != length )
+			return -1;
+
+		if( it->second != m_first )
+		{
+			_unlink( it->second );
+			_linkFirst( it->second );
+		}
+		return entry.width;
+	}
+
+	//____ add() __________________________________________________________________
+
+	void RunWidthCache::add( uint32_t fontSerial, int fontSize, uint64_t hash, int length, int width )
+	{
+		uint64_t key = _key( fontSerial, fontSize, hash, length );
+
+		int index;
+		auto it = m_index.find( key );
+		if( it != m_index.end() )
+		{
+			index = it->second;							// Same key, replace entry.
+			_unlink( index );
+		}
+		else if( (int) m_entries.size() < m_capacity )
+		{
+			index = (int) m_entries.size();
+			m_entries.emplace_back();
+			m_index[key] = index;
+		}
+		else
+		{
+			index = m_last;								// Recycle least recently used entry.
+			_unlink( index );
+			m_index.erase( m_entries[index].key );
+			m_index[key] = index;
+		}
+
+		Entry& entry = m_entries[index];
+		entry.key = key;
+		entry.hash = hash;
+		entry.fontSerial = fontSerial;
+		entry.fontSize = fontSize;
+		entry.length = length;
+		entry.width = width;
+
+		_linkFirst( index );
+	}
+
+	//____ clear() ________________________________________________________________
+
+	void RunWidthCache::clear()
+	{
+		m_entries.clear();
+		m_index.clear();
+		m_first = -1;
+		m_last = -1;
+	}
+
+	//____ hashRun() ______________________________________________________________
+	/**
+	 * @brief Calculate hash of the character codes in a run, excluding pEnd.
+	 */
+
+	uint64_t RunWidthCache::hashRun( const Char * pBeg, const Char * pEnd )
+	{
+		uint64_t hash = 0xCBF29CE484222325ULL;				// FNV-1a
+
+		for( const Char * p = pBeg ; p < pEnd ; p++ )
+		{
+			hash ^= p->code();
+			hash *= 0x100000001B3ULL;
+		}
+		return hash;
+	}
+
+	//____ _unlink() ______________________________________________________________
+
+	void RunWidthCache::_unlink( int index )
+	{
+		Entry& entry = m_entries[index];
+
+		if( entry.prev >= 0 )
+			m_entries[entry.prev].next = entry.next;
+		else
+			m_first = entry.next;
+
+		if( entry.next >= 0 )
+			m_entries[entry.next].prev = entry.prev;
+		else
+			m_last = entry.prev;
+	}
+
+	//____ _linkFirst() ___________________________________________________________
+
+	void RunWidthCache::_linkFirst( int index )
+	{
+		Entry& entry = m_entries[index];
+
+		entry.prev = -1;
+		entry.next = m_first;
+
+		if( m_first >= 0 )
+			m_entries[m_first].prev = index;
+		else
+			m_last = index;
+
+		m_first = index;
+	}
+
+} // namespace wg
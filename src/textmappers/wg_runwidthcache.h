@@ -0,0 +1,87 @@
+/*=========================================================================
+
+                         >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+#ifndef	WG_RUNWIDTHCACHE_DOT_H
+#define WG_RUNWIDTHCACHE_DOT_H
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+
+#include <wg_types.h>
+
+namespace wg 
+{
+	class Char;
+
+	//____ RunWidthCache __________________________________________________________
+	/**
+	 * @brief LRU cache of measured widths for runs of unstyled characters.
+	 *
+	 * Widths are keyed on font, font size and a hash of the character codes, so that
+	 * identical labels shown by many widgets only need to be measured once.
+	 */
+
+	class RunWidthCache		/** @private */
+	{
+	public:
+		RunWidthCache( int capacity );
+
+		int				find( uint32_t fontSerial, int fontSize, uint64_t hash, int length );
+		void			add( uint32_t fontSerial, int fontSize, uint64_t hash, int length, int width );
+		void			clear();
+
+		inline int		size() const { return (int) m_index.size(); }
+		inline int		capacity() const { return m_capacity; }
+
+		static uint64_t	hashRun( const Char * pBeg, const Char * pEnd );
+
+	private:
+
+		struct Entry
+		{
+			uint64_t	key;
+			uint64_t	hash;
+			uint32_t	fontSerial;
+			int			fontSize;
+			int			length;
+			int			width;
+			int			prev;				// Towards most recently used.
+			int			next;				// Towards least recently used.
+		};
+
+		static inline uint64_t	_key( uint32_t fontSerial, int fontSize, uint64_t hash, int length ) 
+		{ 
+			return hash ^ (((uint64_t) fontSerial << 32) | ((uint64_t)(fontSize & 0xFFFF) << 16) | (uint64_t)(length & 0xFFFF)) * 0x9E3779B97F4A7C15ULL; 
+		}
+
+		void			_unlink( int index );
+		void			_linkFirst( int index );
+
+		int								m_capacity;
+		int								m_first;		// Most recently used.
+		int								m_last;			// Least recently used.
+		std::vector<Entry>				m_entries;
+		std::unordered_map<uint64_t,int>	m_index;
+	};
+
+} // namespace wg
+#endif //WG_RUNWIDTHCACHE_DOT_H
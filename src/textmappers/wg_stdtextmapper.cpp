@@ -26,6 +26,8 @@
 #include <wg_gfxdevice.h>
 #include <wg_char.h>
 #include <wg_msgrouter.h>
+#include <wg_tickscheduler.h>
+#include <wg_runwidthcache.h>
 
 #include <stdlib.h>
 #include <algorithm>
@@ -34,11 +36,13 @@ namespace wg
 {
 	
 	const char StdTextMapper::CLASSNAME[] = {"StdTextMapper"};
+
+	RunWidthCache StdTextMapper::s_runWidthCache( StdTextMapper::c_runWidthCacheSize );
 	
 	//____ Constructor _____________________________________________________________
 	
 	StdTextMapper::StdTextMapper() : m_alignment(Origo::NorthWest), m_bLineWrap(false), m_selectionBackColor(Color::White), m_selectionBackRenderMode(BlendMode::Invert),
-		m_selectionCharColor(Color::White), m_selectionCharBlend(BlendMode::Invert), m_pFocusedItem(nullptr), m_tickRouteId(0)
+		m_selectionCharColor(Color::White), m_selectionCharBlend(BlendMode::Invert), m_pFocusedItem(nullptr), m_tickerId(0), m_digitFontSize(0), m_bFixedWidthDigits(false)
 	{
 	}
 	
@@ -46,10 +50,10 @@ namespace wg
 	
 	StdTextMapper::~StdTextMapper()
 	{
-		if( m_tickRouteId )
+		if( m_tickerId )
 		{
-			Base::msgRouter()->deleteRoute( m_tickRouteId );
-			m_tickRouteId = 0;
+			Base::tickScheduler()->removeTicker( m_tickerId );
+			m_tickerId = 0;
 		}
 	}
 	
@@ -104,8 +108,8 @@ namespace wg
 		if( pItem == m_pFocusedItem )
 		{
 			m_pFocusedItem = 0;
-			Base::msgRouter()->deleteRoute( m_tickRouteId );
-			m_tickRouteId = 0;			
+			Base::tickScheduler()->removeTicker( m_tickerId );
+			m_tickerId = 0;			
 		}	
 	}
 	
@@ -304,6 +308,56 @@ namespace wg
 	}
 
 
+	//____ _hasFixedWidthDigits() _______________________________________________
+
+	bool StdTextMapper::_hasFixedWidthDigits( Font * pFont, int size ) const
+	{
+		if( pFont == m_pDigitFont.rawPtr() && size == m_digitFontSize )
+			return m_bFixedWidthDigits;
+
+		m_pDigitFont = pFont;
+		m_digitFontSize = size;
+		m_bFixedWidthDigits = false;
+
+		pFont->setSize(size);
+
+		Glyph_p	digits[10];
+		for( int i = 0 ; i < 10 ; i++ )
+		{
+			digits[i] = _getGlyph( pFont, '0' + i );
+			if( !digits[i] || digits[i]->advance() != digits[0]->advance() )
+				return false;
+		}
+
+		for( int i = 0 ; i < 10 ; i++ )
+			for( int j = 0 ; j < 10 ; j++ )
+				if( pFont->kerning( digits[i], digits[j] ) != 0 )
+					return false;
+
+		m_bFixedWidthDigits = true;
+		return true;
+	}
+
+	//____ _isKerningFreeNeighbour() ______________________________________________
+
+	bool StdTextMapper::_isKerningFreeNeighbour( Font * pFont, const Char& neighbour ) const
+	{
+		if( neighbour.styleHandle() != 0 )
+			return false;
+
+		Glyph_p pNeighbour = _getGlyph( pFont, neighbour.code() );
+		if( !pNeighbour )
+			return true;
+
+		for( int i = 0 ; i < 10 ; i++ )
+		{
+			Glyph_p pDigit = _getGlyph( pFont, '0' + i );
+			if( pFont->kerning( pDigit, pNeighbour ) != 0 || pFont->kerning( pNeighbour, pDigit ) != 0 )
+				return false;
+		}
+		return true;
+	}
+
 	//____ _charDistance() _____________________________________________________
 
 	// Returns distance in pixels between beginning of first and beginning of last char.
@@ -380,6 +434,8 @@ namespace wg
 				{
 					_setItemDirty( m_pFocusedItem, pCaret->dirtyRect(charRect(m_pFocusedItem, pEditState->caretOfs)) );
 				}
+
+				Base::tickScheduler()->setNextTick( m_tickerId, pCaret->nextChange() );
 			}		
 		}
 	}
@@ -669,6 +725,9 @@ namespace wg
 		{
 			bool bDirty = pCaret->restartCycle();
 
+			if( m_tickerId )
+				Base::tickScheduler()->setNextTick( m_tickerId, pCaret->nextChange() );
+
 			if( bDirty || pEditState->caretOfs != ofs )
 			{
 				_setItemDirty( pText, pCaret->dirtyRect( charRect(pText, ofs) ));
@@ -708,6 +767,9 @@ namespace wg
 			if( pEditState->bCaret && pCaret )
 			{
 				pCaret->restartCycle();
+				if( m_tickerId )
+					Base::tickScheduler()->setNextTick( m_tickerId, pCaret->nextChange() );
+
 				dirt.growToContain( pCaret->dirtyRect( charRect(pText, caretOfs) ));
 				dirt.growToContain( pCaret->dirtyRect( charRect(pText, pText->_editState()->caretOfs)) );
 			}
@@ -746,16 +808,16 @@ namespace wg
 			if( newState.isFocused() )
 			{
 				m_pFocusedItem = pItem;
-				if( !m_tickRouteId )
-					m_tickRouteId = Base::msgRouter()->addRoute( MsgType::Tick, this );					
+				if( !m_tickerId )
+					m_tickerId = Base::tickScheduler()->addTicker( this, c_caretPollInterval );
 			}
 			else
 			{
 				m_pFocusedItem = 0;
-				if( m_tickRouteId )
+				if( m_tickerId )
 				{
-					Base::msgRouter()->deleteRoute( m_tickRouteId );
-					m_tickRouteId = 0;
+					Base::tickScheduler()->removeTicker( m_tickerId );
+					m_tickerId = 0;
 				}
 			}
 		}
@@ -800,6 +862,48 @@ namespace wg
 		_setItemDirty(pItem);
 	}
 	
+	//____ onDigitsModified() ___________________________________________________
+
+	void StdTextMapper::onDigitsModified( TextBaseItem * pItem, int ofs, int len )
+	{
+		// Digits of equal width without kerning can be replaced without
+		// affecting layout, so we only need to rerender them.
+
+		const CharBuffer * pBuffer = _charBuffer(pItem);
+		const Char * pChars = pBuffer->chars();
+
+		for( int i = ofs ; i < ofs + len ; i++ )
+		{
+			if( pChars[i].styleHandle() != 0 )
+			{
+				onRefresh(pItem);
+				return;
+			}
+		}
+
+		TextAttr	baseAttr;
+		_baseStyle(pItem)->exportAttr( _state(pItem), &baseAttr );
+
+		Font * pFont = baseAttr.pFont.rawPtr();
+
+		if( !pFont || !_hasFixedWidthDigits( pFont, baseAttr.size ) )
+		{
+			onRefresh(pItem);
+			return;
+		}
+
+		pFont->setSize( baseAttr.size );
+
+		if( (ofs > 0 && !_isKerningFreeNeighbour( pFont, pChars[ofs-1] )) ||
+			(ofs + len < pBuffer->length() && !_isKerningFreeNeighbour( pFont, pChars[ofs+len] )) )
+		{
+			onRefresh(pItem);
+			return;
+		}
+
+		_setItemDirty( pItem, rectForRange( pItem, ofs, len ) );
+	}
+
 	//___ rectForRange() _________________________________________________________
 
 	Rect StdTextMapper::rectForRange( const TextBaseItem * pItem, int ofs, int length ) const
@@ -1024,7 +1128,23 @@ namespace wg
 	
 	int StdTextMapper::matchingHeight( const TextBaseItem * pItem, int width ) const
 	{
-		return _calcMatchingHeight(_charBuffer(pItem), _baseStyle(pItem), _state(pItem), width);
+		// Result is memoized in the block header until text or style changes.
+
+		BlockHeader * pHeader = const_cast<BlockHeader*>(_header(_itemDataBlock(pItem)));
+		State state = _state(pItem);
+
+		if( pHeader && pHeader->matchingHeightWidth == width && pHeader->matchingHeightState == state )
+			return pHeader->matchingHeight;
+
+		int height = _calcMatchingHeight(_charBuffer(pItem), _baseStyle(pItem), state, width);
+
+		if( pHeader )
+		{
+			pHeader->matchingHeightWidth = width;
+			pHeader->matchingHeightState = state;
+			pHeader->matchingHeight = height;
+		}
+		return height;
 	}
 	
 	//____ _countLines() ___________________________________________________________
@@ -1398,6 +1518,7 @@ namespace wg
 		pBlock = malloc( sizeof(BlockHeader) + sizeof(LineInfo)*nLines);
 		_setItemDataBlock(pItem, pBlock);
 		((BlockHeader *)pBlock)->nbLines = nLines;
+		((BlockHeader *)pBlock)->matchingHeightWidth = -1;
 		
 		return pBlock;
 	}
@@ -1410,6 +1531,8 @@ namespace wg
 		BlockHeader * pHeader = _header(_itemDataBlock(pItem));
 		Size preferredSize;
 
+		pHeader->matchingHeightWidth = -1;
+
 
 		if (m_bLineWrap)
 		{
@@ -1686,6 +1809,10 @@ namespace wg
 		int maxDescendGap = 0;							// Including the line gap.
 		int spaceAdv = 0;
 		int width = 0;
+
+		bool		bLineStart = true;
+		const Char*	pRunBeg = nullptr;				// Start of unstyled line to add to run width cache.
+		uint64_t	runHash = 0;
 		
 		pLines->offset = pChars - pBuffer->chars();
 
@@ -1725,6 +1852,36 @@ namespace wg
 				hCharStyle = pChars->styleHandle();
 			}
 
+			// Unstyled lines are measured through the run width cache.
+
+			if( bLineStart )
+			{
+				bLineStart = false;
+
+				if( hCharStyle == 0 )
+				{
+					const Char * pEnd = pChars;
+					while( !pEnd->isEndOfLine() && pEnd->styleHandle() == 0 )
+						pEnd++;
+
+					if( pEnd->isEndOfLine() && pEnd->styleHandle() == 0 && pEnd > pChars )
+					{
+						uint64_t hash = RunWidthCache::hashRun( pChars, pEnd );
+						int cachedWidth = s_runWidthCache.find( pFont->serial(), attr.size, hash, int(pEnd - pChars) );
+						if( cachedWidth >= 0 )
+						{
+							width = cachedWidth;
+							pChars = pEnd;
+						}
+						else
+						{
+							pRunBeg = pChars;
+							runHash = hash;
+						}
+					}
+				}
+			}
+
 
 			// TODO: Include handling of special characters
 			// TODO: Support sub/superscript.
@@ -1747,6 +1904,12 @@ namespace wg
 	
 			if( pChars->isEndOfLine() )
 			{
+				if( pRunBeg )
+				{
+					s_runWidthCache.add( pFont->serial(), attr.size, runHash, int(pChars - pRunBeg), width );
+					pRunBeg = nullptr;
+				}
+
 				// Make sure we have space for eol caret
 
 				if( pCaret )
@@ -1786,6 +1949,7 @@ namespace wg
 				pLines->offset = pChars - pBuffer->chars();
 				width = 0;
 				pPrevGlyph = nullptr;
+				bLineStart = true;
 
 				if (pChars->styleHandle() == hCharStyle)
 				{
@@ -27,6 +27,7 @@
 #include <wg_textmapper.h>
 #include <wg_textstyle.h>
 #include <wg_caret.h>
+#include <wg_runwidthcache.h>
 
 namespace wg 
 {
@@ -113,6 +114,7 @@ namespace wg
 		virtual void	onStyleChanged( TextBaseItem * pItem, TextStyle * pNewStyle, TextStyle * pOldStyle );
 		virtual void	onCharStyleChanged( TextBaseItem * pText, int ofs, int len );
 		virtual void	onRefresh( TextBaseItem * pItem );
+		virtual void	onDigitsModified( TextBaseItem * pItem, int ofs, int len );
 
 
 
@@ -142,6 +144,9 @@ namespace wg
 	protected:
 		StdTextMapper();
 		virtual ~StdTextMapper();
+
+		const static int	c_caretPollInterval = 100;		// Millisec between ticks while focused item has no caret to animate.
+		const static int	c_runWidthCacheSize = 4096;		// Max number of line widths kept in run width cache.
 	
 	
 		struct BlockHeader
@@ -149,6 +154,10 @@ namespace wg
 			int nbLines;
 			Size preferredSize;
 			Size textSize;
+
+			int matchingHeightWidth;		// Width matchingHeight was memoized for, -1 if none.
+			State matchingHeightState;		// State matchingHeight was memoized for.
+			int matchingHeight;				// Memoized result from matchingHeight().
 		};
 	
 		struct LineInfo
@@ -178,6 +187,9 @@ namespace wg
 
 
 		int				_charDistance( const Char * pFirst, const Char * pLast, const TextAttr& baseAttr, State state ) const;
+
+		bool			_hasFixedWidthDigits( Font * pFont, int size ) const;
+		bool			_isKerningFreeNeighbour( Font * pFont, const Char& neighbour ) const;
 		
 		inline BlockHeader *		_header( void * pBlock ) { return static_cast<BlockHeader*>(pBlock); }
 		inline const BlockHeader *	_header( const void * pBlock ) const { return static_cast<const BlockHeader*>(pBlock); }
@@ -217,7 +229,13 @@ namespace wg
 
 
 		TextBaseItem *	m_pFocusedItem;
-		RouteId			m_tickRouteId;
+		TickerId		m_tickerId;
+
+		mutable Font_p	m_pDigitFont;			// Font and size m_bFixedWidthDigits was last calculated for.
+		mutable int		m_digitFontSize;
+		mutable bool	m_bFixedWidthDigits;
+
+		static RunWidthCache	s_runWidthCache;	// Widths of unstyled lines, shared by all StdTextMappers.
 	};
 
 
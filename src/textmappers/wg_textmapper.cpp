@@ -57,6 +57,20 @@ namespace wg
 		return 0;
 	}
 	
+	//____ onDigitsModified() ______________________________________________________
+	/**
+	 * @brief Notify that some digits in the text have been replaced by other digits.
+	 *
+	 * Called instead of onTextModified() when nothing but digits in the specified range
+	 * have changed, giving the textmapper a chance to keep its layout if digits are
+	 * of equal width. Default implementation calls onTextModified().
+	 */
+
+	void TextMapper::onDigitsModified( TextBaseItem * pItem, int ofs, int len )
+	{
+		onTextModified( pItem, ofs, len, len );
+	}
+
 	//____ tooltip() _______________________________________________________________
 	
 	String TextMapper::tooltip( const TextBaseItem * pItem ) const
@@ -86,6 +86,7 @@ namespace wg
 		virtual void	onStyleChanged( TextBaseItem * pText, TextStyle * pNewStyle, TextStyle * pOldStyle ) = 0;
 		virtual void	onCharStyleChanged( TextBaseItem * pText, int ofs = 0, int len = INT_MAX ) = 0;
 		virtual void	onRefresh( TextBaseItem * pText ) = 0;
+		virtual void	onDigitsModified( TextBaseItem * pText, int ofs, int len );		// Only digits replaced by other digits, length unchanged.
 	
 	
 		virtual Size	preferredSize( const TextBaseItem * pText ) const = 0;
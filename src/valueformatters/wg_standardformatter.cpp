@@ -22,6 +22,8 @@
 
 #include <wg_standardformatter.h>
 
+#include <cmath>
+
 namespace wg 
 {
 	
@@ -75,14 +77,137 @@ namespace wg
 	
 	String StandardFormatter::format( int64_t value, int scale ) const
 	{	
-		//TODO: Implement!
-		return String();
+		CharBuffer	buffer;
+		formatInto( buffer, value, scale );
+		return &buffer;
 	}
 	
 	String StandardFormatter::format( double value ) const
 	{
-		//TODO: Implement!
-		return String();
+		CharBuffer	buffer;
+		formatInto( buffer, value );
+		return &buffer;
+	}
+
+	//____ formatInto() ___________________________________________________________
+
+	void StandardFormatter::formatInto( CharBuffer& buffer, int64_t value, int scale ) const
+	{
+		Char	chars[c_maxChars];
+		int		nChars = _formatFixed( chars, value, scale, false );
+
+		buffer.clear();
+		buffer.pushBack( chars + c_maxChars - nChars, nChars );
+	}
+
+	void StandardFormatter::formatInto( CharBuffer& buffer, double value ) const
+	{
+		buffer.clear();
+
+		if( std::isnan(value) )
+		{
+			buffer.pushBack( CharSeq("nan") );
+			return;
+		}
+
+		if( std::isinf(value) )
+		{
+			buffer.pushBack( CharSeq( value < 0 ? "-inf" : "inf" ) );
+			return;
+		}
+
+		// Values too large for six decimals in an int64_t lose their decimals and are
+		// clamped to the int64_t range if even the integer part doesn't fit.
+
+		const double c_int64Limit = 9.2e18;
+
+		int64_t	fixed;
+		int		scale;
+		if( std::fabs(value*1000000) < c_int64Limit )
+		{
+			fixed = (int64_t) std::llround(value*1000000);
+			scale = 1000000;
+		}
+		else
+		{
+			if( std::fabs(value) < c_int64Limit )
+				fixed = (int64_t) std::llround(value);
+			else
+				fixed = value < 0 ? INT64_MIN : INT64_MAX;
+			scale = 1;
+		}
+
+		Char	chars[c_maxChars];
+		int		nChars = _formatFixed( chars, fixed, scale, true );
+
+		buffer.pushBack( chars + c_maxChars - nChars, nChars );
+	}
+
+	//____ _formatFixed() _________________________________________________________
+	
+	// Writes value as a fixed point number, right aligned at the end of pBuffer which
+	// needs to be c_maxChars long. Number of decimals is the number of digits needed
+	// to express scale-1. Returns number of characters written.
+
+	int StandardFormatter::_formatFixed( Char * pBuffer, int64_t value, int scale, bool bTrimZeroes ) const
+	{
+		if( scale <= 0 )
+			scale = 1;
+
+		uint64_t absValue = value < 0 ? ((uint64_t) -(value+1)) + 1 : (uint64_t) value;
+
+		uint64_t intPart = absValue / scale;
+		uint64_t fracPart = absValue % scale;
+
+		int			decimals = 0;
+		uint64_t	decimalScale = 1;
+		while( decimalScale < (uint64_t) scale )
+		{
+			decimalScale *= 10;
+			decimals++;
+		}
+
+		// Convert fraction to decimal digits, avoiding overflow for scales above 10^9.
+
+		uint64_t fraction;
+		if( decimalScale == (uint64_t) scale )
+			fraction = fracPart;
+		else if( decimalScale <= 1000000000 )
+			fraction = fracPart * decimalScale / scale;
+		else
+			fraction = (uint64_t) (fracPart * (double) decimalScale / scale);
+
+		Char * pWrite = pBuffer + c_maxChars;
+
+		if( bTrimZeroes )
+		{
+			while( decimals > 0 && fraction % 10 == 0 )
+			{
+				fraction /= 10;
+				decimals--;
+			}
+		}
+
+		if( decimals > 0 )
+		{
+			for( int i = 0 ; i < decimals ; i++ )
+			{
+				(--pWrite)->setCode( (uint16_t) ('0' + fraction % 10) );
+				fraction /= 10;
+			}
+			(--pWrite)->setCode( '.' );
+		}
+
+		do
+		{
+			(--pWrite)->setCode( (uint16_t) ('0' + intPart % 10) );
+			intPart /= 10;
+		} while( intPart > 0 );
+
+		if( value < 0 )
+			(--pWrite)->setCode( '-' );
+
+		return (int) (pBuffer + c_maxChars - pWrite);
 	}
 
 } // namespace wg
@@ -54,11 +54,18 @@ namespace wg
 	
 		String 		format( int64_t value, int scale ) const;
 		String 		format( double value ) const;
+
+		void		formatInto( CharBuffer& buffer, int64_t value, int scale ) const;
+		void		formatInto( CharBuffer& buffer, double value ) const;
 	
 	protected:
 		StandardFormatter();
 		StandardFormatter( const CharSeq& format );
 		~StandardFormatter();
+
+		const static int	c_maxChars = 32;			// Sign, 19 integer digits, decimal point and up to 10 decimals.
+
+		int			_formatFixed( Char * pBuffer, int64_t value, int scale, bool bTrimZeroes ) const;
 	
 	
 	};
@@ -72,6 +72,24 @@ namespace wg
 	
 	String TimeFormatter::format( int64_t value, int scale ) const
 	{
+		CharBuffer	buffer;
+		formatInto( buffer, value, scale );
+		return &buffer;
+	}
+	
+	String TimeFormatter::format( double value ) const
+	{
+		CharBuffer	buffer;
+		formatInto( buffer, value );
+		return &buffer;
+	}
+
+	//____ formatInto() ___________________________________________________________
+
+	void TimeFormatter::formatInto( CharBuffer& output, int64_t value, int scale ) const
+	{
+		output.clear();
+
 		int64_t seconds = value / scale;
 		
 		// Get right format string
@@ -87,12 +105,10 @@ namespace wg
 		}
 		
 		if( pFormat->isEmpty() )
-			return String();
+			return;
 		
 		//
 		
-		CharBuffer output(pFormat->length());
-		
 		const Char * pSrc = pFormat->chars();
 	
 		int unit=1;			// Default to seconds.
@@ -177,7 +193,7 @@ namespace wg
 	
 				while( bar > 0 )
 				{
-					output.pushBack( Char( '0' + num/bar, 0 ) );		//TODO: Add property
+					output.pushBack( Char( (uint16_t) ('0' + num/bar) ) );		//TODO: Add property
 					
 					num %= bar;
 					bar /= 10;		
@@ -189,17 +205,19 @@ namespace wg
 			
 		}
 		
-		return &output;
+		return;
 	error:
-		return String("#ERROR#");
+		output.clear();
+		output.pushBack( CharSeq("#ERROR#") );
+		return;
 	overflow:
-		return String("#OVERFLOW#");
-		
+		output.clear();
+		output.pushBack( CharSeq("#OVERFLOW#") );
 	}
 	
-	String TimeFormatter::format( double value ) const
+	void TimeFormatter::formatInto( CharBuffer& buffer, double value ) const
 	{
-		return format( (int64_t)(value*1000000), 1000000);
+		formatInto( buffer, (int64_t)(value*1000000), 1000000);
 	}
 
 } // namespace wg
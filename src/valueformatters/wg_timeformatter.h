@@ -61,6 +61,9 @@ namespace wg
 	
 		String 		format( int64_t value, int scale ) const;
 		String 		format( double value ) const;
+
+		void		formatInto( CharBuffer& buffer, int64_t value, int scale ) const;
+		void		formatInto( CharBuffer& buffer, double value ) const;
 		
 	protected:
 		TimeFormatter() {};
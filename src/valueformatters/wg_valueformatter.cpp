@@ -55,4 +55,23 @@ namespace wg
 		return 0;
 	}
 
+	//____ formatInto() ___________________________________________________________
+	/**
+	 * @brief Format value into an existing CharBuffer.
+	 *
+	 * Replaces the content of the buffer with the formatted value. Formatters overriding
+	 * this method reuse the capacity of the buffer, so no memory is allocated once the
+	 * buffer has grown large enough. The default implementation goes through format().
+	 */
+
+	void ValueFormatter::formatInto( CharBuffer& buffer, int64_t value, int scale ) const
+	{
+		buffer = format( value, scale );
+	}
+
+	void ValueFormatter::formatInto( CharBuffer& buffer, double value ) const
+	{
+		buffer = format( value );
+	}
+
 } // namespace wg
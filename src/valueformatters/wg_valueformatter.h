@@ -51,6 +51,9 @@ namespace wg
 	
 		virtual String format( int64_t value, int scale ) const = 0;
 		virtual String format( double value ) const = 0;
+
+		virtual void	formatInto( CharBuffer& buffer, int64_t value, int scale ) const;
+		virtual void	formatInto( CharBuffer& buffer, double value ) const;
 	};
 	
 
@@ -33,6 +33,11 @@
 									// that better handles broken unicode strings.
 									// Ignored if USE_UTF8 isn't defined.
 
+	//#define	WG_ATOMIC_REFCOUNT	// Use atomic reference counting for Object and
+									// a lock-free pool for weak pointer hubs, making
+									// it safe to share strong pointers between threads.
+									// Comes with a cost, see benchmarks/refcount_bench.cpp.
+
 
 namespace wg
 {
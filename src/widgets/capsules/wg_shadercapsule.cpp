@@ -101,12 +101,12 @@ namespace wg
 	
 	//____ _renderPatches() ________________________________________________________
 	
-	void ShaderCapsule::_renderPatches( GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, Patches * _pPatches )
+	void ShaderCapsule::_renderPatches( GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, Patches * _pPatches, RootPanel * pRoot )
 	{
 		// Render our skin
 
 		if( m_pSkin )
-			Capsule::_renderPatches( pDevice, _canvas, _window, _pPatches );
+			Capsule::_renderPatches( pDevice, _canvas, _window, _pPatches, pRoot );
 
 		// Set our tint color and blend mode.
 	
@@ -125,7 +125,7 @@ namespace wg
 		Rect canvas = m_pSkin ? m_pSkin->contentRect( _canvas, m_state ) : _canvas;
 
 		if( m_child.pWidget )
-			m_child.pWidget->_renderPatches( pDevice, canvas, canvas, _pPatches );
+			m_child.pWidget->_renderPatches( pDevice, canvas, canvas, _pPatches, pRoot );
 	
 		// Reset old blend mode and tint color
 	
@@ -133,6 +133,31 @@ namespace wg
 		pDevice->setTintColor(oldTC);
 	}
 	
+	//____ _maskPatches() ________________________________________________________
+
+	void ShaderCapsule::_maskPatches( Patches& patches, const Rect& geo, const Rect& clip, BlendMode blendMode )
+	{
+		// Our child is rendered with our render mode and tint, so it can only hide what is
+		// behind it if those are opaque. Tint is only known to be opaque when we replace it
+		// or the callers tint is opaque, which is the case when it masks with Blend.
+
+		if( !m_child.pWidget || (blendMode != BlendMode::Blend && blendMode != BlendMode::Replace) )
+			return;
+
+		BlendMode mode = m_renderMode;
+		if( mode == BlendMode::Blend )
+		{
+			bool bOpaqueTint = (blendMode == BlendMode::Blend || m_tintMode == BlendMode::Replace) &&
+								Color::blend( Color::White, m_tintColor, m_tintMode ).a == 255;
+			if( !bOpaqueTint )
+				return;
+		}
+		else if( mode != BlendMode::Replace )
+			return;
+
+		m_child.pWidget->_maskPatches( patches, geo, clip, mode );
+	}
+
 	//____ _cloneContent() _______________________________________________________
 	
 	void ShaderCapsule::_cloneContent( const Widget * _pOrg )
@@ -72,7 +72,8 @@ namespace wg
 		virtual ~ShaderCapsule();
 		virtual Widget* _newOfMyType() const { return new ShaderCapsule(); };
 	
-		void		_renderPatches( GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, Patches * _pPatches );
+		void		_renderPatches( GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, Patches * _pPatches, RootPanel * pRoot );
+		void		_maskPatches( Patches& patches, const Rect& geo, const Rect& clip, BlendMode blendMode );
 		void		_cloneContent( const Widget * _pOrg );
 		BlendMode _getRenderMode() const;
 	
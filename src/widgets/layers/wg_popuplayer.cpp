@@ -24,6 +24,7 @@
 #include <wg_util.h>
 #include <wg_patches.h>
 #include <wg_msgrouter.h>
+#include <wg_tickscheduler.h>
 #include <wg_panel.h>
 #include <wg_base.h>
 #include <wg_inputhandler.h>
@@ -433,7 +434,7 @@ namespace wg
 		Patches	patches;
 	};
 
-	void PopupLayer::_renderPatches(GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, Patches * _pPatches)
+	void PopupLayer::_renderPatches(GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, Patches * _pPatches, RootPanel * pRoot)
 	{
 
 		// We start by eliminating dirt outside our geometry
@@ -450,7 +451,7 @@ namespace wg
 		// Render container itself
 
 		for (const Rect * pRect = patches.begin(); pRect != patches.end(); pRect++)
-			_render(pDevice, _canvas, _window, *pRect);
+			_renderTracked(pDevice, _canvas, _window, *pRect, pRoot );
 
 
 		// Render children
@@ -491,7 +492,7 @@ namespace wg
 
 
 		if (!patches.isEmpty())
-			m_baseSlot.pWidget->_renderPatches(pDevice, _canvas, _window, &patches);
+			m_baseSlot.pWidget->_renderPatches(pDevice, _canvas, _window, &patches, pRoot);
 
 
 		// Go through WidgetRenderContexts and render the patches in reverse order (topmost popup rendered last).
@@ -509,12 +510,12 @@ namespace wg
 				tint.a = 255 - (255 * p->pSlot->stateCounter / m_closingFadeMs);
 
 			if (tint.a == 255)
-				p->pSlot->pWidget->_renderPatches(pDevice, p->geo, p->geo, &p->patches);
+				p->pSlot->pWidget->_renderPatches(pDevice, p->geo, p->geo, &p->patches, pRoot);
 			else
 			{
 				Color oldTint = pDevice->tintColor();
 				pDevice->setTintColor(oldTint*tint);
-				p->pSlot->pWidget->_renderPatches(pDevice, p->geo, p->geo, &p->patches);
+				p->pSlot->pWidget->_renderPatches(pDevice, p->geo, p->geo, &p->patches, pRoot);
 				pDevice->setTintColor(oldTint);
 			}
 		}
@@ -855,8 +856,8 @@ namespace wg
 		_updateGeo(pSlot, true);
 		_stealKeyboardFocus();
 
-		if (m_tickRouteId == 0)
-			m_tickRouteId = Base::msgRouter()->addRoute(MsgType::Tick, this);
+		if (m_tickerId == 0)
+			m_tickerId = Base::tickScheduler()->addTicker( this );
 	}
 
 
@@ -882,8 +883,8 @@ namespace wg
 
 		if (m_popups.isEmpty())
 		{
-			Base::msgRouter()->deleteRoute(m_tickRouteId);
-			m_tickRouteId = 0;
+			Base::tickScheduler()->removeTicker( m_tickerId );
+			m_tickerId = 0;
 		}
 	}
 
@@ -160,7 +160,7 @@ namespace wg
 
 		// Overloaded from container
 
-		void			_renderPatches(GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, Patches * _pPatches);
+		void			_renderPatches(GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, Patches * _pPatches, RootPanel * pRoot);
 //		void			_maskPatches(Patches& patches, const Rect& geo, const Rect& clip, BlendMode blendMode);
 //		void			_collectPatches(Patches& container, const Rect& geo, const Rect& clip);
 
@@ -175,7 +175,7 @@ namespace wg
 		SlotArray<PopupSlot>m_popups;		// First popup lies at the bottom.	
 		Widget_wp			m_pKeyFocus;	// Pointer at child that held focus before any menu was opened.
 
-		RouteId			m_tickRouteId = 0;
+		TickerId		m_tickerId = 0;
 
 		int				m_openingDelayMs = 100;
 		int				m_openingFadeMs = 100;
@@ -318,7 +318,7 @@ namespace wg
 	
 	//____ _renderPatches() _______________________________________________________
 	
-	void PackList::_renderPatches( GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, Patches * _pPatches )
+	void PackList::_renderPatches( GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, Patches * _pPatches, RootPanel * pRoot )
 	{
 		// We start by eliminating dirt outside our geometry
 	
@@ -333,7 +333,7 @@ namespace wg
 		// Render container itself
 		
 		for( const Rect * pRect = patches.begin() ; pRect != patches.end() ; pRect++ )
-			_render(pDevice, _canvas, _window, *pRect );
+			_renderTracked(pDevice, _canvas, _window, *pRect, pRoot );
 			
 		
 		// Render children
@@ -348,7 +348,7 @@ namespace wg
 			{
 				Rect canvas = child.geo + _canvas.pos();
 				if( canvas.intersectsWith( dirtBounds ) )
-					child.pSlot->pWidget->_renderPatches( pDevice, canvas, canvas, &patches );
+					child.pSlot->pWidget->_renderPatches( pDevice, canvas, canvas, &patches, pRoot );
 				_nextSlotWithGeo( child );
 			}
 		}
@@ -1185,6 +1185,13 @@ namespace wg
 		return geo.pos();
 	}
 
+	//____ _isChildVisible() ___________________________________________________
+
+	bool PackList::_isChildVisible( Slot * pSlot ) const
+	{
+		return ((PackListSlot*)pSlot)->bVisible && _isVisible();
+	}
+
 	//____ _childSize() __________________________________________________________
 
 	Size PackList::_childSize( Slot * _pSlot ) const
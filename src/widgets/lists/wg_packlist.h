@@ -162,7 +162,7 @@ namespace wg
 		void			_collectPatches( Patches& container, const Rect& geo, const Rect& clip );
 		void			_maskPatches( Patches& patches, const Rect& geo, const Rect& clip, BlendMode blendMode );
 		void			_cloneContent( const Widget * _pOrg );
-		void			_renderPatches( GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, Patches * _pPatches );
+		void			_renderPatches( GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, Patches * _pPatches, RootPanel * pRoot );
 		void			_render( GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, const Rect& _clip );
 		void			_setSize( const Size& size );
 		void			_refresh();
@@ -217,6 +217,7 @@ namespace wg
 
 		Coord		_childPos(Slot * pSlot) const;
 		Size		_childSize(Slot * pSlot) const;
+		bool		_isChildVisible(Slot * pSlot) const;
 
 		void		_childRequestRender(Slot * pSlot);
 		void		_childRequestRender(Slot * pSlot, const Rect& rect);
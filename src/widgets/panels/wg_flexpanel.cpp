@@ -914,6 +914,13 @@ namespace wg
 		return ((FlexPanelSlot*)pSlot)->realGeo.pos();
 	}
 
+	//____ _isChildVisible() ___________________________________________________
+
+	bool FlexPanel::_isChildVisible( Slot * pSlot ) const
+	{
+		return ((FlexPanelSlot*)pSlot)->bVisible && _isVisible();
+	}
+
 	//____ _childSize() __________________________________________________________
 
 	Size FlexPanel::_childSize( Slot * pSlot ) const
@@ -325,6 +325,7 @@ namespace wg
 
 		Coord		_childPos( Slot * pSlot ) const;
 		Size		_childSize( Slot * pSlot ) const;
+		bool		_isChildVisible( Slot * pSlot ) const;
 
 		void		_childRequestRender( Slot * pSlot );
 		void		_childRequestRender( Slot * pSlot, const Rect& rect );
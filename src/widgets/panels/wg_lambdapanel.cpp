@@ -397,6 +397,13 @@ namespace wg
 		return ((LambdaPanelSlot*)pSlot)->geo.pos();		
 	}
 
+	//____ _isChildVisible() ___________________________________________________
+
+	bool LambdaPanel::_isChildVisible( Slot * pSlot ) const
+	{
+		return ((LambdaPanelSlot*)pSlot)->bVisible && _isVisible();
+	}
+
 	//____ _childSize() __________________________________________________________
 
 	Size LambdaPanel::_childSize( Slot * pSlot ) const
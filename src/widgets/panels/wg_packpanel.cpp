@@ -110,6 +110,8 @@ namespace wg
 	
 	Size PackPanel::preferredSize() const
 	{
+		_ensureLayout();
+
 		Size size = m_preferredContentSize;
 		if (m_pSkin)
 			size += m_pSkin->contentPadding();
@@ -121,6 +123,8 @@ namespace wg
 	
 	int PackPanel::matchingHeight( int width ) const
 	{
+		_ensureLayout();
+
 		int height = 0;
 	
 		if( m_bHorizontal )
@@ -203,6 +207,8 @@ namespace wg
 	
 	int PackPanel::matchingWidth( int height ) const
 	{
+		_ensureLayout();
+
 		int width = 0;
 	
 		if( !m_bHorizontal )
@@ -423,6 +429,13 @@ namespace wg
 		return ((PackPanelSlot*)pSlot)->geo;
 	}
 
+	//____ _isChildVisible() ___________________________________________________
+
+	bool PackPanel::_isChildVisible( Slot * pSlot ) const
+	{
+		return ((PackPanelSlot*)pSlot)->bVisible && _isVisible();
+	}
+
 	//____ _childSize() _______________________________________________________
 
 	Size PackPanel::_childSize(Slot * pSlot) const
@@ -452,7 +465,7 @@ namespace wg
 		PackPanelSlot * pSlot = static_cast<PackPanelSlot*>(_pSlot);
 		pSlot->preferredSize = pSlot->paddedPreferredSize();
 
-		_refreshAllWidgets();
+		_requestLayout();
 	}
 
 	//____ _prevChild() _______________________________________________________
@@ -492,7 +505,7 @@ namespace wg
 			}
 		}
 
-		_refreshAllWidgets();
+		_requestLayout();
 	}
 	
 	//____ _hideChildren() _______________________________________________________
@@ -502,7 +515,7 @@ namespace wg
 		for (int i = 0; i < nb; i++)
 			pSlot[i].bVisible = false;
 
-		_refreshAllWidgets();
+		_requestLayout();
 	}
 		
 	
@@ -523,6 +536,13 @@ namespace wg
 	
 	
 	
+	//____ _updateLayout() _______________________________________________________
+
+	void PackPanel::_updateLayout()
+	{
+		_refreshAllWidgets();
+	}
+
 	//____ _setSize() ____________________________________________________________
 	
 	void PackPanel::_setSize( const Size& size )
@@ -617,6 +637,14 @@ namespace wg
 	
 	void PackPanel::_refreshChildGeo( bool bRequestRender )
 	{
+		// Preferred content size needs to be up to date before we distribute space.
+
+		if( m_bLayoutPending )
+		{
+			m_bLayoutPending = false;
+			_updatePreferredSize();
+		}
+
 	    if( m_children.isEmpty() )
 	        return;
 	    
@@ -105,6 +105,7 @@ namespace wg
 	    // Overloaded from Widget
 	    
 		void			_setSize( const Size& size );
+		void			_updateLayout();
 	 
 	    
 		// Overloaded from Container
@@ -136,6 +137,7 @@ namespace wg
 
 		Coord		_childPos( Slot * pSlot ) const;
 		Size		_childSize( Slot * pSlot ) const;
+		bool		_isChildVisible( Slot * pSlot ) const;
 
 		void		_childRequestRender( Slot * pSlot );
 		void		_childRequestRender( Slot * pSlot, const Rect& rect );
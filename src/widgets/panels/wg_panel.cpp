@@ -100,11 +100,17 @@ namespace wg
 	
 	void Panel::_maskPatches( Patches& patches, const Rect& geo, const Rect& clip, BlendMode blendMode )
 	{
+		// Nothing left to mask or nothing within our reach, no need to recurse through our children.
+
+		Rect	myClip(geo, clip);				// Need to limit clip to our geo. Otherwise children outside might mask what they shouldn't (for panels where children can go outside parent).
+		if( patches.isEmpty() || !myClip.intersectsWith( patches.getUnion() ) )
+			return;
+
 		//TODO: Don't just check isOpaque() globally, check rect by rect.
 		//TODO: Should m_maskOp be moved to Container instead? Could remove many versions of _maskPatches()...
 		if( (m_bOpaque && blendMode == BlendMode::Blend) || blendMode == BlendMode::Replace )
 		{
-			patches.sub( Rect(geo,clip) );
+			patches.sub( myClip );
 			return;
 		}
 		
@@ -112,13 +118,14 @@ namespace wg
 		{
 			case MaskOp::Recurse:
 			{
-				Rect	myClip(geo, clip);				// Need to limit clip to our geo. Otherwise children outside might mask what they shouldn't (for panels where children can go outside parent).
 				SlotWithGeo child;
 				_firstSlotWithGeo( child );
 
-				while(child.pSlot)
+				while(child.pSlot && !patches.isEmpty() )
 				{
-					child.pSlot->pWidget->_maskPatches( patches, child.geo + geo.pos(), myClip, blendMode );
+					Rect childGeo = child.geo + geo.pos();
+					if( childGeo.intersectsWith( myClip ) )
+						child.pSlot->pWidget->_maskPatches( patches, childGeo, myClip, blendMode );
 					_nextSlotWithGeo( child );
 				}
 				break;
@@ -126,7 +133,7 @@ namespace wg
 			case MaskOp::Skip:
 				break;
 			case MaskOp::Mask:
-				patches.sub( Rect(geo,clip) );
+				patches.sub( myClip );
 				break;
 		}
 	}
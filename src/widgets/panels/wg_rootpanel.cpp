@@ -25,8 +25,12 @@
 #include <wg_container.h>
 #include <wg_boxskin.h>
 #include <wg_inputhandler.h>
+#include <wg_layoutqueue.h>
 
 #include <new>
+#include <chrono>
+#include <algorithm>
+#include <string.h>
 
 
 #include <wg_msgrouter.h>
@@ -35,6 +39,10 @@ namespace wg
 {
 	
 	const char RootPanel::CLASSNAME[] = {"RootPanel"};
+
+
+	static const Color	s_heatmapColors[6] = { Color(0,0,0,0), Color(0,0,255,96), Color(0,255,0,128),
+												Color(255,255,0,128), Color(255,128,0,160), Color(255,0,0,192) };
 		
 	
 	//____ Constructor ____________________________________________________________
@@ -44,12 +52,18 @@ namespace wg
 		m_bVisible = true;
 		m_bHasGeo = false;
 
+		m_bOcclusionCulling = true;
+		m_occludedPixels = 0;
+
 		m_bDebugMode = false;
 
 		BoxSkin_p pDebugOverlay = BoxSkin::create( Color(255,0,0,128), 1, Color(255,0,0,128) );
 		pDebugOverlay->setStateColor( StateEnum::Focused, Color(255,0,0,128), Color(255,0,0,255) );
 		m_pDebugOverlay = pDebugOverlay;
 		m_afterglowFrames = 4;	
+
+		m_debugHeatmap = Heatmap::Off;
+		m_debugStatsFrames = 60;
 	}
 	
 	RootPanel::RootPanel( GfxDevice * pGfxDevice ) : RootPanel()
@@ -112,12 +126,23 @@ namespace wg
 	
 	bool RootPanel::setGeo( const Rect& geo )
 	{
+		Rect oldGeo = this->geo();
+
 		if( geo.x == 0 && geo.y == 0 && geo.w == 0 && geo.h == 0 )
 			m_bHasGeo = false;
 		else
 			m_bHasGeo = true;
 	
 		m_geo = geo;
+
+		Rect newGeo = this->geo();
+		if( newGeo != oldGeo )
+		{
+			if( m_child.pWidget && newGeo.size() != oldGeo.size() )
+				m_child.pWidget->_setSize( newGeo.size() );
+
+			addDirtyPatch( newGeo );
+		}
 		return true;
 	}
 	
@@ -173,6 +198,23 @@ namespace wg
 		return true;
 	}
 	
+	//____ setOcclusionCulling() _______________________________________________
+	/**
+	 * @brief Enable/disable skipping of graphics hidden behind opaque widgets.
+	 *
+	 * When enabled (default), containers only render their own skin in the parts of the
+	 * dirty patches that are not covered by opaque children. Opacity is determined
+	 * through each widgets _maskPatches(), which in turn relies on Skin::isOpaque()
+	 * and Surface::isOpaque().
+	 *
+	 * Disabling this is only useful for debugging and measuring, see occludedPixels().
+	 */
+
+	void RootPanel::setOcclusionCulling( bool bCull )
+	{
+		m_bOcclusionCulling = bCull;
+	}
+
 	//____ setDebugMode() ______________________________________________________
 	
 	void RootPanel::setDebugMode( bool onOff )
@@ -186,7 +228,15 @@ namespace wg
 			for( auto it = m_afterglowRects.begin() ; it != m_afterglowRects.end() ; it++ )
 				m_dirtyPatches.add( &(*it) );
 
-			m_afterglowRects.clear();			
+			m_afterglowRects.clear();
+
+			m_dirtyPatches.add( &m_heatmapPatches );
+			m_heatmapPatches.clear();
+
+			m_heatmapGeo.clear();
+			m_overdrawBuffer.clear();
+			m_renderTimeBuffer.clear();
+			m_renderCosts.clear();
 		}
 	}
 	
@@ -207,6 +257,102 @@ namespace wg
 	}
 
 
+	//____ setDebugHeatmap() ____________________________________________________
+	/**
+	 * @brief Replace the updated rects overlay with a heatmap.
+	 *
+	 * In debug mode, instead of marking updated rects with the debug overlay skin,
+	 * color each updated pixel by how many times it was rendered (Heatmap::Overdraw)
+	 * or by how much time was spent rendering it (Heatmap::RenderTime), going from
+	 * blue through green and yellow to red.
+	 *
+	 * The heatmap stays on screen until the area is rendered again.
+	 */
+
+	void RootPanel::setDebugHeatmap( Heatmap mode )
+	{
+		if( mode == m_debugHeatmap )
+			return;
+
+		// Clean up overlays from the previous mode.
+
+		for( auto it = m_afterglowRects.begin() ; it != m_afterglowRects.end() ; it++ )
+			m_dirtyPatches.add( &(*it) );
+		m_afterglowRects.clear();
+
+		m_dirtyPatches.add( &m_heatmapPatches );
+		m_heatmapPatches.clear();
+
+		m_debugHeatmap = mode;
+	}
+
+	//____ setDebugStatsFrames() ________________________________________________
+	/**
+	 * @brief Set number of frames to collect widget render costs for.
+	 *
+	 * Render costs are collected while in debug mode and are kept for the specified
+	 * number of frames (beginRender()/endRender() pairs). Default is 60.
+	 */
+
+	void RootPanel::setDebugStatsFrames( int frames )
+	{
+		limit(frames, 1, 10000);
+		m_debugStatsFrames = frames;
+
+		while( (int) m_renderCosts.size() > frames )
+			m_renderCosts.pop_back();
+	}
+
+	//____ mostCostlyWidgets() __________________________________________________
+	/**
+	 * @brief Get the widgets that have spent the most time rendering.
+	 *
+	 * @param maxWidgets	Maximum number of widgets to return.
+	 *
+	 * Sums up the render costs of the widgets over the frames collected in
+	 * debug mode, see setDebugStatsFrames().
+	 *
+	 * @return The most costly widgets still alive, most costly first.
+	 */
+
+	std::vector<RootPanel::RenderCost> RootPanel::mostCostlyWidgets( int maxWidgets ) const
+	{
+		std::map<Widget*,RenderCost> sum;
+
+		for( auto& frame : m_renderCosts )
+		{
+			for( auto& entry : frame )
+			{
+				if( !entry.second.pWidget )
+					continue;
+
+				RenderCost& cost = sum[entry.first];
+				if( !cost.pWidget )
+				{
+					cost.pWidget = entry.second.pWidget.rawPtr();
+					cost.microsec = 0;
+					cost.calls = 0;
+					cost.pixels = 0;
+				}
+				cost.microsec += entry.second.microsec;
+				cost.calls += entry.second.calls;
+				cost.pixels += entry.second.pixels;
+			}
+		}
+
+		std::vector<RenderCost> result;
+		result.reserve( sum.size() );
+		for( auto& entry : sum )
+			result.push_back( entry.second );
+
+		std::sort( result.begin(), result.end(), [](const RenderCost& a, const RenderCost& b) { return a.microsec > b.microsec; } );
+
+		if( maxWidgets >= 0 && (int) result.size() > maxWidgets )
+			result.resize( maxWidgets );
+
+		return result;
+	}
+
 	//____ render() _______________________________________________________________
 	
 	bool RootPanel::render()
@@ -238,9 +384,32 @@ namespace wg
 		if( !m_pGfxDevice || !m_child.pWidget )
 			return false;						// No GFX-device or no widgets to render.
 
+		// Carry out pending layout changes, which adds to our dirty patches.
+
+		Base::layoutQueue()->flush();
+
 		// Handle debug overlays.
 	
 		if( m_bDebugMode )
+		{
+			// Start a new frame of render statistics.
+
+			m_renderCosts.push_front( std::map<Widget*,CostEntry>() );
+			while( (int) m_renderCosts.size() > m_debugStatsFrames )
+				m_renderCosts.pop_back();
+
+			Rect canvas = geo();
+			if( canvas != m_heatmapGeo )
+			{
+				m_heatmapGeo = canvas;
+				m_overdrawBuffer.resize( canvas.w*canvas.h );
+				m_renderTimeBuffer.resize( canvas.w*canvas.h );
+			}
+			memset( m_overdrawBuffer.data(), 0, m_overdrawBuffer.size() );
+			memset( m_renderTimeBuffer.data(), 0, m_renderTimeBuffer.size()*sizeof(float) );
+		}
+
+		if( m_bDebugMode && m_debugHeatmap == Heatmap::Off )
 		{
 			// Remove from afterglow queue patches that are overlapped by our new dirty patches.
 
@@ -269,6 +438,8 @@ namespace wg
 			}
 		}
 
+		m_occludedPixels = 0;
+
 		// Initialize GFX-device.
 	
 		return m_pGfxDevice->beginRender();
@@ -307,11 +478,15 @@ namespace wg
 	
 		// Render the dirty patches recursively
 	
-		m_child.pWidget->_renderPatches( m_pGfxDevice.rawPtr(), canvas, canvas, &dirtyPatches );
+		m_child.pWidget->_renderPatches( m_pGfxDevice.rawPtr(), canvas, canvas, &dirtyPatches, this );
 
 		// Handle updated rect overlays
 		
-		if( m_bDebugMode && m_pDebugOverlay )
+		if( m_bDebugMode && m_debugHeatmap != Heatmap::Off )
+		{
+			_renderHeatmap( dirtyPatches );
+		}
+		else if( m_bDebugMode && m_pDebugOverlay )
 		{
 			// Render our new overlays
 			
@@ -352,10 +527,134 @@ namespace wg
 	}
 	
 	
+	//____ _debugRender() ______________________________________________________
+	// Called instead of pWidget->_render() while in debug mode, collecting render statistics.
+
+	void RootPanel::_debugRender( Widget * pWidget, GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, const Rect& _clip )
+	{
+		if( m_renderCosts.empty() )
+		{
+			pWidget->_render( pDevice, _canvas, _window, _clip );		// Debug mode was turned on after beginRender().
+			return;
+		}
+
+		auto start = std::chrono::high_resolution_clock::now();
+		pWidget->_render( pDevice, _canvas, _window, _clip );
+		auto end = std::chrono::high_resolution_clock::now();
+
+		double microsec = std::chrono::duration<double,std::micro>(end - start).count();
+
+		// Update widgets render cost
+
+		CostEntry& cost = m_renderCosts.front()[pWidget];
+		if( !cost.pWidget )
+		{
+			cost.pWidget = pWidget;
+			cost.microsec = 0;
+			cost.calls = 0;
+			cost.pixels = 0;
+		}
+		cost.microsec += microsec;
+		cost.calls++;
+		cost.pixels += _clip.w*_clip.h;
+
+		// Update per pixel buffers
+
+		Rect r( _clip, m_heatmapGeo );
+		if( r.w <= 0 || r.h <= 0 )
+			return;
+
+		float timePerPixel = (float) (microsec / (_clip.w*_clip.h));
+
+		for( int y = r.y ; y < r.y + r.h ; y++ )
+		{
+			int ofs = (y - m_heatmapGeo.y)*m_heatmapGeo.w + r.x - m_heatmapGeo.x;
+			uint8_t * pCount = &m_overdrawBuffer[ofs];
+			float * pTime = &m_renderTimeBuffer[ofs];
+
+			for( int x = 0 ; x < r.w ; x++ )
+			{
+				if( pCount[x] < 255 )
+					pCount[x]++;
+				pTime[x] += timePerPixel;
+			}
+		}
+	}
+
+	//____ _renderHeatmap() ______________________________________________________
+
+	void RootPanel::_renderHeatmap( const Patches& patches )
+	{
+		// Find highest render time to scale against.
+
+		float maxTime = 0.f;
+		if( m_debugHeatmap == Heatmap::RenderTime )
+		{
+			for( const Rect * pRect = patches.begin() ; pRect != patches.end() ; pRect++ )
+			{
+				Rect r( *pRect, m_heatmapGeo );
+				for( int y = r.y ; y < r.y + r.h ; y++ )
+				{
+					const float * pTime = &m_renderTimeBuffer[(y - m_heatmapGeo.y)*m_heatmapGeo.w + r.x - m_heatmapGeo.x];
+					for( int x = 0 ; x < r.w ; x++ )
+						if( pTime[x] > maxTime )
+							maxTime = pTime[x];
+				}
+			}
+		}
+
+		BlendMode oldBlendMode = m_pGfxDevice->blendMode();
+		m_pGfxDevice->setBlendMode( BlendMode::Blend );
+
+		// Fill runs of pixels of same heat level with the color of that level.
+
+		for( const Rect * pRect = patches.begin() ; pRect != patches.end() ; pRect++ )
+		{
+			Rect r( *pRect, m_heatmapGeo );
+			if( r.w <= 0 || r.h <= 0 )
+				continue;
+
+			for( int y = r.y ; y < r.y + r.h ; y++ )
+			{
+				int ofs = (y - m_heatmapGeo.y)*m_heatmapGeo.w + r.x - m_heatmapGeo.x;
+
+				int runStart = 0;
+				int runLevel = -1;
+				for( int x = 0 ; x <= r.w ; x++ )
+				{
+					int level = 0;
+					if( x < r.w )
+					{
+						if( m_debugHeatmap == Heatmap::Overdraw )
+							level = std::min( (int) m_overdrawBuffer[ofs+x], 5 );
+						else if( m_renderTimeBuffer[ofs+x] > 0.f )
+							level = 1 + std::min( (int) (m_renderTimeBuffer[ofs+x] * 5 / maxTime), 4 );
+					}
+					else
+						level = -1;
+
+					if( level != runLevel )
+					{
+						if( runLevel > 0 )
+							m_pGfxDevice->fill( Rect( r.x + runStart, y, x - runStart, 1 ), s_heatmapColors[runLevel] );
+						runStart = x;
+						runLevel = level;
+					}
+				}
+			}
+
+			m_heatmapPatches.add( r );
+		}
+
+		m_pGfxDevice->setBlendMode( oldBlendMode );
+	}
+
 	//____ _findWidget() _____________________________________________________________
 	
 	Widget * RootPanel::_findWidget( const Coord& ofs, SearchMode mode )
 	{
+		Base::layoutQueue()->flush();
+
 		if( !geo().contains(ofs) || !m_child.pWidget )
 			return 0;
 	
@@ -396,7 +695,7 @@ namespace wg
 
 	bool RootPanel::_isChildVisible( Slot * pSlot ) const
 	{
-		return true;
+		return m_bVisible;
 	}
 
 	Rect RootPanel::_childWindowSection( Slot * pSlot ) const
@@ -423,8 +722,12 @@ namespace wg
 
 	void RootPanel::_childRequestRender( Slot * pSlot, const Rect& rect )
 	{
-		if( m_bVisible )
-			addDirtyPatch( Rect( geo().pos() + rect.pos(), rect.size() ) );
+		// Patches outside our geometry are never rendered, so we don't let them
+		// grow our list of dirty patches.
+
+		Rect clipped;
+		if( m_bVisible && clipped.intersection( Rect( geo().pos() + rect.pos(), rect.size() ), geo() ) )
+			addDirtyPatch( clipped );
 	}
 	void RootPanel::_childRequestResize( Slot * pSlot )
 	{
@@ -31,6 +31,10 @@
 #include <wg_gfxdevice.h>
 #include <wg_child.h>
 
+#include <deque>
+#include <map>
+#include <vector>
+
 namespace wg 
 {
 	
@@ -55,11 +59,29 @@ namespace wg
 	
 	class RootPanel : public Object, protected WidgetHolder, protected ChildHolder
 	{
+		friend class Widget;
 		friend class Container;
 		friend class InputHandler;
 	
 	public:
 
+		//.____ Debug __________________________________________________________
+
+		enum class Heatmap
+		{
+			Off,					///< Show updated rects through the debug overlay skin.
+			Overdraw,				///< Color pixels by the number of times they were rendered.
+			RenderTime				///< Color pixels by the time spent rendering them.
+		};
+
+		struct RenderCost
+		{
+			Widget_p	pWidget;
+			double		microsec;	///< Time spent in the widgets own rendering, children excluded.
+			int			calls;		///< Number of times widget was called to render a patch.
+			int			pixels;		///< Number of pixels covered by those patches.
+		};
+
 		//.____ Creation __________________________________________
 
 		static RootPanel_p	create() { return RootPanel_p(new RootPanel()); }
@@ -98,6 +120,9 @@ namespace wg
 		bool		renderSection( const Rect& clip );
 		bool		endRender();
 
+		void		setOcclusionCulling( bool bCull );
+		bool		isOcclusionCulling() const { return m_bOcclusionCulling; }
+
 
 		//.____ Debug __________________________________________________________
 
@@ -107,6 +132,14 @@ namespace wg
 		void				setDebugAfterglow(int frames);
 		Skin_p				debugOverlay() const { return m_pDebugOverlay;  }
 		int					debugAfterglow() const { return m_afterglowFrames;  }
+
+		void				setDebugHeatmap( Heatmap mode );
+		Heatmap				debugHeatmap() const { return m_debugHeatmap; }
+		void				setDebugStatsFrames( int frames );
+		int					debugStatsFrames() const { return m_debugStatsFrames; }
+		std::vector<RenderCost>	mostCostlyWidgets( int maxWidgets ) const;
+
+		int					occludedPixels() const { return m_occludedPixels; }		///< @brief Pixels found hidden behind opaque widgets in last render.
 	
 		//.____ Misc ___________________________________________________________
 	
@@ -171,15 +204,38 @@ namespace wg
 //		void				_setFocusedChild( Widget * pWidget );
 		Widget *			_focusedChild() const;
 
+		void				_debugRender( Widget * pWidget, GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, const Rect& _clip );
+		void				_renderHeatmap( const Patches& patches );
+
+		struct CostEntry
+		{
+			Widget_wp	pWidget;
+			double		microsec;
+			int			calls;
+			int			pixels;
+		};
+
 	
 		Patches				m_dirtyPatches;		// Dirty patches that needs to be rendered.
 		Patches				m_updatedPatches;	// Patches that were updated in last rendering session.
 
 
+		bool				m_bOcclusionCulling;
+		int					m_occludedPixels;	// Pixels hidden behind opaque children during current/last render.
+
 		bool				m_bDebugMode;
 		Skin_p				m_pDebugOverlay;
 		int					m_afterglowFrames;
 		std::deque<Patches>	m_afterglowRects;	// Afterglow rects are placed in this queue.
+
+		Heatmap				m_debugHeatmap;
+		Patches				m_heatmapPatches;	// Areas currently covered by heatmap overlay.
+		Rect				m_heatmapGeo;		// Geometry covered by the buffers below.
+		std::vector<uint8_t>	m_overdrawBuffer;	// Render count per pixel, current frame.
+		std::vector<float>	m_renderTimeBuffer;	// Render time per pixel in microseconds, current frame.
+
+		int					m_debugStatsFrames;
+		std::deque<std::map<Widget*,CostEntry>>	m_renderCosts;	// Render cost per widget, one map per frame, newest first.
 	
 		GfxDevice_p			m_pGfxDevice;
 		Slot				m_child;
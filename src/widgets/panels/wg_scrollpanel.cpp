@@ -1090,7 +1090,7 @@ namespace wg
 	
 	//____ _renderPatches() ________________________________________________________
 	
-	void ScrollPanel::_renderPatches( GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, Patches * _pPatches )
+	void ScrollPanel::_renderPatches( GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, Patches * _pPatches, RootPanel * pRoot )
 	{
 		// We start by eliminating dirt outside our geometry
 	
@@ -1130,7 +1130,7 @@ namespace wg
 			Rect window( canvas, m_viewSlot.windowGeo + _canvas.pos() );	// Use intersection in case canvas is smaller than window.
 	
 			if( window.intersectsWith(dirtBounds) )
-				m_viewSlot.pWidget->_renderPatches( pDevice, canvas, window, &patches );
+				m_viewSlot.pWidget->_renderPatches( pDevice, canvas, window, &patches, pRoot );
 		}
 	
 		for (int i = 0; i < 2; i++)
@@ -1139,7 +1139,7 @@ namespace wg
 			{
 				Rect canvas = m_scrollbarSlots[i].geo + _canvas.pos();
 				if (canvas.intersectsWith(dirtBounds))
-					m_scrollbarSlots[i].pWidget->_renderPatches(pDevice, canvas, canvas, &patches);
+					m_scrollbarSlots[i].pWidget->_renderPatches(pDevice, canvas, canvas, &patches, pRoot);
 			}
 		}
 	
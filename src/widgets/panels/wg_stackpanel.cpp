@@ -347,6 +347,13 @@ namespace wg
 		return _childGeo((StackPanelSlot *)pSlot).pos();	
 	}
 	
+	//____ _isChildVisible() ___________________________________________________
+
+	bool StackPanel::_isChildVisible( Slot * pSlot ) const
+	{
+		return ((StackPanelSlot*)pSlot)->bVisible && _isVisible();
+	}
+
 	//____ _childSize() _______________________________________________________
 
 	Size StackPanel::_childSize( Slot * pSlot ) const
@@ -24,6 +24,7 @@
 #include <wg_animplayer.h>
 #include <wg_util.h>
 #include <wg_msgrouter.h>
+#include <wg_tickscheduler.h>
 #include <wg_gfxdevice.h>
 
 #include <math.h>
@@ -45,15 +46,15 @@ namespace wg
 	
 		m_bPlaying		= false;
 		m_speed			= 1.f;
-		m_tickRouteId	= 0;
+		m_tickerId	= 0;
 	}
 	
 	//____ ~AnimPlayer() _______________________________________________________
 	
 	AnimPlayer::~AnimPlayer()
 	{
-		if( m_tickRouteId )
-			Base::msgRouter()->deleteRoute( m_tickRouteId );		
+		if( m_tickerId )
+			Base::tickScheduler()->removeTicker( m_tickerId );		
 	}
 	
 	//____ isInstanceOf() _________________________________________________________
@@ -90,6 +91,9 @@ namespace wg
 	{
 		m_pAnim			= pAnim;
 		m_playPos		= 0.0;
+
+		if( m_tickerId )
+			Base::tickScheduler()->setNextTick( m_tickerId, 0 );
 		
 		_requestResize();
 		_requestRender();
@@ -196,6 +200,7 @@ namespace wg
 			return false;
 	
 		m_speed = _speed;
+		_scheduleTick();
 		return true;
 	}
 	
@@ -210,7 +215,7 @@ namespace wg
 			return false;
 	
 		m_bPlaying = true;
-		m_tickRouteId = Base::msgRouter()->addRoute( MsgType::Tick, this );
+		m_tickerId = Base::tickScheduler()->addTicker( this );
 		return true;
 	}
 	
@@ -222,8 +227,8 @@ namespace wg
             return true;
         
         m_bPlaying = false;
-		Base::msgRouter()->deleteRoute( m_tickRouteId );
-		m_tickRouteId = 0;
+		Base::tickScheduler()->removeTicker( m_tickerId );
+		m_tickerId = 0;
 		return true;
 	}
 	
@@ -258,6 +263,21 @@ namespace wg
 	
 			Base::msgRouter()->post( ValueUpdateMsg::create(this, (int)m_playPos, (float) (m_playPos/(m_pAnim->duration()-1)),true));
 		}
+
+		_scheduleTick();
+	}
+
+	//____ _scheduleTick() _________________________________________________________
+	
+	void AnimPlayer::_scheduleTick()
+	{
+		// Sleep until next frame is due instead of ticking continuously.
+
+		if( !m_tickerId )
+			return;
+
+		int ms = m_pAnim ? m_pAnim->timeToNextKeyFrame( (int64_t) m_playPos ) : -1;
+		Base::tickScheduler()->setNextTick( m_tickerId, ms < 0 ? -1 : (int) std::ceil( ms / m_speed ) );
 	}
 	
 	
@@ -337,11 +357,11 @@ namespace wg
 		if( state.isEnabled() != m_state.isEnabled() && m_bPlaying )
 		{
 			if( state.isEnabled() )
-				m_tickRouteId = Base::msgRouter()->addRoute( MsgType::Tick, this );
+				m_tickerId = Base::tickScheduler()->addTicker( this );
 			else
 			{	
-				Base::msgRouter()->deleteRoute( m_tickRouteId );
-				m_tickRouteId = 0;
+				Base::tickScheduler()->removeTicker( m_tickerId );
+				m_tickerId = 0;
 			}
 			_requestRender();
 		}
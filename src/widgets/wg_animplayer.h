@@ -95,12 +95,13 @@ namespace wg
 		void			_setState( State state );
 	
 		void			_playPosUpdated();
+		void			_scheduleTick();
 	
 	private:
 	
 		GfxAnim_p	m_pAnim;
 		GfxFrame *	m_pAnimFrame;			// Frame currently used by animation.
-		RouteId		m_tickRouteId;
+		TickerId	m_tickerId;
 	
 		bool			m_bPlaying;
 		double			m_playPos;
@@ -24,6 +24,9 @@
 
 #include <wg_canvas.h>
 #include <wg_gfxdevice.h>
+#include <wg_base.h>
+#include <wg_msgrouter.h>
+#include <wg_tickscheduler.h>
 
 namespace wg 
 {
@@ -40,6 +43,8 @@ namespace wg
 	
 	Canvas::~Canvas()
 	{
+		if (m_tickerId)
+			Base::tickScheduler()->removeTicker( m_tickerId );
 	}
 	
 	//____ isInstanceOf() _________________________________________________________
@@ -171,6 +176,36 @@ namespace wg
 		return m_canvas.alphaTest(itemOfs, m_markOpacity);
 	}
 
+	//____ _receive() _________________________________________________________
+
+	void Canvas::_receive(Msg * pMsg)
+	{
+		Widget::_receive(pMsg);
+
+		if (pMsg->type() == MsgType::Tick)
+			m_canvas.update();
+	}
+
+	//____ _itemNotified() ____________________________________________________
+
+	void Canvas::_itemNotified(Item * pItem, ItemNotif notification, void * pData)
+	{
+		if (notification == ItemNotif::BufferingChanged)
+		{
+			// Frames presented from other threads are picked up on Tick when triple buffered.
+
+			bool bTripleBuffered = canvas.bufferCount() == 3;
+
+			if (bTripleBuffered && !m_tickerId)
+				m_tickerId = Base::tickScheduler()->addTicker( this );
+			else if (!bTripleBuffered && m_tickerId)
+			{
+				Base::tickScheduler()->removeTicker( m_tickerId );
+				m_tickerId = 0;
+			}
+		}
+	}
+
 
 
 } // namespace wg
@@ -102,9 +102,12 @@ namespace wg
 		virtual void	_setSkin(Skin * pSkin);
 		virtual void	_render(GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, const Rect& _clip);
 		virtual	bool	_alphaTest(const Coord& ofs);
+		virtual void	_receive(Msg * pMsg);
+		virtual void	_itemNotified(Item * pItem, ItemNotif notification, void * pData);
 
 
 		ModSurfaceItem	m_canvas;
+		TickerId		m_tickerId = 0;
 	};
 	
 	
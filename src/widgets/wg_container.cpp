@@ -99,7 +99,7 @@ namespace wg
 
 	 bool Container::_isChildVisible( Slot * pSlot ) const
 	 {
-		 return true;
+		 return _isVisible();
 	 }
 
 	Rect Container::_childWindowSection( Slot * pSlot ) const
@@ -257,7 +257,7 @@ namespace wg
 		Patches	patches;
 	};
 	
-	void Container::_renderPatches( GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, Patches * _pPatches )
+	void Container::_renderPatches( GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, Patches * _pPatches, RootPanel * pRoot )
 	{
 	
 		// We start by eliminating dirt outside our geometry
@@ -269,14 +269,18 @@ namespace wg
 			if( _canvas.intersectsWith( *pRect ) )
 				patches.push( Rect(*pRect,_canvas) );
 		}
-	
-	
-		// Render container itself
-		
-		for( const Rect * pRect = patches.begin() ; pRect != patches.end() ; pRect++ )
-			_render(pDevice, _canvas, _window, *pRect );
-			
-		
+
+		// Check if we should take part in the occlusion culling of the RootPanel we are rendered by.
+
+		bool bCull = pRoot && pRoot->m_bOcclusionCulling;
+		bool bCount = pRoot && (pRoot->m_bOcclusionCulling || pRoot->m_bDebugMode);
+
+		// Children rendered with a translucent tint can't hide anything behind them.
+
+		BlendMode maskMode = pDevice->blendMode();
+		if( maskMode == BlendMode::Blend && pDevice->tintColor().a < 255 )
+			maskMode = BlendMode::Ignore;
+
 		// Render children
 	
 		Rect	dirtBounds = patches.getUnion();
@@ -300,31 +304,88 @@ namespace wg
 				_nextSlotWithGeo( child );
 			}
 	
-			// Go through WidgetRenderContexts, push and mask dirt
-	
+			// Go through WidgetRenderContexts, push and mask dirt. What is left when we are done
+			// is the part of ourselves that is not hidden behind opaque children.
+
+			Patches	visiblePatches( patches.size() );
+			visiblePatches.push( &patches );
+
 			for (unsigned int i = 0 ; i < renderList.size(); i++)
 			{
 				WidgetRenderContext * p = &renderList[i];
+
+				// Only hand over the patches that actually touch the child, siblings have fragmented
+				// visiblePatches by now and most of it is of no concern to the child.
+
+				bool bTouched = false;
+				for( const Rect * pRect = visiblePatches.begin() ; pRect != visiblePatches.end() ; pRect++ )
+				{
+					if( p->geo.intersectsWith( *pRect ) )
+					{
+						p->patches.push( *pRect );
+						bTouched = true;
+					}
+				}
+
+				if( bTouched )
+					p->pWidget->_maskPatches( visiblePatches, p->geo, p->geo, maskMode );
 	
-				p->patches.push( &patches );
-	
-				p->pWidget->_maskPatches( patches, p->geo, p->geo, pDevice->blendMode() );		//TODO: Need some optimizations here, grandchildren can be called repeatedly! Expensive!
-	
-				if( patches.isEmpty() )
+				if( visiblePatches.isEmpty() )
 					break;
 			}
+
+			// Render container itself
+
+			if( bCount )
+				pRoot->m_occludedPixels += patches.area() - visiblePatches.area();
+
+			Patches * pOwnPatches = bCull ? &visiblePatches : &patches;
+			for( const Rect * pRect = pOwnPatches->begin() ; pRect != pOwnPatches->end() ; pRect++ )
+				_renderTracked(pDevice, _canvas, _window, *pRect, pRoot );
 	
 			// Go through WidgetRenderContexts and render the patches in reverse order (topmost child rendered last).
 	
 			for (int i = renderList.size() - 1; i >= 0; i--)
 			{
 				WidgetRenderContext * p = &renderList[i];
-				p->pWidget->_renderPatches( pDevice, p->geo, p->geo, &p->patches );
+				p->pWidget->_renderPatches( pDevice, p->geo, p->geo, &p->patches, pRoot );
 			}
 	
 		}
 		else
 		{
+			// Render container itself, skipping what is hidden behind opaque children.
+
+			if( bCount && !patches.isEmpty() )
+			{
+				Patches	visiblePatches( patches.size() );
+				visiblePatches.push( &patches );
+
+				SlotWithGeo child;
+				_firstSlotWithGeo( child );
+
+				while(child.pSlot && !visiblePatches.isEmpty() )
+				{
+					Rect geo = child.geo + _canvas.pos();
+					if( geo.intersectsWith( dirtBounds ) )
+						child.pSlot->pWidget->_maskPatches( visiblePatches, geo, _canvas, maskMode );
+					_nextSlotWithGeo( child );
+				}
+
+				pRoot->m_occludedPixels += patches.area() - visiblePatches.area();
+
+				Patches * pOwnPatches = bCull ? &visiblePatches : &patches;
+				for( const Rect * pRect = pOwnPatches->begin() ; pRect != pOwnPatches->end() ; pRect++ )
+					_renderTracked(pDevice, _canvas, _window, *pRect, pRoot );
+			}
+			else
+			{
+				for( const Rect * pRect = patches.begin() ; pRect != patches.end() ; pRect++ )
+					_renderTracked(pDevice, _canvas, _window, *pRect, pRoot );
+			}
+
+			// Render children
+
 			SlotWithGeo child;
 			_firstSlotWithGeo( child );
 	
@@ -332,7 +393,7 @@ namespace wg
 			{
 				Rect canvas = child.geo + _canvas.pos();
 				if( canvas.intersectsWith( dirtBounds ) )
-					child.pSlot->pWidget->_renderPatches( pDevice, canvas, canvas, &patches );
+					child.pSlot->pWidget->_renderPatches( pDevice, canvas, canvas, &patches, pRoot );
 				_nextSlotWithGeo( child );
 			}
 	
@@ -372,17 +433,28 @@ namespace wg
 	
 	void Container::_maskPatches( Patches& patches, const Rect& geo, const Rect& clip, BlendMode blendMode )
 	{
+		if( patches.isEmpty() )
+			return;
+
 		//TODO: Don't just check isOpaque() globally, check rect by rect.
 		if( (m_bOpaque && blendMode == BlendMode::Blend) || blendMode == BlendMode::Replace)
 			patches.sub( Rect(geo,clip) );
 		else
 		{
+			// Don't recurse through children that can't reach any of the patches.
+
+			Rect	area( clip, patches.getUnion() );
+			if( area.w <= 0 || area.h <= 0 )
+				return;
+
 			SlotWithGeo child;
 			_firstSlotWithGeo( child );
 	
-			while(child.pSlot)
+			while(child.pSlot && !patches.isEmpty() )
 			{
-				child.pSlot->pWidget->_maskPatches( patches, child.geo + geo.pos(), clip, blendMode );
+				Rect childGeo = child.geo + geo.pos();
+				if( childGeo.intersectsWith( area ) )
+					child.pSlot->pWidget->_maskPatches( patches, childGeo, clip, blendMode );
 				_nextSlotWithGeo( child );
 			}
 		}
@@ -28,6 +28,7 @@
 #include	<wg_base.h>
 #include	<wg_stdtextmapper.h>
 #include	<wg_msgrouter.h>
+#include	<wg_tickscheduler.h>
 
 namespace wg 
 {
@@ -59,15 +60,15 @@ namespace wg
 		m_valuesText.setTextMapper(pValueTextMapper);
 
 	
-		m_tickRouteId = Base::msgRouter()->addRoute( MsgType::Tick, this );
+		m_tickerId = Base::tickScheduler()->addTicker( this );
 	}
 	
 	//____ ~FpsDisplay() __________________________________________________________
 	
 	FpsDisplay::~FpsDisplay( void )
 	{
-		if( m_tickRouteId )
-			Base::msgRouter()->deleteRoute( m_tickRouteId );
+		if( m_tickerId )
+			Base::tickScheduler()->removeTicker( m_tickerId );
 		if( m_pTickBuffer )
 		{
 			delete [] m_pTickBuffer;
@@ -227,12 +228,12 @@ namespace wg
 		_requestRender();							//TODO: Check if there has been changes to text appearance.
 	
 		if( state.isEnabled() && !m_state.isEnabled() )
-			m_tickRouteId = Base::msgRouter()->addRoute( MsgType::Tick, this );
+			m_tickerId = Base::tickScheduler()->addTicker( this );
 	
 		if( !state.isEnabled() && m_state.isEnabled() )
 		{
-			Base::msgRouter()->deleteRoute( m_tickRouteId );
-			m_tickRouteId = 0;
+			Base::tickScheduler()->removeTicker( m_tickerId );
+			m_tickerId = 0;
 		}
 
 		Widget::_setState(state);
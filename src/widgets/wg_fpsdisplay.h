@@ -83,7 +83,7 @@ namespace wg
 		TextItem	m_valuesText;
 		int *		m_pTickBuffer;
 		int			m_tickBufferOfs;
-		RouteId		m_tickRouteId;
+		TickerId	m_tickerId;
 	};
 	
 	
@@ -26,6 +26,7 @@
 #include <wg_gfxdevice.h>
 #include <wg_util.h>
 #include <wg_surface.h>
+#include <wg_patches.h>
 
 namespace wg 
 {
@@ -163,6 +164,26 @@ namespace wg
 		}
 	}
 	
+	//____ _maskPatches() _______________________________________________________
+
+	void Image::_maskPatches( Patches& patches, const Rect& geo, const Rect& clip, BlendMode blendMode )
+	{
+		if( (m_bOpaque && blendMode == BlendMode::Blend) || blendMode == BlendMode::Replace )
+			patches.sub( Rect( geo, clip ) );
+		else if( m_pSurface && !m_rect.isEmpty() && m_pSurface->isOpaque() && blendMode == BlendMode::Blend )
+		{
+			// Skin is not opaque, but our image covers the content area.
+
+			Rect dest;
+			if( m_pSkin )
+				dest = m_pSkin->contentRect( geo, state() );
+			else
+				dest = geo;
+
+			patches.sub( Rect( dest, clip ) );
+		}
+	}
+
 	//____ _alphaTest() ___________________________________________________________
 	
 	bool Image::_alphaTest( const Coord& ofs )
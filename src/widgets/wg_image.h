@@ -75,6 +75,7 @@ namespace wg
 	
 		void	_cloneContent( const Widget * _pOrg );
 		void	_render( GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, const Rect& _clip );
+		void	_maskPatches( Patches& patches, const Rect& geo, const Rect& clip, BlendMode blendMode );
 		bool	_alphaTest( const Coord& ofs );
 	
 	private:
@@ -207,7 +207,7 @@ namespace wg
 			return;
 		}
 
-		Size sz = Size();
+		Size sz = m_size;
 
 		// Resize array if needed
 
@@ -223,6 +223,11 @@ namespace wg
 		for( int i = 0 ; i < nPoints ; i++ )
 			m_pLinePoints[i] = pPointValues[i];
 
+		// Without a size there is nothing to display yet, _setSize() will resample the points.
+
+		if( sz.w == 0 )
+			return;
+
 		// Generate and prepare a list of render segments
 
 		int nSegments = m_nRenderSegments;
@@ -446,18 +451,27 @@ namespace wg
 		if(m_nDisplayPoints == 0)
 			return;
 
-		// Draw the oscilloscope line
+		// Draw the oscilloscope line. Include the point left of clip rectangle if there is one, so the line enters smoothly.
 
-		m_iNextPixel = 0;
-			
-	//	antiAlias(_clip.w, _clip.x, m_pDisplayPoints + _clip.x - _canvas.x);
+		int begOfs = _clip.x > _canvas.x ? 1 : 0;
+		int nPoints = _clip.w + 1 + begOfs;
+		const float * pYval = m_pDisplayPoints + _clip.x - _canvas.x - begOfs;
 
-		if( _clip.x > _canvas.x )
-			_antiAlias(_clip.w+1, m_pDisplayPoints + _clip.x - _canvas.x-1, Coord( _clip.x-1, _canvas.y ) );
-		else
-			_antiAlias(_clip.w, m_pDisplayPoints + _clip.x - _canvas.x, Coord( _clip.x, _canvas.y ) );
+		int allocSize = sizeof(CoordF)*nPoints;
+		CoordF * pPoints = reinterpret_cast<CoordF*>(Base::memStackAlloc(allocSize));
+
+		for( int i = 0 ; i < nPoints ; i++ )
+		{
+			float y = pYval[i];
+			if( !(y > 0.0f || y <= 0.0f) )		// Check for NaN
+				y = 0.0f;
+
+			pPoints[i] = CoordF( (float) (_clip.x - begOfs + i), _canvas.y + y );
+		}
+
+		pDevice->clipDrawPolyline(_clip, nPoints, pPoints, m_lineColor, m_lineThickness);
 
-		pDevice->clipPlotPixels(_clip, m_iNextPixel, m_pAAPix, m_pAACol);
+		Base::memStackRelease(allocSize);
 
 		// Blit markers
 
@@ -479,116 +493,4 @@ namespace wg
 		}
 	}
 
-	void Oscilloscope::plot(const int x, const int y, const float alpha)
-	{
-	  if(m_iNextPixel < PixelBufferSize-1)
-	  {
-		  m_pAAPix[m_iNextPixel] = Coord(x, y);
-		  m_pAACol[m_iNextPixel] = m_lineColor;
-		  m_pAACol[m_iNextPixel].a = (uint8_t) (255*alpha);
-		  
-		  ++m_iNextPixel;
-	  }
-	  else
-	  {
-		  //DBGM(DBG_FFT, ("-----WARNING!------- m_iNextPixel=%i", m_iNextPixel));
-	  }
-		
-	  //DBG_ASSERT(m_iNextPixel < WG_OSC_PIXEL_BUFFER_SIZE);
-	}
-
-
-	// Xiaolin Wu's line algorithm
-	void Oscilloscope::_antiAlias(const int nPoints, const float *pYval, Coord ofs )
-	{
-		int   x0i,x1i;
-		float x0,x1,y0,y1,yprev;
-		float dx;
-		float dy;
-		float intery, gradient;
-		int xpxl1, xpxl2;
-		int ypxl1, ypxl2;
-		float xgap;
-		float xend;
-		float yend;
-		
-		yprev = pYval[0];
-		
-		for(x0i = 0; x0i < nPoints; x0i++)
-		{
-			x1i = x0i + 1;
-			y0 = yprev;
-			y1 = pYval[x1i];
-			yprev = y1;
-			
-			x0 = float(x0i);
-			x1 = float(x1i);
-			
-
-			// Check for NaN
-			if(!( y1 > 0.0f || y1 <= 0.0f ))
-				y1 = 0.0f;
-			
-			
-			bool steep = std::abs(y1 - y0) > std::abs(x1 - x0);
-			
-			if(steep) {
-				std::swap(x0,y0);
-				std::swap(x1,y1);
-			}
-			
-			if (x0>x1) {
-				std::swap(x0,x1);
-				std::swap(y0,y1);
-			}
-			
-			dx = (float)x1 - (float)x0;
-			dy = (float)y1 - (float)y0;
-			gradient = dy/dx;
-	   
-			xend = round(x0);
-			yend = y0 + gradient * (xend - x0);
-			xgap = rfpart(x0 + 0.5f);
-			xpxl1 = (int) xend;
-			ypxl1 = ipart(yend);
-			
-			if (steep) {
-				plot(ypxl1 +     ofs.x, xpxl1+ ofs.y, rfpart(yend) * xgap);
-				plot(ypxl1 + 1 + ofs.x, xpxl1+ ofs.y,  fpart(yend) * xgap);
-			} else {
-				plot(xpxl1 +     ofs.x, ypxl1 + ofs.y,     rfpart(yend) * xgap);
-				plot(xpxl1 +     ofs.x, ypxl1 + 1 + ofs.y,  fpart(yend) * xgap);
-			}
-			intery = yend + gradient;
-			
-			// Second end point
-			xend = round(x1);
-			yend = y1 + gradient * (xend - x1);
-			xgap = fpart(x1 + 0.5f);
-			xpxl2 = (int) xend;
-			ypxl2 = ipart(yend);
-			
-			if (steep) {
-				plot(ypxl2 +     ofs.x, xpxl2 + ofs.y, rfpart(yend) * xgap);
-				plot(ypxl2 + 1 + ofs.x, xpxl2 + ofs.y,  fpart(yend) * xgap);
-			} else {
-				plot(xpxl2 +     ofs.x, ypxl2 + ofs.y,     rfpart(yend) * xgap);
-				plot(xpxl2 +     ofs.x, ypxl2 + 1 + ofs.y,  fpart(yend) * xgap);
-			}
-			
-			for (int x=xpxl1+1; x<xpxl2; x++) {
-				if (steep) {
-					plot(ipart(intery) +     ofs.x, x + ofs.y, rfpart(intery));
-					plot(ipart(intery) + 1 + ofs.x, x + ofs.y,  fpart(intery));
-				} else {
-					plot(x + ofs.x, ipart (intery) + ofs.y,  rfpart(intery));
-					plot(x + ofs.x, ipart (intery)+1 + ofs.y, fpart(intery));
-				}
-				intery = intery + gradient;
-			}
-		}
-		
-		return;
-	}
-
 } // namespace wg
@@ -98,19 +98,9 @@ namespace wg
 		void	_render( GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, const Rect& _clip );
 		void	_setSize( const Size& size );
 
-		static const int PixelBufferSize = 16000;
-
-
 	private:
 		void	_updateRenderSegments( int nSegments, Rect * pSegments );
 		void	_resampleLinePoints( Size sz );
-		void 	_antiAlias(const int nPoints, const float *pYval, Coord canvasOfs );
-
-
-		static inline int ipart(double x) { return (int)floor(x); }
-		static inline float fpart(float x) { return std::abs(x) - ipart(x); }
-		static inline float rfpart(float x) { return 1.0f - fpart(x); }
-		void plot(const int x, const int y, const float alpha);
 
 		struct Marker
 		{
@@ -140,11 +130,6 @@ namespace wg
 		Marker *		m_pMarkers;
 		
 		Skin_p			m_pMarkerSkin;
-
-		// Anti-alias
-		int m_iNextPixel;
-		Coord m_pAAPix[PixelBufferSize];
-		Color m_pAACol[PixelBufferSize];
 	};
 
 } // namespace wg
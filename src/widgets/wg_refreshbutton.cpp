@@ -28,6 +28,7 @@
 #include <wg_key.h>
 #include <wg_msg.h>
 #include <wg_msgrouter.h>
+#include <wg_tickscheduler.h>
 
 namespace wg 
 {
@@ -48,15 +49,15 @@ namespace wg
 		m_animTimer			= 0;
 		m_refreshProgress	= 0.f;
 		m_bStopping			= false;
-		m_tickRouteId		= 0;
+		m_tickerId		= 0;
 	}
 	
 	//____ Destructor _____________________________________________________________
 	
 	RefreshButton::~RefreshButton()
 	{
-		if( m_tickRouteId )
-			Base::msgRouter()->deleteRoute( m_tickRouteId );
+		if( m_tickerId )
+			Base::tickScheduler()->removeTicker( m_tickerId );
 	}
 	
 	//____ isInstanceOf() _________________________________________________________
@@ -128,7 +129,7 @@ namespace wg
 			m_refreshProgress = 0.f;
 			m_animTimer = 0;
 			m_pRefreshAnim->setPlayMode( AnimMode::Looping );		//UGLY! Should change once the animation system has been updated.
-			m_tickRouteId = Base::msgRouter()->addRoute( MsgType::Tick, this );
+			m_tickerId = Base::tickScheduler()->addTicker( this );
 			_requestRender();
 		}
 	}
@@ -153,8 +154,8 @@ namespace wg
 	{
 		m_refreshProgress = 1.f;
 		m_bRefreshing = false;
-		Base::msgRouter()->deleteRoute( m_tickRouteId );
-		m_tickRouteId = 0;
+		Base::tickScheduler()->removeTicker( m_tickerId );
+		m_tickerId = 0;
 		_requestRender();
 	}
 	
@@ -221,8 +222,8 @@ namespace wg
 						{
 							m_bRefreshing = false;
 							m_bStopping = false;
-							Base::msgRouter()->deleteRoute( m_tickRouteId );
-							m_tickRouteId = 0;
+							Base::tickScheduler()->removeTicker( m_tickerId );
+							m_tickerId = 0;
 							_requestRender();
 						}
 					}
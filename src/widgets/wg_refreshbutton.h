@@ -111,7 +111,7 @@ namespace wg
 		State			_getRenderState();
 	
 	
-		RouteId			m_tickRouteId;
+		TickerId		m_tickerId;
 		GfxAnim_p		m_pRefreshAnim;
 		AnimTarget		m_animTarget;
 		RefreshMode		m_refreshMode;			// Determines if animation is a progressbar or spinner.
@@ -26,6 +26,7 @@
 #include <wg_msg.h>
 #include <wg_base.h>
 #include <wg_msgrouter.h>
+#include <wg_tickscheduler.h>
 
 #include <math.h>
 
@@ -73,15 +74,15 @@ namespace wg
 		
 		m_bUseFades = false;
 		
-		m_tickRouteId = Base::msgRouter()->addRoute( MsgType::Tick, this );
+		m_tickerId = Base::tickScheduler()->addTicker( this );
 	}
 
 	//____ Destructor _____________________________________________________________
 
 	VolumeMeter::~VolumeMeter()
 	{
-		if( m_tickRouteId )
-			Base::msgRouter()->deleteRoute( m_tickRouteId );
+		if( m_tickerId )
+			Base::tickScheduler()->removeTicker( m_tickerId );
 	}
 
 	//____ isInstanceOf() _________________________________________________________
@@ -88,7 +88,7 @@ namespace wg
 		bool			_alphaTest( const Coord& ofs );
 		void			_setSize( const Size& size );
 		
-		RouteId			m_tickRouteId;
+		TickerId		m_tickerId;
 				
 		Direction		m_direction;
 		Color			m_LEDColors[3][2];
@@ -25,6 +25,7 @@
 #include <wg_rootpanel.h>
 #include <wg_msgrouter.h>
 #include <wg_base.h>
+#include <wg_layoutqueue.h>
 
 namespace wg 
 {
@@ -36,7 +37,8 @@ namespace wg
 	
 	Widget::Widget():m_id(0), m_pHolder(0), m_pSlot(0), m_pointerStyle(PointerStyle::Default),
 						m_markOpacity( 1 ), m_bOpaque(false), m_bTabLock(false),
-						 m_bPressed(false), m_bSelectable(true), m_size(256,256)
+						 m_bPressed(false), m_bSelectable(true), m_size(256,256),
+						 m_bResizePending(false), m_bLayoutPending(false), m_layoutQueuePos(-1)
 	{
 	}
 	
@@ -44,6 +46,8 @@ namespace wg
 	
 	Widget::~Widget()
 	{
+		if( m_layoutQueuePos >= 0 && Base::layoutQueue() )
+			Base::layoutQueue()->remove(this);
 	}
 	
 	//____ isInstanceOf() _________________________________________________________
@@ -453,13 +457,13 @@ namespace wg
 	
 	//____ _renderPatches() ________________________________________________________
 	
-	void Widget::_renderPatches( GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, Patches * _pPatches )
+	void Widget::_renderPatches( GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, Patches * _pPatches, RootPanel * pRoot )
 	{
 		for( const Rect * pRect = _pPatches->begin() ; pRect != _pPatches->end() ; pRect++ )
 		{
 			Rect clip( _window, *pRect );
 			if( clip.w > 0 && clip.h > 0 )
-				_render( pDevice, _canvas, _window, clip );
+				_renderTracked( pDevice, _canvas, _window, clip, pRoot );
 		}
 	}
 	
@@ -488,6 +492,18 @@ namespace wg
 			m_pSkin->render( pDevice, _canvas, m_state, _clip );
 	}
 	
+	//____ _renderTracked() ______________________________________________________
+	// Calls _render(), letting the RootPanel collect render statistics when in debug mode.
+	// Should be used by _renderPatches() for calls to the widgets own _render().
+
+	void Widget::_renderTracked( GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, const Rect& _clip, RootPanel * pRoot )
+	{
+		if( pRoot && pRoot->m_bDebugMode )
+			pRoot->_debugRender( this, pDevice, _canvas, _window, _clip );
+		else
+			_render( pDevice, _canvas, _window, _clip );
+	}
+
 	//____ _setSize() ___________________________________________________________
 	
 	void Widget::_setSize( const Size& size )
@@ -496,6 +512,104 @@ namespace wg
 //		_requestRender();		Do NOT request render here, it is the responsibility of ancestor initiating the series of events.
 	}
 	
+	//____ _requestResize() _____________________________________________________
+	/**
+	 * @brief Request holder to reconsider our size.
+	 *
+	 * The request is placed in the LayoutQueue and passed on to the holder when the
+	 * queue is flushed, so that any number of requests between two renders results in
+	 * a single call to the holder.
+	 */
+
+	void Widget::_requestResize()
+	{
+		if( !m_pHolder )
+			return;
+
+		LayoutQueue * pQueue = Base::layoutQueue();
+		if( !pQueue )
+		{
+			m_pHolder->_childRequestResize( m_pSlot );
+			return;
+		}
+
+		m_bResizePending = true;
+		pQueue->add(this);
+	}
+
+	//____ _requestLayout() _____________________________________________________
+	/**
+	 * @brief Request a deferred call to _updateLayout().
+	 *
+	 * Used by containers that need to recalculate the geometry of their children,
+	 * which is expensive enough to be worth batching until the LayoutQueue is flushed.
+	 * Containers must call _ensureLayout() before using or reporting layout results
+	 * that might be outdated.
+	 */
+
+	void Widget::_requestLayout()
+	{
+		LayoutQueue * pQueue = Base::layoutQueue();
+		if( !pQueue )
+		{
+			_updateLayout();
+			return;
+		}
+
+		m_bLayoutPending = true;
+		pQueue->add(this);
+	}
+
+	//____ _ensureLayout() ______________________________________________________
+	/**
+	 * @brief Bring our layout up to date before it is used or reported.
+	 *
+	 * Our layout might depend on resize requests from descendants that still are
+	 * waiting in the LayoutQueue, so the queue is flushed if anything is pending.
+	 * While the queue already is being flushed, only our own pending layout update
+	 * is performed, since requests from deeper widgets have been handled by then.
+	 */
+
+	void Widget::_ensureLayout() const
+	{
+		LayoutQueue * pQueue = Base::layoutQueue();
+		if( pQueue && !pQueue->isEmpty() && !pQueue->isFlushing() )
+			pQueue->flush();
+		else if( m_bLayoutPending )
+			const_cast<Widget*>(this)->_flushLayout();
+	}
+
+	//____ _flushLayout() _______________________________________________________
+
+	void Widget::_flushLayout()
+	{
+		if( m_bLayoutPending )
+		{
+			m_bLayoutPending = false;
+			_updateLayout();
+		}
+
+		if( m_layoutQueuePos >= 0 && Base::layoutQueue()->isFlushing() )
+		{
+			// Leave the queue before calling our holder, which might make us request again.
+
+			Base::layoutQueue()->remove(this);
+
+			if( m_bResizePending )
+			{
+				m_bResizePending = false;
+				if( m_pHolder )
+					m_pHolder->_childRequestResize( m_pSlot );
+			}
+		}
+	}
+
+	//____ _updateLayout() ______________________________________________________
+
+	void Widget::_updateLayout()
+	{
+	}
+
 	//____ _refresh() ___________________________________________________________
 	
 	void Widget::_refresh()
@@ -67,6 +67,8 @@ namespace wg
 	{
 	friend class MsgRouter;
 	friend class InputHandler;
+	friend class TickScheduler;
+	friend class LayoutQueue;
 	
 	friend class RootPanel;
 	friend class FlexPanel;
@@ -199,7 +201,9 @@ namespace wg
 	
 		inline void		_requestRender() { if( m_pHolder ) m_pHolder->_childRequestRender( m_pSlot ); }
 		inline void		_requestRender( const Rect& rect ) { if( m_pHolder ) m_pHolder->_childRequestRender( m_pSlot, rect ); }
-		inline void		_requestResize() { if( m_pHolder ) m_pHolder->_childRequestResize( m_pSlot ); }
+		void			_requestResize();
+		void			_requestLayout();
+		void			_ensureLayout() const;
 		inline void		_requestInView() const { if( m_pHolder ) m_pHolder->_childRequestInView( m_pSlot ); }
 		inline void		_requestInView( const Rect& mustHaveArea, const Rect& niceToHaveArea ) const { if( m_pHolder ) m_pHolder->_childRequestInView( m_pSlot, mustHaveArea, niceToHaveArea ); }
 		
@@ -209,18 +213,21 @@ namespace wg
 		inline Container *	_parent() const { if( m_pHolder ) return m_pHolder->_childParent(); else return nullptr; }
 	
 		inline Rect		_windowSection() const { if( m_pHolder ) return m_pHolder->_childWindowSection( m_pSlot ); return Rect(); }
+		inline bool		_isVisible() const { if( m_pHolder ) return m_pHolder->_isChildVisible( m_pSlot ); return false; }
 	
 		// To be overloaded by Widget
 	
-		virtual void	_renderPatches( GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, Patches * _pPatches );
+		virtual void	_renderPatches( GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, Patches * _pPatches, RootPanel * pRoot );
 		virtual void	_collectPatches( Patches& container, const Rect& geo, const Rect& clip );
 		virtual void	_maskPatches( Patches& patches, const Rect& geo, const Rect& clip, BlendMode blendMode );
 
 		Widget *		_clone() const;
 		virtual void	_cloneContent( const Widget * _pOrg );
 		virtual void	_render( GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, const Rect& _clip );
+		void			_renderTracked( GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, const Rect& _clip, RootPanel * pRoot );
 	
 		virtual void	_refresh();
+		virtual void	_updateLayout();
 		virtual void	_setSize( const Size& size );
 		virtual void	_setSkin( Skin * pSkin );
 		virtual void	_setState( State state );
@@ -271,8 +278,15 @@ namespace wg
 		State			m_state;
 		Size			m_size;
 
+		bool			m_bResizePending;	// Resize request waiting in LayoutQueue to be passed on to holder.
+		bool			m_bLayoutPending;	// Call to _updateLayout() waiting in LayoutQueue.
+		int				m_layoutQueuePos;	// Position in LayoutQueue or -1.
+
 //	private:
 		bool			m_bPressed;		// Keeps track of pressed button when mouse leaves/re-enters widget.
+
+	private:
+		void			_flushLayout();
 	
 	};
 		
@@ -47,7 +47,10 @@
 #include <wg_gfxstreamwriter.h>
 #include <wg_gfxstreamplug.h>
 #include <wg_gfxstreamlogger.h>
+#include <wg_gfxstreamstatistics.h>
 #include <wg_gfxstreamplayer.h>
+#include <wg_gfxstreamrecorder.h>
+#include <wg_gfxstreamrecording.h>
 #include <wg_inputhandler.h>
 #include <wg_itemholder.h>
 #include <wg_key.h>
@@ -56,6 +59,8 @@
 #include <wg_msg.h>
 #include <wg_msglogger.h>
 #include <wg_msgrouter.h>
+#include <wg_tickscheduler.h>
+#include <wg_layoutqueue.h>
 #include <wg_nullgfxdevice.h>
 #include <wg_object.h>
 #include <wg_paddedslot.h>
@@ -0,0 +1,181 @@
+/*=========================================================================
+
+                         >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+/*
+	respack - Build a WonderGUI resource pack from a manifest.
+
+	Usage: respack <manifest> <output.wgrp>
+
+	Each line of the manifest describes one resource:
+
+		surface   <id> <image file> [pixelformat ...]
+		font      <id> <file>
+		textstyle <id> <file>
+		skin      <id> <file>
+		data      <id> <file>
+
+	Images are loaded with SDL_image and stored once for each pixel format listed
+	(BGRA_8 if none). Empty lines and lines starting with '#' are ignored.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <sstream>
+#include <fstream>
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+#include <wondergui.h>
+#include <wg_softsurface.h>
+#include <wg_softsurfacefactory.h>
+#include <wg_respackwriter.h>
+#include <wg_enumextras.h>
+
+using namespace wg;
+
+//____ parseFormat() __________________________________________________________
+
+static PixelFormat parseFormat( const std::string& name )
+{
+	for( int i = 0 ; i < PixelFormat_size ; i++ )
+	{
+		if( name == toString( (PixelFormat) i ) )
+			return (PixelFormat) i;
+	}
+	return PixelFormat::Unknown;
+}
+
+//____ loadImage() ____________________________________________________________
+
+static Surface_p loadImage( const std::string& path )
+{
+	SDL_Surface * pImage = IMG_Load( path.c_str() );
+	if( !pImage )
+		return nullptr;
+
+	// SDL_PIXELFORMAT_ARGB8888 has the memory layout of PixelFormat::BGRA_8 on little-endian machines.
+
+	SDL_Surface * pConverted = SDL_ConvertSurfaceFormat( pImage, SDL_PIXELFORMAT_ARGB8888, 0 );
+	SDL_FreeSurface( pImage );
+	if( !pConverted )
+		return nullptr;
+
+	SDL_LockSurface( pConverted );
+	Surface_p pSurface = SoftSurface::create( Size(pConverted->w, pConverted->h), PixelFormat::BGRA_8, (uint8_t*) pConverted->pixels, pConverted->pitch );
+	SDL_UnlockSurface( pConverted );
+	SDL_FreeSurface( pConverted );
+	return pSurface;
+}
+
+//____ main() _________________________________________________________________
+
+int main( int argc, char * argv[] )
+{
+	if( argc != 3 )
+	{
+		printf( "Usage: respack <manifest> <output>\n" );
+		return 1;
+	}
+
+	std::ifstream manifest( argv[1] );
+	if( !manifest )
+	{
+		printf( "Could not open manifest '%s'.\n", argv[1] );
+		return 1;
+	}
+
+	Base::init();
+	IMG_Init( IMG_INIT_PNG | IMG_INIT_JPG );
+
+	int		nErrors = 0;
+	{
+		ResPackWriter_p pWriter = ResPackWriter::create( SoftSurfaceFactory::create() );
+
+		std::string line;
+		int lineNb = 0;
+		while( std::getline( manifest, line ) )
+		{
+			lineNb++;
+
+			std::istringstream	words(line);
+			std::string			type, id, path;
+
+			if( !(words >> type) || type[0] == '#' )
+				continue;
+
+			if( !(words >> id >> path) )
+			{
+				printf( "%s:%d: Expected <type> <id> <file>.\n", argv[1], lineNb );
+				nErrors++;
+				continue;
+			}
+
+			bool bOk = false;
+			if( type == "surface" )
+			{
+				Surface_p pSurface = loadImage( path );
+				if( pSurface )
+				{
+					std::string formatName;
+					int nFormats = 0;
+					bOk = true;
+					while( words >> formatName )
+					{
+						PixelFormat format = parseFormat( formatName );
+						bOk = bOk && format != PixelFormat::Unknown && pWriter->addSurface( id, pSurface, format );
+						nFormats++;
+					}
+					if( nFormats == 0 )
+						bOk = pWriter->addSurface( id, pSurface, PixelFormat::BGRA_8 );
+				}
+			}
+			else if( type == "font" )
+				bOk = pWriter->addFile( id, path, ResPack::Type::Font );
+			else if( type == "textstyle" )
+				bOk = pWriter->addFile( id, path, ResPack::Type::TextStyle );
+			else if( type == "skin" )
+				bOk = pWriter->addFile( id, path, ResPack::Type::Skin );
+			else if( type == "data" )
+				bOk = pWriter->addFile( id, path, ResPack::Type::Data );
+
+			if( !bOk )
+			{
+				printf( "%s:%d: Failed to add %s '%s' from '%s'.\n", argv[1], lineNb, type.c_str(), id.c_str(), path.c_str() );
+				nErrors++;
+			}
+		}
+
+		if( nErrors == 0 && !pWriter->save( argv[2] ) )
+		{
+			printf( "Could not write '%s'.\n", argv[2] );
+			nErrors++;
+		}
+		else if( nErrors == 0 )
+			printf( "Wrote %d resources to '%s'.\n", pWriter->size(), argv[2] );
+	}
+
+	IMG_Quit();
+	Base::exit();
+	return nErrors == 0 ? 0 : 1;
+}
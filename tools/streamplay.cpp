@@ -0,0 +1,210 @@
+/*=========================================================================
+
+                         >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+/*
+	streamplay - Render frames of a GfxStream recording to PNG images.
+
+	Usage: streamplay [options] <recording> <output directory>
+
+	Options:
+
+		--frames <first>[-<last>]	Frames to render, counting from 0. Default is all frames.
+		--info						Only print information about the recording.
+
+	Recordings are made with GfxStreamRecorder. Frames are played offscreen on a
+	SoftGfxDevice with a canvas of the recorded size. Playback starts from the
+	closest keyframe before the first frame, so rendering a few frames late in a
+	long recording is fast. Each frame is saved as frame_<number>.png.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <string>
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+#include <wondergui.h>
+#include <wg_softsurface.h>
+#include <wg_softsurfacefactory.h>
+#include <wg_softgfxdevice.h>
+
+using namespace wg;
+
+//____ loadFile() _____________________________________________________________
+
+static Blob_p loadFile( const char * pPath )
+{
+	FILE * fp = fopen( pPath, "rb" );
+	if( !fp )
+		return nullptr;
+
+	fseek( fp, 0, SEEK_END );
+	int64_t size = ftell( fp );
+	fseek( fp, 0, SEEK_SET );
+
+	// Recordings are played from memory, so we are limited to what fits in a Blob.
+
+	if( size < 0 || size > INT_MAX )
+	{
+		printf( "'%s' is too large to be loaded.\n", pPath );
+		fclose( fp );
+		return nullptr;
+	}
+
+	Blob_p pBlob = Blob::create( (int) size );
+	int nRead = (int) fread( pBlob->data(), 1, size, fp );
+	fclose( fp );
+
+	if( nRead != size )
+		return nullptr;
+
+	return pBlob;
+}
+
+//____ saveCanvas() ___________________________________________________________
+
+static bool saveCanvas( Surface * pCanvas, const std::string& path )
+{
+	// SDL_PIXELFORMAT_ARGB8888 has the memory layout of PixelFormat::BGRA_8 on little-endian machines.
+
+	uint8_t * pPixels = pCanvas->lock( AccessMode::ReadOnly );
+
+	SDL_Surface * pSurface = SDL_CreateRGBSurfaceWithFormatFrom( pPixels, pCanvas->width(), pCanvas->height(), 32,
+																 pCanvas->pitch(), SDL_PIXELFORMAT_ARGB8888 );
+	bool bOk = pSurface && IMG_SavePNG( pSurface, path.c_str() ) == 0;
+
+	if( pSurface )
+		SDL_FreeSurface( pSurface );
+	pCanvas->unlock();
+	return bOk;
+}
+
+//____ main() _________________________________________________________________
+
+int main( int argc, char * argv[] )
+{
+	const char *	pRecordingPath = nullptr;
+	const char *	pOutputDir = nullptr;
+	int				firstFrame = 0;
+	int				lastFrame = -1;
+	bool			bInfoOnly = false;
+
+	for( int i = 1 ; i < argc ; i++ )
+	{
+		if( strcmp( argv[i], "--frames" ) == 0 && i + 1 < argc )
+		{
+			const char * p = argv[++i];
+			firstFrame = atoi( p );
+			const char * pDash = strchr( p, '-' );
+			lastFrame = pDash ? atoi( pDash + 1 ) : firstFrame;
+		}
+		else if( strcmp( argv[i], "--info" ) == 0 )
+			bInfoOnly = true;
+		else if( !pRecordingPath )
+			pRecordingPath = argv[i];
+		else if( !pOutputDir )
+			pOutputDir = argv[i];
+		else
+		{
+			pRecordingPath = nullptr;
+			break;
+		}
+	}
+
+	if( !pRecordingPath || (!pOutputDir && !bInfoOnly) )
+	{
+		printf( "Usage: streamplay [--frames <first>[-<last>]] [--info] <recording> <output directory>\n" );
+		return 1;
+	}
+
+	Base::init();
+	IMG_Init( IMG_INIT_PNG );
+
+	int		nErrors = 0;
+	{
+		Blob_p pFile = loadFile( pRecordingPath );
+		GfxStreamRecording_p pRecording = pFile ? GfxStreamRecording::create( pFile ) : nullptr;
+
+		if( !pRecording || !pRecording->isValid() )
+		{
+			printf( "Could not read recording '%s'.\n", pRecordingPath );
+			nErrors++;
+		}
+		else
+		{
+			int nFrames = pRecording->frames();
+
+			printf( "%s: %dx%d, %d frames, %d keyframes%s.\n", pRecordingPath, pRecording->canvasSize().w, pRecording->canvasSize().h,
+					nFrames, pRecording->keyframes(), pRecording->hasIndex() ? "" : " (index rebuilt, recording was not closed)" );
+
+			if( lastFrame < 0 || lastFrame >= nFrames )
+				lastFrame = nFrames - 1;
+
+			if( !bInfoOnly && firstFrame <= lastFrame )
+			{
+				SoftSurfaceFactory_p pFactory = SoftSurfaceFactory::create();
+				Surface_p pCanvas = pFactory->createSurface( pRecording->canvasSize(), PixelFormat::BGRA_8 );
+				SoftGfxDevice_p pDevice = SoftGfxDevice::create( pCanvas );
+
+				GfxStreamPlayer_p pPlayer = GfxStreamPlayer::create( pRecording->stream, pDevice, pFactory );
+
+				if( !pPlayer->seek( firstFrame ) )
+				{
+					printf( "Could not seek to frame %d.\n", firstFrame );
+					nErrors++;
+				}
+				else
+				{
+					for( int frame = firstFrame ; frame <= lastFrame ; frame++ )
+					{
+						if( !pPlayer->playFrame() )
+						{
+							printf( "Recording ended unexpectedly at frame %d.\n", frame );
+							nErrors++;
+							break;
+						}
+
+						char name[32];
+						snprintf( name, sizeof(name), "/frame_%05d.png", frame );
+
+						std::string path = std::string(pOutputDir) + name;
+						if( !saveCanvas( pCanvas, path ) )
+						{
+							printf( "Could not write '%s'.\n", path.c_str() );
+							nErrors++;
+							break;
+						}
+					}
+
+					printf( "Rendered frames %d to %d.\n", firstFrame, lastFrame );
+				}
+			}
+		}
+	}
+
+	IMG_Quit();
+	Base::exit();
+	return nErrors == 0 ? 0 : 1;
+}